@@ -50,6 +50,8 @@
 #include <86box/config.h>
 #include <86box/mem.h>
 #include "cpu.h"
+#include <86box/cpu_prof.h>
+#include <86box/trace.h>
 #ifdef USE_DYNAREC
 #    include "codegen_public.h"
 #endif
@@ -201,6 +203,8 @@ uint32_t mem_size                               = 0;              /* (C) memory
                                                                          system board)*/
 uint32_t isa_mem_size                           = 0;              /* (C) memory size (ISA Memory Cards) */
 int      cpu_use_dynarec                        = 0;              /* (C) cpu uses/needs Dyna */
+int      mem_smc_protect                        = 0;              /* (C) write-protect dynarec code pages */
+int      cpu_dynarec_blocks                     = 0;              /* (C) old dynarec block cache size, 0 = auto */
 int      cpu                                    = 0;              /* (C) cpu type */
 int      fpu_type                               = 0;              /* (C) fpu type */
 int      fpu_softfloat                          = 0;              /* (C) fpu uses softfloat */
@@ -211,6 +215,8 @@ int      confirm_save                           = 1;              /* (G) enable
 int      enable_discord                         = 0;              /* (C) enable Discord integration */
 int      pit_mode                               = -1;             /* (C) force setting PIT mode */
 int      fm_driver                              = 0;              /* (C) select FM sound driver */
+int      fm_offload                             = 0;              /* (C) render FM synthesis on a
+                                                                         separate thread */
 int      open_dir_usr_path                      = 0;              /* (G) default file open dialog directory
                                                                          of usr_path */
 int      video_fullscreen_scale_maximized       = 0;              /* (C) Whether fullscreen scaling settings
@@ -326,6 +332,11 @@ struct accelKey def_acc_keys[NUM_ACCELS] = {
 char vmm_path[1024] = { '\0' }; /* VM manager path to scan for VMs */
 int  start_vmm = 1;
 
+#ifdef MTR_ENABLED
+static char trace_fn[1024];          /* trace started with -U */
+static char trace_counters_fn[1024];
+#endif
+
 /* Statistics. */
 extern int mmuflush;
 extern int readlnum;
@@ -709,6 +720,8 @@ pc_show_usage(void)
 #ifdef USE_INSTRUMENT
             "-J or --instrument name\t- set 'name' to be the profiling instrument\n"
 #endif
+            "-K or --cpuprof prefix\t- profile guest execution, write 'prefix'.json\n"
+            "\t\t\t\t   and 'prefix'.folded on exit\n"
             "-L or --logfile path\t\t- set 'path' to be the logfile\n"
             "-M or --missing\t\t- dump missing machines and video cards\n"
             "-N or --noconfirm\t\t- do not ask for confirmation on quit\n"
@@ -721,6 +734,10 @@ pc_show_usage(void)
 #ifdef SHOW_EXTRA_PARAMS
             "-T or --testmode\t\t- test mode: execute the test mode entry\n"
             "\t\t\t\t   point on init/hard reset\n"
+#endif
+#ifdef MTR_ENABLED
+            "-U or --trace prefix\t\t- trace host time, write 'prefix'.json\n"
+            "\t\t\t\t   and 'prefix'_counters.json on exit\n"
 #endif
             "-V or --vmname name\t\t- overrides the name of the running VM\n"
 #ifdef _WIN32
@@ -860,6 +877,21 @@ usage:
 #endif
         } else if (!strcasecmp(argv[c], "--fullscreen") || !strcasecmp(argv[c], "-F")) {
             start_in_fullscreen = 1;
+        } else if (!strcasecmp(argv[c], "--cpuprof") || !strcasecmp(argv[c], "-K")) {
+            if ((c + 1) == argc)
+                goto usage;
+
+            cpu_prof_set_path(argv[++c]);
+            cpu_prof_start();
+#ifdef MTR_ENABLED
+        } else if (!strcasecmp(argv[c], "--trace") || !strcasecmp(argv[c], "-U")) {
+            if ((c + 1) == argc)
+                goto usage;
+
+            snprintf(trace_fn, sizeof(trace_fn), "%s.json", argv[++c]);
+            snprintf(trace_counters_fn, sizeof(trace_counters_fn), "%s_counters.json", argv[c]);
+            trace_start(trace_fn);
+#endif
         } else if (!strcasecmp(argv[c], "--logfile") || !strcasecmp(argv[c], "-L")) {
             if ((c + 1) == argc)
                 goto usage;
@@ -1929,6 +1961,12 @@ pc_close(UNUSED(thread_t *ptr))
 
     plat_mouse_capture(0);
 
+    cpu_prof_stop();
+#ifdef MTR_ENABLED
+    if (trace_counters_fn[0] != '\0')
+        trace_stop(trace_counters_fn);
+#endif
+
     /* Close all the memory mappings. */
     mem_close();
 
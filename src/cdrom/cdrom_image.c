@@ -37,9 +37,11 @@
 #include <86box/nvr.h>
 #include <86box/path.h>
 #include <86box/plat.h>
+#include <86box/thread.h>
 #include <86box/cdrom.h>
 #include <86box/cdrom_image.h>
 #include <86box/cdrom_image_viso.h>
+#include <86box/chd_image.h>
 
 #include <sndfile.h>
 
@@ -56,6 +58,10 @@
 #define MAX_FILENAME_LENGTH 256
 #define CROSS_LEN           512
 
+/* Read-ahead window, in bytes, after the first and at most after many sequential reads. */
+#define CACHE_WINDOW_MIN    (16 << 10)
+#define CACHE_WINDOW_MAX    (256 << 10)
+
 static char temp_keyword[1024];
 static char temp_file[260]     = { 0 };
 
@@ -509,6 +515,207 @@ bin_init(const uint8_t id, const char *filename, int *error)
     return tf;
 }
 
+#ifdef USE_CHD
+/* CHD track functions - every track gets its own file, which presents
+   the track's frames as if they were a BIN file of sector_size sectors. */
+typedef struct chd_track_t {
+    chd_image_t *chd;
+    uint64_t     frame; /* First frame of the track in the CHD. */
+    uint64_t     frames;
+    uint32_t     sector_size;
+} chd_track_t;
+
+static int
+chd_track_read(void *priv, uint8_t *buffer, const uint64_t seek, const size_t count)
+{
+    const track_file_t *tf     = (track_file_t *) priv;
+    const chd_track_t  *ctr    = (chd_track_t *) tf->priv;
+    uint64_t            frame  = seek / ctr->sector_size;
+    uint32_t            off    = seek % ctr->sector_size;
+    size_t              remain = count;
+    uint8_t            *buf    = buffer;
+
+    image_log(tf->log, "chd_track_read(pos=%" PRIu64 " count=%lu)\n", seek, count);
+
+    while (remain > 0) {
+        size_t n = ctr->sector_size - off;
+
+        if (n > remain)
+            n = remain;
+
+        if ((frame >= ctr->frames) ||
+            (chd_image_read(ctr->chd, buf, ((ctr->frame + frame) * CHD_CD_FRAME_SIZE) + off, n) < 0)) {
+            image_log(tf->log, "chd_track_read failed!\n");
+
+            return -1;
+        }
+
+        buf += n;
+        remain -= n;
+        off = 0;
+        frame++;
+    }
+
+    /* CD-DA is stored big endian. */
+    if (tf->motorola) {
+        for (uint64_t i = 0; i < count; i += 2) {
+            const uint8_t buffer0 = buffer[i];
+            const uint8_t buffer1 = buffer[i + 1];
+            buffer[i] = buffer1;
+            buffer[i + 1] = buffer0;
+        }
+    }
+
+    return 1;
+}
+
+static uint64_t
+chd_track_get_length(void *priv)
+{
+    const track_file_t *tf  = (track_file_t *) priv;
+    const chd_track_t  *ctr = (chd_track_t *) tf->priv;
+
+    return ctr->frames * ctr->sector_size;
+}
+
+static void
+chd_track_close(void *priv)
+{
+    track_file_t *tf  = (track_file_t *) priv;
+    chd_track_t  *ctr = (chd_track_t *) tf->priv;
+
+    chd_image_close(ctr->chd);
+    free(ctr);
+
+    log_close(tf->log);
+    tf->log = NULL;
+
+    free(tf);
+}
+
+static track_file_t *
+chd_track_init(const uint8_t id, const char *filename, chd_image_t *chd,
+               const uint64_t frame, const uint64_t frames, const uint32_t sector_size)
+{
+    track_file_t *tf  = (track_file_t *) calloc(1, sizeof(track_file_t));
+    chd_track_t  *ctr = (chd_track_t *) calloc(1, sizeof(chd_track_t));
+    char          n[1024] = { 0 };
+
+    sprintf(n, "CD-ROM %i CHD  ", id + 1);
+    tf->log = log_open(n);
+
+    strncpy(tf->fn, filename, sizeof(tf->fn) - 1);
+
+    chd_image_ref(chd);
+    ctr->chd         = chd;
+    ctr->frame       = frame;
+    ctr->frames      = frames;
+    ctr->sector_size = sector_size;
+
+    tf->priv       = ctr;
+    tf->read       = chd_track_read;
+    tf->get_length = chd_track_get_length;
+    tf->close      = chd_track_close;
+
+    return tf;
+}
+#endif
+
+/*
+   Read-ahead sector cache for BIN and VISO files.
+
+   A request that misses the buffer refills it from the request onwards;
+   while the requests are sequential, the refill grows from CACHE_WINDOW_MIN
+   up to CACHE_WINDOW_MAX, so a streaming installer or CD-DA playback ends
+   up doing one host read per hundred or so sectors, while a seek drops the
+   window and only reads what was asked for. Reads can come from both the
+   emulation and the CD audio threads, hence the mutex.
+ */
+typedef struct track_cache_t {
+    mutex_t  *mutex;
+    uint8_t  *buf;
+    uint64_t  start;    /* File offset of buf[0]. */
+    uint64_t  next;     /* File offset following the previous request. */
+    uint64_t  file_len;
+    uint32_t  len;      /* Valid bytes in buf. */
+    uint32_t  window;   /* Current read-ahead, 0 if not streaming. */
+} track_cache_t;
+
+static void
+track_cache_init(track_file_t *tf)
+{
+    track_cache_t *tc = (track_cache_t *) calloc(1, sizeof(track_cache_t));
+
+    tc->buf      = (uint8_t *) malloc(CACHE_WINDOW_MAX);
+    tc->mutex    = thread_create_mutex();
+    tc->file_len = tf->get_length(tf);
+
+    tf->cache    = tc;
+}
+
+static void
+track_cache_close(track_file_t *tf)
+{
+    track_cache_t *tc = (track_cache_t *) tf->cache;
+
+    if (tc == NULL)
+        return;
+
+    thread_close_mutex(tc->mutex);
+    free(tc->buf);
+    free(tc);
+
+    tf->cache = NULL;
+}
+
+static int
+image_file_read(track_file_t *tf, uint8_t *buffer, const uint64_t seek, const size_t count)
+{
+    track_cache_t *tc  = (track_cache_t *) tf->cache;
+    uint64_t       len;
+    int            ret = 1;
+
+    if ((tc == NULL) || (count > CACHE_WINDOW_MAX))
+        return tf->read(tf, buffer, seek, count);
+
+    thread_wait_mutex(tc->mutex);
+
+    if ((seek < tc->start) || ((seek + count) > (tc->start + tc->len))) {
+        if (seek == tc->next)
+            tc->window = tc->window ? MIN(tc->window << 1, CACHE_WINDOW_MAX) : CACHE_WINDOW_MIN;
+        else
+            tc->window = 0;
+
+        len = MAX(count, tc->window);
+        if ((seek + len) > tc->file_len)
+            len = (seek < tc->file_len) ? (tc->file_len - seek) : 0ULL;
+
+        tc->len = 0;
+        if (len < count) {
+            /* Past the end of the file, let the file's own read fail. */
+            ret = tf->read(tf, buffer, seek, count);
+            thread_release_mutex(tc->mutex);
+            return ret;
+        }
+
+        ret = tf->read(tf, tc->buf, seek, len);
+        if (ret <= 0) {
+            thread_release_mutex(tc->mutex);
+            return ret;
+        }
+
+        tc->start = seek;
+        tc->len   = len;
+    }
+
+    memcpy(buffer, tc->buf + (seek - tc->start), count);
+    tc->next = seek + count;
+
+    thread_release_mutex(tc->mutex);
+
+    return ret;
+}
+
 static track_file_t *
 index_file_init(const uint8_t id, const char *filename, int *error, int *is_viso)
 {
@@ -532,6 +739,9 @@ index_file_init(const uint8_t id, const char *filename, int *error, int *is_viso
             *is_viso = 1;
     }
 
+    if (!*error)
+        track_cache_init(tf);
+
     return tf;
 }
 
@@ -548,6 +758,8 @@ index_file_close(track_index_t *idx)
         idx->file->log = NULL;
     }
 
+    track_cache_close(idx->file);
+
     if (idx->file->close != NULL)
         idx->file->close(idx->file);
 
@@ -647,7 +859,7 @@ image_can_read_pvd(track_file_t *file, const uint64_t start,
             pvd = &(buf[8]);
     }
 
-    file->read(file, buf, seek, sector_size);
+    image_file_read(file, buf, seek, sector_size);
 
     int ret = (((pvd[0] == 1) &&
                 !strncmp((char *) &(pvd[1]), "CD001", 5) &&
@@ -1897,6 +2109,164 @@ image_load_cue(cd_image_t *img, const char *cuefile)
     return success;
 }
 
+#ifdef USE_CHD
+static int
+image_load_chd(cd_image_t *img, const char *filename)
+{
+    track_t       *ct         = NULL;
+    track_index_t *ci         = NULL;
+    track_file_t  *tf         = NULL;
+    chd_image_t   *chd        = NULL;
+    uint64_t       chd_frame  = 0ULL;
+    int            success    = 1;
+    char           meta[256];
+    char           type[32];
+    char           subtype[32];
+    char           pgtype[32];
+    char           pgsub[32];
+    int            t;
+    int            frames;
+    int            pregap;
+    int            postgap;
+
+    img->tracks     = NULL;
+    img->tracks_num = 0;
+
+    chd = chd_image_open(filename, 1);
+    if (chd == NULL) {
+#ifdef ENABLE_IMAGE_LOG
+        log_warning(img->log, "    [CHD   ] Unable to open CHD \"%s\"\n", filename);
+#else
+        warning("Unable to open CHD \"%s\"\n", filename);
+#endif
+        return 0;
+    }
+
+    /*
+       Pass 1 - loading the track metadata.
+     */
+    image_log(img->log, "Pass 1 (loading the CHD track metadata)...\n");
+
+    for (int i = 0; i < 3; i++)
+        (void) image_insert_track(img, 1, 0xa0 + i);
+
+    for (int i = 0; i < 99; i++) {
+        pregap  = 0;
+        postgap = 0;
+        strcpy(pgtype, "MODE1");
+
+        if (chd_image_get_metadata(chd, CHD_TAG_CDROM_TRACK2, i, meta, sizeof(meta))) {
+            if (sscanf(meta, "TRACK:%d TYPE:%31s SUBTYPE:%31s FRAMES:%d PREGAP:%d "
+                       "PGTYPE:%31s PGSUB:%31s POSTGAP:%d",
+                       &t, type, subtype, &frames, &pregap, pgtype, pgsub, &postgap) != 8)
+                success = 0;
+        } else if (chd_image_get_metadata(chd, CHD_TAG_CDROM_TRACK, i, meta, sizeof(meta))) {
+            if (sscanf(meta, "TRACK:%d TYPE:%31s SUBTYPE:%31s FRAMES:%d",
+                       &t, type, subtype, &frames) != 4)
+                success = 0;
+        } else
+            break;
+
+        if (!success || (t < 1) || (t > 99) || (frames <= 0)) {
+            success = 0;
+            break;
+        }
+
+        ct = image_insert_track(img, 1, t);
+
+        for (int j = 2; j >= 0; j--)
+            ct->idx[j].type = INDEX_NONE;
+
+        ct->form = 0;
+        ct->mode = 0;
+
+        if (!strcmp(type, "AUDIO")) {
+            ct->sector_size = RAW_SECTOR_SIZE;
+            ct->attr        = AUDIO_TRACK;
+        } else {
+            ct->attr = DATA_TRACK;
+            ct->mode = (type[4] == '2') ? 2 : 1;
+
+            if (!strcmp(type, "MODE1") || !strcmp(type, "MODE2_FORM1"))
+                ct->sector_size = COOKED_SECTOR_SIZE;
+            else if (!strcmp(type, "MODE2_FORM2"))
+                ct->sector_size = 2324;
+            else if (!strcmp(type, "MODE2") || !strcmp(type, "MODE2_FORM_MIX"))
+                ct->sector_size = 2336;
+            else
+                ct->sector_size = RAW_SECTOR_SIZE;
+
+            /* Same as for the equivalent MODEx/yyyy Cue sheet track. */
+            if (ct->mode == 2)
+                ct->form = (ct->sector_size == 2324) ? 2 : 1;
+            if ((ct->sector_size == 2336) && (ct->mode == 2) && (ct->form == 1))
+                ct->skip = 8;
+        }
+
+        image_set_track_subch_type(ct);
+
+        /*
+           A pre-gap with a PGTYPE starting with V is in the file and counted
+           in FRAMES, otherwise it is not stored at all.
+         */
+        if ((pregap > 0) && (pgtype[0] == 'V')) {
+            ci             = &(ct->idx[0]);
+            ci->type       = INDEX_NORMAL;
+            ci->file_start = 0ULL;
+        } else if (pregap > 0) {
+            ci             = &(ct->idx[0]);
+            ci->type       = INDEX_ZERO;
+            ci->length     = pregap;
+        }
+
+        ci             = &(ct->idx[1]);
+        ci->type       = INDEX_NORMAL;
+        ci->file_start = (pgtype[0] == 'V') ? pregap : 0;
+
+        if (postgap > 0) {
+            ci         = &(ct->idx[2]);
+            ci->type   = INDEX_ZERO;
+            ci->length = postgap;
+        }
+
+        tf           = chd_track_init(img->dev->id, filename, chd, chd_frame, frames,
+                                      ct->sector_size);
+        tf->motorola = (ct->attr == AUDIO_TRACK);
+        for (int j = 0; j <= ct->max_index; j++)
+            ct->idx[j].file = tf;
+
+        image_log(img->log, "    [TRACK   ] %02X/%02X, ATTR %02X, MODE %02X/%02X,\n",
+                  ct->session,
+                  ct->point,
+                  ct->attr,
+                  ct->mode, ct->form);
+        image_log(img->log, "               %i, %i frames at %" PRIu64 "\n",
+                  ct->sector_size, frames, chd_frame);
+
+        /* Tracks are padded to a multiple of CHD_CD_TRACK_PADDING frames. */
+        chd_frame += (frames + CHD_CD_TRACK_PADDING - 1) & ~(CHD_CD_TRACK_PADDING - 1);
+    }
+
+    /* The tracks hold their own references. */
+    chd_image_close(chd);
+
+    if (img->tracks_num == 3)
+        success = 0;
+
+    if (success)
+        image_process(img);
+    else
+#ifdef ENABLE_IMAGE_LOG
+        log_warning(img->log, "    [CHD   ] Unable to read the track metadata of \"%s\"\n",
+                    filename);
+#else
+        warning("Unable to read the track metadata of CHD \"%s\"\n", filename);
+#endif
+
+    return success;
+}
+#endif
+
 /*
    Converts UTF-16 string into UTF-8 string.
 
@@ -2823,7 +3193,7 @@ image_read_sector(const void *local, uint8_t *buffer,
 
             if (idx->type >= INDEX_NORMAL)
                 /* Read the data from the file. */
-                ret = idx->file->read(idx->file, buffer, seek, trk->sector_size);
+                ret = image_file_read(idx->file, buffer, seek, trk->sector_size);
             else
                 /* Index is not in the file, no read to fail here. */
                 ret = 1;
@@ -3033,6 +3403,9 @@ image_open(cdrom_t *dev, const char *path)
         const int is_cue  = ((ext == 4) && !stricmp(path + strlen(path) - ext + 1, "CUE"));
         const int is_mds  = ((ext == 4) && (!stricmp(path + strlen(path) - ext + 1, "MDS") ||
                                             !stricmp(path + strlen(path) - ext + 1, "MDX")));
+#ifdef USE_CHD
+        const int is_chd  = ((ext == 4) && !stricmp(path + strlen(path) - ext + 1, "CHD"));
+#endif
         char      n[1024] = { 0 };
 
         sprintf(n, "CD-ROM %i Image", dev->id + 1);
@@ -3040,6 +3413,17 @@ image_open(cdrom_t *dev, const char *path)
 
         img->dev          = dev;
 
+#ifdef USE_CHD
+        if (is_chd) {
+            ret = image_load_chd(img, path);
+
+            if (ret)
+                img->has_audio = 1;
+
+            if (ret >= 1)
+                img->is_dvd = 2;
+        } else
+#endif
         if (is_mds) {
             ret = image_load_mds(img, path);
 
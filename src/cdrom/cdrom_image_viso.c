@@ -133,6 +133,10 @@ typedef struct {
     viso_entry_t  *root_dir;
     viso_entry_t **entry_map;
     viso_entry_t  *file_fifo[VISO_OPEN_FILES];
+
+    /* Where the last read left its file, so sequential reads do not seek. */
+    viso_entry_t  *last_entry;
+    uint64_t       last_pos;
 } viso_t;
 
 static const char rr_eid[]   = "RRIP_1991A"; /* identifiers used in ER field for Rock Ridge */
@@ -686,7 +690,7 @@ viso_read(void *priv, uint8_t *buffer, uint64_t seek, size_t count)
     track_file_t *tf   = (track_file_t *) priv;
     viso_t       *viso = (viso_t *) tf->priv;
 
-    /* Handle reads in a sector by sector basis. */
+    /* Handle reads in a sector by sector basis, merging runs of sectors from the same file. */
     while (count > 0) {
         /* Determine the current sector, offset and remainder. */
         size_t sector        = seek / viso->sector_size;
@@ -703,6 +707,14 @@ viso_read(void *priv, uint8_t *buffer, uint64_t seek, size_t count)
             /* Get the file entry corresponding to this sector. */
             viso_entry_t *entry = viso->entry_map[sector - viso->metadata_sectors];
             if (entry) {
+                const uint64_t pos = seek - entry->data_offset;
+
+                /* Extend the read over the following sectors of the same file. */
+                for (size_t next = sector + 1 - viso->metadata_sectors;
+                     (sector_remain < count) && (next < viso->entry_map_size) &&
+                     (viso->entry_map[next] == entry); next++)
+                    sector_remain += MIN(count - sector_remain, viso->sector_size);
+
                 /* Open file if it's not already open. */
                 if (!entry->file) {
                     /* Close any existing FIFO entry's file. */
@@ -711,6 +723,8 @@ viso_read(void *priv, uint8_t *buffer, uint64_t seek, size_t count)
                         image_viso_log(viso->tf.log, "Closing [%s]...\n", other_entry->path);
                         fclose(other_entry->file);
                         other_entry->file = NULL;
+                        if (viso->last_entry == other_entry)
+                            viso->last_entry = NULL;
                         image_viso_log(viso->tf.log, "Done\n");
                     }
 
@@ -731,11 +745,20 @@ viso_read(void *priv, uint8_t *buffer, uint64_t seek, size_t count)
                 }
 
                 /* Read data. */
-                if (!entry->file || (fseeko64(entry->file, seek - entry->data_offset, SEEK_SET) == -1))
+                if (!entry->file)
                     return -1;
+                if ((entry != viso->last_entry) || (pos != viso->last_pos)) {
+                    viso->last_entry = NULL;
+                    if (fseeko64(entry->file, pos, SEEK_SET) == -1)
+                        return -1;
+                }
                 read = fread(buffer, 1, sector_remain, entry->file);
-                if (sector_remain && !read)
+                if (sector_remain && !read) {
+                    viso->last_entry = NULL;
                     return -1;
+                }
+                viso->last_entry = entry;
+                viso->last_pos   = pos + read;
             }
 
             /* Fill remainder with 00 bytes if needed. */
@@ -270,6 +270,14 @@ extern codeblock_t *codeblock;
 
 extern codeblock_t **codeblock_hash;
 
+/*Block cache statistics. Hits are blocks found through the hash, tree hits
+  blocks found by walking the page tree after a hash miss, misses blocks that
+  had to be created and evictions valid blocks overwritten to make room*/
+extern uint64_t codegen_block_hits;
+extern uint64_t codegen_block_tree_hits;
+extern uint64_t codegen_block_misses;
+extern uint64_t codegen_block_evictions;
+
 extern void codegen_init(void);
 extern void codegen_reset(void);
 extern void codegen_block_init(uint32_t phys_addr);
@@ -5,6 +5,7 @@
 #    include <string.h>
 #    include <stdint.h>
 #    include <stdlib.h>
+#    include <inttypes.h>
 #    define HAVE_STDARG_H
 #    include <86box/86box.h>
 #    include <86box/plat.h>
@@ -18,6 +19,7 @@
 #    include "x87.h"
 #    include <86box/mem.h>
 #    include <86box/plat_unused.h>
+#    include <86box/cpu_prof.h>
 
 #    include "386_common.h"
 
@@ -44,6 +46,17 @@ codeblock_t  *codeblock;
 codeblock_t **codeblock_hash;
 int           codegen_mmx_entered = 0;
 
+uint32_t        codegen_block_mask;
+uint32_t        codegen_hash_mask;
+int             codegen_hash_shift;
+static uint32_t codegen_block_count;
+static uint32_t codegen_hash_size;
+
+uint64_t codegen_block_hits;
+uint64_t codegen_block_tree_hits;
+uint64_t codegen_block_misses;
+uint64_t codegen_block_evictions;
+
 int        block_current = 0;
 static int block_num;
 int        block_pos;
@@ -55,30 +68,115 @@ static int codegen_block_ins;
 static int codegen_block_full_ins;
 
 static uint32_t last_op32;
+
+#    ifdef ENABLE_CODEGEN_LOG
+int codegen_do_log = ENABLE_CODEGEN_LOG;
+
+static void
+codegen_log(const char *fmt, ...)
+{
+    va_list ap;
+
+    if (codegen_do_log) {
+        va_start(ap, fmt);
+        pclog_ex(fmt, ap);
+        va_end(ap);
+    }
+}
+#    else
+#        define codegen_log(fmt, ...)
+#    endif
 static x86seg  *last_ea_seg;
 static int      last_ssegs;
 
+/*Number of blocks to use - cpu_dynarec_blocks if set, otherwise one block
+  per 4 kB of guest RAM, between 16k blocks (~36 MB) and 64k blocks (~140 MB).
+  Always a power of two*/
+static uint32_t
+codegen_cache_size(void)
+{
+    uint32_t want = 0x4000;
+    uint32_t size = 0x1000;
+
+    if (cpu_dynarec_blocks) {
+        want = cpu_dynarec_blocks;
+        if (want > 0x40000)
+            want = 0x40000;
+    } else if ((mem_size >> 2) > want) {
+        want = mem_size >> 2;
+        if (want > 0x10000)
+            want = 0x10000;
+    }
+
+    while (size < want)
+        size <<= 1;
+
+    return size;
+}
+
+/*(Re)allocate the block array and hash if the wanted size has changed. Only
+  done while the cache is empty, as blocks are referenced by address from the
+  page lists and the tree*/
+static void
+codegen_cache_alloc(void)
+{
+    uint32_t size = codegen_cache_size();
+
+    if (size == codegen_block_count)
+        return;
+
+    if (codeblock != NULL)
+        plat_munmap(codeblock, codegen_block_count * sizeof(codeblock_t));
+    free(codeblock_hash);
+
+    codegen_block_count = size;
+    codegen_block_mask  = size - 1;
+    /*Eight hash entries per block, as with the original 16k blocks / 128k hash*/
+    codegen_hash_size  = size << 3;
+    codegen_hash_mask  = codegen_hash_size - 1;
+    codegen_hash_shift = 0;
+    while ((1u << codegen_hash_shift) < codegen_hash_size)
+        codegen_hash_shift++;
+
+    codeblock      = plat_mmap(codegen_block_count * sizeof(codeblock_t), 1);
+    codeblock_hash = calloc(1, codegen_hash_size * sizeof(codeblock_t *));
+    if ((codeblock == NULL) || (codeblock_hash == NULL))
+        fatal("codegen_cache_alloc - unable to allocate %u blocks\n", codegen_block_count);
+
+    block_current = 0;
+}
+
 void
 codegen_init(void)
 {
-    codeblock      = plat_mmap(BLOCK_SIZE * sizeof(codeblock_t), 1);
-    codeblock_hash = calloc(1, HASH_SIZE * sizeof(codeblock_t *));
+    codegen_cache_alloc();
 
-    memset(codeblock, 0, BLOCK_SIZE * sizeof(codeblock_t));
+    memset(codeblock, 0, codegen_block_count * sizeof(codeblock_t));
 
-    for (int c = 0; c < BLOCK_SIZE; c++)
+    for (uint32_t c = 0; c < codegen_block_count; c++)
         codeblock[c].valid = 0;
 }
 
 void
 codegen_reset(void)
 {
-    memset(codeblock, 0, BLOCK_SIZE * sizeof(codeblock_t));
-    memset(codeblock_hash, 0, HASH_SIZE * sizeof(codeblock_t *));
+    if (codegen_block_misses)
+        codegen_log("Dynarec: %u blocks, %" PRIu64 " hits, %" PRIu64 " tree hits, %" PRIu64 " misses, %" PRIu64 " evictions\n",
+              codegen_block_count, codegen_block_hits, codegen_block_tree_hits, codegen_block_misses, codegen_block_evictions);
+
+    codegen_cache_alloc();
+
+    memset(codeblock, 0, codegen_block_count * sizeof(codeblock_t));
+    memset(codeblock_hash, 0, codegen_hash_size * sizeof(codeblock_t *));
     mem_reset_page_blocks();
 
-    for (int c = 0; c < BLOCK_SIZE; c++)
+    for (uint32_t c = 0; c < codegen_block_count; c++)
         codeblock[c].valid = 0;
+
+    codegen_block_hits      = 0;
+    codegen_block_tree_hits = 0;
+    codegen_block_misses    = 0;
+    codegen_block_evictions = 0;
 }
 
 void
@@ -178,11 +276,13 @@ delete_block(codeblock_t *block)
 void
 codegen_check_flush(page_t *page, uint64_t mask, uint32_t phys_addr)
 {
-    struct codeblock_t *block = page->block[(phys_addr >> 10) & 3];
+    struct codeblock_t *block       = page->block[(phys_addr >> 10) & 3];
+    int                 invalidated = 0;
 
     while (block) {
         if (mask & block->page_mask) {
             delete_block(block);
+            invalidated++;
         }
         if (block == block->next)
             fatal("Broken 1\n");
@@ -194,11 +294,15 @@ codegen_check_flush(page_t *page, uint64_t mask, uint32_t phys_addr)
     while (block) {
         if (mask & block->page_mask2) {
             delete_block(block);
+            invalidated++;
         }
         if (block == block->next_2)
             fatal("Broken 2\n");
         block = block->next_2;
     }
+
+    if (cpu_prof_on)
+        cpu_prof_flush(phys_addr, invalidated);
 }
 
 void
@@ -210,10 +314,14 @@ codegen_block_init(uint32_t phys_addr)
     if (!page->block[(phys_addr >> 10) & 3])
         mem_flush_write_page(phys_addr, cs + cpu_state.pc);
 
-    block_current = (block_current + 1) & BLOCK_MASK;
+    block_current = (block_current + 1) & codegen_block_mask;
     block         = &codeblock[block_current];
 
+    if (cpu_prof_on)
+        codegen_block_misses++;
     if (block->valid != 0) {
+        if (cpu_prof_on)
+            codegen_block_evictions++;
         delete_block(block);
     }
     block_num                 = HASH(phys_addr);
@@ -1,11 +1,14 @@
-#define BLOCK_SIZE        0x4000
-#define BLOCK_MASK        0x3fff
 #define BLOCK_START       0
 
-#define HASH_SIZE         0x20000
-#define HASH_MASK         0x1ffff
+/*Block array and hash sizes are picked by codegen_init() and codegen_reset(),
+  from cpu_dynarec_blocks or the guest RAM size. The address bits above the
+  hash index are folded into it, so that code at the same offset in different
+  parts of a large guest RAM does not keep evicting itself from the hash*/
+extern uint32_t codegen_block_mask;
+extern uint32_t codegen_hash_mask;
+extern int      codegen_hash_shift;
 
-#define HASH(l)           ((l) &0x1ffff)
+#define HASH(l)           (((l) ^ ((l) >> codegen_hash_shift)) & codegen_hash_mask)
 
 #define BLOCK_EXIT_OFFSET 0x7e0
 #ifdef OLD_GPF
@@ -381,6 +381,24 @@ static uint8_t opcode_0f_modrm[256] = {
 };
 // clang-format on
 
+/*Record which MMX registers the uOPs generated since uop_start write, so
+  mmx_sf_flush() can set their exponents*/
+static void
+codegen_mmx_sf_mark_written(ir_data_t *ir, int uop_start)
+{
+    uint32_t written = 0;
+
+    for (int c = uop_start; c < ir->wr_pos; c++) {
+        int reg = IREG_GET_REG(ir->uops[c].dest_reg_a.reg);
+
+        if ((reg >= IREG_MM0x) && (reg <= IREG_MM7x))
+            written |= 1 << (reg - IREG_MM0x);
+    }
+
+    if (written)
+        uop_OR_IMM(ir, IREG_mmx_sf_written, IREG_mmx_sf_written, written);
+}
+
 void
 codegen_generate_call(uint8_t opcode, OpFn op, uint32_t fetchdat, uint32_t new_pc, uint32_t old_pc)
 {
@@ -414,7 +432,7 @@ codegen_generate_call(uint8_t opcode, OpFn op, uint32_t fetchdat, uint32_t new_p
                 last_prefix = 0x0f;
 #endif
                 op_table        = x86_dynarec_opcodes_0f;
-                recomp_op_table = fpu_softfloat ? recomp_opcodes_0f_no_mmx : recomp_opcodes_0f;
+                recomp_op_table = recomp_opcodes_0f;
                 over            = 1;
                 break;
 
@@ -450,6 +468,8 @@ codegen_generate_call(uint8_t opcode, OpFn op, uint32_t fetchdat, uint32_t new_p
                 op_32 = ((use32 & 0x200) ^ 0x200) | (op_32 & 0x100);
                 break;
 
+            /*With softfloat only MMX/3DNow! is recompiled; x87 opcodes keep
+              calling the interpreter, as the IR has no 80-bit registers*/
             case 0xd8:
 #ifdef DEBUG_EXTRA
                 last_prefix = 0xd8;
@@ -658,11 +678,11 @@ generate_call:
         }
 
         opcode_3dnow = fastreadb(cs + opcode_pc);
-        if (!fpu_softfloat && recomp_opcodes_3DNOW[opcode_3dnow]) {
+        if (recomp_opcodes_3DNOW[opcode_3dnow]) {
             next_pc = opcode_pc + 1;
 
             op_table           = x86_dynarec_opcodes_3DNOW;
-            recomp_op_table    = fpu_softfloat ? NULL : recomp_opcodes_3DNOW;
+            recomp_op_table    = recomp_opcodes_3DNOW;
             opcode             = opcode_3dnow;
             recomp_opcode_mask = 0xff;
             opcode_mask        = 0xff;
@@ -681,8 +701,11 @@ generate_call:
         goto codegen_skip;
 
     if (recomp_op_table && recomp_op_table[(opcode | op_32) & recomp_opcode_mask]) {
-        uint32_t new_pc = recomp_op_table[(opcode | op_32) & recomp_opcode_mask](block, ir, opcode, fetchdat, op_32, op_pc);
+        int      uop_start = ir->wr_pos;
+        uint32_t new_pc    = recomp_op_table[(opcode | op_32) & recomp_opcode_mask](block, ir, opcode, fetchdat, op_32, op_pc);
         if (new_pc) {
+            if (fpu_softfloat)
+                codegen_mmx_sf_mark_written(ir, uop_start);
             if (new_pc != -1)
                 uop_MOV_IMM(ir, IREG_pc, new_pc);
 
@@ -748,6 +771,11 @@ codegen_skip:
         uop_MOV_IMM(ir, IREG_ssegs, op_ssegs);
     uop_CALL_INSTRUCTION_FUNC(ir, op, fetchdat);
     codegen_flags_changed = 0;
+    if (fpu_softfloat) {
+        /*The interpreter may have written the MMX registers back, reload them
+          before the next recompiled MMX instruction*/
+        codegen_mmx_entered = 0;
+    }
     codegen_mark_code_present(block, cs + cpu_state.pc, 8);
 
     last_op_32     = op_32;
@@ -58,6 +58,9 @@ typedef struct codeblock_t {
     /*First mem_block_t used by this block. Any subsequent mem_block_ts
       will be in the list starting at head_mem_block->next.*/
     struct mem_block_t *head_mem_block;
+
+    /*Memory accesses from this block that missed the inline fast path.*/
+    uint32_t slow_calls;
 } codeblock_t;
 
 extern codeblock_t *codeblock;
@@ -292,6 +295,9 @@ codegen_mark_code_present(codeblock_t *block, uint32_t start_pc, int len)
 
 extern void codegen_init(void);
 extern void codegen_reset(void);
+#ifdef DEBUG_EXTRA
+extern void codegen_mem_slow_report(void);
+#endif
 extern void codegen_block_init(uint32_t phys_addr);
 extern void codegen_block_remove(void);
 extern void codegen_block_start_recompile(codeblock_t *block);
@@ -5,6 +5,7 @@
 #    include <86box/86box.h>
 #    include "cpu.h"
 #    include <86box/mem.h>
+#    include <86box/plat_unused.h>
 
 #    include "codegen.h"
 #    include "codegen_allocator.h"
@@ -56,8 +57,17 @@ host_reg_def_t codegen_host_reg_list[CODEGEN_HOST_REGS] = {
     { REG_X24, 0},
     { REG_X25, 0},
     { REG_X26, 0},
-    { REG_X27, 0},
-    { REG_X28, 0}
+  /*Note: X8-X15 are not preserved by the AAPCS64, the load/store routines
+  save them around readmem*l()/writemem*l() and every other call out of a
+  block is a barrier, which writes back and invalidates all registers*/
+    { REG_X8,  0},
+    { REG_X9,  0},
+    { REG_X10, 0},
+    { REG_X11, 0},
+    { REG_X12, 0},
+    { REG_X13, 0},
+    { REG_X14, 0},
+    { REG_X15, 0}
 };
 
 host_reg_def_t codegen_host_fp_reg_list[CODEGEN_HOST_FP_REGS] = {
@@ -71,38 +81,106 @@ host_reg_def_t codegen_host_fp_reg_list[CODEGEN_HOST_FP_REGS] = {
     { REG_V15, 0}
 };
 
+/*Count calls into readmem*l()/writemem*l(), the dispatcher charges them to
+  the block on exit. Only with DEBUG_EXTRA. Corrupts W2*/
+static void
+build_slow_call_count(UNUSED(codeblock_t *block))
+{
+#ifdef DEBUG_EXTRA
+    codegen_direct_read_32(block, REG_W2, &cpu_state.mem_slow_calls);
+    host_arm64_ADD_IMM(block, REG_W2, REG_W2, 1);
+    codegen_direct_write_32(block, &cpu_state.mem_slow_calls, REG_W2);
+#endif
+}
+
+/*Preserve the caller-saved registers in the allocator's list across a
+  C call from the load/store routines*/
+static void
+build_save_host_regs(codeblock_t *block)
+{
+    host_arm64_STP_PREIDX_X(block, REG_X8, REG_X9, REG_XSP, -16);
+    host_arm64_STP_PREIDX_X(block, REG_X10, REG_X11, REG_XSP, -16);
+    host_arm64_STP_PREIDX_X(block, REG_X12, REG_X13, REG_XSP, -16);
+    host_arm64_STP_PREIDX_X(block, REG_X14, REG_X15, REG_XSP, -16);
+}
+
+static void
+build_restore_host_regs(codeblock_t *block)
+{
+    host_arm64_LDP_POSTIDX_X(block, REG_X14, REG_X15, REG_XSP, 16);
+    host_arm64_LDP_POSTIDX_X(block, REG_X12, REG_X13, REG_XSP, 16);
+    host_arm64_LDP_POSTIDX_X(block, REG_X10, REG_X11, REG_XSP, 16);
+    host_arm64_LDP_POSTIDX_X(block, REG_X8, REG_X9, REG_XSP, 16);
+}
+
+/*Charge the misaligned access penalty readmem*l()/writemem*l() would have,
+  for an access of size bytes at the address in W0. Corrupts X3-X5*/
+static void
+build_misaligned_penalty(codeblock_t *block, int size)
+{
+    /*Word, dword and qword rows of the table*/
+    uint8_t *table = timing_misaligned_table[size >> 2];
+
+    host_arm64_AND_IMM(block, REG_W3, REG_W0, 7);
+    host_arm64_MOVX_IMM(block, REG_X4, (uint64_t) table);
+    host_arm64_LDRB_REG(block, REG_W3, REG_X4, REG_X3);
+    codegen_direct_read_32(block, REG_W5, &cpu_state._cycles);
+    host_arm64_SUB_REG(block, REG_W5, REG_W5, REG_W3, 0);
+    codegen_direct_write_32(block, &cpu_state._cycles, REG_W5);
+}
+
 static void
 build_load_routine(codeblock_t *block, int size, int is_float)
 {
     uint32_t *branch_offset;
-    uint32_t *misaligned_offset;
+    uint32_t *cross_offset      = NULL;
+    uint32_t *misaligned_offset = NULL;
+    uint8_t  *access;
 
     /*In - W0 = address
       Out - W0 = data, W1 = abrt*/
-    /*MOV W1, W0, LSR #12
-      MOV X2, #readlookup2
-      LDR X1, [X2, X1, LSL #3]
+    /*AND W1, W0, #0xfff        (not for bytes)
+      CMP W1, #0x1000-size
+      BHI slow
+      MOV W1, W0, LSR #12
+      LDR X1, [X28, X1, LSL #3]   (X28 = readlookup2)
       CMP X1, #-1
-      BEQ +
-      LDRB W0, [X1, X0]
+      BEQ slow
+      TST W0, #size-1           (not for bytes)
+      BNE misaligned
+    * LDRB W0, [X1, X0]
       MOV W1, #0
       RET
-    * STP X29, X30, [SP, #-16]
+    slow:
+      INC cpu_state.mem_slow_calls
+      STP X29, X30, [SP, #-16]
+      STP X8-X15
       BL readmembl
       LDRB R1, cpu_state.abrt
+      LDP X8-X15
       LDP X29, X30, [SP, #-16]
       RET
+    misaligned:
+      SUB cycles, timing_misaligned_table[size][W0 & 7]
+      B *
     */
-    codegen_alloc(block, 80);
+    codegen_alloc(block, 192);
+    if (size != 1) {
+        /*Accesses within a page take the fast path regardless of alignment,
+          only those crossing into the next page need readmem*l()*/
+        host_arm64_AND_IMM(block, REG_W1, REG_W0, 0xfff);
+        host_arm64_CMP_IMM(block, REG_W1, 0x1000 - size);
+        cross_offset = host_arm64_BHI_(block);
+    }
     host_arm64_MOV_REG_LSR(block, REG_W1, REG_W0, 12);
-    host_arm64_MOVX_IMM(block, REG_X2, (uint64_t) readlookup2);
-    host_arm64_LDRX_REG_LSL3(block, REG_X1, REG_X2, REG_X1);
+    host_arm64_LDRX_REG_LSL3(block, REG_X1, REG_READLOOKUP, REG_X1);
+    host_arm64_CMPX_IMM(block, REG_X1, -1);
+    branch_offset = host_arm64_BEQ_(block);
     if (size != 1) {
         host_arm64_TST_IMM(block, REG_W0, size - 1);
         misaligned_offset = host_arm64_BNE_(block);
     }
-    host_arm64_CMPX_IMM(block, REG_X1, -1);
-    branch_offset = host_arm64_BEQ_(block);
+    access = &block_write_data[block_pos];
     if (size == 1 && !is_float)
         host_arm64_LDRB_REG(block, REG_W0, REG_W1, REG_W0);
     else if (size == 2 && !is_float)
@@ -118,8 +196,10 @@ build_load_routine(codeblock_t *block, int size, int is_float)
 
     host_arm64_branch_set_offset(branch_offset, &block_write_data[block_pos]);
     if (size != 1)
-        host_arm64_branch_set_offset(misaligned_offset, &block_write_data[block_pos]);
+        host_arm64_branch_set_offset(cross_offset, &block_write_data[block_pos]);
+    build_slow_call_count(block);
     host_arm64_STP_PREIDX_X(block, REG_X29, REG_X30, REG_XSP, -16);
+    build_save_host_regs(block);
     if (size == 1)
         host_arm64_call(block, (void *) readmembl);
     else if (size == 2)
@@ -135,42 +215,67 @@ build_load_routine(codeblock_t *block, int size, int is_float)
         host_arm64_FMOV_S_W(block, REG_V_TEMP, REG_W0);
     else if (size == 8)
         host_arm64_FMOV_D_Q(block, REG_V_TEMP, REG_X0);
+    build_restore_host_regs(block);
     host_arm64_LDP_POSTIDX_X(block, REG_X29, REG_X30, REG_XSP, 16);
     host_arm64_RET(block, REG_X30);
+
+    if (size != 1) {
+        host_arm64_branch_set_offset(misaligned_offset, &block_write_data[block_pos]);
+        build_misaligned_penalty(block, size);
+        host_arm64_B(block, access);
+    }
 }
 
 static void
 build_store_routine(codeblock_t *block, int size, int is_float)
 {
     uint32_t *branch_offset;
-    uint32_t *misaligned_offset;
+    uint32_t *cross_offset      = NULL;
+    uint32_t *misaligned_offset = NULL;
+    uint8_t  *access;
 
     /*In - R0 = address, R1 = data
       Out - R1 = abrt*/
-    /*MOV W2, W0, LSR #12
-      MOV X3, #writelookup2
-      LDR X2, [X3, X2, LSL #3]
+    /*AND W2, W0, #0xfff        (not for bytes)
+      CMP W2, #0x1000-size
+      BHI slow
+      MOV W2, W0, LSR #12
+      LDR X2, [X27, X2, LSL #3]   (X27 = writelookup2)
       CMP X2, #-1
-      BEQ +
-      STRB W1, [X2, X0]
+      BEQ slow
+      TST W0, #size-1           (not for bytes)
+      BNE misaligned
+    * STRB W1, [X2, X0]
       MOV W1, #0
       RET
-    * STP X29, X30, [SP, #-16]
+    slow:
+      INC cpu_state.mem_slow_calls
+      STP X29, X30, [SP, #-16]
+      STP X8-X15
       BL writemembl
       LDRB R1, cpu_state.abrt
+      LDP X8-X15
       LDP X29, X30, [SP, #-16]
       RET
+    misaligned:
+      SUB cycles, timing_misaligned_table[size][W0 & 7]
+      B *
     */
-    codegen_alloc(block, 80);
+    codegen_alloc(block, 192);
+    if (size != 1) {
+        host_arm64_AND_IMM(block, REG_W2, REG_W0, 0xfff);
+        host_arm64_CMP_IMM(block, REG_W2, 0x1000 - size);
+        cross_offset = host_arm64_BHI_(block);
+    }
     host_arm64_MOV_REG_LSR(block, REG_W2, REG_W0, 12);
-    host_arm64_MOVX_IMM(block, REG_X3, (uint64_t) writelookup2);
-    host_arm64_LDRX_REG_LSL3(block, REG_X2, REG_X3, REG_X2);
+    host_arm64_LDRX_REG_LSL3(block, REG_X2, REG_WRITELOOKUP, REG_X2);
+    host_arm64_CMPX_IMM(block, REG_X2, -1);
+    branch_offset = host_arm64_BEQ_(block);
     if (size != 1) {
         host_arm64_TST_IMM(block, REG_W0, size - 1);
         misaligned_offset = host_arm64_BNE_(block);
     }
-    host_arm64_CMPX_IMM(block, REG_X2, -1);
-    branch_offset = host_arm64_BEQ_(block);
+    access = &block_write_data[block_pos];
     if (size == 1 && !is_float)
         host_arm64_STRB_REG(block, REG_X1, REG_X2, REG_X0);
     else if (size == 2 && !is_float)
@@ -186,8 +291,10 @@ build_store_routine(codeblock_t *block, int size, int is_float)
 
     host_arm64_branch_set_offset(branch_offset, &block_write_data[block_pos]);
     if (size != 1)
-        host_arm64_branch_set_offset(misaligned_offset, &block_write_data[block_pos]);
+        host_arm64_branch_set_offset(cross_offset, &block_write_data[block_pos]);
+    build_slow_call_count(block);
     host_arm64_STP_PREIDX_X(block, REG_X29, REG_X30, REG_XSP, -16);
+    build_save_host_regs(block);
     if (size == 4 && is_float)
         host_arm64_FMOV_W_S(block, REG_W1, REG_V_TEMP);
     else if (size == 8)
@@ -203,8 +310,15 @@ build_store_routine(codeblock_t *block, int size, int is_float)
     else
         fatal("build_store_routine - unknown size %i\n", size);
     codegen_direct_read_8(block, REG_W1, &cpu_state.abrt);
+    build_restore_host_regs(block);
     host_arm64_LDP_POSTIDX_X(block, REG_X29, REG_X30, REG_XSP, 16);
     host_arm64_RET(block, REG_X30);
+
+    if (size != 1) {
+        host_arm64_branch_set_offset(misaligned_offset, &block_write_data[block_pos]);
+        build_misaligned_penalty(block, size);
+        host_arm64_B(block, access);
+    }
 }
 
 static void
@@ -352,6 +466,8 @@ codegen_backend_prologue(codeblock_t *block)
     host_arm64_STP_PREIDX_X(block, REG_X19, REG_X20, REG_XSP, -64);
 
     host_arm64_MOVX_IMM(block, REG_CPUSTATE, (uint64_t) &cpu_state);
+    host_arm64_MOVX_IMM(block, REG_READLOOKUP, (uint64_t) readlookup2);
+    host_arm64_MOVX_IMM(block, REG_WRITELOOKUP, (uint64_t) writelookup2);
 
     if (block->flags & CODEBLOCK_HAS_FPU) {
         host_arm64_LDR_IMM_W(block, REG_TEMP, REG_CPUSTATE, (uintptr_t) &cpu_state.TOP - (uintptr_t) &cpu_state);
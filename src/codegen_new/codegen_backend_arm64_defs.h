@@ -105,13 +105,17 @@
 #define REG_ARG3             REG_X3
 
 #define REG_CPUSTATE         REG_X29
+/*Bases of the lookup tables used by the load/store routines, loaded by the
+  block prologue*/
+#define REG_READLOOKUP       REG_X28
+#define REG_WRITELOOKUP      REG_X27
 
 #define REG_TEMP             REG_X7
 #define REG_TEMP2            REG_X6
 
 #define REG_V_TEMP           REG_V0
 
-#define CODEGEN_HOST_REGS    10
+#define CODEGEN_HOST_REGS    16
 #define CODEGEN_HOST_FP_REGS 8
 
 extern void *codegen_mem_load_byte;
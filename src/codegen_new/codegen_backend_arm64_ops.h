@@ -261,5 +261,7 @@ void host_arm64_mov_imm(codeblock_t *block, int reg, uint32_t imm_data);
 #define in_range12_q(offset) (((offset) >= 0) && ((offset) < 0x8000) && !((offset) &7))
 
 void codegen_direct_read_8(codeblock_t *block, int host_reg, void *p);
+void codegen_direct_read_32(codeblock_t *block, int host_reg, void *p);
+void codegen_direct_write_32(codeblock_t *block, void *p, int host_reg);
 
 void codegen_alloc(codeblock_t *block, int size);
@@ -5,6 +5,7 @@
 #    include <86box/86box.h>
 #    include "cpu.h"
 #    include <86box/mem.h>
+#    include <86box/plat_unused.h>
 
 #    include "codegen.h"
 #    include "codegen_allocator.h"
@@ -69,23 +70,67 @@ host_reg_def_t codegen_host_fp_reg_list[CODEGEN_HOST_FP_REGS] = {
     { REG_XMM5, HOST_REG_FLAG_VOLATILE}
 };
 
+/*Count calls into readmem*l()/writemem*l(), the dispatcher charges them to
+  the block on exit. Only with DEBUG_EXTRA. Corrupts ESI*/
+static void
+build_slow_call_count(UNUSED(codeblock_t *block))
+{
+#ifdef DEBUG_EXTRA
+    host_x86_MOV32_REG_ABS(block, REG_ESI, &cpu_state.mem_slow_calls);
+    host_x86_ADD32_REG_IMM(block, REG_ESI, 1);
+    host_x86_MOV32_ABS_REG(block, &cpu_state.mem_slow_calls, REG_ESI);
+#endif
+}
+
+/*Charge the misaligned access penalty readmem*l()/writemem*l() would have,
+  for an access of size bytes at the address in addr_reg. Preserves all
+  registers other than flags*/
+static void
+build_misaligned_penalty(codeblock_t *block, int size, int addr_reg)
+{
+    /*Word, dword and qword rows of the table*/
+    uint8_t *table = timing_misaligned_table[size >> 2];
+
+    host_x86_PUSH(block, REG_RAX);
+    host_x86_PUSH(block, REG_RDX);
+    host_x86_MOV32_REG_REG(block, REG_EAX, addr_reg);
+    host_x86_AND32_REG_IMM(block, REG_EAX, 7);
+    host_x86_MOV64_REG_IMM(block, REG_RDX, (uint64_t) (uintptr_t) table);
+    host_x86_MOVZX_BASE_INDEX_32_8(block, REG_EAX, REG_RDX, REG_RAX);
+    host_x86_MOV32_REG_ABS(block, REG_EDX, &cpu_state._cycles);
+    host_x86_SUB32_REG_REG(block, REG_EDX, REG_EAX);
+    host_x86_MOV32_ABS_REG(block, &cpu_state._cycles, REG_EDX);
+    host_x86_POP(block, REG_RDX);
+    host_x86_POP(block, REG_RAX);
+}
+
 static void
 build_load_routine(codeblock_t *block, int size, int is_float)
 {
     uint8_t *branch_offset;
+    uint8_t *cross_offset      = NULL;
     uint8_t *misaligned_offset = NULL;
+    uint8_t *access;
 
     /*In - ESI = address
       Out - ECX = data, ESI = abrt*/
     /*MOV ECX, ESI
+      AND ESI, 0xfff          (not for bytes)
+      CMP ESI, 0x1000-size
+      JNBE slow
+      MOV ESI, ECX
       SHR ESI, 12
       MOV RSI, [readlookup2+ESI*4]
       CMP ESI, -1
-      JNZ +
-      MOVZX ECX, B[RSI+RCX]
+      JZ slow
+      TEST ECX, size-1        (not for bytes)
+      JNZ misaligned
+    * MOVZX ECX, B[RSI+RCX]
       XOR ESI,ESI
       RET
-    * PUSH EAX
+    slow:
+      INC [mem_slow_calls]
+      PUSH EAX
       PUSH EDX
       PUSH ECX
       CALL readmembl
@@ -94,17 +139,29 @@ build_load_routine(codeblock_t *block, int size, int is_float)
       POP EAX
       MOVZX ECX, AL
       RET
+    misaligned:
+      SUB [cycles], timing_misaligned_table[size][ECX & 7]
+      JMP *
     */
     host_x86_MOV32_REG_REG(block, REG_ECX, REG_ESI);
+    if (size != 1) {
+        /*Accesses within a page take the fast path regardless of alignment,
+          only those crossing into the next page need readmem*l()*/
+        host_x86_AND32_REG_IMM(block, REG_ESI, 0xfff);
+        host_x86_CMP32_REG_IMM(block, REG_ESI, 0x1000 - size);
+        cross_offset = host_x86_JNBE_short(block);
+        host_x86_MOV32_REG_REG(block, REG_ESI, REG_ECX);
+    }
     host_x86_SHR32_IMM(block, REG_ESI, 12);
     host_x86_MOV64_REG_IMM(block, REG_RDI, (uint64_t) (uintptr_t) readlookup2);
     host_x86_MOV64_REG_BASE_INDEX_SHIFT(block, REG_RSI, REG_RDI, REG_RSI, 3);
+    host_x86_CMP64_REG_IMM(block, REG_RSI, (uint32_t) -1);
+    branch_offset = host_x86_JZ_short(block);
     if (size != 1) {
         host_x86_TEST32_REG_IMM(block, REG_ECX, size - 1);
         misaligned_offset = host_x86_JNZ_short(block);
     }
-    host_x86_CMP64_REG_IMM(block, REG_RSI, (uint32_t) -1);
-    branch_offset = host_x86_JZ_short(block);
+    access = &block_write_data[block_pos];
     if (size == 1 && !is_float)
         host_x86_MOVZX_BASE_INDEX_32_8(block, REG_ECX, REG_RSI, REG_RCX);
     else if (size == 2 && !is_float)
@@ -122,7 +179,8 @@ build_load_routine(codeblock_t *block, int size, int is_float)
 
     *branch_offset = (uint8_t) ((uintptr_t) &block_write_data[block_pos] - (uintptr_t) branch_offset) - 1;
     if (size != 1)
-        *misaligned_offset = (uint8_t) ((uintptr_t) &block_write_data[block_pos] - (uintptr_t) misaligned_offset) - 1;
+        *cross_offset = (uint8_t) ((uintptr_t) &block_write_data[block_pos] - (uintptr_t) cross_offset) - 1;
+    build_slow_call_count(block);
     host_x86_PUSH(block, REG_RAX);
     host_x86_PUSH(block, REG_RDX);
 #    if _WIN64
@@ -155,26 +213,42 @@ build_load_routine(codeblock_t *block, int size, int is_float)
     host_x86_POP(block, REG_RAX);
     host_x86_MOVZX_REG_ABS_32_8(block, REG_ESI, &cpu_state.abrt);
     host_x86_RET(block);
+
+    if (size != 1) {
+        *misaligned_offset = (uint8_t) ((uintptr_t) &block_write_data[block_pos] - (uintptr_t) misaligned_offset) - 1;
+        build_misaligned_penalty(block, size, REG_ECX);
+        host_x86_JMP(block, access);
+    }
 }
 
 static void
 build_store_routine(codeblock_t *block, int size, int is_float)
 {
     uint8_t *branch_offset;
+    uint8_t *cross_offset      = NULL;
     uint8_t *misaligned_offset = NULL;
+    uint8_t *access;
 
     /*In - ECX = data, ESI = address
       Out - ESI = abrt
       Corrupts EDI*/
     /*MOV EDI, ESI
+      AND ESI, 0xfff          (not for bytes)
+      CMP ESI, 0x1000-size
+      JNBE slow
+      MOV ESI, EDI
       SHR ESI, 12
       MOV ESI, [writelookup2+ESI*4]
       CMP ESI, -1
-      JNZ +
-      MOV [RSI+RDI], ECX
+      JZ slow
+      TEST EDI, size-1        (not for bytes)
+      JNZ misaligned
+    * MOV [RSI+RDI], ECX
       XOR ESI,ESI
       RET
-    * PUSH EAX
+    slow:
+      INC [mem_slow_calls]
+      PUSH EAX
       PUSH EDX
       PUSH ECX
       CALL writemembl
@@ -183,17 +257,27 @@ build_store_routine(codeblock_t *block, int size, int is_float)
       POP EAX
       MOVZX ECX, AL
       RET
+    misaligned:
+      SUB [cycles], timing_misaligned_table[size][EDI & 7]
+      JMP *
     */
     host_x86_MOV32_REG_REG(block, REG_EDI, REG_ESI);
+    if (size != 1) {
+        host_x86_AND32_REG_IMM(block, REG_ESI, 0xfff);
+        host_x86_CMP32_REG_IMM(block, REG_ESI, 0x1000 - size);
+        cross_offset = host_x86_JNBE_short(block);
+        host_x86_MOV32_REG_REG(block, REG_ESI, REG_EDI);
+    }
     host_x86_SHR32_IMM(block, REG_ESI, 12);
     host_x86_MOV64_REG_IMM(block, REG_R8, (uint64_t) (uintptr_t) writelookup2);
     host_x86_MOV64_REG_BASE_INDEX_SHIFT(block, REG_RSI, REG_R8, REG_RSI, 3);
+    host_x86_CMP64_REG_IMM(block, REG_RSI, (uint32_t) -1);
+    branch_offset = host_x86_JZ_short(block);
     if (size != 1) {
         host_x86_TEST32_REG_IMM(block, REG_EDI, size - 1);
         misaligned_offset = host_x86_JNZ_short(block);
     }
-    host_x86_CMP64_REG_IMM(block, REG_RSI, (uint32_t) -1);
-    branch_offset = host_x86_JZ_short(block);
+    access = &block_write_data[block_pos];
     if (size == 1 && !is_float)
         host_x86_MOV8_BASE_INDEX_REG(block, REG_RSI, REG_RDI, REG_ECX);
     else if (size == 2 && !is_float)
@@ -211,7 +295,8 @@ build_store_routine(codeblock_t *block, int size, int is_float)
 
     *branch_offset = (uint8_t) ((uintptr_t) &block_write_data[block_pos] - (uintptr_t) branch_offset) - 1;
     if (size != 1)
-        *misaligned_offset = (uint8_t) ((uintptr_t) &block_write_data[block_pos] - (uintptr_t) misaligned_offset) - 1;
+        *cross_offset = (uint8_t) ((uintptr_t) &block_write_data[block_pos] - (uintptr_t) cross_offset) - 1;
+    build_slow_call_count(block);
     host_x86_PUSH(block, REG_RAX);
     host_x86_PUSH(block, REG_RDX);
 #    if _WIN64
@@ -250,6 +335,12 @@ build_store_routine(codeblock_t *block, int size, int is_float)
     host_x86_POP(block, REG_RAX);
     host_x86_MOVZX_REG_ABS_32_8(block, REG_ESI, &cpu_state.abrt);
     host_x86_RET(block);
+
+    if (size != 1) {
+        *misaligned_offset = (uint8_t) ((uintptr_t) &block_write_data[block_pos] - (uintptr_t) misaligned_offset) - 1;
+        build_misaligned_penalty(block, size, REG_EDI);
+        host_x86_JMP(block, access);
+    }
 }
 
 static void
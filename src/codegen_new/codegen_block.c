@@ -6,6 +6,7 @@
 #include "cpu.h"
 #include <86box/mem.h>
 #include <86box/plat_unused.h>
+#include <86box/cpu_prof.h>
 
 #include "x86.h"
 #include "x86_flags.h"
@@ -231,11 +232,51 @@ codegen_init(void)
 #endif
 }
 
+#ifdef DEBUG_EXTRA
+#define SLOW_REPORT_BLOCKS 16
+
+/*Log the blocks whose memory accesses most often missed the inline fast path
+  (page crossings, MMIO, unmapped or write-protected pages)*/
+void
+codegen_mem_slow_report(void)
+{
+    codeblock_t *top[SLOW_REPORT_BLOCKS];
+    int          nr = 0;
+
+    for (int c = 1; c < BLOCK_SIZE; c++) {
+        codeblock_t *block = &codeblock[c];
+        int          d;
+
+        if (!block->valid || !block->slow_calls)
+            continue;
+        if ((nr == SLOW_REPORT_BLOCKS) && (block->slow_calls <= top[nr - 1]->slow_calls))
+            continue;
+
+        if (nr < SLOW_REPORT_BLOCKS)
+            nr++;
+        for (d = nr - 1; (d > 0) && (top[d - 1]->slow_calls < block->slow_calls); d--)
+            top[d] = top[d - 1];
+        top[d] = block;
+    }
+
+    if (!nr)
+        return;
+
+    pclog("codegen: blocks with most slow path memory accesses:\n");
+    for (int c = 0; c < nr; c++)
+        pclog("  %08x (phys %08x) : %u\n", top[c]->pc, top[c]->phys, top[c]->slow_calls);
+}
+#endif
+
 void
 codegen_reset(void)
 {
     int c;
 
+#ifdef DEBUG_EXTRA
+    codegen_mem_slow_report();
+#endif
+
     for (c = 1; c < BLOCK_SIZE; c++) {
         codeblock_t *block = &codeblock[c];
 
@@ -455,6 +496,7 @@ codegen_check_flush(page_t *page, UNUSED(uint64_t mask), UNUSED(uint32_t phys_ad
 {
     uint16_t block_nr               = page->block;
     int      remove_from_evict_list = 0;
+    int      invalidated            = 0;
 
     while (block_nr) {
         codeblock_t *block      = &codeblock[block_nr];
@@ -462,6 +504,7 @@ codegen_check_flush(page_t *page, UNUSED(uint64_t mask), UNUSED(uint32_t phys_ad
 
         if (*block->dirty_mask & block->page_mask) {
             invalidate_block(block);
+            invalidated++;
         }
 #ifndef RELEASE_BUILD
         if (block_nr == next_block)
@@ -478,6 +521,7 @@ codegen_check_flush(page_t *page, UNUSED(uint64_t mask), UNUSED(uint32_t phys_ad
 
         if (*block->dirty_mask2 & block->page_mask2) {
             invalidate_block(block);
+            invalidated++;
         }
 #ifndef RELEASE_BUILD
         if (block_nr == next_block)
@@ -486,6 +530,9 @@ codegen_check_flush(page_t *page, UNUSED(uint64_t mask), UNUSED(uint32_t phys_ad
         block_nr = next_block;
     }
 
+    if (cpu_prof_on)
+        cpu_prof_flush((uint32_t) (page - pages) << 12, invalidated);
+
     if (page->code_present_mask & page->dirty_mask)
         remove_from_evict_list = 1;
     page->code_present_mask &= ~page->dirty_mask;
@@ -531,6 +578,7 @@ codegen_block_init(uint32_t phys_addr)
     block->page_mask = block->page_mask2 = 0;
     block->flags                         = CODEBLOCK_STATIC_TOP;
     block->status                        = cpu_cur_status;
+    block->slow_calls                    = 0;
 
     recomp_page = block->phys & ~0xfff;
     codeblock_tree_add(block);
@@ -669,6 +669,7 @@ uop_gen_reg_src2_pointer(uint32_t uop_type, ir_data_t *ir, int src_reg_a, int sr
 }
 
 extern int codegen_mmx_enter(void);
+extern int codegen_mmx_enter_sf(void);
 extern int codegen_fp_enter(void);
 
 #define uop_LOAD_FUNC_ARG_REG(ir, arg, reg)                      uop_gen_reg_src1(UOP_LOAD_FUNC_ARG_0 + arg, ir, reg)
@@ -750,7 +751,7 @@ extern int codegen_fp_enter(void);
     do {                                                     \
         if (!codegen_mmx_entered) {                         \
             uop_MOV_IMM(ir, IREG_oldpc, cpu_state.oldpc);            \
-            uop_CALL_FUNC_RESULT(ir, IREG_temp0, codegen_mmx_enter); \
+            uop_CALL_FUNC_RESULT(ir, IREG_temp0, fpu_softfloat ? codegen_mmx_enter_sf : codegen_mmx_enter); \
             uop_CMP_IMM_JZ(ir, IREG_temp0, 1, codegen_exit_rout); \
         }                                                   \
         codegen_mmx_entered = 1;                             \
@@ -764,10 +765,18 @@ extern int codegen_fp_enter(void);
         codegen_fpu_entered = 1;                            \
         codegen_mmx_entered = 0;                            \
     } while (0)
+/*Softfloat needs the MMX registers copied out of the x87 register file, which
+  is left to the C helper*/
 #define uop_MMX_ENTER(ir)                                    \
     do {                                                     \
-        if (!codegen_mmx_entered)                            \
-            uop_gen_imm(UOP_MMX_ENTER, ir, cpu_state.oldpc); \
+        if (!codegen_mmx_entered) {                          \
+            if (fpu_softfloat) {                             \
+                uop_MOV_IMM(ir, IREG_oldpc, cpu_state.oldpc);               \
+                uop_CALL_FUNC_RESULT(ir, IREG_temp0, codegen_mmx_enter_sf); \
+                uop_CMP_IMM_JZ(ir, IREG_temp0, 1, codegen_exit_rout);       \
+            } else                                           \
+                uop_gen_imm(UOP_MMX_ENTER, ir, cpu_state.oldpc); \
+        }                                                    \
         codegen_mmx_entered = 1;                             \
         codegen_fpu_entered = 0;                             \
     } while (0)
@@ -15,10 +15,59 @@
 #include "codegen_ops_arith.h"
 #include "codegen_ops_helpers.h"
 
+/*Work out CF inline from the flags state left by an earlier instruction in this
+  block, where that is cheap. Returns 0 if CF_SET() has to be called instead*/
+static int
+get_cf_inline(ir_data_t *ir, int dest_reg)
+{
+    switch (codegen_flags_changed ? cpu_state.flags_op : FLAGS_UNKNOWN) {
+        case FLAGS_ZN8:
+        case FLAGS_ZN16:
+        case FLAGS_ZN32:
+            /*Logic ops always clear carry*/
+            uop_MOV_IMM(ir, dest_reg, 0);
+            return 1;
+
+        case FLAGS_ADD8:
+            uop_ADD(ir, dest_reg, IREG_flags_op1, IREG_flags_op2);
+            uop_SHR_IMM(ir, dest_reg, dest_reg, 8);
+            uop_AND_IMM(ir, dest_reg, dest_reg, 1);
+            return 1;
+        case FLAGS_ADD16:
+            uop_ADD(ir, dest_reg, IREG_flags_op1, IREG_flags_op2);
+            uop_SHR_IMM(ir, dest_reg, dest_reg, 16);
+            uop_AND_IMM(ir, dest_reg, dest_reg, 1);
+            return 1;
+
+        case FLAGS_ROL8:
+        case FLAGS_ROL16:
+        case FLAGS_ROL32:
+            uop_AND_IMM(ir, dest_reg, IREG_flags_res, 1);
+            return 1;
+
+        case FLAGS_INC8:
+        case FLAGS_INC16:
+        case FLAGS_INC32:
+        case FLAGS_DEC8:
+        case FLAGS_DEC16:
+        case FLAGS_DEC32:
+            /*Carry was rebuilt into flags before the INC/DEC*/
+            uop_MOVZX(ir, dest_reg, IREG_flags);
+            uop_AND_IMM(ir, dest_reg, dest_reg, C_FLAG);
+            return 1;
+
+        default:
+            break;
+    }
+
+    return 0;
+}
+
 static inline void
 get_cf(ir_data_t *ir, int dest_reg)
 {
-    uop_CALL_FUNC_RESULT(ir, dest_reg, CF_SET);
+    if (!get_cf_inline(ir, dest_reg))
+        uop_CALL_FUNC_RESULT(ir, dest_reg, CF_SET);
 }
 
 uint32_t
@@ -2269,26 +2318,31 @@ rop83_l(codeblock_t *block, ir_data_t *ir, UNUSED(uint8_t opcode), uint32_t fetc
 static void
 rebuild_c(ir_data_t *ir)
 {
-    int needs_rebuild = 1;
-
-    if (codegen_flags_changed) {
-        switch (cpu_state.flags_op) {
-            case FLAGS_INC8:
-            case FLAGS_INC16:
-            case FLAGS_INC32:
-            case FLAGS_DEC8:
-            case FLAGS_DEC16:
-            case FLAGS_DEC32:
-                needs_rebuild = 0;
-                break;
-
-            default:
-                break;
-        }
-    }
-
-    if (needs_rebuild) {
-        uop_CALL_FUNC(ir, flags_rebuild_c);
+    switch (codegen_flags_changed ? cpu_state.flags_op : FLAGS_UNKNOWN) {
+        case FLAGS_INC8:
+        case FLAGS_INC16:
+        case FLAGS_INC32:
+        case FLAGS_DEC8:
+        case FLAGS_DEC16:
+        case FLAGS_DEC32:
+            /*Carry is already in flags*/
+            break;
+
+        case FLAGS_ZN8:
+        case FLAGS_ZN16:
+        case FLAGS_ZN32:
+            uop_AND_IMM(ir, IREG_flags, IREG_flags, ~C_FLAG);
+            break;
+
+        default:
+            /*Fold carry into flags inline rather than calling out, as the
+              call is a barrier that flushes every host register*/
+            if (get_cf_inline(ir, IREG_temp0)) {
+                uop_AND_IMM(ir, IREG_flags, IREG_flags, ~C_FLAG);
+                uop_OR(ir, IREG_flags, IREG_flags, IREG_temp0_W);
+            } else
+                uop_CALL_FUNC(ir, flags_rebuild_c);
+            break;
     }
 }
 
@@ -2391,5 +2445,6 @@ ropINCDEC(codeblock_t *block, ir_data_t *ir, UNUSED(uint8_t opcode), uint32_t fe
         }
     }
 
+    codegen_flags_changed = 1;
     return op_pc + 1;
 }
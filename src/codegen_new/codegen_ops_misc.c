@@ -578,6 +578,17 @@ ropLxS(LSS, &cpu_state.seg_ss)
 uint32_t
 ropCLC(UNUSED(codeblock_t *block), ir_data_t *ir, UNUSED(uint8_t opcode), UNUSED(uint32_t fetchdat), UNUSED(uint32_t op_32), uint32_t op_pc)
 {
+    switch (codegen_flags_changed ? cpu_state.flags_op : FLAGS_UNKNOWN) {
+        case FLAGS_ZN8:
+        case FLAGS_ZN16:
+        case FLAGS_ZN32:
+            /*Carry is already known to be clear*/
+            return op_pc;
+
+        default:
+            break;
+    }
+
     uop_CALL_FUNC(ir, flags_rebuild);
     uop_AND_IMM(ir, IREG_flags, IREG_flags, ~C_FLAG);
     return op_pc;
@@ -123,6 +123,9 @@ enum {
 
     IREG_FPU_TOP,
 
+    /*Mask of MMX registers written under softfloat, see mmx_sf_flush()*/
+    IREG_mmx_sf_written,
+
     /*Temporary registers are stored on the stack, and are not guaranteed to
       be preserved across uOPs. They will not be written back if they will
       not be read again.*/
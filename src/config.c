@@ -493,6 +493,10 @@ load_machine(void)
         mem_size = machine_get_max_ram(machine);
 
     cpu_use_dynarec = !!ini_section_get_int(cat, "cpu_use_dynarec", 0);
+    mem_smc_protect = !!ini_section_get_int(cat, "cpu_smc_protect", 0);
+    cpu_dynarec_blocks = ini_section_get_int(cat, "cpu_dynarec_blocks", 0);
+    if (cpu_dynarec_blocks < 0)
+        cpu_dynarec_blocks = 0;
     fpu_softfloat = !!ini_section_get_int(cat, "fpu_softfloat", 0);
     if ((fpu_type != FPU_NONE) && machine_has_flags(machine, MACHINE_SOFTFLOAT_ONLY))
         fpu_softfloat = 1;
@@ -852,6 +856,7 @@ load_sound(void)
     } else {
         fm_driver = FM_DRV_NUKED;
     }
+    fm_offload = !!ini_section_get_int(cat, "fm_offload", 0);
 
     p = ini_section_get_string(cat, "sound_output_device", "");
     strncpy(sound_output_device, p, sizeof(sound_output_device) - 1);
@@ -2908,6 +2913,16 @@ save_machine(void)
 
     ini_section_set_int(cat, "cpu_use_dynarec", cpu_use_dynarec);
 
+    if (mem_smc_protect)
+        ini_section_set_int(cat, "cpu_smc_protect", mem_smc_protect);
+    else
+        ini_section_delete_var(cat, "cpu_smc_protect");
+
+    if (cpu_dynarec_blocks)
+        ini_section_set_int(cat, "cpu_dynarec_blocks", cpu_dynarec_blocks);
+    else
+        ini_section_delete_var(cat, "cpu_dynarec_blocks");
+
     if (fpu_softfloat == 0)
         ini_section_delete_var(cat, "fpu_softfloat");
     else
@@ -3165,6 +3180,11 @@ save_sound(void)
     else
         ini_section_set_string(cat, "fm_driver", "ymfm");
 
+    if (fm_offload == 0)
+        ini_section_delete_var(cat, "fm_offload");
+    else
+        ini_section_set_int(cat, "fm_offload", fm_offload);
+
     if (sound_output_device[0] == '\0')
         ini_section_delete_var(cat, "sound_output_device");
     else
@@ -32,6 +32,8 @@
 #include <86box/plat_fallthrough.h>
 #include <86box/plat_unused.h>
 #include <86box/gdbstub.h>
+#include <86box/trace.h>
+#include <86box/cpu_prof.h>
 #ifdef USE_DYNAREC
 #    include "codegen.h"
 #    ifdef USE_NEW_DYNAREC
@@ -250,6 +252,22 @@ codegen_mmx_enter(void)
     return 0;
 }
 
+#    ifdef USE_NEW_DYNAREC
+/*Recompiled MMX code under softfloat works on cpu_state.MM, FP_ENTER() and
+  MMX_ENTER() write it back before the interpreter next uses the registers*/
+int
+codegen_mmx_enter_sf(void)
+{
+    if (cr0 & 0xc) {
+        x86_int(7);
+        return 1;
+    }
+    mmx_sf_load();
+    x87_set_mmx();
+    return 0;
+}
+#    endif
+
 int
 codegen_fp_enter(void)
 {
@@ -390,13 +408,14 @@ block_ended:
 }
 
 #if defined(__linux__) && !defined(__clang__) && defined(USE_NEW_DYNAREC)
-static inline void __attribute__((optimize("O2")))
+static inline int __attribute__((optimize("O2")))
 #else
-static __inline void
+static __inline int
 #endif
 exec386_dynarec_dyn(void)
 {
     uint32_t start_pc  = 0;
+    int      state     = CPU_PROF_INTERP;
     uint32_t phys_addr = get_phys(cs + cpu_state.pc);
     int      hash      = HASH(phys_addr);
 #    ifdef USE_NEW_DYNAREC
@@ -418,6 +437,10 @@ exec386_dynarec_dyn(void)
            and physical address. The physical address check will
            also catch any page faults at this stage */
         valid_block = (block->pc == cs + cpu_state.pc) && (block->_cs == cs) && (block->phys == phys_addr) && !((block->status ^ cpu_cur_status) & CPU_STATUS_FLAGS) && ((block->status & cpu_cur_status & CPU_STATUS_MASK) == (cpu_cur_status & CPU_STATUS_MASK));
+#    ifndef USE_NEW_DYNAREC
+        if (valid_block && cpu_prof_on)
+            codegen_block_hits++;
+#    endif
         if (!valid_block) {
             uint64_t mask = (uint64_t) 1 << ((phys_addr >> PAGE_MASK_SHIFT) & PAGE_MASK_MASK);
 #    ifdef USE_NEW_DYNAREC
@@ -438,6 +461,9 @@ exec386_dynarec_dyn(void)
                         block = new_block;
 #    ifdef USE_NEW_DYNAREC
                         codeblock_hash[hash] = get_block_nr(block);
+#    else
+                        if (cpu_prof_on)
+                            codegen_block_tree_hits++;
 #    endif
                     }
                 }
@@ -523,12 +549,21 @@ exec386_dynarec_dyn(void)
 #    ifndef USE_NEW_DYNAREC
         codeblock_hash[hash] = block;
 #    endif
+        TRACE_NAMED_COUNT_ENTER("dynarec", "execute");
+        state    = CPU_PROF_EXEC;
         inrecomp = 1;
         code();
 #    ifdef USE_ACYCS
         acycs = 0;
 #    endif
         inrecomp = 0;
+#    if defined(USE_NEW_DYNAREC) && defined(DEBUG_EXTRA)
+        if (cpu_state.mem_slow_calls) {
+            block->slow_calls += cpu_state.mem_slow_calls;
+            cpu_state.mem_slow_calls = 0;
+        }
+#    endif
+        TRACE_LEAVE();
 
 #    ifndef USE_NEW_DYNAREC
         if (!use32)
@@ -545,6 +580,8 @@ exec386_dynarec_dyn(void)
         cpu_block_end = 0;
         x86_was_reset = 0;
 
+        TRACE_NAMED_ENTER("dynarec", "compile");
+        state = CPU_PROF_COMPILE;
 #    if defined(__APPLE__) && defined(__aarch64__)
         if (__builtin_available(macOS 11.0, *)) {
             pthread_jit_write_protect_np(0);
@@ -636,6 +673,7 @@ exec386_dynarec_dyn(void)
             codegen_reset();
 
         codegen_in_recompile = 0;
+        TRACE_LEAVE();
 #    if defined(__APPLE__) && defined(__aarch64__)
         if (__builtin_available(macOS 11.0, *)) {
             pthread_jit_write_protect_np(1);
@@ -653,6 +691,7 @@ exec386_dynarec_dyn(void)
         cpu_block_end = 0;
         x86_was_reset = 0;
 
+        state = CPU_PROF_MARK;
         codegen_block_init(phys_addr);
 
         while (!cpu_block_end) {
@@ -741,6 +780,8 @@ exec386_dynarec_dyn(void)
     else
         cpu_state.oldpc = cpu_state.pc;
 #    endif
+
+    return state;
 }
 
 void
@@ -755,6 +796,9 @@ exec386_dynarec(int32_t cycs)
     uint64_t delta;
 
     int32_t cyc_period = cycs / (force_10ms ? 2000 : 200); /*5us*/
+    int     prof_state;
+
+    cpu_prof_poll();
 
 #    ifdef USE_ACYCS
     acycs = 0;
@@ -779,12 +823,17 @@ exec386_dynarec(int32_t cycs)
             cycles_old       = cycles;
             oldtsc           = tsc;
             tsc_old          = tsc;
+            if (cpu_prof_on)
+                cpu_prof_enter();
             if (cpu_force_interpreter || cpu_override_dynarec ||  (!CACHE_ON())) /*Interpret block*/
             {
                 exec386_dynarec_int();
+                prof_state = CPU_PROF_INTERP;
             } else {
-                exec386_dynarec_dyn();
+                prof_state = exec386_dynarec_dyn();
             }
+            if (cpu_prof_on)
+                cpu_prof_leave(prof_state, oldcyc - cycles);
 
             if (cpu_init) {
                 cpu_init = 0;
@@ -249,6 +249,7 @@ int timing_jmp_rm;
 int timing_jmp_pm;
 int timing_jmp_pm_gate;
 int timing_misaligned;
+uint8_t timing_misaligned_table[3][8];
 
 uint32_t cpu_features;
 uint32_t cpu_fast_off_flags;
@@ -504,6 +505,9 @@ SF_FPU_reset(void)
         fpu_state.fds = 0;
         fpu_state.fdp = 0;
         memset(fpu_state.st_space, 0, sizeof(floatx80) * 8);
+#ifdef USE_NEW_DYNAREC
+        mmx_sf_cached = 0;
+#endif
     }
 }
 
@@ -1874,6 +1878,13 @@ cpu_set(void)
         cpu_exec = execx86;
     mmx_init();
     gdbstub_cpu_init();
+
+    /* Same rules as readmemwl()/readmemll()/readmemql() and their write counterparts. */
+    for (uint8_t a = 0; a < 8; a++) {
+        timing_misaligned_table[0][a] = ((a & 1) && (!cpu_cyrix_alignment || (a == 7))) ? timing_misaligned : 0;
+        timing_misaligned_table[1][a] = ((a & 3) && (!cpu_cyrix_alignment || (a > 4))) ? timing_misaligned : 0;
+        timing_misaligned_table[2][a] = (a & 7) ? timing_misaligned : 0;
+    }
 }
 
 void
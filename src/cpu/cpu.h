@@ -391,6 +391,11 @@ typedef struct {
 #    if defined __amd64__ || defined _M_X64
     uint32_t trunc_fp_control;
 #    endif
+    /* Recompiled memory accesses that went through readmem*l()/writemem*l()
+       since the last block exit. */
+    uint32_t mem_slow_calls;
+    /* MMX registers written by recompiled code since mmx_sf_load(). */
+    uint32_t mmx_sf_written;
 #else
     uint16_t old_npxc;
     uint16_t new_npxc;
@@ -678,6 +683,9 @@ extern int timing_jmp_rm;
 extern int timing_jmp_pm;
 extern int timing_jmp_pm_gate;
 extern int timing_misaligned;
+/* Misalignment penalty by access size (word, dword, qword) and address bits 0-2,
+   for the recompiler's inline memory access paths. */
+extern uint8_t timing_misaligned_table[3][8];
 
 extern int      in_sys;
 extern int      unmask_a20_in_smm;
@@ -832,6 +840,20 @@ extern int  cpu_force_interpreter;
 extern int  cpu_override_dynarec;
 
 extern void mmx_init(void);
+#ifdef USE_NEW_DYNAREC
+/* With softfloat the MMX registers live in the x87 register file, recompiled
+   MMX code works on a copy of them in cpu_state.MM. */
+extern int  mmx_sf_cached;
+extern void mmx_sf_load(void);
+extern void mmx_sf_flush(void);
+#    define MMX_SF_FLUSH()        \
+        do {                      \
+            if (mmx_sf_cached)    \
+                mmx_sf_flush();   \
+        } while (0)
+#else
+#    define MMX_SF_FLUSH()
+#endif
 extern void prefetch_flush(void);
 
 extern void prefetch_run(int instr_cycles, int bytes, int modrm, int reads, int reads_l, int writes, int writes_l, int ea32);
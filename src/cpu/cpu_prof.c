@@ -0,0 +1,297 @@
+/*
+ * 86Box    A hypervisor and IBM PC system emulator that specializes in
+ *          running old operating systems and software designed for IBM
+ *          PC systems and compatibles from 1981 through fairly recent
+ *          system designs based on the PCI bus.
+ *
+ *          This file is part of the 86Box distribution.
+ *
+ *          Guest execution profiler.
+ *
+ *          Pages live in a fixed open-addressed table keyed by the
+ *          physical page number, only touched from the CPU thread.
+ *          Each page remembers the last CS:EIP a block was entered
+ *          with, so the output can be matched against guest symbols.
+ */
+#include <stdarg.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <wchar.h>
+#include <inttypes.h>
+#define HAVE_STDARG_H
+#include <86box/86box.h>
+#include "cpu.h"
+#include "x86.h"
+#include <86box/mem.h>
+#include <86box/path.h>
+#include <86box/plat.h>
+#include <86box/cpu_prof.h>
+#if defined(USE_DYNAREC) && !defined(USE_NEW_DYNAREC)
+#    include "codegen.h"
+#endif
+
+#define CPU_PROF_PAGES 16384 /* must be a power of two */
+
+enum {
+    MODE_REAL = 0,
+    MODE_V86,
+    MODE_PM16,
+    MODE_PM32
+};
+
+typedef struct cpu_prof_page_t {
+    uint32_t page; /* Physical page number + 1, 0 = free */
+    uint32_t eip;
+    uint16_t sel;
+    uint8_t  mode;
+
+    uint64_t blocks[CPU_PROF_STATES];
+    uint64_t ticks[CPU_PROF_STATES]; /* Guest cycles */
+    uint64_t flushes;
+} cpu_prof_page_t;
+
+int cpu_prof_on = 0;
+
+static cpu_prof_page_t *prof_pages;
+static uint64_t         prof_dropped;
+static char             prof_prefix[1024];
+static atomic_int       prof_request;
+
+/* Block being run, set by cpu_prof_enter(). */
+static uint32_t prof_phys;
+static uint32_t prof_eip;
+static uint16_t prof_sel;
+static uint8_t  prof_mode;
+
+static const char *state_names[CPU_PROF_STATES] = { "interpreted", "marked", "recompiling", "recompiled" };
+static const char *mode_names[4]                = { "real", "v86", "pm16", "pm32" };
+
+static cpu_prof_page_t *
+cpu_prof_page(uint32_t phys)
+{
+    uint32_t         key = (phys >> 12) + 1;
+    uint32_t         i   = ((key * 0x9e3779b1) >> 16) & (CPU_PROF_PAGES - 1);
+    cpu_prof_page_t *p;
+
+    for (uint32_t n = 0; n < CPU_PROF_PAGES; n++, i = (i + 1) & (CPU_PROF_PAGES - 1)) {
+        p = &prof_pages[i];
+        if (p->page == key)
+            return p;
+        if (p->page == 0) {
+            p->page = key;
+            return p;
+        }
+    }
+
+    /* Table full. */
+    prof_dropped++;
+    return NULL;
+}
+
+void
+cpu_prof_enter(void)
+{
+    uint32_t lin = cs + cpu_state.pc;
+
+    prof_phys = get_phys_noabrt(lin);
+    prof_eip  = cpu_state.pc;
+    prof_sel  = CS;
+    if (!(msw & 1))
+        prof_mode = MODE_REAL;
+    else if (cpu_state.eflags & VM_FLAG)
+        prof_mode = MODE_V86;
+    else
+        prof_mode = use32 ? MODE_PM32 : MODE_PM16;
+}
+
+void
+cpu_prof_leave(int state, int32_t cyc)
+{
+    cpu_prof_page_t *p;
+
+    if (prof_phys == 0xffffffff)
+        return;
+
+    p = cpu_prof_page(prof_phys);
+    if (p == NULL)
+        return;
+
+    p->eip  = prof_eip;
+    p->sel  = prof_sel;
+    p->mode = prof_mode;
+    p->blocks[state]++;
+    if (cyc > 0)
+        p->ticks[state] += cyc;
+}
+
+void
+cpu_prof_flush(uint32_t phys, int blocks)
+{
+    cpu_prof_page_t *p;
+
+    if (!blocks)
+        return;
+
+    p = cpu_prof_page(phys);
+    if (p != NULL)
+        p->flushes += blocks;
+}
+
+static uint64_t
+cpu_prof_total(const cpu_prof_page_t *p)
+{
+    uint64_t total = 0;
+
+    for (int i = 0; i < CPU_PROF_STATES; i++)
+        total += p->ticks[i];
+
+    return total;
+}
+
+static int
+cpu_prof_cmp(const void *a, const void *b)
+{
+    uint64_t ta = cpu_prof_total(*(const cpu_prof_page_t * const *) a);
+    uint64_t tb = cpu_prof_total(*(const cpu_prof_page_t * const *) b);
+
+    return (ta < tb) - (ta > tb);
+}
+
+static FILE *
+cpu_prof_open(const char *ext)
+{
+    char fn[1024 + 16];
+
+    if (prof_prefix[0] != '\0')
+        snprintf(fn, sizeof(fn), "%s.%s", prof_prefix, ext);
+    else {
+        char name[32];
+
+        snprintf(name, sizeof(name), "cpu_profile.%s", ext);
+        path_append_filename(fn, usr_path, name);
+    }
+
+    return plat_fopen(fn, "wb");
+}
+
+void
+cpu_prof_save(void)
+{
+    cpu_prof_page_t **list;
+    int               n = 0;
+    FILE             *fp;
+
+    if (prof_pages == NULL)
+        return;
+
+    list = (cpu_prof_page_t **) malloc(CPU_PROF_PAGES * sizeof(cpu_prof_page_t *));
+    for (int i = 0; i < CPU_PROF_PAGES; i++) {
+        if (prof_pages[i].page)
+            list[n++] = &prof_pages[i];
+    }
+    qsort(list, n, sizeof(cpu_prof_page_t *), cpu_prof_cmp);
+
+    if ((fp = cpu_prof_open("json")) != NULL) {
+        fprintf(fp, "{\"dropped\":%" PRIu64 ",", prof_dropped);
+#if defined(USE_DYNAREC) && !defined(USE_NEW_DYNAREC)
+        fprintf(fp, "\"codegen\":{\"hits\":%" PRIu64 ",\"tree_hits\":%" PRIu64 ",\"misses\":%" PRIu64 ",\"evictions\":%" PRIu64 "},",
+                codegen_block_hits, codegen_block_tree_hits, codegen_block_misses, codegen_block_evictions);
+#endif
+        fprintf(fp, "\"tlb\":{\"hits\":%" PRIu64 ",\"misses\":%" PRIu64 "},", mmu_tlb_hits, mmu_tlb_misses);
+        fprintf(fp, "\"pages\":[\n");
+        for (int i = 0; i < n; i++) {
+            const cpu_prof_page_t *p = list[i];
+
+            fprintf(fp, "  {\"phys\":\"%08x\",\"cs\":\"%04x\",\"eip\":\"%08x\",\"mode\":\"%s\",\"flushes\":%" PRIu64,
+                    (p->page - 1) << 12, p->sel, p->eip, mode_names[p->mode], p->flushes);
+            fprintf(fp, ",\"blocks\":{");
+            for (int s = 0; s < CPU_PROF_STATES; s++)
+                fprintf(fp, "%s\"%s\":%" PRIu64, s ? "," : "", state_names[s], p->blocks[s]);
+            fprintf(fp, "},\"cycles\":{");
+            for (int s = 0; s < CPU_PROF_STATES; s++)
+                fprintf(fp, "%s\"%s\":%" PRIu64, s ? "," : "", state_names[s], p->ticks[s]);
+            fprintf(fp, "}}%s\n", (i < (n - 1)) ? "," : "");
+        }
+        fprintf(fp, "]}\n");
+        fclose(fp);
+    }
+
+    /* mode;CS:EIP page@physical page;state cycles */
+    if ((fp = cpu_prof_open("folded")) != NULL) {
+        for (int i = 0; i < n; i++) {
+            const cpu_prof_page_t *p = list[i];
+
+            for (int s = 0; s < CPU_PROF_STATES; s++) {
+                if (p->ticks[s])
+                    fprintf(fp, "%s;%04x:%08x@%08x;%s %" PRIu64 "\n", mode_names[p->mode], p->sel,
+                            p->eip & ~0xfff, (p->page - 1) << 12, state_names[s], p->ticks[s]);
+            }
+        }
+        fclose(fp);
+    }
+
+    free(list);
+}
+
+void
+cpu_prof_set_path(const char *prefix)
+{
+    if (prefix != NULL)
+        snprintf(prof_prefix, sizeof(prof_prefix), "%s", prefix);
+    else
+        prof_prefix[0] = '\0';
+}
+
+void
+cpu_prof_start(void)
+{
+    if (prof_pages == NULL)
+        prof_pages = (cpu_prof_page_t *) calloc(CPU_PROF_PAGES, sizeof(cpu_prof_page_t));
+    else
+        memset(prof_pages, 0x00, CPU_PROF_PAGES * sizeof(cpu_prof_page_t));
+    prof_dropped   = 0;
+    mmu_tlb_hits   = 0;
+    mmu_tlb_misses = 0;
+#if defined(USE_DYNAREC) && !defined(USE_NEW_DYNAREC)
+    codegen_block_hits      = 0;
+    codegen_block_tree_hits = 0;
+    codegen_block_misses    = 0;
+    codegen_block_evictions = 0;
+#endif
+
+    cpu_prof_on = 1;
+}
+
+void
+cpu_prof_stop(void)
+{
+    if (!cpu_prof_on)
+        return;
+
+    cpu_prof_on = 0;
+    cpu_prof_save();
+
+    free(prof_pages);
+    prof_pages = NULL;
+}
+
+void
+cpu_prof_request_toggle(void)
+{
+    atomic_store(&prof_request, 1);
+}
+
+void
+cpu_prof_poll(void)
+{
+    if (!atomic_exchange(&prof_request, 0))
+        return;
+
+    if (cpu_prof_on)
+        cpu_prof_stop();
+    else
+        cpu_prof_start();
+}
@@ -35,10 +35,45 @@ uint16_t *MMEP[8];
 static uint16_t MME[8];
 
 #define MMX_GETREGP(r) fpu_softfloat ? ((MMX_REG *) &fpu_state.st_space[r].signif) : &(cpu_state.MM[r])
+#ifdef USE_NEW_DYNAREC
+int mmx_sf_cached;
+
+/* Copy the softfloat MMX registers to cpu_state.MM for recompiled code. */
+void
+mmx_sf_load(void)
+{
+    if (mmx_sf_cached)
+        return;
+
+    for (uint8_t i = 0; i < 8; i++)
+        cpu_state.MM[i].q = fpu_state.st_space[i].signif;
+    cpu_state.mmx_sf_written = 0;
+    mmx_sf_cached            = 1;
+}
+
+/* Write the copy back before the interpreter touches the x87 register file,
+   setting the exponent of every register recompiled code wrote the way
+   MMX_SETEXP() does. */
+void
+mmx_sf_flush(void)
+{
+    for (uint8_t i = 0; i < 8; i++) {
+        fpu_state.st_space[i].signif = cpu_state.MM[i].q;
+        if (cpu_state.mmx_sf_written & (1 << i))
+            fpu_state.st_space[i].signExp = 0xffff;
+    }
+    cpu_state.mmx_sf_written = 0;
+    mmx_sf_cached            = 0;
+}
+#endif
+
 void
 mmx_init(void)
 {
     memset(MME, 0xff, sizeof(MME));
+#ifdef USE_NEW_DYNAREC
+    mmx_sf_cached = 0;
+#endif
 
     for (uint8_t i = 0; i < 8; i++) {
         if (fpu_softfloat) {
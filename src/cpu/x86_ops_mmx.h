@@ -31,6 +31,7 @@
         x86_int(7);                          \
         return 1;                            \
     }                                        \
+    MMX_SF_FLUSH();                          \
     x87_set_mmx()
 
 static int
@@ -232,6 +232,7 @@ static int op0F00_common(uint32_t fetchdat, UNUSED(int ea32))
             }
             ldt.base = base;
             ldt.seg  = sel;
+            x86seg_dcache_flush();
             CLOCK_CYCLES(20);
             PREFETCH_RUN(20, 2, rmdat, (cpu_mod == 3) ? 0 : 1, 2, 0, 0, ea32);
             break;
@@ -405,6 +406,7 @@ op0F01_common(UNUSED(uint32_t fetchdat), int is32, int is286, UNUSED(int ea32))
             gdt.base  = base;
             if (!is32)
                 gdt.base &= 0xffffff;
+            x86seg_dcache_flush();
             CLOCK_CYCLES(11);
             PREFETCH_RUN(11, 2, rmdat, 1, 1, 0, 0, ea32);
             break;
@@ -480,7 +482,7 @@ op0F01_common(UNUSED(uint32_t fetchdat), int is32, int is286, UNUSED(int ea32))
                     break;
                 }
                 SEG_CHECK_READ(cpu_state.ea_seg);
-                flushmmucache_nopc();
+                flushmmucache_page(cpu_state.ea_seg->base + cpu_state.eaaddr);
                 CLOCK_CYCLES(12);
                 PREFETCH_RUN(12, 2, rmdat, 0, 0, 0, 0, ea32);
                 break;
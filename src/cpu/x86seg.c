@@ -270,6 +270,31 @@ read_descriptor(uint32_t addr, uint16_t *segdat, uint32_t *segdat32, int overrid
         cpl_override = 0;
 }
 
+/* Selector loads, through the descriptor cache in x86seg_common.c. */
+static void
+read_descriptor_cached(uint32_t addr, uint16_t *segdat, uint32_t *segdat32)
+{
+    if (x86seg_dcache_lookup(addr, segdat))
+        return;
+
+    read_descriptor(addr, segdat, segdat32, 1);
+    if (!cpu_state.abrt)
+        x86seg_dcache_fill(addr, segdat);
+}
+
+/* Only written when still clear, as real hardware does; the write would
+   otherwise drop the cached descriptor on every load. */
+static void
+set_accessed(uint32_t addr, const uint16_t *segdat)
+{
+    if (segdat[2] & 0x0100)
+        return;
+
+    cpl_override = 1;
+    writememw(0, addr + 4, segdat[2] | 0x0100); /* Set accessed bit */
+    cpl_override = 0;
+}
+
 #ifdef USE_NEW_DYNAREC
 int
 #else
@@ -320,7 +345,7 @@ loadseg(uint16_t seg, x86seg *s)
 #endif
         }
         addr += dt->base;
-        read_descriptor(addr, segdat, segdat32, 1);
+        read_descriptor_cached(addr, segdat, segdat32);
         if (cpu_state.abrt)
 #ifdef USE_NEW_DYNAREC
             return 1;
@@ -432,10 +457,8 @@ loadseg(uint16_t seg, x86seg *s)
         s->seg = seg;
         do_seg_load(s, segdat);
 
-        cpl_override = 1;
-        writememw(0, addr + 4, segdat[2] | 0x100); /* Set accessed bit */
-        cpl_override = 0;
-        s->checked   = 0;
+        set_accessed(addr, segdat);
+        s->checked = 0;
 #ifdef USE_DYNAREC
         if (s == &cpu_state.seg_ds)
             codegen_flat_ds = 0;
@@ -504,7 +527,7 @@ loadcs(uint16_t seg)
         }
         addr += dt->base;
 
-        read_descriptor(addr, segdat, segdat32, 1);
+        read_descriptor_cached(addr, segdat, segdat32);
         if (cpu_state.abrt)
             return;
         if (segdat[2] & 0x1000) {
@@ -533,14 +556,12 @@ loadcs(uint16_t seg)
             do_seg_load(&cpu_state.seg_cs, segdat);
             use32 = (segdat[3] & 0x40) ? 0x300 : 0;
             if ((CPL == 3) && (oldcpl != 3))
-                flushmmucache_nopc();
+                flushmmucache_cpl();
 #ifdef USE_NEW_DYNAREC
             oldcpl = CPL;
 #endif
 
-            cpl_override = 1;
-            writememw(0, addr + 4, segdat[2] | 0x0100); /* Set accessed bit */
-            cpl_override = 0;
+            set_accessed(addr, segdat);
         } else {
             /* System segment */
             if (!(segdat[2] & 0x8000)) {
@@ -562,7 +583,7 @@ loadcs(uint16_t seg)
         cpu_state.seg_cs.access     = (cpu_state.eflags & VM_FLAG) ? 0xe2 : 0x82;
         cpu_state.seg_cs.ar_high    = 0x10;
         if ((CPL == 3) && (oldcpl != 3))
-            flushmmucache_nopc();
+            flushmmucache_cpl();
 #ifdef USE_NEW_DYNAREC
         oldcpl = CPL;
 #endif
@@ -596,7 +617,7 @@ loadcsjmp(uint16_t seg, uint32_t old_pc)
             return;
         }
         addr += dt->base;
-        read_descriptor(addr, segdat, segdat32, 1);
+        read_descriptor_cached(addr, segdat, segdat32);
         if (cpu_state.abrt)
             return;
         x86seg_log("%04X %04X %04X %04X\n", segdat[0], segdat[1], segdat[2], segdat[3]);
@@ -623,16 +644,14 @@ loadcsjmp(uint16_t seg, uint32_t old_pc)
             }
             set_use32(segdat[3] & 0x0040);
 
-            cpl_override = 1;
-            writememw(0, addr + 4, segdat[2] | 0x0100); /* Set accessed bit */
-            cpl_override = 0;
+            set_accessed(addr, segdat);
 
             CS        = (seg & 0xfffc) | CPL;
             segdat[2] = (segdat[2] & ~(3 << 13)) | (CPL << 13);
 
             do_seg_load(&cpu_state.seg_cs, segdat);
             if ((CPL == 3) && (oldcpl != 3))
-                flushmmucache_nopc();
+                flushmmucache_cpl();
 #ifdef USE_NEW_DYNAREC
             oldcpl = CPL;
 #endif
@@ -680,7 +699,7 @@ loadcsjmp(uint16_t seg, uint32_t old_pc)
                         return;
                     }
                     addr += dt->base;
-                    read_descriptor(addr, segdat, segdat32, 1);
+                    read_descriptor_cached(addr, segdat, segdat32);
                     if (cpu_state.abrt)
                         return;
 
@@ -710,16 +729,14 @@ loadcsjmp(uint16_t seg, uint32_t old_pc)
                             CS = seg2;
                             do_seg_load(&cpu_state.seg_cs, segdat);
                             if ((CPL == 3) && (oldcpl != 3))
-                                flushmmucache_nopc();
+                                flushmmucache_cpl();
 #ifdef USE_NEW_DYNAREC
                             oldcpl = CPL;
 #endif
                             set_use32(segdat[3] & 0x40);
                             cpu_state.pc = newpc;
 
-                            cpl_override = 1;
-                            writememw(0, addr + 4, segdat[2] | 0x100); /* Set accessed bit */
-                            cpl_override = 0;
+                            set_accessed(addr, segdat);
                             break;
 
                         default:
@@ -753,7 +770,7 @@ loadcsjmp(uint16_t seg, uint32_t old_pc)
         cpu_state.seg_cs.access     = (cpu_state.eflags & VM_FLAG) ? 0xe2 : 0x82;
         cpu_state.seg_cs.ar_high    = 0x10;
         if ((CPL == 3) && (oldcpl != 3))
-            flushmmucache_nopc();
+            flushmmucache_cpl();
 #ifdef USE_NEW_DYNAREC
         oldcpl = CPL;
 #endif
@@ -912,7 +929,7 @@ loadcscall(uint16_t seg)
             return;
         }
         addr += dt->base;
-        read_descriptor(addr, segdat, segdat32, 1);
+        read_descriptor_cached(addr, segdat, segdat32);
         if (cpu_state.abrt)
             return;
         type  = segdat[2] & 0x0f00;
@@ -942,9 +959,7 @@ loadcscall(uint16_t seg)
             }
             set_use32(segdat[3] & 0x0040);
 
-            cpl_override = 1;
-            writememw(0, addr + 4, segdat[2] | 0x100); /* Set accessed bit */
-            cpl_override = 0;
+            set_accessed(addr, segdat);
 
             /* Conforming segments don't change CPL, so preserve existing CPL */
             if (segdat[2] & 0x0400) {
@@ -955,7 +970,7 @@ loadcscall(uint16_t seg)
             CS = seg;
             do_seg_load(&cpu_state.seg_cs, segdat);
             if ((CPL == 3) && (oldcpl != 3))
-                flushmmucache_nopc();
+                flushmmucache_cpl();
 #ifdef USE_NEW_DYNAREC
             oldcpl = CPL;
 #endif
@@ -1003,7 +1018,7 @@ loadcscall(uint16_t seg)
                         return;
                     }
                     addr += dt->base;
-                    read_descriptor(addr, segdat, segdat32, 1);
+                    read_descriptor_cached(addr, segdat, segdat32);
                     if (cpu_state.abrt)
                         return;
 
@@ -1063,7 +1078,7 @@ loadcscall(uint16_t seg)
                                 }
                                 addr += dt->base;
                                 x86seg_log("Read stack seg\n");
-                                read_descriptor(addr, segdat2, segdat232, 1);
+                                read_descriptor_cached(addr, segdat2, segdat232);
                                 if (cpu_state.abrt)
                                     return;
                                 x86seg_log("Read stack seg done!\n");
@@ -1091,14 +1106,12 @@ loadcscall(uint16_t seg)
                                 do_seg_load(&cpu_state.seg_ss, segdat2);
 
                                 x86seg_log("Set access 1\n");
-                                cpl_override = 1;
-                                writememw(0, addr + 4, segdat2[2] | 0x100); /* Set accessed bit */
-                                cpl_override = 0;
+                                set_accessed(addr, segdat2);
 
                                 CS = seg2;
                                 do_seg_load(&cpu_state.seg_cs, segdat);
                                 if ((CPL == 3) && (oldcpl != 3))
-                                    flushmmucache_nopc();
+                                    flushmmucache_cpl();
 #ifdef USE_NEW_DYNAREC
                                 oldcpl = CPL;
 #endif
@@ -1107,9 +1120,7 @@ loadcscall(uint16_t seg)
 
                                 x86seg_log("Set access 2\n");
 
-                                cpl_override = 1;
-                                writememw(0, oaddr + 4, segdat[2] | 0x100); /* Set accessed bit */
-                                cpl_override = 0;
+                                set_accessed(oaddr, segdat);
 
                                 x86seg_log("Type %04X\n", type);
                                 if (type == 0x0c00) {
@@ -1215,16 +1226,14 @@ loadcscall(uint16_t seg)
                             CS = seg2;
                             do_seg_load(&cpu_state.seg_cs, segdat);
                             if ((CPL == 3) && (oldcpl != 3))
-                                flushmmucache_nopc();
+                                flushmmucache_cpl();
 #ifdef USE_NEW_DYNAREC
                             oldcpl = CPL;
 #endif
                             set_use32(segdat[3] & 0x0040);
                             cpu_state.pc = newpc;
 
-                            cpl_override = 1;
-                            writememw(0, addr + 4, segdat[2] | 0x100); /* Set accessed bit */
-                            cpl_override = 0;
+                            set_accessed(addr, segdat);
                             cycles -= timing_call_pm_gate;
                             break;
 
@@ -1260,7 +1269,7 @@ loadcscall(uint16_t seg)
         cpu_state.seg_cs.access     = (cpu_state.eflags & VM_FLAG) ? 0xe2 : 0x82;
         cpu_state.seg_cs.ar_high    = 0x10;
         if ((CPL == 3) && (oldcpl != 3))
-            flushmmucache_nopc();
+            flushmmucache_cpl();
 #ifdef USE_NEW_DYNAREC
         oldcpl = CPL;
 #endif
@@ -1381,7 +1390,7 @@ pmoderetf(int is32, uint16_t off)
         do_seg_load(&cpu_state.seg_cs, segdat);
         cpu_state.seg_cs.access = (cpu_state.seg_cs.access & ~(3 << 5)) | ((CS & 3) << 5);
         if ((CPL == 3) && (oldcpl != 3))
-            flushmmucache_nopc();
+            flushmmucache_cpl();
 #ifdef USE_NEW_DYNAREC
         oldcpl = CPL;
 #endif
@@ -1500,7 +1509,7 @@ pmoderetf(int is32, uint16_t off)
         CS           = seg;
         do_seg_load(&cpu_state.seg_cs, segdat);
         if ((CPL == 3) && (oldcpl != 3))
-            flushmmucache_nopc();
+            flushmmucache_cpl();
 #ifdef USE_NEW_DYNAREC
         oldcpl = CPL;
 #endif
@@ -1774,7 +1783,7 @@ pmodeint(int num, int soft)
             CS                      = (seg & 0xfffc) | new_cpl;
             cpu_state.seg_cs.access = (cpu_state.seg_cs.access & ~0x60) | (new_cpl << 5);
             if ((CPL == 3) && (oldcpl != 3))
-                flushmmucache_nopc();
+                flushmmucache_cpl();
 #ifdef USE_NEW_DYNAREC
             oldcpl = CPL;
 #endif
@@ -1951,7 +1960,7 @@ pmodeiret(int is32)
             cpu_state.seg_cs.access     = 0xe2;
             cpu_state.seg_cs.ar_high    = 0x10;
             if ((CPL == 3) && (oldcpl != 3))
-                flushmmucache_nopc();
+                flushmmucache_cpl();
 #ifdef USE_NEW_DYNAREC
             oldcpl = CPL;
 #endif
@@ -2042,7 +2051,7 @@ pmodeiret(int is32)
         do_seg_load(&cpu_state.seg_cs, segdat);
         cpu_state.seg_cs.access = (cpu_state.seg_cs.access & ~0x60) | ((CS & 0x0003) << 5);
         if ((CPL == 3) && (oldcpl != 3))
-            flushmmucache_nopc();
+            flushmmucache_cpl();
 #ifdef USE_NEW_DYNAREC
         oldcpl = CPL;
 #endif
@@ -2131,7 +2140,7 @@ pmodeiret(int is32)
         do_seg_load(&cpu_state.seg_cs, segdat);
         cpu_state.seg_cs.access = (cpu_state.seg_cs.access & ~0x60) | ((CS & 3) << 5);
         if ((CPL == 3) && (oldcpl != 3))
-            flushmmucache_nopc();
+            flushmmucache_cpl();
 #ifdef USE_NEW_DYNAREC
         oldcpl = CPL;
 #endif
@@ -2184,6 +2193,8 @@ taskswitch286(uint16_t seg, uint16_t *segdat, int is32)
     uint32_t     *segdat232 = (uint32_t *) segdat2;
     const x86seg *dt;
 
+    x86seg_dcache_flush();
+
     base  = segdat[1] | ((segdat[2] & 0x00ff) << 16);
     limit = segdat[0];
     if (is386) {
@@ -2286,7 +2297,7 @@ taskswitch286(uint16_t seg, uint16_t *segdat, int is32)
         cr0 |= 8;
 
         cr3 = new_cr3;
-        flushmmucache();
+        flushmmucache_cr3();
 
         cpu_state.pc     = new_pc;
         cpu_state.flags  = new_flags;
@@ -2350,7 +2361,7 @@ taskswitch286(uint16_t seg, uint16_t *segdat, int is32)
             CS = new_cs;
             do_seg_load(&cpu_state.seg_cs, segdat2);
             if ((CPL == 3) && (oldcpl != 3))
-                flushmmucache_nopc();
+                flushmmucache_cpl();
 #ifdef USE_NEW_DYNAREC
             oldcpl = CPL;
 #endif
@@ -2531,7 +2542,7 @@ taskswitch286(uint16_t seg, uint16_t *segdat, int is32)
         CS = new_cs;
         do_seg_load(&cpu_state.seg_cs, segdat2);
         if ((CPL == 3) && (oldcpl != 3))
-            flushmmucache_nopc();
+            flushmmucache_cpl();
 #ifdef USE_NEW_DYNAREC
         oldcpl = CPL;
 #endif
@@ -43,6 +43,85 @@ int cgate32;
 
 int intgatesize;
 
+/* Raw descriptors read by selector loads, keyed by their linear address
+   (table base + selector), so a table moved by LGDT/LLDT simply misses.
+   An entry holds as long as no translation was flushed and the RAM page
+   it came from was not written; the privilege checks are still done by
+   the caller on every load. */
+#define SEG_DCACHE_SIZE 256 /* must be a power of two */
+
+typedef struct seg_dcache_t {
+    uint32_t addr;
+    uint32_t map_gen;
+    uint32_t epoch;
+    uint64_t tag;
+    uint64_t phys;
+    uint16_t segdat[4];
+} seg_dcache_t;
+
+static seg_dcache_t seg_dcache[SEG_DCACHE_SIZE];
+static uint32_t     seg_dcache_epoch = 1;
+
+uint64_t seg_dcache_hits   = 0;
+uint64_t seg_dcache_misses = 0;
+
+static __inline seg_dcache_t *
+seg_dcache_entry(uint32_t addr)
+{
+    return &seg_dcache[((addr >> 3) ^ (addr >> 11)) & (SEG_DCACHE_SIZE - 1)];
+}
+
+int
+x86seg_dcache_lookup(uint32_t addr, uint16_t *segdat)
+{
+    const seg_dcache_t *e = seg_dcache_entry(addr);
+
+    if ((e->epoch != seg_dcache_epoch) || (e->addr != addr) || (e->map_gen != mmu_map_gen) ||
+        !mem_watch_valid(e->phys, e->tag)) {
+        seg_dcache_misses++;
+        return 0;
+    }
+
+    memcpy(segdat, e->segdat, sizeof(e->segdat));
+    seg_dcache_hits++;
+    return 1;
+}
+
+void
+x86seg_dcache_fill(uint32_t addr, const uint16_t *segdat)
+{
+    seg_dcache_t *e = seg_dcache_entry(addr);
+    uint32_t      phys;
+    uint64_t      tag;
+
+    /* A descriptor split across two pages would need both watched. */
+    if ((addr & 0xfff) > 0xff8)
+        return;
+
+    cpl_override = 1;
+    phys         = get_phys_noabrt(addr);
+    cpl_override = 0;
+    if ((phys == 0xffffffff) || !(tag = mem_watch_page(phys)))
+        return;
+
+    e->addr    = addr;
+    e->map_gen = mmu_map_gen;
+    e->tag     = tag;
+    e->phys    = phys;
+    e->epoch   = seg_dcache_epoch;
+    memcpy(e->segdat, segdat, sizeof(e->segdat));
+}
+
+/* LGDT, LLDT, task switches and resets. */
+void
+x86seg_dcache_flush(void)
+{
+    if (++seg_dcache_epoch == 0) {
+        memset(seg_dcache, 0x00, sizeof(seg_dcache));
+        seg_dcache_epoch = 1;
+    }
+}
+
 static void
 seg_reset(x86seg *s)
 {
@@ -74,6 +153,8 @@ x86seg_reset(void)
     seg_reset(&cpu_state.seg_fs);
     seg_reset(&cpu_state.seg_gs);
     seg_reset(&cpu_state.seg_ss);
+
+    x86seg_dcache_flush();
 }
 
 void
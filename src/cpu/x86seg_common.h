@@ -40,6 +40,9 @@ extern int     cgate32;
 
 extern int     intgatesize;
 
+extern uint64_t seg_dcache_hits;
+extern uint64_t seg_dcache_misses;
+
 extern void    x86seg_reset(void);
 extern void    x86gen(void);
 extern void    x86de(char *s, uint16_t error);
@@ -50,4 +53,8 @@ extern void    x86ss(char *s, uint16_t error);
 extern void    x86ts(char *s, uint16_t error);
 extern void    do_seg_load(x86seg *s, uint16_t *segdat);
 
+extern int     x86seg_dcache_lookup(uint32_t addr, uint16_t *segdat);
+extern void    x86seg_dcache_fill(uint32_t addr, const uint16_t *segdat);
+extern void    x86seg_dcache_flush(void);
+
 #endif /*EMU_X86SEG_COMMON_H*/
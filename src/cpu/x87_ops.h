@@ -491,6 +491,7 @@ typedef union {
                 x86_int(7);  \
                 return 1;    \
             }                \
+            MMX_SF_FLUSH();  \
         } while (0)
 #endif
 
@@ -548,6 +548,20 @@ device_get_priv(const device_t *dev)
     return (NULL);
 }
 
+const device_t *
+device_get_by_priv(const void *priv)
+{
+    if (priv == NULL)
+        return (NULL);
+
+    for (uint16_t c = 0; c < DEVICE_MAX; c++) {
+        if ((devices[c] != NULL) && (device_priv[c] == priv))
+            return (devices[c]);
+    }
+
+    return (NULL);
+}
+
 int
 device_available(const device_t *dev)
 {
@@ -65,6 +65,10 @@
 #define FLAG_CACHE         0x02
 #define FLAG_PS2           0x04
 
+#define KBC_POLL_PERIOD    (100ULL * TIMER_USEC)
+#define KBC_PARK_POLLS     4  /* idle polls before a timer is parked */
+#define KBC_SENTINEL_POLLS 10 /* a parked device poll still runs every 1 ms */
+
 enum {
     STATE_RESET = 0,       /* KBC reset state, only accepts command AA. */
     STATE_KBC_DELAY_OUT,   /* KBC is sending one single byte. */
@@ -132,6 +136,14 @@ typedef struct atkbc_t {
     pc_timer_t kbc_poll_timer;
     pc_timer_t kbc_dev_poll_timer;
 
+    /* Timer parking while idle, the timestamps are those of the first poll not run. */
+    uint8_t   poll_idle;
+    uint8_t   dev_poll_idle;
+    uint8_t   parked;
+    uint8_t   dev_parked;
+    uint128_t parked_ts;
+    uint128_t dev_parked_ts;
+
     /* P2 pulse callback timer. */
     pc_timer_t pulse_cb;
 
@@ -421,6 +433,7 @@ kbc_delay_to_ob(atkbc_t *dev, uint8_t val, uint8_t channel, uint8_t stat_hi)
 }
 
 static void kbc_at_process_cmd(void *priv);
+static void kbc_at_dev_timer_wake(atkbc_t *dev);
 
 static void
 set_enable_kbd(atkbc_t *dev, uint8_t enable)
@@ -447,6 +460,7 @@ kbc_ibf_process(atkbc_t *dev)
     else {
         set_enable_kbd(dev, 1);
         if ((dev->ports[0] != NULL) && (dev->ports[0]->priv != NULL)) {
+            kbc_at_dev_timer_wake(dev);
             dev->ports[0]->wantcmd = 1;
             dev->ports[0]->dat = dev->ib;
             dev->state         = STATE_SEND_KBD;
@@ -719,29 +733,248 @@ kbc_at_poll_ps2(atkbc_t *dev)
     }
 }
 
+/*
+   Idle timer parking.
+
+   With nothing in the input buffer and nothing coming from either device, the
+   main loop only cycles through its MAIN_* states and each poll is otherwise
+   a no-op, so after a few such polls the timer is stopped. Anything that can
+   change this (a host port access, a device byte, a reset) calls
+   kbc_at_wake() first, which steps the state machine through the polls that
+   were skipped and puts the timer back in phase. The device poll is parked
+   the same way, but since host keystrokes are queued from the UI thread, it
+   keeps looking every KBC_SENTINEL_POLLS polls.
+ */
+static int
+kbc_at_idle(const atkbc_t *dev)
+{
+    if ((dev->status & STAT_IFULL) || dev->do_irq || dev->pending)
+        return 0;
+
+    if ((dev->state < STATE_MAIN_IBF) || (dev->state > STATE_MAIN_BOTH))
+        return 0;
+
+    for (int i = 0; i < 2; i++) {
+        if ((dev->ports[i] != NULL) && (dev->ports[i]->out_new != -1))
+            return 0;
+    }
+
+    return 1;
+}
+
+/* One poll of an idle controller, as done by kbc_at_poll_at() or kbc_at_poll_ps2(). */
+static uint8_t
+kbc_at_idle_step(const atkbc_t *dev, uint8_t state)
+{
+    int kbd_enabled = !(dev->mem[0x20] & 0x10);
+
+    if (kbc_at_do_poll == kbc_at_poll_ps2) {
+        switch (state) {
+            case STATE_MAIN_IBF:
+                if (dev->status & STAT_OFULL)
+                    return state;
+                if (dev->mem[0x20] & 0x20)
+                    return kbd_enabled ? STATE_MAIN_KBD : state;
+                return kbd_enabled ? STATE_MAIN_BOTH : STATE_MAIN_AUX;
+            case STATE_MAIN_BOTH:
+                return STATE_MAIN_AUX;
+            default:
+                return STATE_MAIN_IBF;
+        }
+    }
+
+    if ((state == STATE_MAIN_KBD) || (state == STATE_MAIN_BOTH))
+        return STATE_MAIN_IBF;
+
+    /* STATE_MAIN_AUX falls into the STATE_MAIN_IBF handling on the AT. */
+    if (!(dev->status & STAT_OFULL) && kbd_enabled)
+        return STATE_MAIN_KBD;
+
+    return state;
+}
+
+/* Number of polls with the given period due before now, starting at *ts, which is moved past them. */
+static uint64_t
+kbc_at_polls_due(uint128_t *ts)
+{
+    uint128_t now   = ((uint128_t) tsc + 1) << 32;
+    uint64_t  polls = 0;
+
+    if (*ts < now) {
+        polls = (uint64_t) ((now - *ts - 1) / KBC_POLL_PERIOD) + 1;
+        *ts += (uint128_t) polls * KBC_POLL_PERIOD;
+    }
+
+    return polls;
+}
+
+static void
+kbc_at_rearm(pc_timer_t *timer, uint128_t ts)
+{
+    timer->ts_integer = (uint64_t) (ts >> 32);
+    timer->ts_frac    = (uint32_t) ts;
+    timer_enable(timer);
+}
+
+static void
+kbc_at_wake(atkbc_t *dev)
+{
+    uint128_t ts;
+    uint64_t  polls;
+
+    if (!dev->parked)
+        return;
+
+    dev->parked    = 0;
+    dev->poll_idle = 0;
+
+    ts    = dev->parked_ts;
+    polls = kbc_at_polls_due(&ts);
+
+    /* The idle states repeat every 1, 2 or 3 polls. */
+    if (polls > 6)
+        polls = 6 + (polls % 6);
+    for (; polls > 0; polls--)
+        dev->state = kbc_at_idle_step(dev, dev->state);
+
+    kbc_at_rearm(&dev->kbc_poll_timer, ts);
+}
+
+static void
+kbc_at_park(atkbc_t *dev)
+{
+    if (!kbc_at_idle(dev)) {
+        dev->poll_idle = 0;
+        return;
+    }
+
+    if (dev->poll_idle < KBC_PARK_POLLS) {
+        dev->poll_idle++;
+        return;
+    }
+
+    dev->parked    = 1;
+    dev->parked_ts = ((uint128_t) dev->kbc_poll_timer.ts_integer << 32) | dev->kbc_poll_timer.ts_frac;
+    timer_disable(&dev->kbc_poll_timer);
+}
+
+static int
+kbc_at_ports_idle(void)
+{
+    for (int i = 0; i < 2; i++) {
+        const kbc_at_port_t *port = kbc_at_ports[i];
+
+        if ((port == NULL) || (port->priv == NULL))
+            continue;
+
+        if ((port->idle == NULL) || (port->skip == NULL) || !port->idle(port->priv))
+            return 0;
+    }
+
+    return 1;
+}
+
+static void
+kbc_at_ports_skip(uint64_t polls)
+{
+    if (polls == 0)
+        return;
+
+    for (int i = 0; i < 2; i++) {
+        if ((kbc_at_ports[i] != NULL) && (kbc_at_ports[i]->priv != NULL))
+            kbc_at_ports[i]->skip(kbc_at_ports[i]->priv, polls);
+    }
+}
+
+static void
+kbc_at_dev_timer_wake(atkbc_t *dev)
+{
+    uint128_t ts;
+
+    if (!dev->dev_parked)
+        return;
+
+    dev->dev_parked    = 0;
+    dev->dev_poll_idle = 0;
+
+    ts = dev->dev_parked_ts;
+    kbc_at_ports_skip(kbc_at_polls_due(&ts));
+
+    kbc_at_rearm(&dev->kbc_dev_poll_timer, ts);
+}
+
+void
+kbc_at_dev_wake(kbc_at_port_t *port)
+{
+    if ((port != NULL) && (port->kbc != NULL))
+        kbc_at_dev_timer_wake((atkbc_t *) port->kbc);
+}
+
+static void
+kbc_at_dev_park(atkbc_t *dev)
+{
+    if (!kbc_at_ports_idle()) {
+        dev->dev_poll_idle = 0;
+        return;
+    }
+
+    if (dev->dev_poll_idle < KBC_PARK_POLLS) {
+        dev->dev_poll_idle++;
+        return;
+    }
+
+    /* Keep the sentinel on the poll grid so that the skipped polls can be counted exactly. */
+    dev->dev_parked    = 1;
+    dev->dev_parked_ts = ((uint128_t) dev->kbc_dev_poll_timer.ts_integer << 32) | dev->kbc_dev_poll_timer.ts_frac;
+    timer_advance_u64(&dev->kbc_dev_poll_timer, (KBC_SENTINEL_POLLS - 1) * KBC_POLL_PERIOD);
+}
+
 static void
 kbc_at_poll(void *priv)
 {
     atkbc_t *dev = (atkbc_t *) priv;
 
-    timer_advance_u64(&dev->kbc_poll_timer, (100ULL * TIMER_USEC));
+    timer_advance_u64(&dev->kbc_poll_timer, KBC_POLL_PERIOD);
 
     /* TODO: Implement the password security state. */
     kbc_at_do_poll(dev);
+
+    kbc_at_park(dev);
 }
 
 static void
 kbc_at_dev_poll(void *priv)
 {
-    atkbc_t *dev = (atkbc_t *) priv;
+    atkbc_t  *dev = (atkbc_t *) priv;
+    uint128_t ts;
 
-    timer_advance_u64(&dev->kbc_dev_poll_timer, (100ULL * TIMER_USEC));
+    if (dev->dev_parked) {
+        if (kbc_at_ports_idle()) {
+            timer_advance_u64(&dev->kbc_dev_poll_timer, KBC_SENTINEL_POLLS * KBC_POLL_PERIOD);
+            return;
+        }
+
+        /* Input arrived, catch up with the polls before this one and run it. */
+        ts = ((uint128_t) dev->kbc_dev_poll_timer.ts_integer << 32) | dev->kbc_dev_poll_timer.ts_frac;
+        kbc_at_ports_skip((uint64_t) ((ts - dev->dev_parked_ts) / KBC_POLL_PERIOD));
+        dev->dev_parked    = 0;
+        dev->dev_poll_idle = 0;
+    }
+
+    timer_advance_u64(&dev->kbc_dev_poll_timer, KBC_POLL_PERIOD);
 
     if ((kbc_at_ports[0] != NULL) && (kbc_at_ports[0]->priv != NULL))
         kbc_at_ports[0]->poll(kbc_at_ports[0]->priv);
 
     if ((kbc_at_ports[1] != NULL) && (kbc_at_ports[1]->priv != NULL))
         kbc_at_ports[1]->poll(kbc_at_ports[1]->priv);
+
+    for (int i = 0; i < 2; i++) {
+        if ((kbc_at_ports[i] != NULL) && (kbc_at_ports[i]->out_new != -1))
+            kbc_at_wake(dev);
+    }
+
+    kbc_at_dev_park(dev);
 }
 
 static void
@@ -829,6 +1062,8 @@ kbc_at_write_p(void *priv, uint8_t port, uint8_t mask, uint8_t val)
     atkbc_t *dev = (atkbc_t *) priv;
     uint8_t *p   = (port == 2) ? &dev->p2 : &dev->p1;
 
+    kbc_at_wake(dev);
+
     *p = (*p & mask) | val;
 }
 
@@ -891,6 +1126,8 @@ pulse_poll(void *priv)
 {
     atkbc_t *dev = (atkbc_t *) priv;
 
+    kbc_at_wake(dev);
+
     kbc_at_log("ATkbc: pulse_poll(): P2 now: %02X\n", dev->p2 | dev->old_p2);
     write_p2(dev, dev->p2 | dev->old_p2);
 }
@@ -973,6 +1210,8 @@ kbc_at_set_ps2(void *priv, const uint8_t ps2)
 {
     atkbc_t *dev = (atkbc_t *) priv;
 
+    kbc_at_wake(dev);
+
     dev->ami_flags = (dev->ami_flags & 0xfe) | (!!ps2);
     dev->misc_flags &= ~FLAG_PS2;
     if (ps2) {
@@ -2611,6 +2850,7 @@ kbc_at_process_cmd(void *priv)
                 if (dev->misc_flags & FLAG_PS2) {
                     set_enable_aux(dev, 1);
                     if ((dev->ports[1] != NULL) && (dev->ports[1]->priv != NULL)) {
+                        kbc_at_dev_timer_wake(dev);
                         dev->ports[1]->wantcmd = 1;
                         dev->ports[1]->dat = dev->ib;
                         dev->state         = STATE_SEND_AUX;
@@ -2631,6 +2871,8 @@ kbc_at_port_1_write(uint16_t port, uint8_t val, void *priv)
 
     kbc_at_log("ATkbc: [%04X:%08X] write(%04X) = %02X\n", CS, cpu_state.pc, port, val);
 
+    kbc_at_wake(dev);
+
     dev->status &= ~STAT_CD;
 
     if (fast_a20 && dev->wantdata && (dev->command == 0xd1)) {
@@ -2663,6 +2905,8 @@ kbc_at_port_2_write(uint16_t port, uint8_t val, void *priv)
 
     kbc_at_log("ATkbc: [%04X:%08X] write(%04X) = %02X\n", CS, cpu_state.pc, port, val);
 
+    kbc_at_wake(dev);
+
     dev->status |= STAT_CD;
 
     if (fast_a20 && (val == 0xd1)) {
@@ -2729,6 +2973,8 @@ kbc_at_port_1_read(uint16_t port, void *priv)
     if (machine_has_flags_ex(MACHINE_PS2_KBC))
         cycles -= ISA_CYCLES(8);
 
+    kbc_at_wake(dev);
+
     ret = dev->ob;
     dev->status &= ~STAT_OFULL;
     /*
@@ -2766,6 +3012,9 @@ kbc_at_reset(void *priv)
 {
     atkbc_t *dev = (atkbc_t *) priv;
 
+    kbc_at_wake(dev);
+    kbc_at_dev_timer_wake(dev);
+
     dev->status        = STAT_UNLOCKED;
     dev->mem[0x20]     = 0x01;
     dev->mem[0x20]    |= CCB_TRANSLATE;
@@ -3018,6 +3267,7 @@ kbc_at_init(const device_t *info)
     for (int i = 0; i < max_ports; i++) {
         kbc_at_ports[i] = (kbc_at_port_t *) calloc(1, sizeof(kbc_at_port_t));
         kbc_at_ports[i]->out_new = -1;
+        kbc_at_ports[i]->kbc     = dev;
     }
 
     dev->ports[0] = kbc_at_ports[0];
@@ -162,9 +162,38 @@ kbc_at_dev_poll(void *priv)
     }
 }
 
+/* Nothing to process and nothing to send, only the main loop is running. */
+static int
+kbc_at_dev_idle(void *priv)
+{
+    const atkbc_dev_t *dev = (atkbc_dev_t *) priv;
+
+    if ((dev->state != DEV_STATE_MAIN_1) && (dev->state != DEV_STATE_MAIN_2))
+        return 0;
+
+    return !dev->port->wantcmd && (dev->port->out_new == -1) &&
+           (dev->queue_start == dev->queue_end) && (dev->cmd_queue_start == dev->cmd_queue_end);
+}
+
+/* Advance an idle device by the given number of polls, see kbc_at_dev_poll(). */
+static void
+kbc_at_dev_skip(void *priv, uint64_t polls)
+{
+    atkbc_dev_t *dev = (atkbc_dev_t *) priv;
+
+    if (dev->ignore || !(*dev->scan)) {
+        /* Main loop #2 goes straight back to #1. */
+        if (polls & 1)
+            dev->state = (dev->state == DEV_STATE_MAIN_1) ? DEV_STATE_MAIN_2 : DEV_STATE_MAIN_1;
+    } else if (polls)
+        dev->state = DEV_STATE_MAIN_2;
+}
+
 void
 kbc_at_dev_reset(atkbc_dev_t *dev, int do_fa)
 {
+    kbc_at_dev_wake(dev->port);
+
     dev->port->out_new = -1;
     dev->port->wantcmd = 0;
 
@@ -193,6 +222,8 @@ kbc_at_dev_init(uint8_t inst)
     if (dev->port != NULL) {
         dev->port->priv = dev;
         dev->port->poll = kbc_at_dev_poll;
+        dev->port->idle = kbc_at_dev_idle;
+        dev->port->skip = kbc_at_dev_skip;
     }
 
     /* Return our private data to the I/O layer. */
@@ -335,8 +335,10 @@ ps2_poll(void *priv)
     int cond = (mouse_capture || (video_fullscreen && !fullscreen_ui_visible)) && mouse_scan && (dev->mode == MODE_STREAM) &&
                mouse_state_changed() && (kbc_at_dev_queue_pos(dev, 1) < (FIFO_SIZE - packet_size));
 
-    if (cond)
+    if (cond) {
+        kbc_at_dev_wake(dev->port);
         ps2_report_coordinates(dev, 1);
+    }
 
     return !cond;
 }
@@ -153,6 +153,39 @@ serial_clear_timeout(serial_t *dev)
     serial_update_ints(dev);
 }
 
+/* Nothing can reach the RSR until a device calls serial_write_fifo() or the
+   loopback transmits, so the receive poll is stopped meanwhile and resumed in
+   the phase it would have had. */
+static void
+serial_receive_park(serial_t *dev)
+{
+    dev->receive_parked    = 1;
+    dev->receive_parked_ts = ((uint128_t) dev->receive_timer.ts_integer << 32) | dev->receive_timer.ts_frac;
+    timer_disable(&dev->receive_timer);
+}
+
+static void
+serial_receive_wake(serial_t *dev)
+{
+    uint128_t now = ((uint128_t) tsc + 1) << 32;
+    uint128_t ts  = dev->receive_parked_ts;
+    uint64_t  period;
+
+    if (!dev->receive_parked)
+        return;
+
+    dev->receive_parked = 0;
+
+    /* Same rounding as timer_on_auto(). */
+    period = (uint64_t) (dev->transmit_period * ((double) TIMER_USEC));
+    if ((period != 0) && (ts < now))
+        ts += (uint128_t) (((now - ts - 1) / period) + 1) * period;
+
+    dev->receive_timer.ts_integer = (uint64_t) (ts >> 32);
+    dev->receive_timer.ts_frac    = (uint32_t) ts;
+    timer_enable(&dev->receive_timer);
+}
+
 static void
 serial_receive_timer(void *priv)
 {
@@ -202,6 +235,9 @@ serial_receive_timer(void *priv)
             serial_update_ints(dev);
         }
     }
+
+    if (dev->out_new == 0xffff)
+        serial_receive_park(dev);
 }
 
 static void
@@ -212,6 +248,8 @@ write_fifo(serial_t *dev, uint8_t dat)
                ((dev->type >= SERIAL_16550) && dev->fifo_enabled) ?
                fifo_get_count(dev->rcvr_fifo) : 0);
 
+    serial_receive_wake(dev);
+
     /* Do this here, because in non-FIFO mode, this is read directly. */
     dev->out_new = (uint16_t) dat;
 }
@@ -364,6 +402,7 @@ static void
 serial_update_speed(serial_t *dev)
 {
     serial_log("serial_update_speed(%lf)\n", dev->transmit_period);
+    dev->receive_parked = 0;
     timer_on_auto(&dev->receive_timer, /* dev->bits * */ dev->transmit_period);
 
     if (dev->transmit_enabled & 3)
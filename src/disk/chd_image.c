@@ -0,0 +1,409 @@
+/*
+ * 86Box    A hypervisor and IBM PC system emulator that specializes in
+ *          running old operating systems and software designed for IBM
+ *          PC systems and compatibles from 1981 through fairly recent
+ *          system designs based on the PCI bus.
+ *
+ *          This file is part of the 86Box distribution.
+ *
+ *          CHD (compressed hunks of data) image reader.
+ *
+ *          The container and its codecs (zlib, LZMA, FLAC, Huffman)
+ *          are handled by libchdr; this layer keeps an LRU cache of
+ *          decompressed hunks so that sector-sized reads do not
+ *          decompress the same hunk over and over, and optionally
+ *          runs a worker thread that decompresses the hunks following
+ *          a sequential read ahead of time, so that CD-DA playback
+ *          and installs from compressed images run at raw speed.
+ *
+ *          libchdr is not thread safe, every chd_read() goes through
+ *          chd_mutex; the cache has its own lock so that hits never
+ *          wait for a decompression in progress. Lock order is
+ *          chd_mutex, then cache_mutex.
+ */
+#include <stdarg.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <wchar.h>
+#include <libchdr/chd.h>
+#define HAVE_STDARG_H
+#include <86box/86box.h>
+#include <86box/plat.h>
+#include <86box/thread.h>
+#include <86box/chd_image.h>
+
+#define CHD_CACHE_BYTES   (8 << 20) /* decompressed hunks kept per image */
+#define CHD_CACHE_MIN     16
+#define CHD_CACHE_MAX     256
+#define CHD_READ_AHEAD    4         /* hunks decompressed ahead of a sequential read */
+#define CHD_HUNK_NONE     0xffffffff
+
+typedef struct chd_hunk_t {
+    uint32_t hunk;
+    uint32_t stamp;
+    uint8_t *data;
+} chd_hunk_t;
+
+struct chd_image_t {
+    chd_file *chd;
+    int       refcount;
+
+    uint32_t hunk_bytes;
+    uint32_t total_hunks;
+    uint64_t logical_bytes;
+
+    mutex_t *chd_mutex;
+    uint8_t *scratch; /* Decompression target, owned by whoever holds chd_mutex. */
+
+    mutex_t    *cache_mutex;
+    chd_hunk_t *cache;
+    int         cache_entries;
+    int         last_hit;
+    uint32_t    stamp;
+
+    /* Read-ahead, protected by cache_mutex. */
+    thread_t    *thread;
+    event_t     *wake;
+    volatile int closing;
+    uint32_t     last_hunk;
+    uint32_t     ra_next;
+    uint32_t     ra_end;
+};
+
+#ifdef ENABLE_CHD_IMAGE_LOG
+int chd_image_do_log = ENABLE_CHD_IMAGE_LOG;
+
+static void
+chd_image_log(const char *fmt, ...)
+{
+    va_list ap;
+
+    if (chd_image_do_log) {
+        va_start(ap, fmt);
+        pclog_ex(fmt, ap);
+        va_end(ap);
+    }
+}
+#else
+#    define chd_image_log(fmt, ...)
+#endif
+
+/* Must be called with cache_mutex held. */
+static chd_hunk_t *
+chd_cache_find(chd_image_t *img, uint32_t hunk)
+{
+    chd_hunk_t *ent = &img->cache[img->last_hit];
+
+    if (ent->hunk == hunk)
+        return ent;
+
+    for (int i = 0; i < img->cache_entries; i++) {
+        if (img->cache[i].hunk == hunk) {
+            img->last_hit = i;
+            return &img->cache[i];
+        }
+    }
+
+    return NULL;
+}
+
+/* Must be called with both mutexes held; the scratch buffer holding the
+   freshly decompressed hunk is swapped with the evicted entry's buffer. */
+static chd_hunk_t *
+chd_cache_insert(chd_image_t *img, uint32_t hunk)
+{
+    chd_hunk_t *ent;
+    uint8_t    *data;
+    int         victim = 0;
+
+    for (int i = 0; i < img->cache_entries; i++) {
+        if (img->cache[i].hunk == CHD_HUNK_NONE) {
+            victim = i;
+            break;
+        }
+        if ((img->stamp - img->cache[i].stamp) > (img->stamp - img->cache[victim].stamp))
+            victim = i;
+    }
+
+    ent          = &img->cache[victim];
+    data         = ent->data;
+    ent->data    = img->scratch;
+    img->scratch = data;
+    ent->hunk    = hunk;
+    ent->stamp   = img->stamp++;
+
+    img->last_hit = victim;
+
+    return ent;
+}
+
+/* Makes sure a hunk is in the cache; with buf, also copies part of it out.
+   Returns 0 on success, -1 on a decompression error. */
+static int
+chd_hunk_get(chd_image_t *img, uint32_t hunk, uint8_t *buf, uint32_t offset, uint32_t count)
+{
+    chd_hunk_t *ent;
+    chd_error   err;
+
+    thread_wait_mutex(img->cache_mutex);
+    ent = chd_cache_find(img, hunk);
+    if (ent != NULL) {
+        ent->stamp = img->stamp++;
+        if (buf != NULL)
+            memcpy(buf, ent->data + offset, count);
+        thread_release_mutex(img->cache_mutex);
+        return 0;
+    }
+    thread_release_mutex(img->cache_mutex);
+
+    thread_wait_mutex(img->chd_mutex);
+
+    /* The read-ahead thread may have decompressed it while we waited. */
+    thread_wait_mutex(img->cache_mutex);
+    ent = chd_cache_find(img, hunk);
+    thread_release_mutex(img->cache_mutex);
+
+    if (ent == NULL) {
+        err = chd_read(img->chd, hunk, img->scratch);
+        if (err != CHDERR_NONE) {
+            chd_image_log("CHD: Error decompressing hunk %u: %s\n", hunk, chd_error_string(err));
+            thread_release_mutex(img->chd_mutex);
+            return -1;
+        }
+    }
+
+    thread_wait_mutex(img->cache_mutex);
+    if (ent == NULL)
+        ent = chd_cache_insert(img, hunk);
+    else
+        ent->stamp = img->stamp++;
+    if (buf != NULL)
+        memcpy(buf, ent->data + offset, count);
+    thread_release_mutex(img->cache_mutex);
+
+    thread_release_mutex(img->chd_mutex);
+
+    return 0;
+}
+
+static void
+chd_read_ahead_thread(void *priv)
+{
+    chd_image_t *img = (chd_image_t *) priv;
+    uint32_t     hunk;
+    int          present;
+
+    while (1) {
+        thread_wait_event(img->wake, -1);
+        thread_reset_event(img->wake);
+
+        while (!img->closing) {
+            thread_wait_mutex(img->cache_mutex);
+            if (img->ra_next >= img->ra_end) {
+                thread_release_mutex(img->cache_mutex);
+                break;
+            }
+            hunk    = img->ra_next++;
+            present = (chd_cache_find(img, hunk) != NULL);
+            thread_release_mutex(img->cache_mutex);
+
+            if (!present && (chd_hunk_get(img, hunk, NULL, 0, 0) < 0))
+                break;
+        }
+
+        if (img->closing)
+            break;
+    }
+}
+
+/* Called after a read ending in last_hunk; a read that continues the
+   previous one queues the next hunks for the worker thread. */
+static void
+chd_read_ahead(chd_image_t *img, uint32_t first_hunk, uint32_t last_hunk)
+{
+    uint32_t end;
+    int      kick = 0;
+
+    thread_wait_mutex(img->cache_mutex);
+    if ((first_hunk == img->last_hunk) || (first_hunk == (img->last_hunk + 1))) {
+        end = last_hunk + 1 + CHD_READ_AHEAD;
+        if (end > img->total_hunks)
+            end = img->total_hunks;
+        if (img->ra_next <= last_hunk)
+            img->ra_next = last_hunk + 1;
+        if (end > img->ra_end) {
+            img->ra_end = end;
+            kick        = (img->ra_next < img->ra_end);
+        }
+    } else {
+        /* Seek, drop whatever was queued. */
+        img->ra_next = img->ra_end = 0;
+    }
+    img->last_hunk = last_hunk;
+    thread_release_mutex(img->cache_mutex);
+
+    if (kick)
+        thread_set_event(img->wake);
+}
+
+int
+chd_image_read(chd_image_t *img, uint8_t *buf, uint64_t offset, uint32_t count)
+{
+    uint32_t hunk       = (uint32_t) (offset / img->hunk_bytes);
+    uint32_t off        = (uint32_t) (offset % img->hunk_bytes);
+    uint32_t first_hunk = hunk;
+    uint32_t n;
+
+    if ((offset + count) > ((uint64_t) img->total_hunks * img->hunk_bytes))
+        return -1;
+
+    while (count > 0) {
+        n = img->hunk_bytes - off;
+        if (n > count)
+            n = count;
+
+        if (chd_hunk_get(img, hunk, buf, off, n) < 0)
+            return -1;
+
+        buf += n;
+        count -= n;
+        off = 0;
+        if (count > 0)
+            hunk++;
+    }
+
+    if (img->thread != NULL)
+        chd_read_ahead(img, first_hunk, hunk);
+
+    return 0;
+}
+
+uint64_t
+chd_image_get_length(chd_image_t *img)
+{
+    return img->logical_bytes;
+}
+
+int
+chd_image_get_metadata(chd_image_t *img, uint32_t tag, uint32_t index, char *buf, uint32_t len)
+{
+    uint32_t  result_len = 0;
+    chd_error err;
+
+    thread_wait_mutex(img->chd_mutex);
+    err = chd_get_metadata(img->chd, tag, index, buf, len - 1, &result_len, NULL, NULL);
+    thread_release_mutex(img->chd_mutex);
+
+    if (err != CHDERR_NONE)
+        return 0;
+
+    buf[(result_len < len) ? result_len : (len - 1)] = '\0';
+    return 1;
+}
+
+int
+chd_image_is_chd(const char *fn)
+{
+    char  magic[8];
+    FILE *fp = plat_fopen(fn, "rb");
+    int   ret;
+
+    if (fp == NULL)
+        return 0;
+
+    ret = (fread(magic, 1, 8, fp) == 8) && !memcmp(magic, "MComprHD", 8);
+    fclose(fp);
+
+    return ret;
+}
+
+chd_image_t *
+chd_image_open(const char *fn, int read_ahead)
+{
+    chd_image_t      *img;
+    chd_file         *chd = NULL;
+    const chd_header *hdr;
+    chd_error         err;
+
+    err = chd_open(fn, CHD_OPEN_READ, NULL, &chd);
+    if (err != CHDERR_NONE) {
+        chd_image_log("CHD: Unable to open %s: %s\n", fn, chd_error_string(err));
+        return NULL;
+    }
+
+    hdr = chd_get_header(chd);
+    if ((hdr == NULL) || (hdr->hunkbytes == 0) || (hdr->totalhunks == 0)) {
+        chd_close(chd);
+        return NULL;
+    }
+
+    img = (chd_image_t *) calloc(1, sizeof(chd_image_t));
+
+    img->chd           = chd;
+    img->refcount      = 1;
+    img->hunk_bytes    = hdr->hunkbytes;
+    img->total_hunks   = hdr->totalhunks;
+    img->logical_bytes = hdr->logicalbytes;
+    img->last_hunk     = CHD_HUNK_NONE - 1;
+
+    img->cache_entries = CHD_CACHE_BYTES / img->hunk_bytes;
+    if (img->cache_entries < CHD_CACHE_MIN)
+        img->cache_entries = CHD_CACHE_MIN;
+    else if (img->cache_entries > CHD_CACHE_MAX)
+        img->cache_entries = CHD_CACHE_MAX;
+    if ((uint32_t) img->cache_entries > img->total_hunks)
+        img->cache_entries = img->total_hunks;
+
+    img->cache = (chd_hunk_t *) calloc(img->cache_entries, sizeof(chd_hunk_t));
+    for (int i = 0; i < img->cache_entries; i++) {
+        img->cache[i].hunk = CHD_HUNK_NONE;
+        img->cache[i].data = (uint8_t *) malloc(img->hunk_bytes);
+    }
+    img->scratch = (uint8_t *) malloc(img->hunk_bytes);
+
+    img->chd_mutex   = thread_create_mutex();
+    img->cache_mutex = thread_create_mutex();
+
+    if (read_ahead) {
+        img->wake   = thread_create_event();
+        img->thread = thread_create(chd_read_ahead_thread, img);
+    }
+
+    chd_image_log("CHD: Opened %s, %u hunks of %u bytes, %i cached\n",
+                  fn, img->total_hunks, img->hunk_bytes, img->cache_entries);
+
+    return img;
+}
+
+void
+chd_image_ref(chd_image_t *img)
+{
+    img->refcount++;
+}
+
+void
+chd_image_close(chd_image_t *img)
+{
+    if ((img == NULL) || (--img->refcount > 0))
+        return;
+
+    if (img->thread != NULL) {
+        img->closing = 1;
+        thread_set_event(img->wake);
+        thread_wait(img->thread);
+        thread_destroy_event(img->wake);
+    }
+
+    chd_close(img->chd);
+
+    thread_close_mutex(img->cache_mutex);
+    thread_close_mutex(img->chd_mutex);
+
+    for (int i = 0; i < img->cache_entries; i++)
+        free(img->cache[i].data);
+    free(img->cache);
+    free(img->scratch);
+    free(img);
+}
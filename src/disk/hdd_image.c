@@ -37,6 +37,8 @@
 #include <86box/plat.h>
 #include <86box/random.h>
 #include <86box/hdd.h>
+#include <86box/chd_image.h>
+#include <86box/trace.h>
 #include "minivhd/minivhd.h"
 #include "minivhd/internal.h"
 
@@ -44,14 +46,18 @@
 #define HDD_IMAGE_HDI 1
 #define HDD_IMAGE_HDX 2
 #define HDD_IMAGE_VHD 3
+#define HDD_IMAGE_CHD 4
 
 typedef struct hdd_image_t {
     FILE     *file; /* Used for HDD_IMAGE_RAW, HDD_IMAGE_HDI, and HDD_IMAGE_HDX. */
     MVHDMeta *vhd;  /* Used for HDD_IMAGE_VHD. */
+#ifdef USE_CHD
+    chd_image_t *chd; /* Used for HDD_IMAGE_CHD, always mounted read-only. */
+#endif
     uint32_t  base;
     uint32_t  pos;
     uint32_t  last_sector;
-    uint8_t   type; /* HDD_IMAGE_RAW, HDD_IMAGE_HDI, HDD_IMAGE_HDX, or HDD_IMAGE_VHD */
+    uint8_t   type; /* HDD_IMAGE_RAW, HDD_IMAGE_HDI, HDD_IMAGE_HDX, HDD_IMAGE_VHD, or HDD_IMAGE_CHD */
     uint8_t   loaded;
     uint8_t   is_block_device; /* 1 if this is a raw block device (e.g., /dev/disk4s1) */
 } hdd_image_t;
@@ -259,6 +265,76 @@ hdd_image_init(void)
         memset(&hdd_images[i], 0, sizeof(hdd_image_t));
 }
 
+#ifdef USE_CHD
+static void
+hdd_image_chd_close(uint8_t id)
+{
+    hdd_image_t *img = &hdd_images[id];
+
+    chd_image_close(img->chd);
+    img->chd = NULL;
+}
+
+static int
+hdd_image_chd_load(int id, const char *fn)
+{
+    hdd_image_t *img = &hdd_images[id];
+    char         meta[256];
+    uint32_t     cyls;
+    uint32_t     heads;
+    uint32_t     secs;
+    uint32_t     bps;
+    uint64_t     full_size;
+
+    img->chd = chd_image_open(fn, 1);
+    if (img->chd == NULL) {
+        hdd_image_log("CHD: Unable to open image\n");
+        memset(hdd[id].fn, 0, sizeof(hdd[id].fn));
+        return 0;
+    }
+
+    if (!chd_image_get_metadata(img->chd, CHD_TAG_HARD_DISK, 0, meta, sizeof(meta)) ||
+        (sscanf(meta, "CYLS:%u,HEADS:%u,SECS:%u,BPS:%u", &cyls, &heads, &secs, &bps) != 4) ||
+        (bps != 512)) {
+        /* Not a hard disk CHD, or the sector size is not 512. */
+        hdd_image_log("CHD: Missing hard disk metadata or sector size is not 512\n");
+        hdd_image_chd_close(id);
+        memset(hdd[id].fn, 0, sizeof(hdd[id].fn));
+        return 0;
+    }
+
+    hdd[id].tracks = cyls;
+    hdd[id].hpc    = heads;
+    hdd[id].spt    = secs;
+
+    full_size = ((uint64_t) secs) * ((uint64_t) heads) * ((uint64_t) cyls) << 9LL;
+    if (full_size > chd_image_get_length(img->chd))
+        full_size = chd_image_get_length(img->chd);
+
+    img->type        = HDD_IMAGE_CHD;
+    img->last_sector = (uint32_t) (full_size >> 9) - 1;
+    img->loaded      = 1;
+
+    /* Compressed hunks cannot be rewritten in place, so the guest gets write errors. */
+    hdd[id].wp = 1;
+
+    return 1;
+}
+
+static int
+hdd_image_chd_read(uint8_t id, uint32_t sector, uint32_t count, uint8_t *buffer)
+{
+    hdd_image_t *img = &hdd_images[id];
+
+    if (chd_image_read(img->chd, buffer, (uint64_t) sector << 9LL, count << 9) < 0)
+        return -1;
+
+    img->pos = sector + count;
+
+    return 0;
+}
+#endif
+
 int
 hdd_image_load(int id)
 {
@@ -292,6 +368,10 @@ hdd_image_load(int id)
             mvhd_close(hdd_images[id].vhd);
             hdd_images[id].vhd = NULL;
         }
+#ifdef USE_CHD
+        else if (hdd_images[id].chd)
+            hdd_image_chd_close(id);
+#endif
         hdd_images[id].loaded = 0;
     }
 
@@ -333,6 +413,11 @@ hdd_image_load(int id)
         return 1;
     }
 
+#ifdef USE_CHD
+    if (chd_image_is_chd(fn))
+        return hdd_image_chd_load(id, fn);
+#endif
+
     is_hdx[0] = image_is_hdx(fn, 0);
     is_hdx[1] = image_is_hdx(fn, 1);
 
@@ -565,7 +650,7 @@ hdd_image_seek(uint8_t id, uint32_t sector)
     addr         = (uint64_t) sector << 9LL;
 
     hdd_images[id].pos = sector;
-    if (hdd_images[id].type != HDD_IMAGE_VHD) {
+    if ((hdd_images[id].type != HDD_IMAGE_VHD) && (hdd_images[id].type != HDD_IMAGE_CHD)) {
         if (!hdd_images[id].file || (fseeko64(hdd_images[id].file, addr + hdd_images[id].base, SEEK_SET) == -1)) {
             hdd_image_log("hdd_image_seek(): Error seeking\n");
             return -1;
@@ -580,26 +665,33 @@ hdd_image_read(uint8_t id, uint32_t sector, uint32_t count, uint8_t *buffer)
 {
     int    non_transferred_sectors;
     size_t num_read;
+    int    ret = 0;
+
+    TRACE_NAMED_ENTER("disk", "hdd read");
 
     if (hdd_images[id].type == HDD_IMAGE_VHD) {
         hdd_images[id].vhd->error = 0;
         non_transferred_sectors   = mvhd_read_sectors(hdd_images[id].vhd, sector, count, buffer);
         hdd_images[id].pos        = sector + count - non_transferred_sectors - 1;
         if (hdd_images[id].vhd->error)
-            return -1;
+            ret = -1;
+#ifdef USE_CHD
+    } else if (hdd_images[id].type == HDD_IMAGE_CHD) {
+        ret = hdd_image_chd_read(id, sector, count, buffer);
+#endif
+    } else if (!hdd_images[id].file || (fseeko64(hdd_images[id].file, ((uint64_t) (sector) << 9LL) + hdd_images[id].base, SEEK_SET) == -1)) {
+        hdd_image_log("Hard disk image %i: Read error during seek\n", id);
+        ret = -1;
     } else {
-        if (!hdd_images[id].file || (fseeko64(hdd_images[id].file, ((uint64_t) (sector) << 9LL) + hdd_images[id].base, SEEK_SET) == -1)) {
-            hdd_image_log("Hard disk image %i: Read error during seek\n", id);
-            return -1;
-        }
-
         num_read           = fread(buffer, 512, count, hdd_images[id].file);
         hdd_images[id].pos = sector + num_read;
         if ((num_read < count) && !feof(hdd_images[id].file))
-            return -1;
+            ret = -1;
     }
 
-    return 0;
+    TRACE_LEAVE();
+
+    return ret;
 }
 
 uint32_t
@@ -636,27 +728,35 @@ hdd_image_write(uint8_t id, uint32_t sector, uint32_t count, uint8_t *buffer)
 {
     int    non_transferred_sectors;
     size_t num_write;
+    int    ret = 0;
+
+    TRACE_NAMED_ENTER("disk", "hdd write");
 
     if (hdd_images[id].type == HDD_IMAGE_VHD) {
         hdd_images[id].vhd->error = 0;
         non_transferred_sectors   = mvhd_write_sectors(hdd_images[id].vhd, sector, count, buffer);
         hdd_images[id].pos        = sector + count - non_transferred_sectors - 1;
         if (hdd_images[id].vhd->error)
-            return -1;
+            ret = -1;
+#ifdef USE_CHD
+    } else if (hdd_images[id].type == HDD_IMAGE_CHD) {
+        hdd_image_log("Hard disk image %i: Write to a read-only CHD image\n", id);
+        ret = -1;
+#endif
+    } else if (!hdd_images[id].file || (fseeko64(hdd_images[id].file, ((uint64_t) (sector) << 9LL) + hdd_images[id].base, SEEK_SET) == -1)) {
+        hdd_image_log("Hard disk image %i: Write error during seek\n", id);
+        ret = -1;
     } else {
-        if (!hdd_images[id].file || (fseeko64(hdd_images[id].file, ((uint64_t) (sector) << 9LL) + hdd_images[id].base, SEEK_SET) == -1)) {
-            hdd_image_log("Hard disk image %i: Write error during seek\n", id);
-            return -1;
-        }
-
         num_write          = fwrite(buffer, 512, count, hdd_images[id].file);
         hdd_images[id].pos = sector + num_write;
         fflush(hdd_images[id].file);
         if (num_write < count)
-            return -1;
+            ret = -1;
     }
 
-    return 0;
+    TRACE_LEAVE();
+
+    return ret;
 }
 
 int
@@ -685,6 +785,10 @@ hdd_image_zero(uint8_t id, uint32_t sector, uint32_t count)
         hdd_images[id].pos          = sector + count - non_transferred_sectors - 1;
         if (hdd_images[id].vhd->error)
             return -1;
+#ifdef USE_CHD
+    } else if (hdd_images[id].type == HDD_IMAGE_CHD) {
+        return -1;
+#endif
     } else {
         memset(empty_sector, 0, 512);
 
@@ -750,6 +854,10 @@ hdd_image_unload(uint8_t id, UNUSED(int fn_preserve))
             mvhd_close(hdd_images[id].vhd);
             hdd_images[id].vhd = NULL;
         }
+#ifdef USE_CHD
+        else if (hdd_images[id].chd != NULL)
+            hdd_image_chd_close(id);
+#endif
         hdd_images[id].loaded = 0;
     }
 
@@ -773,6 +881,10 @@ hdd_image_close(uint8_t id)
         mvhd_close(hdd_images[id].vhd);
         hdd_images[id].vhd = NULL;
     }
+#ifdef USE_CHD
+    else if (hdd_images[id].chd != NULL)
+        hdd_image_chd_close(id);
+#endif
 
     memset(&hdd_images[id], 0, sizeof(hdd_image_t));
     hdd_images[id].loaded = 0;
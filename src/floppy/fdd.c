@@ -113,6 +113,12 @@ pc_timer_t fdd_seek_timer[FDD_NUM];
 int        fdd_seek_in_progress[FDD_NUM] = { 0, 0, 0, 0 };
 
 static int fdd_notfound = 0;
+
+/* Motor on but the controller has nothing for the drive to do: the per-bit
+   poll timer is stopped and fdd_parked_ts holds the 32:32 time of the first
+   poll that has not been run. fdd_sync() replays the rotation since then. */
+static int       fdd_parked[FDD_NUM];
+static uint128_t fdd_parked_ts[FDD_NUM];
 static int driveloaders[FDD_NUM];
 static int fdd_audio_profile[FDD_NUM] = { 0 };
 
@@ -328,6 +334,8 @@ fdd_get_from_internal_name(char *s)
 void
 fdd_do_seek(int drive, int track)
 {
+    fdd_sync(drive);
+
     if (drives[drive].seek)
         drives[drive].seek(drive, track);
 }
@@ -609,6 +617,7 @@ void
 fdd_set_head(int drive, int head)
 {
     fdd_log("fdd_set_head(%d, %d)\n", drive, head);
+    fdd_sync(drive);
     if (head && !fdd_is_double_sided(drive))
         fdd[drive].head = 0;
     else
@@ -626,6 +635,7 @@ fdd_get_head(int drive)
 void
 fdd_set_turbo(int drive, int turbo)
 {
+    fdd_sync(drive);
     fdd[drive].turbo = turbo;
 }
 
@@ -665,6 +675,7 @@ fdd_load(int drive, char *fn)
 
     if (!fn)
         return;
+    fdd_sync(drive);
     if (strstr(fn, "wp://") == fn) {
         offs                = 5;
         ui_writeprot[drive] = 1;
@@ -735,6 +746,7 @@ fdd_load(int drive, char *fn)
 void
 fdd_close(int drive)
 {
+    fdd_sync(drive);
     d86f_stop(drive); /* Call this first of all to make sure the 86F poll is back to idle state. */
 
     drives[drive].hole          = NULL;
@@ -747,6 +759,8 @@ fdd_close(int drive)
     drives[drive].format        = NULL;
     drives[drive].byteperiod    = NULL;
     drives[drive].stop          = NULL;
+    drives[drive].idle          = NULL;
+    drives[drive].skip_bits     = NULL;
     fdd_seek_in_progress[drive] = 0;
 
     if (strstr(floppyfns[drive], "ioctl://") != NULL) {
@@ -789,11 +803,64 @@ fdd_set_motor_enable(int drive, int motor_enable)
     if (motor_enable && !motoron[drive]) {
         timer_set_delay_u64(&fdd_poll_time[drive], fdd_byteperiod(drive));
     } else if (!motor_enable && motoron[drive]) {
+        fdd_sync(drive);
         timer_disable(&fdd_poll_time[drive]);
     }
     motoron[drive] = motor_enable;
 }
 
+/* Stop polling a drive whose image handler reports it idle. Nothing observable
+   happens on an idle drive except the disk turning under the head, which
+   fdd_sync() can catch up on in one go. */
+static void
+fdd_park(int drive)
+{
+    if (!drives[drive].idle || !drives[drive].skip_bits || !drives[drive].idle(drive))
+        return;
+
+    if (fdd_notfound || (fdd_changed[drive] && (fdd_fdc->flags & FDC_FLAG_5550)))
+        return;
+
+    fdd_parked[drive]    = 1;
+    fdd_parked_ts[drive] = ((uint128_t) fdd_poll_time[drive].ts_integer << 32) | fdd_poll_time[drive].ts_frac;
+    timer_disable(&fdd_poll_time[drive]);
+}
+
+/* Bring a parked drive's rotation up to the current time and resume bit-level
+   polling in phase with where it would have been. Must be called before
+   anything that starts a command on the drive or changes its track, head or
+   bit rate. */
+void
+fdd_sync(int drive)
+{
+    uint128_t now;
+    uint128_t ts;
+    uint64_t  period;
+    uint64_t  bits = 0;
+
+    if (!fdd_parked[drive])
+        return;
+
+    fdd_parked[drive] = 0;
+
+    period = fdd_byteperiod(drive);
+    ts     = fdd_parked_ts[drive];
+
+    /* Every poll whose integer timestamp is <= tsc would have run by now. */
+    now = ((uint128_t) tsc + 1) << 32;
+    if (ts < now) {
+        bits = (uint64_t) ((now - ts - 1) / period) + 1;
+        ts += (uint128_t) bits * period;
+    }
+
+    if (bits && drives[drive].skip_bits)
+        drives[drive].skip_bits(drive, bits);
+
+    fdd_poll_time[drive].ts_integer = (uint64_t) (ts >> 32);
+    fdd_poll_time[drive].ts_frac    = (uint32_t) ts;
+    timer_enable(&fdd_poll_time[drive]);
+}
+
 static void
 fdd_poll(void *priv)
 {
@@ -819,6 +886,8 @@ fdd_poll(void *priv)
     if (fdd_changed[drive]) {
         fdc_diskchange_interrupt(fdd_fdc, drive);
     }
+
+    fdd_park(drive);
 }
 
 int
@@ -856,6 +925,7 @@ fdd_reset(void)
     for (uint8_t i = 0; i < FDD_NUM; i++) {
         drives[i].id = i;
         timer_add(&(fdd_poll_time[i]), fdd_poll, &drives[i], 0);
+        fdd_parked[i] = 0;
 
         /* Clear any pending seek state */
         fdd_seek_in_progress[i] = 0;
@@ -887,6 +957,7 @@ fdd_readsector(int drive, int sector, int track, int side, int density, int sect
         return;
     }
 
+    fdd_sync(drive);
     if (drives[drive].readsector)
         drives[drive].readsector(drive, sector, track, side, density, sector_size);
     else
@@ -913,6 +984,7 @@ fdd_writesector(int drive, int sector, int track, int side, int density, int sec
         return;
     }
 
+    fdd_sync(drive);
     if (drives[drive].writesector)
         drives[drive].writesector(drive, sector, track, side, density, sector_size);
     else
@@ -937,6 +1009,7 @@ fdd_comparesector(int drive, int sector, int track, int side, int density, int s
         return;
     }
 
+    fdd_sync(drive);
     if (drives[drive].comparesector)
         drives[drive].comparesector(drive, sector, track, side, density, sector_size);
     else
@@ -959,6 +1032,7 @@ fdd_readaddress(int drive, int side, int density)
         return;
     }
 
+    fdd_sync(drive);
     if (drives[drive].readaddress)
         drives[drive].readaddress(drive, side, density);
 }
@@ -980,6 +1054,7 @@ fdd_format(int drive, int side, int density, uint8_t fill)
         return;
     }
 
+    fdd_sync(drive);
     if (drives[drive].format)
         drives[drive].format(drive, side, density, fill);
     else
@@ -989,6 +1064,7 @@ fdd_format(int drive, int side, int density, uint8_t fill)
 void
 fdd_stop(int drive)
 {
+    fdd_sync(drive);
     if (drives[drive].stop)
         drives[drive].stop(drive);
 }
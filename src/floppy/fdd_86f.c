@@ -1799,6 +1799,62 @@ d86f_advance_word(int drive, int side)
         dev->index_count++;
 }
 
+/* Nothing but the rotation itself matters while the drive is idle, so the
+   poll timer may be stopped; see fdd_park(). */
+int
+d86f_idle(int drive)
+{
+    const d86f_t *dev = d86f[drive];
+
+    return (dev != NULL) && (dev->state == STATE_IDLE);
+}
+
+/* Advance an idle drive by the given number of bit cells exactly as that many
+   d86f_poll() calls would have. Whole revolutions are skipped, only calling
+   read_revolution() at each index crossing, and the last 16 bit cells are
+   really read so last_word is right when the next command starts. */
+void
+d86f_skip_bits(int drive, uint64_t bits)
+{
+    d86f_t  *dev = d86f[drive];
+    int      side;
+    uint32_t raw_size;
+    uint32_t to_index;
+
+    if (dev == NULL)
+        return;
+
+    /* The turbo poll does not move the head over the track when idle. */
+    if (fdd_get_turbo(drive) && (dev->version == 0x0063))
+        return;
+
+    side = fdd_get_head(drive);
+    if (!fdd_is_double_sided(drive))
+        side = 0;
+
+    while (bits > 16) {
+        raw_size = d86f_handler[drive].get_raw_size(drive, side);
+        to_index = (d86f_handler[drive].index_hole_pos(drive, side) + raw_size - dev->track_pos) % raw_size;
+        if (to_index == 0)
+            to_index = raw_size;
+
+        if ((bits - 16) < to_index) {
+            dev->track_pos = (uint32_t) ((dev->track_pos + (bits - 16)) % raw_size);
+            bits           = 16;
+        } else {
+            dev->track_pos = (dev->track_pos + to_index) % raw_size;
+            bits -= to_index;
+            d86f_handler[drive].read_revolution(drive);
+        }
+    }
+
+    for (; bits > 0; bits--) {
+        d86f_get_bit(drive, side ^ 1);
+        d86f_get_bit(drive, side);
+        d86f_advance_bit(drive, side);
+    }
+}
+
 void
 d86f_spin_to_index(int drive, int side)
 {
@@ -3491,6 +3547,8 @@ d86f_common_handlers(int drive)
     drives[drive].readaddress   = d86f_readaddress;
     drives[drive].byteperiod    = d86f_byteperiod;
     drives[drive].poll          = d86f_poll;
+    drives[drive].idle          = d86f_idle;
+    drives[drive].skip_bits     = d86f_skip_bits;
     drives[drive].format        = d86f_proxy_format;
     drives[drive].stop          = d86f_stop;
     drives[drive].hole          = d86f_hole;
@@ -0,0 +1,54 @@
+/*
+ * 86Box    A hypervisor and IBM PC system emulator that specializes in
+ *          running old operating systems and software designed for IBM
+ *          PC systems and compatibles from 1981 through fairly recent
+ *          system designs based on the PCI bus.
+ *
+ *          This file is part of the 86Box distribution.
+ *
+ *          Definitions for the CHD (compressed hunks of data) image
+ *          reader shared by the CD-ROM and hard disk image code.
+ */
+#ifndef EMU_CHD_IMAGE_H
+#define EMU_CHD_IMAGE_H
+
+#ifdef USE_CHD
+/* Metadata tags, as defined by the CHD format. */
+#    define CHD_TAG(a, b, c, d)      (((uint32_t) (a) << 24) | ((uint32_t) (b) << 16) | \
+                                      ((uint32_t) (c) << 8) | (uint32_t) (d))
+#    define CHD_TAG_HARD_DISK        CHD_TAG('G', 'D', 'D', 'D')
+#    define CHD_TAG_CDROM_TRACK      CHD_TAG('C', 'H', 'T', 'R')
+#    define CHD_TAG_CDROM_TRACK2     CHD_TAG('C', 'H', 'T', '2')
+
+/* CD-ROM CHDs store every frame as 2352 bytes of data plus 96 bytes of subchannel. */
+#    define CHD_CD_FRAME_SIZE        2448
+#    define CHD_CD_SECTOR_DATA       2352
+/* Each track is padded to a multiple of this many frames. */
+#    define CHD_CD_TRACK_PADDING     4
+
+typedef struct chd_image_t chd_image_t;
+
+#    ifdef __cplusplus
+extern "C" {
+#    endif
+
+/* Opens a CHD; read_ahead starts a worker thread that decompresses the
+   hunks following a sequential read before they are asked for. */
+extern chd_image_t *chd_image_open(const char *fn, int read_ahead);
+extern void         chd_image_ref(chd_image_t *img);
+extern void         chd_image_close(chd_image_t *img);
+
+extern uint64_t chd_image_get_length(chd_image_t *img);
+extern int      chd_image_get_metadata(chd_image_t *img, uint32_t tag, uint32_t index,
+                                       char *buf, uint32_t len);
+/* Returns 0 on success, -1 on a read or decompression error. */
+extern int      chd_image_read(chd_image_t *img, uint8_t *buf, uint64_t offset, uint32_t count);
+
+extern int chd_image_is_chd(const char *fn);
+
+#    ifdef __cplusplus
+}
+#    endif
+#endif
+
+#endif /*EMU_CHD_IMAGE_H*/
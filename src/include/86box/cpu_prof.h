@@ -0,0 +1,56 @@
+/*
+ * 86Box    A hypervisor and IBM PC system emulator that specializes in
+ *          running old operating systems and software designed for IBM
+ *          PC systems and compatibles from 1981 through fairly recent
+ *          system designs based on the PCI bus.
+ *
+ *          This file is part of the 86Box distribution.
+ *
+ *          Definitions for the guest execution profiler.
+ *
+ *          When enabled, every block run by the dynarec CPU loop is
+ *          charged, in guest cycles, to the physical page it starts
+ *          in, split by how it was run. Blocks invalidated by writes
+ *          to their page are counted as well. The result is written
+ *          as JSON and as folded stacks for flamegraph tools.
+ */
+#ifndef EMU_CPU_PROF_H
+#define EMU_CPU_PROF_H
+
+/* How a block was run. */
+enum {
+    CPU_PROF_INTERP = 0, /* Interpreter, cache off or dynarec bypassed */
+    CPU_PROF_MARK,       /* First run, interpreted while the block is marked */
+    CPU_PROF_COMPILE,    /* Interpreted while the block is recompiled */
+    CPU_PROF_EXEC,       /* Recompiled code */
+    CPU_PROF_STATES
+};
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+extern int cpu_prof_on;
+
+/* Output file name without extension, NULL for cpu_profile in the VM directory. */
+extern void cpu_prof_set_path(const char *prefix);
+extern void cpu_prof_start(void);
+/* Write the profile and stop. */
+extern void cpu_prof_stop(void);
+extern void cpu_prof_save(void);
+
+/* Start, or save and stop, from any thread; done by the CPU thread. */
+extern void cpu_prof_request_toggle(void);
+extern void cpu_prof_poll(void);
+
+/* Called by the CPU loop around each block. */
+extern void cpu_prof_enter(void);
+extern void cpu_prof_leave(int state, int32_t cyc);
+/* Called by codegen_check_flush() when blocks on a page were invalidated. */
+extern void cpu_prof_flush(uint32_t phys, int blocks);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /*EMU_CPU_PROF_H*/
@@ -40,6 +40,7 @@ extern int fdd_swap;
 
 extern void fdd_set_motor_enable(int drive, int motor_enable);
 extern void fdd_do_seek(int drive, int track);
+extern void fdd_sync(int drive);
 extern void fdd_forced_seek(int drive, int track_diff);
 extern void fdd_seek(int drive, int track_diff);
 extern int  fdd_track0(int drive);
@@ -93,6 +94,8 @@ typedef struct DRIVE {
     uint64_t (*byteperiod)(int drive);
     void (*stop)(int drive);
     void (*poll)(int drive);
+    int (*idle)(int drive);
+    void (*skip_bits)(int drive, uint64_t bits);
 } DRIVE;
 
 extern DRIVE      drives[FDD_NUM];
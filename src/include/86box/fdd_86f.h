@@ -56,6 +56,8 @@ extern int      d86f_hole(int drive);
 extern uint64_t d86f_byteperiod(int drive);
 extern void     d86f_stop(int drive);
 extern void     d86f_poll(int drive);
+extern int      d86f_idle(int drive);
+extern void     d86f_skip_bits(int drive, uint64_t bits);
 extern int      d86f_realtrack(int track, int drive);
 extern void     d86f_reset(int drive, int side);
 extern void     d86f_readsector(int drive, int sector, int track, int side, int density, int sector_size);
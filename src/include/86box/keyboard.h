@@ -67,8 +67,12 @@ typedef struct kbc_at_port_t {
     int16_t out_new;
 
     void *priv;
+    void *kbc;
 
     void (*poll)(void *priv);
+    /* Optional, lets the controller stop polling a device that has nothing to do. */
+    int  (*idle)(void *priv);
+    void (*skip)(void *priv, uint64_t polls);
 } kbc_at_port_t;
 
 /* Used by the AT / PS/2 common device, keyboard, and mouse. */
@@ -240,6 +244,8 @@ extern void         kbc_at_set_fast_reset(uint8_t new_fast_reset);
 extern void         kbc_at_port_handler(int num, int set, uint16_t port, void *priv);
 extern void         kbc_at_handler(int set, uint16_t port, void *priv);
 extern void         kbc_at_set_irq(int num, uint16_t irq, void *priv);
+/* Resume polling of the devices before the emulation thread hands them work. */
+extern void         kbc_at_dev_wake(kbc_at_port_t *port);
 
 extern void         kbc_at_dev_queue_reset(atkbc_dev_t *dev, uint8_t reset_main);
 extern uint8_t      kbc_at_dev_queue_pos(atkbc_dev_t *dev, uint8_t main);
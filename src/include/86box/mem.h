@@ -288,6 +288,15 @@ extern page_t *page_lookup[1048576];
 extern uintptr_t readlookup2[1048576];
 extern uintptr_t writelookup2[1048576];
 
+/* Writes to write-protected code pages caught by the host fault handler. */
+extern uint64_t mem_smc_faults;
+
+/* Tagged translation cache statistics, counted while the CPU profiler runs. */
+extern uint64_t mmu_tlb_hits;
+extern uint64_t mmu_tlb_misses;
+/* Bumped whenever linear to physical translations may have changed. */
+extern uint32_t mmu_map_gen;
+
 extern uint32_t get_phys_virt;
 extern uint32_t get_phys_phys;
 
@@ -436,6 +445,9 @@ extern int mem_addr_is_ram(uint32_t addr);
 
 extern uint64_t mmutranslate_noabrt(uint32_t addr, int rw);
 
+extern uint64_t mem_watch_page(uint64_t phys);
+extern int      mem_watch_valid(uint64_t phys, uint64_t tag);
+
 extern void mem_invalidate_range(uint32_t start_addr, uint32_t end_addr);
 
 extern void mem_write_ramb_page(uint32_t addr, uint8_t val, page_t *page);
@@ -443,12 +455,19 @@ extern void mem_write_ramw_page(uint32_t addr, uint16_t val, page_t *page);
 extern void mem_write_raml_page(uint32_t addr, uint32_t val, page_t *page);
 extern void mem_flush_write_page(uint32_t addr, uint32_t virt);
 
+extern int  mem_smc_fault(uintptr_t addr);
+extern int  mem_smc_host_init(void);
+extern int  mem_smc_host_protect(void *p, int writable);
+
 extern void mem_reset_page_blocks(void);
 
 extern void flushmmucache(void);
 extern void flushmmucache_write(void);
 extern void flushmmucache_pc(void);
 extern void flushmmucache_nopc(void);
+extern void flushmmucache_cr3(void);
+extern void flushmmucache_cpl(void);
+extern void flushmmucache_page(uint32_t addr);
 
 extern void mem_debug_check_addr(uint32_t addr, int write);
 
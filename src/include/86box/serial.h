@@ -82,6 +82,7 @@ typedef struct serial_s {
     uint8_t txsr_empty;
     uint8_t msr_set;
     uint8_t irq_state;
+    uint8_t receive_parked;
 
     uint16_t dlab;
     uint16_t base_address;
@@ -94,6 +95,7 @@ typedef struct serial_s {
     pc_timer_t transmit_timer;
     pc_timer_t timeout_timer;
     pc_timer_t receive_timer;
+    uint128_t  receive_parked_ts;
     double     clock_src;
     double     transmit_period;
 
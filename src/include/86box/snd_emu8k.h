@@ -400,10 +400,21 @@ typedef struct emu8k_t {
     int32_t buffer[WTBUFLEN * 2];
 
     uint16_t addr;
+
+    /* Reverb/chorus worker thread. When running, the effects of each buffer
+       are rendered while the next one is being generated, and mixed into it. */
+    void        *fx_thread;
+    void        *fx_start_event;
+    void        *fx_done_event;
+    volatile int fx_quit;
+    int32_t      fx_chorus_in[WTBUFLEN];
+    int32_t      fx_reverb_in[WTBUFLEN];
+    int32_t      fx_out[WTBUFLEN * 2];
 } emu8k_t;
 
 void emu8k_change_addr(emu8k_t *emu8k, uint16_t emu_addr);
 void emu8k_init(emu8k_t *emu8k, uint16_t emu_addr, int onboard_ram);
+void emu8k_fx_thread_start(emu8k_t *emu8k);
 void emu8k_close(emu8k_t *emu8k);
 
 void emu8k_update(emu8k_t *emu8k);
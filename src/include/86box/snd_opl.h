@@ -71,6 +71,21 @@ typedef struct fm_drv_t {
 extern uint8_t fm_driver_get_ex(int chip_id, fm_drv_t *drv, int is_48k);
 extern uint8_t fm_driver_get(int chip_id, fm_drv_t *drv);
 
+/* Synthesis offload: register accesses are queued with their buffer position
+   and rendered by a shared thread, the chip wrapper keeps the status and
+   timers on the emulation thread. */
+typedef struct fm_offload_t fm_offload_t;
+
+extern fm_offload_t *fm_offload_attach(void *priv, void (*write)(void *priv, uint16_t port, uint8_t val),
+                                       void (*read)(void *priv, uint16_t port), void (*timer)(void *priv, int tnum),
+                                       void (*generate)(void *priv, int32_t *data, uint32_t num_samples),
+                                       int *pos_global);
+extern void          fm_offload_detach(fm_offload_t *fo);
+extern void          fm_offload_write(fm_offload_t *fo, uint16_t port, uint8_t val);
+extern void          fm_offload_read(fm_offload_t *fo, uint16_t port);
+extern void          fm_offload_timer(fm_offload_t *fo, int tnum);
+extern int32_t      *fm_offload_update(fm_offload_t *fo);
+
 extern const fm_drv_t nuked_opl2_drv;
 extern const fm_drv_t nuked_opl2_drv_48k;
 extern const fm_drv_t nuked_opl3_drv;
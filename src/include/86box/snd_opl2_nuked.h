@@ -169,6 +169,9 @@ typedef struct {
     int32_t buffer[MUSICBUFLEN * 2];
 
     int32_t *(*update)(void *priv);
+
+    /* Set once the chip is rendered by the synthesis thread. */
+    fm_offload_t *offload;
 } nuked_opl2_drv_t;
 
 enum {
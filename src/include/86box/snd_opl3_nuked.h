@@ -160,6 +160,10 @@ typedef struct {
     int32_t buffer[MUSICBUFLEN * 2];
 
     int32_t *(*update)(void *priv);
+
+    /* Set once the chip is rendered by the synthesis thread. */
+    fm_offload_t *offload;
+    uint8_t       newm;
 } nuked_opl3_drv_t;
 
 enum {
@@ -0,0 +1,75 @@
+/*
+ * 86Box    A hypervisor and IBM PC system emulator that specializes in
+ *          running old operating systems and software designed for IBM
+ *          PC systems and compatibles from 1981 through fairly recent
+ *          system designs based on the PCI bus.
+ *
+ *          This file is part of the 86Box distribution.
+ *
+ *          Definitions for the host time instrumentation layer.
+ *
+ *          Hot paths are wrapped in TRACE_*_ENTER() / TRACE_LEAVE()
+ *          pairs, which aggregate call counts and host time per
+ *          (handler, instance) pair and, for the less frequent paths,
+ *          also emit Chrome trace events through minitrace. Without
+ *          MTR_ENABLED the macros compile to nothing; with it, a
+ *          disabled trace costs one test of tracing_on.
+ *
+ *          Use at most one ENTER per C scope.
+ */
+#ifndef EMU_TRACE_H
+#define EMU_TRACE_H
+
+#ifdef MTR_ENABLED
+#    include <minitrace/minitrace.h>
+
+#    ifdef __cplusplus
+extern "C" {
+#    endif
+
+typedef struct trace_counter_t trace_counter_t;
+
+extern int tracing_on;
+
+extern trace_counter_t *trace_counter_get(const char *cat, const void *key, void *priv,
+                                          const char *name, int span);
+extern uint64_t         trace_enter(trace_counter_t *ctr);
+extern void             trace_leave(trace_counter_t *ctr, uint64_t start);
+
+/* Begin writing Chrome trace events to trace_fn and reset the counters,
+   unless a trace is already running. */
+extern void trace_start(const char *trace_fn);
+/* Stop tracing, if running, and write the aggregated counters to
+   counters_fn as JSON. */
+extern void trace_stop(const char *counters_fn);
+extern void trace_counters_save(const char *fn);
+
+#    ifdef __cplusplus
+}
+#    endif
+
+#    define TRACE_ENTER_EX(cat, key, priv, name, span)                                                 \
+        trace_counter_t *trace_ctr_ = tracing_on ?                                                     \
+                                      trace_counter_get((cat), (const void *) (key), (priv), (name), (span)) : \
+                                      NULL;                                                            \
+        uint64_t         trace_ts_  = (trace_ctr_ != NULL) ? trace_enter(trace_ctr_) : 0
+
+/* Counted and emitted as a Chrome trace span, named after the owning device. */
+#    define TRACE_SPAN_ENTER(cat, key, priv)  TRACE_ENTER_EX(cat, key, priv, NULL, 1)
+/* Counted only, for paths too frequent for the trace buffer (I/O, MMIO, timers). */
+#    define TRACE_COUNT_ENTER(cat, key, priv) TRACE_ENTER_EX(cat, key, priv, NULL, 0)
+/* Fixed name instead of a handler/instance pair. */
+#    define TRACE_NAMED_ENTER(cat, name)      TRACE_ENTER_EX(cat, name, NULL, name, 1)
+#    define TRACE_NAMED_COUNT_ENTER(cat, name) TRACE_ENTER_EX(cat, name, NULL, name, 0)
+#    define TRACE_LEAVE()      \
+        if (trace_ctr_ != NULL) \
+            trace_leave(trace_ctr_, trace_ts_)
+#else
+#    define TRACE_SPAN_ENTER(cat, key, priv)
+#    define TRACE_COUNT_ENTER(cat, key, priv)
+#    define TRACE_NAMED_ENTER(cat, name)
+#    define TRACE_NAMED_COUNT_ENTER(cat, name)
+#    define TRACE_LEAVE()
+#endif
+
+#endif /*EMU_TRACE_H*/
@@ -0,0 +1,566 @@
+/*
+ * 86Box    A hypervisor and IBM PC system emulator that specializes in
+ *          running old operating systems and software designed for IBM
+ *          PC systems and compatibles from 1981 through fairly recent
+ *          system designs based on the PCI bus.
+ *
+ *          This file is part of the 86Box distribution.
+ *
+ *          Definitions for the shared 2D blitter core.
+ *
+ *          video_rop3() evaluates one of the 256 ternary raster
+ *          operations on destination, pattern and source data; with a
+ *          constant ROP it folds down to the plain expression. The row
+ *          kernels apply a ROP to a run of pixels; the pattern-independent
+ *          ROPs are specialized per pixel size, so that engines which can
+ *          hand over whole rows do not pay for the per-pixel dispatch.
+ */
+#ifndef VIDEO_BLIT_H
+#define VIDEO_BLIT_H
+
+/* Whether a ROP uses the source or the destination operand at all. */
+#define VIDEO_ROP_USES_SRC(rop) ((((rop) >> 2) ^ (rop)) & 0x33)
+#define VIDEO_ROP_USES_DST(rop) ((((rop) >> 1) ^ (rop)) & 0x55)
+
+static __inline uint32_t
+video_rop3(uint8_t rop, uint32_t D, uint32_t P, uint32_t S)
+{
+    switch (rop) {
+        case 0x00:
+            return 0;
+        case 0x01:
+            return ~(D | (P | S));
+        case 0x02:
+            return D & ~(P | S);
+        case 0x03:
+            return ~(P | S);
+        case 0x04:
+            return S & ~(D | P);
+        case 0x05:
+            return ~(D | P);
+        case 0x06:
+            return ~(P | ~(D ^ S));
+        case 0x07:
+            return ~(P | (D & S));
+        case 0x08:
+            return S & (D & ~P);
+        case 0x09:
+            return ~(P | (D ^ S));
+        case 0x0a:
+            return D & ~P;
+        case 0x0b:
+            return ~(P | (S & ~D));
+        case 0x0c:
+            return S & ~P;
+        case 0x0d:
+            return ~(P | (D & ~S));
+        case 0x0e:
+            return ~(P | ~(D | S));
+        case 0x0f:
+            return ~P;
+        case 0x10:
+            return P & ~(D | S);
+        case 0x11:
+            return ~(D | S);
+        case 0x12:
+            return ~(S | ~(D ^ P));
+        case 0x13:
+            return ~(S | (D & P));
+        case 0x14:
+            return ~(D | ~(P ^ S));
+        case 0x15:
+            return ~(D | (P & S));
+        case 0x16:
+            return P ^ (S ^ (D & ~(P & S)));
+        case 0x17:
+            return ~(S ^ ((S ^ P) & (D ^ S)));
+        case 0x18:
+            return (S ^ P) & (P ^ D);
+        case 0x19:
+            return ~(S ^ (D & ~(P & S)));
+        case 0x1a:
+            return P ^ (D | (S & P));
+        case 0x1b:
+            return ~(S ^ (D & (P ^ S)));
+        case 0x1c:
+            return P ^ (S | (D & P));
+        case 0x1d:
+            return ~(D ^ (S & (P ^ D)));
+        case 0x1e:
+            return P ^ (D | S);
+        case 0x1f:
+            return ~(P & (D | S));
+        case 0x20:
+            return D & (P & ~S);
+        case 0x21:
+            return ~(S | (D ^ P));
+        case 0x22:
+            return D & ~S;
+        case 0x23:
+            return ~(S | (P & ~D));
+        case 0x24:
+            return (S ^ P) & (D ^ S);
+        case 0x25:
+            return ~(P ^ (D & ~(S & P)));
+        case 0x26:
+            return S ^ (D | (P & S));
+        case 0x27:
+            return S ^ (D | ~(P ^ S));
+        case 0x28:
+            return D & (P ^ S);
+        case 0x29:
+            return ~(P ^ (S ^ (D | (P & S))));
+        case 0x2a:
+            return D & ~(P & S);
+        case 0x2b:
+            return ~(S ^ ((S ^ P) & (P ^ D)));
+        case 0x2c:
+            return S ^ (P & (D | S));
+        case 0x2d:
+            return P ^ (S | ~D);
+        case 0x2e:
+            return P ^ (S | (D ^ P));
+        case 0x2f:
+            return ~(P & (S | ~D));
+        case 0x30:
+            return P & ~S;
+        case 0x31:
+            return ~(S | (D & ~P));
+        case 0x32:
+            return S ^ (D | (P | S));
+        case 0x33:
+            return ~S;
+        case 0x34:
+            return S ^ (P | (D & S));
+        case 0x35:
+            return S ^ (P | ~(D ^ S));
+        case 0x36:
+            return S ^ (D | P);
+        case 0x37:
+            return ~(S & (D | P));
+        case 0x38:
+            return P ^ (S & (D | P));
+        case 0x39:
+            return S ^ (P | ~D);
+        case 0x3a:
+            return S ^ (P | (D ^ S));
+        case 0x3b:
+            return ~(S & (P | ~D));
+        case 0x3c:
+            return P ^ S;
+        case 0x3d:
+            return S ^ (P | ~(D | S));
+        case 0x3e:
+            return S ^ (P | (D & ~S));
+        case 0x3f:
+            return ~(P & S);
+        case 0x40:
+            return P & (S & ~D);
+        case 0x41:
+            return ~(D | (P ^ S));
+        case 0x42:
+            return (S ^ D) & (P ^ D);
+        case 0x43:
+            return ~(S ^ (P & ~(D & S)));
+        case 0x44:
+            return S & ~D;
+        case 0x45:
+            return ~(D | (P & ~S));
+        case 0x46:
+            return D ^ (S | (P & D));
+        case 0x47:
+            return ~(P ^ (S & (D ^ P)));
+        case 0x48:
+            return S & (D ^ P);
+        case 0x49:
+            return ~(P ^ (D ^ (S | (P & D))));
+        case 0x4a:
+            return D ^ (P & (S | D));
+        case 0x4b:
+            return P ^ (D | ~S);
+        case 0x4c:
+            return S & ~(D & P);
+        case 0x4d:
+            return ~(S ^ ((S ^ P) | (D ^ S)));
+        case 0x4e:
+            return P ^ (D | (S ^ P));
+        case 0x4f:
+            return ~(P & (D | ~S));
+        case 0x50:
+            return P & ~D;
+        case 0x51:
+            return ~(D | (S & ~P));
+        case 0x52:
+            return D ^ (P | (S & D));
+        case 0x53:
+            return ~(S ^ (P & (D ^ S)));
+        case 0x54:
+            return ~(D | ~(P | S));
+        case 0x55:
+            return ~D;
+        case 0x56:
+            return D ^ (P | S);
+        case 0x57:
+            return ~(D & (P | S));
+        case 0x58:
+            return P ^ (D & (S | P));
+        case 0x59:
+            return D ^ (P | ~S);
+        case 0x5a:
+            return D ^ P;
+        case 0x5b:
+            return D ^ (P | ~(S | D));
+        case 0x5c:
+            return D ^ (P | (S ^ D));
+        case 0x5d:
+            return ~(D & (P | ~S));
+        case 0x5e:
+            return D ^ (P | (S & ~D));
+        case 0x5f:
+            return ~(D & P);
+        case 0x60:
+            return P & (D ^ S);
+        case 0x61:
+            return ~(D ^ (S ^ (P | (D & S))));
+        case 0x62:
+            return D ^ (S & (P | D));
+        case 0x63:
+            return S ^ (D | ~P);
+        case 0x64:
+            return S ^ (D & (P | S));
+        case 0x65:
+            return D ^ (S | ~P);
+        case 0x66:
+            return D ^ S;
+        case 0x67:
+            return S ^ (D | ~(P | S));
+        case 0x68:
+            return ~(D ^ (S ^ (P | ~(D | S))));
+        case 0x69:
+            return ~(P ^ (D ^ S));
+        case 0x6a:
+            return D ^ (P & S);
+        case 0x6b:
+            return ~(P ^ (S ^ (D & (P | S))));
+        case 0x6c:
+            return S ^ (D & P);
+        case 0x6d:
+            return ~(P ^ (D ^ (S & (P | D))));
+        case 0x6e:
+            return S ^ (D & (P | ~S));
+        case 0x6f:
+            return ~(P & ~(D ^ S));
+        case 0x70:
+            return P & ~(D & S);
+        case 0x71:
+            return ~(S ^ ((S ^ D) & (P ^ D)));
+        case 0x72:
+            return S ^ (D | (P ^ S));
+        case 0x73:
+            return ~(S & (D | ~P));
+        case 0x74:
+            return D ^ (S | (P ^ D));
+        case 0x75:
+            return ~(D & (S | ~P));
+        case 0x76:
+            return S ^ (D | (P & ~S));
+        case 0x77:
+            return ~(D & S);
+        case 0x78:
+            return P ^ (D & S);
+        case 0x79:
+            return ~(D ^ (S ^ (P & (D | S))));
+        case 0x7a:
+            return D ^ (P & (S | ~D));
+        case 0x7b:
+            return ~(S & ~(D ^ P));
+        case 0x7c:
+            return S ^ (P & (D | ~S));
+        case 0x7d:
+            return ~(D & ~(P ^ S));
+        case 0x7e:
+            return (S ^ P) | (D ^ S);
+        case 0x7f:
+            return ~(D & (P & S));
+        case 0x80:
+            return D & (P & S);
+        case 0x81:
+            return ~((S ^ P) | (D ^ S));
+        case 0x82:
+            return D & ~(P ^ S);
+        case 0x83:
+            return ~(S ^ (P & (D | ~S)));
+        case 0x84:
+            return S & ~(D ^ P);
+        case 0x85:
+            return ~(P ^ (D & (S | ~P)));
+        case 0x86:
+            return D ^ (S ^ (P & (D | S)));
+        case 0x87:
+            return ~(P ^ (D & S));
+        case 0x88:
+            return D & S;
+        case 0x89:
+            return ~(S ^ (D | (P & ~S)));
+        case 0x8a:
+            return D & (S | ~P);
+        case 0x8b:
+            return ~(D ^ (S | (P ^ D)));
+        case 0x8c:
+            return S & (D | ~P);
+        case 0x8d:
+            return ~(S ^ (D | (P ^ S)));
+        case 0x8e:
+            return S ^ ((S ^ D) & (P ^ D));
+        case 0x8f:
+            return ~(P & ~(D & S));
+        case 0x90:
+            return P & ~(D ^ S);
+        case 0x91:
+            return ~(S ^ (D & (P | ~S)));
+        case 0x92:
+            return D ^ (P ^ (S & (D | P)));
+        case 0x93:
+            return ~(S ^ (P & D));
+        case 0x94:
+            return P ^ (S ^ (D & (P | S)));
+        case 0x95:
+            return ~(D ^ (P & S));
+        case 0x96:
+            return D ^ (P ^ S);
+        case 0x97:
+            return P ^ (S ^ (D | ~(P | S)));
+        case 0x98:
+            return ~(S ^ (D | ~(P | S)));
+        case 0x99:
+            return ~(D ^ S);
+        case 0x9a:
+            return D ^ (P & ~S);
+        case 0x9b:
+            return ~(S ^ (D & (P | S)));
+        case 0x9c:
+            return S ^ (P & ~D);
+        case 0x9d:
+            return ~(D ^ (S & (P | D)));
+        case 0x9e:
+            return D ^ (S ^ (P | (D & S)));
+        case 0x9f:
+            return ~(P & (D ^ S));
+        case 0xa0:
+            return D & P;
+        case 0xa1:
+            return ~(P ^ (D | (S & ~P)));
+        case 0xa2:
+            return D & (P | ~S);
+        case 0xa3:
+            return ~(D ^ (P | (S ^ D)));
+        case 0xa4:
+            return ~(P ^ (D | ~(S | P)));
+        case 0xa5:
+            return ~(P ^ D);
+        case 0xa6:
+            return D ^ (S & ~P);
+        case 0xa7:
+            return ~(P ^ (D & (S | P)));
+        case 0xa8:
+            return D & (P | S);
+        case 0xa9:
+            return ~(D ^ (P | S));
+        case 0xaa:
+            return D;
+        case 0xab:
+            return D | ~(P | S);
+        case 0xac:
+            return S ^ (P & (D ^ S));
+        case 0xad:
+            return ~(D ^ (P | (S & D)));
+        case 0xae:
+            return D | (S & ~P);
+        case 0xaf:
+            return D | ~P;
+        case 0xb0:
+            return P & (D | ~S);
+        case 0xb1:
+            return ~(P ^ (D | (S ^ P)));
+        case 0xb2:
+            return S ^ ((S ^ P) | (D ^ S));
+        case 0xb3:
+            return ~(S & ~(D & P));
+        case 0xb4:
+            return P ^ (S & ~D);
+        case 0xb5:
+            return ~(D ^ (P & (S | D)));
+        case 0xb6:
+            return D ^ (P ^ (S | (D & P)));
+        case 0xb7:
+            return ~(S & (D ^ P));
+        case 0xb8:
+            return P ^ (S & (D ^ P));
+        case 0xb9:
+            return ~(D ^ (S | (P & D)));
+        case 0xba:
+            return D | (P & ~S);
+        case 0xbb:
+            return D | ~S;
+        case 0xbc:
+            return S ^ (P & ~(D & S));
+        case 0xbd:
+            return ~((S ^ D) & (P ^ D));
+        case 0xbe:
+            return D | (P ^ S);
+        case 0xbf:
+            return D | ~(P & S);
+        case 0xc0:
+            return P & S;
+        case 0xc1:
+            return ~(S ^ (P | (D & ~S)));
+        case 0xc2:
+            return ~(S ^ (P | ~(D | S)));
+        case 0xc3:
+            return ~(P ^ S);
+        case 0xc4:
+            return S & (P | ~D);
+        case 0xc5:
+            return ~(S ^ (P | (D ^ S)));
+        case 0xc6:
+            return S ^ (D & ~P);
+        case 0xc7:
+            return ~(P ^ (S & (D | P)));
+        case 0xc8:
+            return S & (D | P);
+        case 0xc9:
+            return ~(S ^ (P | D));
+        case 0xca:
+            return D ^ (P & (S ^ D));
+        case 0xcb:
+            return ~(S ^ (P | (D & S)));
+        case 0xcc:
+            return S;
+        case 0xcd:
+            return S | ~(D | P);
+        case 0xce:
+            return S | (D & ~P);
+        case 0xcf:
+            return S | ~P;
+        case 0xd0:
+            return P & (S | ~D);
+        case 0xd1:
+            return ~(P ^ (S | (D ^ P)));
+        case 0xd2:
+            return P ^ (D & ~S);
+        case 0xd3:
+            return ~(S ^ (P & (D | S)));
+        case 0xd4:
+            return S ^ ((S ^ P) & (P ^ D));
+        case 0xd5:
+            return ~(D & ~(P & S));
+        case 0xd6:
+            return P ^ (S ^ (D | (P & S)));
+        case 0xd7:
+            return ~(D & (P ^ S));
+        case 0xd8:
+            return P ^ (D & (S ^ P));
+        case 0xd9:
+            return ~(S ^ (D | (P & S)));
+        case 0xda:
+            return D ^ (P & ~(S & D));
+        case 0xdb:
+            return ~((S ^ P) & (D ^ S));
+        case 0xdc:
+            return S | (P & ~D);
+        case 0xdd:
+            return S | ~D;
+        case 0xde:
+            return S | (D ^ P);
+        case 0xdf:
+            return S | ~(D & P);
+        case 0xe0:
+            return P & (D | S);
+        case 0xe1:
+            return ~(P ^ (D | S));
+        case 0xe2:
+            return D ^ (S & (P ^ D));
+        case 0xe3:
+            return ~(P ^ (S | (D & P)));
+        case 0xe4:
+            return S ^ (D & (P ^ S));
+        case 0xe5:
+            return ~(P ^ (D | (S & P)));
+        case 0xe6:
+            return S ^ (D & ~(P & S));
+        case 0xe7:
+            return ~((S ^ P) & (P ^ D));
+        case 0xe8:
+            return S ^ ((S ^ P) & (D ^ S));
+        case 0xe9:
+            return ~(D ^ (S ^ (P & ~(D & S))));
+        case 0xea:
+            return D | (P & S);
+        case 0xeb:
+            return D | ~(P ^ S);
+        case 0xec:
+            return S | (D & P);
+        case 0xed:
+            return S | ~(D ^ P);
+        case 0xee:
+            return D | S;
+        case 0xef:
+            return S | (D | ~P);
+        case 0xf0:
+            return P;
+        case 0xf1:
+            return P | ~(D | S);
+        case 0xf2:
+            return P | (D & ~S);
+        case 0xf3:
+            return P | ~S;
+        case 0xf4:
+            return P | (S & ~D);
+        case 0xf5:
+            return P | ~D;
+        case 0xf6:
+            return P | (D ^ S);
+        case 0xf7:
+            return P | ~(D & S);
+        case 0xf8:
+            return P | (D & S);
+        case 0xf9:
+            return P | ~(D ^ S);
+        case 0xfa:
+            return D | P;
+        case 0xfb:
+            return D | (P | ~S);
+        case 0xfc:
+            return P | S;
+        case 0xfd:
+            return P | (S | ~D);
+        case 0xfe:
+            return D | (P | S);
+        case 0xff:
+            return ~0;
+    }
+
+    return 0;
+}
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Apply rop to n pixels of bpp (8, 16 or 32) bits. dst and src point to the
+   lowest addressed pixel of the run, src may be NULL if the ROP does not use
+   it. The pixels are walked from the highest address down when backwards is
+   set, so overlapping runs behave like the hardware walking in that
+   direction. */
+extern void video_blit_rop_row(uint8_t rop, int bpp, uint8_t *dst, const uint8_t *src,
+                               uint32_t pat, int n, int backwards);
+
+/* dst = (dst & and_mask) ^ xor_val on n pixels, which covers solid fills and
+   every two-operand mix with a constant source. */
+extern void video_blit_logic_row(int bpp, uint8_t *dst, uint32_t and_mask, uint32_t xor_val, int n);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /*VIDEO_BLIT_H*/
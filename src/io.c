@@ -29,6 +29,7 @@
 #include "x86.h"
 #include <86box/m_amstrad.h>
 #include <86box/pci.h>
+#include <86box/trace.h>
 
 #define NPORTS 65536 /* PC/AT supports 64K ports */
 
@@ -365,7 +366,9 @@ inb(uint16_t port)
         while (p) {
             q = p->next;
             if (p->inb) {
+                TRACE_COUNT_ENTER("io", p->inb, p->priv);
                 ret &= p->inb(port, p->priv);
+                TRACE_LEAVE();
                 found |= 1;
 #ifdef ENABLE_IO_LOG
                 qfound++;
@@ -432,7 +435,9 @@ outb(uint16_t port, uint8_t val)
         while (p) {
             q = p->next;
             if (p->outb) {
+                TRACE_COUNT_ENTER("io", p->outb, p->priv);
                 p->outb(port, val, p->priv);
+                TRACE_LEAVE();
                 found |= 1;
 #ifdef ENABLE_IO_LOG
                 qfound++;
@@ -490,7 +495,9 @@ inw(uint16_t port)
         while (p) {
             q = p->next;
             if (p->inw) {
+                TRACE_COUNT_ENTER("io", p->inw, p->priv);
                 ret &= p->inw(port, p->priv);
+                TRACE_LEAVE();
                 found |= 2;
 #ifdef ENABLE_IO_LOG
                 qfound++;
@@ -506,7 +513,9 @@ inw(uint16_t port)
             while (p) {
                 q = p->next;
                 if (p->inb && !p->inw) {
+                    TRACE_COUNT_ENTER("io", p->inb, p->priv);
                     ret8[i] &= p->inb(port + i, p->priv);
+                    TRACE_LEAVE();
                     found |= 1;
 #ifdef ENABLE_IO_LOG
                     qfound++;
@@ -569,7 +578,9 @@ outw(uint16_t port, uint16_t val)
         while (p) {
             q = p->next;
             if (p->outw) {
+                TRACE_COUNT_ENTER("io", p->outw, p->priv);
                 p->outw(port, val, p->priv);
+                TRACE_LEAVE();
                 found |= 2;
 #ifdef ENABLE_IO_LOG
                 qfound++;
@@ -583,7 +594,9 @@ outw(uint16_t port, uint16_t val)
             while (p) {
                 q = p->next;
                 if (p->outb && !p->outw) {
+                    TRACE_COUNT_ENTER("io", p->outb, p->priv);
                     p->outb(port + i, val >> (i << 3), p->priv);
+                    TRACE_LEAVE();
                     found |= 1;
 #ifdef ENABLE_IO_LOG
                     qfound++;
@@ -643,7 +656,9 @@ inl(uint16_t port)
         while (p) {
             q = p->next;
             if (p->inl) {
+                TRACE_COUNT_ENTER("io", p->inl, p->priv);
                 ret &= p->inl(port, p->priv);
+                TRACE_LEAVE();
                 found |= 4;
 #ifdef ENABLE_IO_LOG
                 qfound++;
@@ -658,7 +673,9 @@ inl(uint16_t port)
         while (p) {
             q = p->next;
             if (p->inw && !p->inl) {
+                TRACE_COUNT_ENTER("io", p->inw, p->priv);
                 ret16[0] &= p->inw(port, p->priv);
+                TRACE_LEAVE();
                 found |= 2;
 #ifdef ENABLE_IO_LOG
                 qfound++;
@@ -671,7 +688,9 @@ inl(uint16_t port)
         while (p) {
             q = p->next;
             if (p->inw && !p->inl) {
+                TRACE_COUNT_ENTER("io", p->inw, p->priv);
                 ret16[1] &= p->inw(port + 2, p->priv);
+                TRACE_LEAVE();
                 found |= 2;
 #ifdef ENABLE_IO_LOG
                 qfound++;
@@ -690,7 +709,9 @@ inl(uint16_t port)
             while (p) {
                 q = p->next;
                 if (p->inb && !p->inw && !p->inl) {
+                    TRACE_COUNT_ENTER("io", p->inb, p->priv);
                     ret8[i] &= p->inb(port + i, p->priv);
+                    TRACE_LEAVE();
                     found |= 1;
 #ifdef ENABLE_IO_LOG
                     qfound++;
@@ -755,7 +776,9 @@ outl(uint16_t port, uint32_t val)
             while (p) {
                 q = p->next;
                 if (p->outl) {
+                    TRACE_COUNT_ENTER("io", p->outl, p->priv);
                     p->outl(port, val, p->priv);
+                    TRACE_LEAVE();
                     found |= 4;
 #ifdef ENABLE_IO_LOG
                     qfound++;
@@ -770,7 +793,9 @@ outl(uint16_t port, uint32_t val)
             while (p) {
                 q = p->next;
                 if (p->outw && !p->outl) {
+                    TRACE_COUNT_ENTER("io", p->outw, p->priv);
                     p->outw(port + i, val >> (i << 3), p->priv);
+                    TRACE_LEAVE();
                     found |= 2;
 #ifdef ENABLE_IO_LOG
                     qfound++;
@@ -785,7 +810,9 @@ outl(uint16_t port, uint32_t val)
             while (p) {
                 q = p->next;
                 if (p->outb && !p->outw && !p->outl) {
+                    TRACE_COUNT_ENTER("io", p->outb, p->priv);
                     p->outb(port + i, val >> (i << 3), p->priv);
+                    TRACE_LEAVE();
                     found |= 1;
 #ifdef ENABLE_IO_LOG
                     qfound++;
@@ -38,6 +38,8 @@
 #include <86box/plat.h>
 #include <86box/rom.h>
 #include <86box/gdbstub.h>
+#include <86box/trace.h>
+#include <86box/cpu_prof.h>
 #ifdef USE_DYNAREC
 #    include "codegen_public.h"
 #else
@@ -158,6 +160,428 @@ mem_log(const char *fmt, ...)
 #    define mem_log(fmt, ...)
 #endif
 
+#ifdef MTR_ENABLED
+/* Mapping handler calls, counted per handler and instance while tracing. */
+#    define MEM_TRACE_READ(sz, type)                                \
+        static type                                                 \
+        mem_trace_read_##sz(mem_mapping_t *map, uint32_t addr)      \
+        {                                                           \
+            type ret;                                               \
+            TRACE_COUNT_ENTER("mmio", map->read_##sz, map->priv);   \
+            ret = map->read_##sz(addr, map->priv);                  \
+            TRACE_LEAVE();                                          \
+            return ret;                                             \
+        }
+#    define MEM_TRACE_WRITE(sz, type)                                         \
+        static void                                                           \
+        mem_trace_write_##sz(mem_mapping_t *map, uint32_t addr, type val)     \
+        {                                                                     \
+            TRACE_COUNT_ENTER("mmio", map->write_##sz, map->priv);            \
+            map->write_##sz(addr, val, map->priv);                            \
+            TRACE_LEAVE();                                                    \
+        }
+
+MEM_TRACE_READ(b, uint8_t)
+MEM_TRACE_READ(w, uint16_t)
+MEM_TRACE_READ(l, uint32_t)
+MEM_TRACE_WRITE(b, uint8_t)
+MEM_TRACE_WRITE(w, uint16_t)
+MEM_TRACE_WRITE(l, uint32_t)
+
+#    define MAP_READ(sz, map, a)       (tracing_on ? mem_trace_read_##sz((map), (a)) : (map)->read_##sz((a), (map)->priv))
+#    define MAP_WRITE(sz, map, a, v)   (tracing_on ? mem_trace_write_##sz((map), (a), (v)) : (map)->write_##sz((a), (v), (map)->priv))
+#else
+#    define MAP_READ(sz, map, a)       (map)->read_##sz((a), (map)->priv)
+#    define MAP_WRITE(sz, map, a, v)   (map)->write_##sz((a), (v), (map)->priv)
+#endif
+
+/*
+ * Second level, set-associative translation cache.
+ *
+ * The 256-entry lookup rings above are direct host pointers and have to be
+ * emptied whenever CR3 or CPL changes. Entries in this cache instead hold the
+ * result of a page walk tagged with the CR3 it was done under (global pages
+ * match any CR3), so switching back to an address space does not have to walk
+ * the page tables again. The permission check is redone on every hit against
+ * the current CPL and CR0.WP.
+ *
+ * Rather than relying on the guest to INVLPG after every page table edit, the
+ * physical pages holding the PDPT/PDE/PTE used by an entry are watched: writes
+ * to a watched page go through the page write handlers, which bump a per-page
+ * generation, and an entry whose generations no longer match is a miss.
+ */
+#define MMU_TLB_SETS      1024 /* must be a power of two */
+#define MMU_TLB_WAYS      4
+
+#define MMU_TLB_DIRTY     0x01
+#define MMU_TLB_GLOBAL    0x02
+#define MMU_TLB_LARGE     0x04
+
+/* 4M/2M frames with cached pieces that INVLPG has to look for; past this many
+   it scans the whole cache until the next flush. */
+#define MMU_TLB_LARGE_MAX 16
+
+typedef struct mmu_tlb_entry_t {
+    uint32_t vpage;
+    uint32_t ctx;
+    uint64_t phys;
+    uint32_t pt_page[3];
+    uint32_t pt_gen[3];
+    uint16_t epoch;
+    uint8_t  perm;
+    uint8_t  flags;
+} mmu_tlb_entry_t;
+
+/* Counted while the CPU profiler runs. */
+uint64_t mmu_tlb_hits   = 0;
+uint64_t mmu_tlb_misses = 0;
+/* Bumped whenever linear to physical translations may have changed. */
+uint32_t mmu_map_gen = 0;
+
+static mmu_tlb_entry_t mmu_tlb[MMU_TLB_SETS][MMU_TLB_WAYS];
+static uint8_t         mmu_tlb_victim[MMU_TLB_SETS];
+static uint16_t        mmu_tlb_epoch = 1;
+static uint32_t        mmu_tlb_large_frame[MMU_TLB_LARGE_MAX];
+static int             mmu_tlb_large = 0; /* Frames in use, MMU_TLB_LARGE_MAX + 1 once overflowed. */
+
+/* Per physical RAM page: the epoch it was last watched in and its write
+   generation, wide enough not to wrap back onto a stale entry. */
+static uint16_t *mmu_tlb_pt_watch = NULL;
+static uint32_t *mmu_tlb_pt_gen   = NULL;
+static uint32_t  mmu_tlb_pt_pages = 0;
+
+static void
+mmu_tlb_flush(void)
+{
+    if (++mmu_tlb_epoch == 0) {
+        /* Wrapped, stale epochs could match again. */
+        memset(mmu_tlb, 0x00, sizeof(mmu_tlb));
+        if (mmu_tlb_pt_watch != NULL)
+            memset(mmu_tlb_pt_watch, 0x00, mmu_tlb_pt_pages * sizeof(uint16_t));
+        mmu_tlb_epoch = 1;
+    }
+
+    mmu_tlb_large = 0;
+}
+
+static __inline int
+mmu_tlb_pt_watched(uint32_t n)
+{
+    return (n < mmu_tlb_pt_pages) && (mmu_tlb_pt_watch[n] == mmu_tlb_epoch);
+}
+
+static __inline void
+mmu_tlb_pt_write(uint32_t n)
+{
+    if (mmu_tlb_pt_watched(n))
+        mmu_tlb_pt_gen[n]++;
+}
+
+static void
+mmu_tlb_pt_watch_page(uint32_t n)
+{
+    uintptr_t target = (uintptr_t) &ram[(uintptr_t) n << 12];
+    int       v;
+
+    mmu_tlb_pt_watch[n] = mmu_tlb_epoch;
+
+    /* Make sure no direct write pointer to the page is left in the lookup ring. */
+    for (uint16_t c = 0; c < 256; c++) {
+        v = writelookup[c];
+        if ((v != (int) 0xffffffff) && (writelookup2[v] != (uintptr_t) LOOKUP_INV) &&
+            ((writelookup2[v] + ((uintptr_t) v << 12)) == target)) {
+            writelookup2[v] = LOOKUP_INV;
+            page_lookup[v]  = NULL;
+            writelookup[c]  = 0xffffffff;
+        }
+    }
+}
+
+static __inline uint32_t
+mmu_tlb_ctx(void)
+{
+    return (cr4 & CR4_PAE) ? (cr3 & ~0x1f) : (cr3 & ~0xfff);
+}
+
+static __inline int
+mmu_tlb_lookup(uint32_t addr, int rw, uint64_t *phys)
+{
+    uint32_t               vpage = addr >> 12;
+    uint32_t               ctx   = mmu_tlb_ctx();
+    const mmu_tlb_entry_t *e     = mmu_tlb[vpage & (MMU_TLB_SETS - 1)];
+    int                    wp;
+
+    for (int w = 0; w < MMU_TLB_WAYS; w++, e++) {
+        if ((e->epoch != mmu_tlb_epoch) || (e->vpage != vpage) ||
+            ((e->ctx != ctx) && !(e->flags & MMU_TLB_GLOBAL)))
+            continue;
+
+        if ((mmu_tlb_pt_gen[e->pt_page[0]] != e->pt_gen[0]) ||
+            (mmu_tlb_pt_gen[e->pt_page[1]] != e->pt_gen[1]) ||
+            (mmu_tlb_pt_gen[e->pt_page[2]] != e->pt_gen[2]))
+            continue;
+
+        /* Same checks as the page walk; anything that would fault, or a write
+           that has to set the dirty bit, takes the walk. */
+        wp = (cr4 & CR4_PAE) ? (cr0 & WP_FLAG) : ((is486 || isibm486) && (cr0 & WP_FLAG));
+        if (((CPL == 3) && !(e->perm & 4) && !cpl_override) ||
+            (rw && !cpl_override && !(e->perm & 2) && (((CPL == 3) && !cpl_override) || wp)) ||
+            (rw && !(e->flags & MMU_TLB_DIRTY)))
+            return 0;
+
+        *phys = e->phys;
+        return 1;
+    }
+
+    return 0;
+}
+
+static __inline int
+mmu_tlb_pt_ok(uint64_t a)
+{
+    uint64_t n = a >> 12;
+
+    /* Only plain RAM outside the adapter area goes through the page write handlers. */
+    return (n < mmu_tlb_pt_pages) && ((n < 0xa0) || (n >= 0x100));
+}
+
+/* Write watch for caches of guest memory contents outside this file (the
+   segment descriptor cache). The returned tag stays valid until the page is
+   written or the watches are dropped by a flush; 0 means not watchable. */
+uint64_t
+mem_watch_page(uint64_t phys)
+{
+    uint32_t n = (uint32_t) (phys >> 12);
+
+    if (!cpu_use_exec || (mmu_tlb_pt_watch == NULL) || !mmu_tlb_pt_ok(phys))
+        return 0;
+
+    if (!mmu_tlb_pt_watched(n))
+        mmu_tlb_pt_watch_page(n);
+
+    return ((uint64_t) mmu_tlb_epoch << 32) | mmu_tlb_pt_gen[n];
+}
+
+int
+mem_watch_valid(uint64_t phys, uint64_t tag)
+{
+    uint32_t n = (uint32_t) (phys >> 12);
+
+    return mmu_tlb_pt_watched(n) && ((((uint64_t) mmu_tlb_epoch << 32) | mmu_tlb_pt_gen[n]) == tag);
+}
+
+static __inline uint8_t
+mmu_tlb_flags(uint32_t pte, int rw)
+{
+    return ((rw || (pte & 0x40)) ? MMU_TLB_DIRTY : 0) | ((pte & 0x100) ? MMU_TLB_GLOBAL : 0);
+}
+
+static __inline uint32_t
+mmu_tlb_large_mask(void)
+{
+    return (cr4 & CR4_PAE) ? ~0x1ff : ~0x3ff;
+}
+
+static void
+mmu_tlb_large_add(uint32_t vpage)
+{
+    uint32_t frame = vpage & mmu_tlb_large_mask();
+
+    if (mmu_tlb_large > MMU_TLB_LARGE_MAX)
+        return;
+
+    for (int i = 0; i < mmu_tlb_large; i++) {
+        if (mmu_tlb_large_frame[i] == frame)
+            return;
+    }
+
+    if (mmu_tlb_large < MMU_TLB_LARGE_MAX)
+        mmu_tlb_large_frame[mmu_tlb_large] = frame;
+    mmu_tlb_large++;
+}
+
+/* Returns 1 if pieces of the large page at frame may be cached, and forgets it. */
+static int
+mmu_tlb_large_remove(uint32_t frame)
+{
+    if (mmu_tlb_large > MMU_TLB_LARGE_MAX)
+        return 1;
+
+    for (int i = 0; i < mmu_tlb_large; i++) {
+        if (mmu_tlb_large_frame[i] == frame) {
+            mmu_tlb_large_frame[i] = mmu_tlb_large_frame[--mmu_tlb_large];
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+static void
+mmu_tlb_fill(uint32_t addr, uint64_t phys, uint32_t perm, uint8_t flags,
+             uint64_t pt0, uint64_t pt1, uint64_t pt2)
+{
+    uint32_t         vpage = addr >> 12;
+    uint32_t         set   = vpage & (MMU_TLB_SETS - 1);
+    uint32_t         ctx   = mmu_tlb_ctx();
+    uint32_t         pt[3];
+    mmu_tlb_entry_t *e     = NULL;
+
+    if (!cpu_use_exec || (mmu_tlb_pt_watch == NULL) ||
+        !mmu_tlb_pt_ok(pt0) || !mmu_tlb_pt_ok(pt1) || !mmu_tlb_pt_ok(pt2))
+        return;
+
+    pt[0] = (uint32_t) (pt0 >> 12);
+    pt[1] = (uint32_t) (pt1 >> 12);
+    pt[2] = (uint32_t) (pt2 >> 12);
+
+    for (int w = 0; w < MMU_TLB_WAYS; w++) {
+        if ((mmu_tlb[set][w].epoch != mmu_tlb_epoch) ||
+            ((mmu_tlb[set][w].vpage == vpage) &&
+             ((mmu_tlb[set][w].ctx == ctx) || (mmu_tlb[set][w].flags & MMU_TLB_GLOBAL)))) {
+            e = &mmu_tlb[set][w];
+            break;
+        }
+    }
+    if (e == NULL)
+        e = &mmu_tlb[set][mmu_tlb_victim[set]++ & (MMU_TLB_WAYS - 1)];
+
+    for (int i = 0; i < 3; i++) {
+        if (!mmu_tlb_pt_watched(pt[i]))
+            mmu_tlb_pt_watch_page(pt[i]);
+        e->pt_page[i] = pt[i];
+        e->pt_gen[i]  = mmu_tlb_pt_gen[pt[i]];
+    }
+
+    e->vpage = vpage;
+    e->ctx   = ctx;
+    e->phys  = phys & ~0xfffULL;
+    e->perm  = perm & 6;
+    e->flags = flags;
+    if (!(cr4 & CR4_PGE))
+        e->flags &= ~MMU_TLB_GLOBAL;
+    e->epoch = mmu_tlb_epoch;
+
+    if (flags & MMU_TLB_LARGE)
+        mmu_tlb_large_add(vpage);
+}
+
+static void
+mmu_tlb_reset(void)
+{
+    free(mmu_tlb_pt_watch);
+    free(mmu_tlb_pt_gen);
+
+    mmu_tlb_pt_pages = MIN(pages_sz, (uint32_t) (mem_size >> 2));
+    mmu_tlb_pt_watch = (uint16_t *) calloc(mmu_tlb_pt_pages + 1, sizeof(uint16_t));
+    mmu_tlb_pt_gen   = (uint32_t *) calloc(mmu_tlb_pt_pages + 1, sizeof(uint32_t));
+
+    memset(mmu_tlb, 0x00, sizeof(mmu_tlb));
+    memset(mmu_tlb_victim, 0x00, sizeof(mmu_tlb_victim));
+    mmu_tlb_epoch = 1;
+    mmu_tlb_large = 0;
+    mmu_tlb_hits  = 0;
+    mmu_tlb_misses = 0;
+}
+
+/*
+ * Self-modifying code detection by host page protection.
+ *
+ * Normally a guest page holding translated code has every write routed
+ * through the page write handlers, which keep the dirty masks the recompiler
+ * checks. In this mode the host page backing such a guest page is made
+ * read-only instead, and writes to it take the direct lookup path. The first
+ * write faults, and the fault handler marks the whole page dirty and makes
+ * it writable again. The page is protected again the next time a write
+ * lookup is added for it while it holds code. Pages that keep faulting
+ * because they mix code and data go back to the write handlers.
+ */
+#define SMC_PROTECTED  0x80
+#define SMC_FAULTS     0x7f
+#define SMC_MAX_FAULTS 32
+
+uint64_t mem_smc_faults = 0;
+
+static uint8_t *smc_state  = NULL;
+static uint32_t smc_pages  = 0;
+static int      smc_active = 0;
+
+static int
+mem_smc_protect_page(uint32_t n)
+{
+    if (!smc_active || (n >= smc_pages))
+        return 0;
+
+    if (smc_state[n] & SMC_PROTECTED)
+        return 1;
+
+    /* Only pages backed by their own slice of RAM, nothing remapped. */
+    if (((smc_state[n] & SMC_FAULTS) >= SMC_MAX_FAULTS) || (pages[n].mem != &ram[(uintptr_t) n << 12]))
+        return 0;
+
+    if (!mem_smc_host_protect(&ram[(uintptr_t) n << 12], 0))
+        return 0;
+
+    smc_state[n] |= SMC_PROTECTED;
+    return 1;
+}
+
+static void
+mem_smc_unprotect_all(void)
+{
+    if (smc_state == NULL)
+        return;
+
+    for (uint32_t n = 0; n < smc_pages; n++) {
+        if (smc_state[n] & SMC_PROTECTED)
+            mem_smc_host_protect(&ram[(uintptr_t) n << 12], 1);
+        smc_state[n] = 0;
+    }
+}
+
+/* Called from the host fault handler; returns 1 if the fault was ours and the
+   access can be restarted. */
+int
+mem_smc_fault(uintptr_t addr)
+{
+    uint32_t n;
+
+    if (!smc_active || (addr < (uintptr_t) ram) || (addr >= ((uintptr_t) ram + ((uintptr_t) smc_pages << 12))))
+        return 0;
+
+    n = (uint32_t) ((addr - (uintptr_t) ram) >> 12);
+    if (!(smc_state[n] & SMC_PROTECTED))
+        return 0;
+
+    if (!mem_smc_host_protect(&ram[(uintptr_t) n << 12], 1))
+        return 0;
+
+    smc_state[n] &= ~SMC_PROTECTED;
+    if ((smc_state[n] & SMC_FAULTS) < SMC_MAX_FAULTS)
+        smc_state[n]++;
+    mem_smc_faults++;
+
+    mem_invalidate_range(n << 12, n << 12);
+
+    return 1;
+}
+
+static void
+mem_smc_reset(void)
+{
+    free(smc_state);
+    smc_state  = NULL;
+    smc_pages  = 0;
+    smc_active = 0;
+
+    if (!mem_smc_protect || !cpu_use_dynarec || (((uintptr_t) ram) & 0xfff) || !mem_smc_host_init())
+        return;
+
+    smc_pages  = MIN(pages_sz, (uint32_t) (mem_size >> 2));
+    smc_state  = (uint8_t *) calloc(smc_pages, 1);
+    smc_active = (smc_state != NULL);
+}
+
 int
 mem_addr_is_ram(uint32_t addr)
 {
@@ -190,8 +614,8 @@ resetreadlookup(void)
     high_page  = 0;
 }
 
-void
-flushmmucache(void)
+static void
+flushmmucache_lookup(void)
 {
     for (uint16_t c = 0; c < 256; c++) {
         if (readlookup[c] != (int) 0xffffffff) {
@@ -204,7 +628,15 @@ flushmmucache(void)
             writelookup[c]               = 0xffffffff;
         }
     }
+}
+
+/* CR3 load: the tagged translation cache is left alone. */
+void
+flushmmucache_cr3(void)
+{
+    flushmmucache_lookup();
     mmuflush++;
+    mmu_map_gen++;
 
     pccache  = (uint32_t) 0xffffffff;
     pccache2 = (uint8_t *) 0xffffffff;
@@ -214,6 +646,13 @@ flushmmucache(void)
 #endif
 }
 
+void
+flushmmucache(void)
+{
+    flushmmucache_cr3();
+    mmu_tlb_flush();
+}
+
 void
 flushmmucache_write(void)
 {
@@ -243,31 +682,63 @@ flushmmucache_pc(void)
 void
 flushmmucache_nopc(void)
 {
-    for (uint16_t c = 0; c < 256; c++) {
-        if (readlookup[c] != (int) 0xffffffff) {
-            readlookup2[readlookup[c]] = LOOKUP_INV;
-            readlookup[c]              = 0xffffffff;
-        }
-        if (writelookup[c] != (int) 0xffffffff) {
-            page_lookup[writelookup[c]]  = NULL;
-            writelookup2[writelookup[c]] = LOOKUP_INV;
-            writelookup[c]               = 0xffffffff;
+    flushmmucache_lookup();
+    mmu_tlb_flush();
+    mmu_map_gen++;
+}
+
+/* CPL change: the lookup rings were filled with the old CPL's permission
+   checks, the tagged translation cache checks again on every hit. */
+void
+flushmmucache_cpl(void)
+{
+    flushmmucache_lookup();
+}
+
+/* INVLPG: drop the translation for one page, any CR3, global or not. */
+void
+flushmmucache_page(uint32_t addr)
+{
+    uint32_t         vpage = addr >> 12;
+    uint32_t         mask  = mmu_tlb_large_mask();
+    mmu_tlb_entry_t *e     = mmu_tlb[vpage & (MMU_TLB_SETS - 1)];
+
+    flushmmucache_lookup();
+    mmu_map_gen++;
+
+    for (int w = 0; w < MMU_TLB_WAYS; w++) {
+        if (e[w].vpage == vpage)
+            e[w].epoch = 0;
+    }
+
+    /* Large pages are cached per 4K page, drop every piece of the one containing
+       addr. Only scan when that frame has pieces cached. */
+    if (mmu_tlb_large && mmu_tlb_large_remove(vpage & mask)) {
+        e = &mmu_tlb[0][0];
+        for (int i = 0; i < (MMU_TLB_SETS * MMU_TLB_WAYS); i++, e++) {
+            if ((e->flags & MMU_TLB_LARGE) && !((e->vpage ^ vpage) & mask))
+                e->epoch = 0;
         }
     }
 }
 
 void
-mem_flush_write_page(uint32_t addr, uint32_t virt)
+mem_flush_write_page(uint32_t addr, UNUSED(uint32_t virt))
 {
     const page_t *page_target = &pages[addr >> 12];
+    uintptr_t     target      = (uintptr_t) &ram[(uintptr_t) (addr & ~0xfff)];
+    int           v;
 
+    /* Match direct pointers by the RAM page they reach, so every linear alias
+       of the physical page is dropped, not only the one at virt. */
     for (uint16_t c = 0; c < 256; c++) {
-        if (writelookup[c] != (int) 0xffffffff) {
-            uintptr_t target = (uintptr_t) &ram[(uintptr_t) (addr & ~0xfff) - (virt & ~0xfff)];
-            if (writelookup2[writelookup[c]] == target || page_lookup[writelookup[c]] == page_target) {
-                writelookup2[writelookup[c]] = LOOKUP_INV;
-                page_lookup[writelookup[c]]  = NULL;
-                writelookup[c]               = 0xffffffff;
+        v = writelookup[c];
+        if (v != (int) 0xffffffff) {
+            if (((writelookup2[v] != (uintptr_t) LOOKUP_INV) && ((writelookup2[v] + ((uintptr_t) v << 12)) == target)) ||
+                (page_lookup[v] == page_target)) {
+                writelookup2[v] = LOOKUP_INV;
+                page_lookup[v]  = NULL;
+                writelookup[c]  = 0xffffffff;
             }
         }
     }
@@ -323,6 +794,8 @@ mmutranslatereal_normal(uint32_t addr, int rw)
         uint64_t page = temp & ~0x3fffff;
         if (cpu_features & CPU_FEATURE_PSE36)
             page |= (uint64_t) (temp & 0x1e000) << 19;
+        mmu_tlb_fill(addr, page + (addr & 0x3fffff), temp, mmu_tlb_flags(temp, rw) | MMU_TLB_LARGE,
+                     addr2, addr2, addr2);
         return page + (addr & 0x3fffff);
     }
 
@@ -343,6 +816,8 @@ mmutranslatereal_normal(uint32_t addr, int rw)
     rammap(addr2) |= 0x20;
     rammap((temp2 & ~0xfff) + ((addr >> 10) & 0xffc)) |= (rw ? 0x60 : 0x20);
 
+    mmu_tlb_fill(addr, temp, temp3, mmu_tlb_flags(temp, rw), addr2, addr2, temp2 & ~0xfff);
+
     return (uint64_t) ((temp & ~0xfff) + (addr & 0xfff));
 }
 
@@ -405,6 +880,8 @@ mmutranslatereal_pae(uint32_t addr, int rw)
         }
         rammap64(addr3) |= (rw ? 0x60 : 0x20);
 
+        mmu_tlb_fill(addr, (temp & ~0x1fffffULL) + (addr & 0x1fffffULL), (uint32_t) temp,
+                     mmu_tlb_flags((uint32_t) temp, rw) | MMU_TLB_LARGE, addr2, addr3, addr3);
         return ((temp & ~0x1fffffULL) + (addr & 0x1fffffULL)) & 0x000000ffffffffffULL;
     }
 
@@ -426,16 +903,28 @@ mmutranslatereal_pae(uint32_t addr, int rw)
     rammap64(addr3) |= 0x20;
     rammap64(addr4) |= (rw ? 0x60 : 0x20);
 
+    mmu_tlb_fill(addr, temp, (uint32_t) temp3, mmu_tlb_flags((uint32_t) temp, rw), addr2, addr3, addr4);
+
     return ((temp & ~0xfffULL) + ((uint64_t) (addr & 0xfff))) & 0x000000ffffffffffULL;
 }
 
 uint64_t
 mmutranslatereal(uint32_t addr, int rw)
 {
+    uint64_t phys;
+
     /* Fast path to return invalid without any call if an exception has occurred beforehand. */
     if (cpu_state.abrt)
         return 0xffffffffffffffffULL;
 
+    if (mmu_tlb_pt_pages && mmu_tlb_lookup(addr, rw, &phys)) {
+        if (cpu_prof_on)
+            mmu_tlb_hits++;
+        return phys | (addr & 0xfff);
+    }
+    if (cpu_prof_on)
+        mmu_tlb_misses++;
+
     if (cr4 & CR4_PAE)
         return mmutranslatereal_pae(addr, rw);
     else
@@ -621,6 +1110,12 @@ addwritelookup(uint32_t virt, uint32_t phys)
     if (pages[phys >> 12].block[0] || pages[phys >> 12].block[1] || pages[phys >> 12].block[2] || pages[phys >> 12].block[3]) {
 #    endif
 #endif
+        if (!mmu_tlb_pt_watched(phys >> 12) && mem_smc_protect_page(phys >> 12))
+            writelookup2[virt >> 12] = (uintptr_t) &ram[(uintptr_t) (phys & ~0xFFF) - (uintptr_t) (virt & ~0xfff)];
+        else
+            page_lookup[virt >> 12] = &pages[phys >> 12];
+    } else if (mmu_tlb_pt_watched(phys >> 12)) {
+        /* Page tables backing the translation cache, see the writes. */
         page_lookup[virt >> 12]  = &pages[phys >> 12];
     } else {
 
@@ -679,7 +1174,7 @@ read_mem_b(uint32_t addr)
 
     map = read_mapping[addr >> MEM_GRANULARITY_BITS];
     if (map && map->read_b)
-        ret = map->read_b(addr, map->priv);
+        ret = MAP_READ(b, map, addr);
 
     return ret;
 }
@@ -699,9 +1194,9 @@ read_mem_w(uint32_t addr)
         map = read_mapping[addr >> MEM_GRANULARITY_BITS];
 
         if (map && map->read_w)
-            ret = map->read_w(addr, map->priv);
+            ret = MAP_READ(w, map, addr);
         else if (map && map->read_b)
-            ret = map->read_b(addr, map->priv) | (map->read_b(addr + 1, map->priv) << 8);
+            ret = MAP_READ(b, map, addr) | (MAP_READ(b, map, addr + 1) << 8);
     }
 
     return ret;
@@ -717,7 +1212,7 @@ write_mem_b(uint32_t addr, uint8_t val)
 
     map = write_mapping[addr >> MEM_GRANULARITY_BITS];
     if (map && map->write_b)
-        map->write_b(addr, val, map->priv);
+        MAP_WRITE(b, map, addr, val);
 }
 
 void
@@ -735,10 +1230,10 @@ write_mem_w(uint32_t addr, uint16_t val)
         map = write_mapping[addr >> MEM_GRANULARITY_BITS];
         if (map) {
             if (map->write_w)
-                map->write_w(addr, val, map->priv);
+                MAP_WRITE(w, map, addr, val);
             else if (map->write_b) {
-                map->write_b(addr, val, map->priv);
-                map->write_b(addr + 1, val >> 8, map->priv);
+                MAP_WRITE(b, map, addr, val);
+                MAP_WRITE(b, map, addr + 1, val >> 8);
             }
         }
     }
@@ -771,7 +1266,7 @@ readmembl(uint32_t addr)
 
     map = read_mapping[addr >> MEM_GRANULARITY_BITS];
     if (map && map->read_b)
-        return map->read_b(addr, map->priv);
+        return MAP_READ(b, map, addr);
 
     return 0xff;
 }
@@ -808,7 +1303,7 @@ writemembl(uint32_t addr, uint8_t val)
 
     map = write_mapping[addr >> MEM_GRANULARITY_BITS];
     if (map && map->write_b)
-        map->write_b(addr, val, map->priv);
+        MAP_WRITE(b, map, addr, val);
 }
 
 /* Read a byte from memory without MMU translation - result of previous MMU translation passed as value. */
@@ -831,7 +1326,7 @@ readmembl_no_mmut(uint32_t addr, uint32_t a64)
 
     map = read_mapping[addr >> MEM_GRANULARITY_BITS];
     if (map && map->read_b)
-        return map->read_b(addr, map->priv);
+        return MAP_READ(b, map, addr);
 
     return 0xff;
 }
@@ -861,7 +1356,7 @@ writemembl_no_mmut(uint32_t addr, uint32_t a64, uint8_t val)
 
     map = write_mapping[addr >> MEM_GRANULARITY_BITS];
     if (map && map->write_b)
-        map->write_b(addr, val, map->priv);
+        MAP_WRITE(b, map, addr, val);
 }
 
 uint16_t
@@ -915,10 +1410,10 @@ readmemwl(uint32_t addr)
     map = read_mapping[addr >> MEM_GRANULARITY_BITS];
 
     if (map && map->read_w)
-        return map->read_w(addr, map->priv);
+        return MAP_READ(w, map, addr);
 
     if (map && map->read_b) {
-        return map->read_b(addr, map->priv) | ((uint16_t) (map->read_b(addr + 1, map->priv)) << 8);
+        return MAP_READ(b, map, addr) | ((uint16_t) (MAP_READ(b, map, addr + 1)) << 8);
     }
 
     return 0xffff;
@@ -989,13 +1484,13 @@ writememwl(uint32_t addr, uint16_t val)
     map = write_mapping[addr >> MEM_GRANULARITY_BITS];
 
     if (map && map->write_w) {
-        map->write_w(addr, val, map->priv);
+        MAP_WRITE(w, map, addr, val);
         return;
     }
 
     if (map && map->write_b) {
-        map->write_b(addr, val, map->priv);
-        map->write_b(addr + 1, val >> 8, map->priv);
+        MAP_WRITE(b, map, addr, val);
+        MAP_WRITE(b, map, addr + 1, val >> 8);
         return;
     }
 }
@@ -1035,10 +1530,10 @@ readmemwl_no_mmut(uint32_t addr, uint32_t *a64)
     map = read_mapping[addr >> MEM_GRANULARITY_BITS];
 
     if (map && map->read_w)
-        return map->read_w(addr, map->priv);
+        return MAP_READ(w, map, addr);
 
     if (map && map->read_b) {
-        return map->read_b(addr, map->priv) | ((uint16_t) (map->read_b(addr + 1, map->priv)) << 8);
+        return MAP_READ(b, map, addr) | ((uint16_t) (MAP_READ(b, map, addr + 1)) << 8);
     }
 
     return 0xffff;
@@ -1088,13 +1583,13 @@ writememwl_no_mmut(uint32_t addr, uint32_t *a64, uint16_t val)
     map = write_mapping[addr >> MEM_GRANULARITY_BITS];
 
     if (map && map->write_w) {
-        map->write_w(addr, val, map->priv);
+        MAP_WRITE(w, map, addr, val);
         return;
     }
 
     if (map && map->write_b) {
-        map->write_b(addr, val, map->priv);
-        map->write_b(addr + 1, val >> 8, map->priv);
+        MAP_WRITE(b, map, addr, val);
+        MAP_WRITE(b, map, addr + 1, val >> 8);
         return;
     }
 }
@@ -1164,13 +1659,13 @@ readmemll(uint32_t addr)
     map = read_mapping[addr >> MEM_GRANULARITY_BITS];
 
     if (map && map->read_l)
-        return map->read_l(addr, map->priv);
+        return MAP_READ(l, map, addr);
 
     if (map && map->read_w)
-        return map->read_w(addr, map->priv) | ((uint32_t) (map->read_w(addr + 2, map->priv)) << 16);
+        return MAP_READ(w, map, addr) | ((uint32_t) (MAP_READ(w, map, addr + 2)) << 16);
 
     if (map && map->read_b)
-        return map->read_b(addr, map->priv) | ((uint32_t) (map->read_b(addr + 1, map->priv)) << 8) | ((uint32_t) (map->read_b(addr + 2, map->priv)) << 16) | ((uint32_t) (map->read_b(addr + 3, map->priv)) << 24);
+        return MAP_READ(b, map, addr) | ((uint32_t) (MAP_READ(b, map, addr + 1)) << 8) | ((uint32_t) (MAP_READ(b, map, addr + 2)) << 16) | ((uint32_t) (MAP_READ(b, map, addr + 3)) << 24);
 
     return 0xffffffff;
 }
@@ -1253,19 +1748,19 @@ writememll(uint32_t addr, uint32_t val)
     map = write_mapping[addr >> MEM_GRANULARITY_BITS];
 
     if (map && map->write_l) {
-        map->write_l(addr, val, map->priv);
+        MAP_WRITE(l, map, addr, val);
         return;
     }
     if (map && map->write_w) {
-        map->write_w(addr, val, map->priv);
-        map->write_w(addr + 2, val >> 16, map->priv);
+        MAP_WRITE(w, map, addr, val);
+        MAP_WRITE(w, map, addr + 2, val >> 16);
         return;
     }
     if (map && map->write_b) {
-        map->write_b(addr, val, map->priv);
-        map->write_b(addr + 1, val >> 8, map->priv);
-        map->write_b(addr + 2, val >> 16, map->priv);
-        map->write_b(addr + 3, val >> 24, map->priv);
+        MAP_WRITE(b, map, addr, val);
+        MAP_WRITE(b, map, addr + 1, val >> 8);
+        MAP_WRITE(b, map, addr + 2, val >> 16);
+        MAP_WRITE(b, map, addr + 3, val >> 24);
         return;
     }
 }
@@ -1305,13 +1800,13 @@ readmemll_no_mmut(uint32_t addr, uint32_t *a64)
     map = read_mapping[addr >> MEM_GRANULARITY_BITS];
 
     if (map && map->read_l)
-        return map->read_l(addr, map->priv);
+        return MAP_READ(l, map, addr);
 
     if (map && map->read_w)
-        return map->read_w(addr, map->priv) | ((uint32_t) (map->read_w(addr + 2, map->priv)) << 16);
+        return MAP_READ(w, map, addr) | ((uint32_t) (MAP_READ(w, map, addr + 2)) << 16);
 
     if (map && map->read_b)
-        return map->read_b(addr, map->priv) | ((uint32_t) (map->read_b(addr + 1, map->priv)) << 8) | ((uint32_t) (map->read_b(addr + 2, map->priv)) << 16) | ((uint32_t) (map->read_b(addr + 3, map->priv)) << 24);
+        return MAP_READ(b, map, addr) | ((uint32_t) (MAP_READ(b, map, addr + 1)) << 8) | ((uint32_t) (MAP_READ(b, map, addr + 2)) << 16) | ((uint32_t) (MAP_READ(b, map, addr + 3)) << 24);
 
     return 0xffffffff;
 }
@@ -1360,19 +1855,19 @@ writememll_no_mmut(uint32_t addr, uint32_t *a64, uint32_t val)
     map = write_mapping[addr >> MEM_GRANULARITY_BITS];
 
     if (map && map->write_l) {
-        map->write_l(addr, val, map->priv);
+        MAP_WRITE(l, map, addr, val);
         return;
     }
     if (map && map->write_w) {
-        map->write_w(addr, val, map->priv);
-        map->write_w(addr + 2, val >> 16, map->priv);
+        MAP_WRITE(w, map, addr, val);
+        MAP_WRITE(w, map, addr + 2, val >> 16);
         return;
     }
     if (map && map->write_b) {
-        map->write_b(addr, val, map->priv);
-        map->write_b(addr + 1, val >> 8, map->priv);
-        map->write_b(addr + 2, val >> 16, map->priv);
-        map->write_b(addr + 3, val >> 24, map->priv);
+        MAP_WRITE(b, map, addr, val);
+        MAP_WRITE(b, map, addr + 1, val >> 8);
+        MAP_WRITE(b, map, addr + 2, val >> 16);
+        MAP_WRITE(b, map, addr + 3, val >> 24);
         return;
     }
 }
@@ -1441,24 +1936,24 @@ readmemql(uint32_t addr)
     map = read_mapping[addr >> MEM_GRANULARITY_BITS];
 
     if (map && map->read_l)
-        return map->read_l(addr, map->priv) |
-               ((uint64_t) map->read_l(addr + 4, map->priv) << 32);
+        return MAP_READ(l, map, addr) |
+               ((uint64_t) MAP_READ(l, map, addr + 4) << 32);
 
     if (map && map->read_w)
-        return map->read_w(addr, map->priv) |
-               ((uint64_t) map->read_w(addr + 2, map->priv) << 16) |
-               ((uint64_t) map->read_w(addr + 4, map->priv) << 32) |
-               ((uint64_t) map->read_w(addr + 6, map->priv) << 48);
+        return MAP_READ(w, map, addr) |
+               ((uint64_t) MAP_READ(w, map, addr + 2) << 16) |
+               ((uint64_t) MAP_READ(w, map, addr + 4) << 32) |
+               ((uint64_t) MAP_READ(w, map, addr + 6) << 48);
 
     if (map && map->read_b)
-        return map->read_b(addr, map->priv) |
-               ((uint64_t) map->read_b(addr + 1, map->priv) << 8) |
-               ((uint64_t) map->read_b(addr + 2, map->priv) << 16) |
-               ((uint64_t) map->read_b(addr + 3, map->priv) << 24) |
-               ((uint64_t) map->read_b(addr + 4, map->priv) << 32) |
-               ((uint64_t) map->read_b(addr + 5, map->priv) << 40) |
-               ((uint64_t) map->read_b(addr + 6, map->priv) << 48) |
-               ((uint64_t) map->read_b(addr + 7, map->priv) << 56);
+        return MAP_READ(b, map, addr) |
+               ((uint64_t) MAP_READ(b, map, addr + 1) << 8) |
+               ((uint64_t) MAP_READ(b, map, addr + 2) << 16) |
+               ((uint64_t) MAP_READ(b, map, addr + 3) << 24) |
+               ((uint64_t) MAP_READ(b, map, addr + 4) << 32) |
+               ((uint64_t) MAP_READ(b, map, addr + 5) << 40) |
+               ((uint64_t) MAP_READ(b, map, addr + 6) << 48) |
+               ((uint64_t) MAP_READ(b, map, addr + 7) << 56);
 
     return 0xffffffffffffffffULL;
 }
@@ -1539,26 +2034,26 @@ writememql(uint32_t addr, uint64_t val)
     map = write_mapping[addr >> MEM_GRANULARITY_BITS];
 
     if (map && map->write_l) {
-        map->write_l(addr, val, map->priv);
-        map->write_l(addr + 4, val >> 32, map->priv);
+        MAP_WRITE(l, map, addr, val);
+        MAP_WRITE(l, map, addr + 4, val >> 32);
         return;
     }
     if (map && map->write_w) {
-        map->write_w(addr, val, map->priv);
-        map->write_w(addr + 2, val >> 16, map->priv);
-        map->write_w(addr + 4, val >> 32, map->priv);
-        map->write_w(addr + 6, val >> 48, map->priv);
+        MAP_WRITE(w, map, addr, val);
+        MAP_WRITE(w, map, addr + 2, val >> 16);
+        MAP_WRITE(w, map, addr + 4, val >> 32);
+        MAP_WRITE(w, map, addr + 6, val >> 48);
         return;
     }
     if (map && map->write_b) {
-        map->write_b(addr, val, map->priv);
-        map->write_b(addr + 1, val >> 8, map->priv);
-        map->write_b(addr + 2, val >> 16, map->priv);
-        map->write_b(addr + 3, val >> 24, map->priv);
-        map->write_b(addr + 4, val >> 32, map->priv);
-        map->write_b(addr + 5, val >> 40, map->priv);
-        map->write_b(addr + 6, val >> 48, map->priv);
-        map->write_b(addr + 7, val >> 56, map->priv);
+        MAP_WRITE(b, map, addr, val);
+        MAP_WRITE(b, map, addr + 1, val >> 8);
+        MAP_WRITE(b, map, addr + 2, val >> 16);
+        MAP_WRITE(b, map, addr + 3, val >> 24);
+        MAP_WRITE(b, map, addr + 4, val >> 32);
+        MAP_WRITE(b, map, addr + 5, val >> 40);
+        MAP_WRITE(b, map, addr + 6, val >> 48);
+        MAP_WRITE(b, map, addr + 7, val >> 56);
         return;
     }
 }
@@ -1624,7 +2119,7 @@ mem_readb_phys(uint32_t addr)
         if (cpu_use_exec && map->exec)
             ret = map->exec[(addr - map->base) & map->mask];
         else if (map->read_b)
-            ret = map->read_b(addr, map->priv);
+            ret = MAP_READ(b, map, addr);
     }
 
     return ret;
@@ -1643,7 +2138,7 @@ mem_readw_phys(uint32_t addr)
         p   = (uint16_t *) &(map->exec[(addr - map->base) & map->mask]);
         ret = *p;
     } else if (((addr & MEM_GRANULARITY_MASK) <= MEM_GRANULARITY_HBOUND) && (map && map->read_w))
-        ret = map->read_w(addr, map->priv);
+        ret = MAP_READ(w, map, addr);
     else {
         ret = mem_readb_phys(addr + 1) << 8;
         ret |= mem_readb_phys(addr);
@@ -1665,7 +2160,7 @@ mem_readl_phys(uint32_t addr)
         p   = (uint32_t *) &(map->exec[(addr - map->base) & map->mask]);
         ret = *p;
     } else if (((addr & MEM_GRANULARITY_MASK) <= MEM_GRANULARITY_QBOUND) && (map && map->read_l))
-        ret = map->read_l(addr, map->priv);
+        ret = MAP_READ(l, map, addr);
     else {
         ret = mem_readw_phys(addr + 2) << 16;
         ret |= mem_readw_phys(addr);
@@ -1701,10 +2196,11 @@ mem_writeb_phys(uint32_t addr, uint8_t val)
     mem_logical_addr = 0xffffffff;
 
     if (map) {
-        if (cpu_use_exec && map->exec)
+        if (cpu_use_exec && map->exec) {
             map->exec[(addr - map->base) & map->mask] = val;
-        else if (map->write_b)
-            map->write_b(addr, val, map->priv);
+            mmu_tlb_pt_write(addr >> 12);
+        } else if (map->write_b)
+            MAP_WRITE(b, map, addr, val);
     }
 }
 
@@ -1719,8 +2215,9 @@ mem_writew_phys(uint32_t addr, uint16_t val)
     if (cpu_use_exec && ((addr & MEM_GRANULARITY_MASK) <= MEM_GRANULARITY_HBOUND) && (map && map->exec)) {
         p  = (uint16_t *) &(map->exec[(addr - map->base) & map->mask]);
         *p = val;
+        mmu_tlb_pt_write(addr >> 12);
     } else if (((addr & MEM_GRANULARITY_MASK) <= MEM_GRANULARITY_HBOUND) && (map && map->write_w))
-        map->write_w(addr, val, map->priv);
+        MAP_WRITE(w, map, addr, val);
     else {
         mem_writeb_phys(addr, val & 0xff);
         mem_writeb_phys(addr + 1, (val >> 8) & 0xff);
@@ -1738,8 +2235,9 @@ mem_writel_phys(uint32_t addr, uint32_t val)
     if (cpu_use_exec && ((addr & MEM_GRANULARITY_MASK) <= MEM_GRANULARITY_QBOUND) && (map && map->exec)) {
         p  = (uint32_t *) &(map->exec[(addr - map->base) & map->mask]);
         *p = val;
+        mmu_tlb_pt_write(addr >> 12);
     } else if (((addr & MEM_GRANULARITY_MASK) <= MEM_GRANULARITY_QBOUND) && (map && map->write_l))
-        map->write_l(addr, val, map->priv);
+        MAP_WRITE(l, map, addr, val);
     else {
         mem_writew_phys(addr, val & 0xffff);
         mem_writew_phys(addr + 2, (val >> 16) & 0xffff);
@@ -1892,6 +2390,7 @@ mem_write_ramb_page(uint32_t addr, uint8_t val, page_t *page)
 #    else
     if ((page->mem == NULL) || (page->mem == page_ff) || (val != page->mem[addr & 0xfff])) {
 #    endif
+        mmu_tlb_pt_write((uint32_t) (page - pages));
         uint64_t mask        = (uint64_t) 1 << ((addr >> PAGE_MASK_SHIFT) & PAGE_MASK_MASK);
         int      byte_offset = (addr >> PAGE_BYTE_MASK_SHIFT) & PAGE_BYTE_MASK_OFFSET_MASK;
         uint64_t byte_mask   = (uint64_t) 1 << (addr & PAGE_BYTE_MASK_MASK);
@@ -1917,6 +2416,7 @@ mem_write_ramw_page(uint32_t addr, uint16_t val, page_t *page)
 #    else
     if ((page->mem == NULL) || (page->mem == page_ff) || (val != *(uint16_t *) &page->mem[addr & 0xfff])) {
 #    endif
+        mmu_tlb_pt_write((uint32_t) (page - pages));
         uint64_t mask        = (uint64_t) 1 << ((addr >> PAGE_MASK_SHIFT) & PAGE_MASK_MASK);
         int      byte_offset = (addr >> PAGE_BYTE_MASK_SHIFT) & PAGE_BYTE_MASK_OFFSET_MASK;
         uint64_t byte_mask   = (uint64_t) 1 << (addr & PAGE_BYTE_MASK_MASK);
@@ -1952,6 +2452,7 @@ mem_write_raml_page(uint32_t addr, uint32_t val, page_t *page)
 #    else
     if ((page->mem == NULL) || (page->mem == page_ff) || (val != *(uint32_t *) &page->mem[addr & 0xfff])) {
 #    endif
+        mmu_tlb_pt_write((uint32_t) (page - pages));
         uint64_t mask        = (uint64_t) 1 << ((addr >> PAGE_MASK_SHIFT) & PAGE_MASK_MASK);
         int      byte_offset = (addr >> PAGE_BYTE_MASK_SHIFT) & PAGE_BYTE_MASK_OFFSET_MASK;
         uint64_t byte_mask   = (uint64_t) 0xf << (addr & PAGE_BYTE_MASK_MASK);
@@ -1984,6 +2485,7 @@ mem_write_ramb_page(uint32_t addr, uint8_t val, page_t *page)
 #    else
     if ((page->mem == NULL) || (page->mem == page_ff) || (val != page->mem[addr & 0xfff])) {
 #    endif
+        mmu_tlb_pt_write((uint32_t) (page - pages));
         uint64_t mask = (uint64_t) 1 << ((addr >> PAGE_MASK_SHIFT) & PAGE_MASK_MASK);
         page->dirty_mask[(addr >> PAGE_MASK_INDEX_SHIFT) & PAGE_MASK_INDEX_MASK] |= mask;
         page->mem[addr & 0xfff] = val;
@@ -2001,6 +2503,7 @@ mem_write_ramw_page(uint32_t addr, uint16_t val, page_t *page)
 #    else
     if ((page->mem == NULL) || (page->mem == page_ff) || (val != *(uint16_t *) &page->mem[addr & 0xfff])) {
 #    endif
+        mmu_tlb_pt_write((uint32_t) (page - pages));
         uint64_t mask = (uint64_t) 1 << ((addr >> PAGE_MASK_SHIFT) & PAGE_MASK_MASK);
         if ((addr & 0xf) == 0xf)
             mask |= (mask << 1);
@@ -2020,6 +2523,7 @@ mem_write_raml_page(uint32_t addr, uint32_t val, page_t *page)
 #    else
     if ((page->mem == NULL) || (page->mem == page_ff) || (val != *(uint32_t *) &page->mem[addr & 0xfff])) {
 #    endif
+        mmu_tlb_pt_write((uint32_t) (page - pages));
         uint64_t mask = (uint64_t) 1 << ((addr >> PAGE_MASK_SHIFT) & PAGE_MASK_MASK);
         if ((addr & 0xf) >= 0xd)
             mask |= (mask << 1);
@@ -2213,6 +2717,8 @@ mem_invalidate_range(uint32_t start_addr, uint32_t end_addr)
         if ((start_addr >> 12) >= pages_sz)
             continue;
 
+        mmu_tlb_pt_write(start_addr >> 12);
+
         page = &pages[start_addr >> 12];
         if (page) {
             page->dirty_mask = 0xffffffffffffffffULL;
@@ -2235,6 +2741,7 @@ mem_invalidate_range(uint32_t start_addr, uint32_t end_addr)
         cur_addr = (start_addr >> 12);
         if (cur_addr < pages_sz)
             memset(pages[cur_addr].dirty_mask, 0xff, sizeof(pages[cur_addr].dirty_mask));
+        mmu_tlb_pt_write(cur_addr);
     }
 #endif
 }
@@ -2735,6 +3242,7 @@ mem_init_ram_mapping(mem_mapping_t *mapping, uint32_t base, uint32_t size)
 void
 mem_zero(void)
 {
+    mem_smc_unprotect_all();
     memset(ram, 0x00, ram_size + 16);
 }
 
@@ -2765,6 +3273,7 @@ mem_reset(void)
     }
 
     if (ram != NULL) {
+        mem_smc_unprotect_all();
         plat_munmap(ram, ram_size);
         ram      = NULL;
         ram_size = 0;
@@ -2812,6 +3321,9 @@ mem_reset(void)
 
     memset(page_lookup, 0x00, (1 << 20) * sizeof(page_t *));
 
+    mmu_tlb_reset();
+    mem_smc_reset();
+
 #ifdef USE_NEW_DYNAREC
     byte_dirty_mask = calloc(1, (mem_size * 1024) / 8);
 
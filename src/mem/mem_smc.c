@@ -0,0 +1,137 @@
+/*
+ * 86Box    A hypervisor and IBM PC system emulator that specializes in
+ *          running old operating systems and software designed for IBM
+ *          PC systems and compatibles from 1981 through fairly recent
+ *          system designs based on the PCI bus.
+ *
+ *          This file is part of the 86Box distribution.
+ *
+ *          Host side of the page protection based self-modifying code
+ *          detection: write-protecting guest RAM pages and catching the
+ *          resulting access faults.
+ *
+ *          Only used when the host page size matches the 4K guest page
+ *          size; everywhere else mem_smc_host_init() fails and writes to
+ *          code pages keep going through the page write handlers.
+ */
+#include <stdarg.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <wchar.h>
+#ifdef _WIN32
+#    define WIN32_LEAN_AND_MEAN
+#    include <windows.h>
+#else
+#    include <signal.h>
+#    include <sys/mman.h>
+#    include <unistd.h>
+#endif
+#define HAVE_STDARG_H
+#include <86box/86box.h>
+#include <86box/mem.h>
+
+static int smc_host_state = 0; /* 0 = not tried, 1 = usable, -1 = unusable */
+
+#ifdef _WIN32
+static PVOID smc_veh = NULL;
+
+static LONG CALLBACK
+mem_smc_exception(PEXCEPTION_POINTERS ep)
+{
+    const EXCEPTION_RECORD *er = ep->ExceptionRecord;
+
+    /* ExceptionInformation[0] is 1 for a write, [1] is the faulting address. */
+    if ((er->ExceptionCode == EXCEPTION_ACCESS_VIOLATION) && (er->NumberParameters >= 2) &&
+        (er->ExceptionInformation[0] == 1) && mem_smc_fault((uintptr_t) er->ExceptionInformation[1]))
+        return EXCEPTION_CONTINUE_EXECUTION;
+
+    return EXCEPTION_CONTINUE_SEARCH;
+}
+
+static int
+mem_smc_host_install(void)
+{
+    SYSTEM_INFO si;
+
+    GetSystemInfo(&si);
+    if (si.dwPageSize != 4096)
+        return 0;
+
+    smc_veh = AddVectoredExceptionHandler(1, mem_smc_exception);
+
+    return (smc_veh != NULL);
+}
+
+int
+mem_smc_host_protect(void *p, int writable)
+{
+    DWORD old;
+
+    return !!VirtualProtect(p, 4096, writable ? PAGE_READWRITE : PAGE_READONLY, &old);
+}
+#else
+static struct sigaction smc_old_segv;
+static struct sigaction smc_old_bus;
+
+static void
+mem_smc_signal(int sig, siginfo_t *info, void *ctx)
+{
+    const struct sigaction *old = (sig == SIGBUS) ? &smc_old_bus : &smc_old_segv;
+
+    if (mem_smc_fault((uintptr_t) info->si_addr))
+        return;
+
+    /* Not one of ours, pass it on to whoever was there before. */
+    if (old->sa_flags & SA_SIGINFO) {
+        if (old->sa_sigaction != NULL)
+            old->sa_sigaction(sig, info, ctx);
+    } else if ((old->sa_handler == SIG_DFL) || (old->sa_handler == SIG_IGN)) {
+        /* Restore it and let the access fault again. */
+        sigaction(sig, old, NULL);
+    } else
+        old->sa_handler(sig);
+}
+
+static int
+mem_smc_host_install(void)
+{
+    struct sigaction sa;
+
+    if (sysconf(_SC_PAGESIZE) != 4096)
+        return 0;
+
+    memset(&sa, 0x00, sizeof(sa));
+    sa.sa_sigaction = mem_smc_signal;
+    sa.sa_flags     = SA_SIGINFO;
+    sigemptyset(&sa.sa_mask);
+
+    if (sigaction(SIGSEGV, &sa, &smc_old_segv) != 0)
+        return 0;
+    /* macOS reports writes to read-only pages as SIGBUS. */
+    if (sigaction(SIGBUS, &sa, &smc_old_bus) != 0) {
+        sigaction(SIGSEGV, &smc_old_segv, NULL);
+        return 0;
+    }
+
+    return 1;
+}
+
+int
+mem_smc_host_protect(void *p, int writable)
+{
+    return (mprotect(p, 4096, PROT_READ | (writable ? PROT_WRITE : 0)) == 0);
+}
+#endif
+
+int
+mem_smc_host_init(void)
+{
+    if (smc_host_state == 0) {
+        smc_host_state = mem_smc_host_install() ? 1 : -1;
+        if (smc_host_state < 0)
+            pclog("MEM: Page protection not available, tracking writes to code pages per store\n");
+    }
+
+    return (smc_host_state > 0);
+}
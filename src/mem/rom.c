@@ -20,6 +20,7 @@
  *          Copyright 2016-2019 Miran Grca.
  *          Copyright 2018-2019 Fred N. van Kempen.
  */
+#include <ctype.h>
 #include <stdarg.h>
 #include <stdio.h>
 #include <stdint.h>
@@ -27,6 +28,8 @@
 #include <stdlib.h>
 #include <wchar.h>
 #include <stdbool.h>
+#include <sys/stat.h>
+#include <time.h>
 #define HAVE_STDARG_H
 #include <86box/86box.h>
 #include "cpu.h"
@@ -34,6 +37,8 @@
 #include <86box/rom.h>
 #include <86box/path.h>
 #include <86box/plat.h>
+#include <86box/plat_dir.h>
+#include <86box/thread.h>
 #include <86box/machine.h>
 #include <86box/m_xt_xi8088.h>
 
@@ -55,6 +60,37 @@ rom_log(const char *fmt, ...)
 #    define rom_log(fmt, ...)
 #endif
 
+/*
+   Index of every file under the ROM paths, so that rom_present() can answer
+   the availability scans of the machine and device lists (thousands of names
+   times every ROM path) from memory. It is built on first use and rebuilt
+   when a ROM path is added or, checked at most once a second, when the
+   modification time of any indexed directory changes.
+ */
+#define ROM_INDEX_DEPTH    16
+#define ROM_INDEX_RECHECK  1000 /* ms */
+
+typedef struct rom_index_dir_t {
+    char  *path;
+    time_t mtime;
+} rom_index_dir_t;
+
+enum {
+    ROM_INDEX_NONE = 0,
+    ROM_INDEX_VALID,
+    ROM_INDEX_UNUSABLE /* fall back to probing the filesystem */
+};
+
+static mutex_t         *rom_index_mutex;
+static int              rom_index_state;
+static uint32_t         rom_index_checked;
+static char           **rom_index;
+static uint32_t         rom_index_size;
+static uint32_t         rom_index_count;
+static rom_index_dir_t *rom_index_dirs;
+static int              rom_index_dirs_num;
+static int              rom_index_dirs_max;
+
 static void
 add_path(rom_path_t *list, const char *path)
 {
@@ -93,10 +129,19 @@ add_path(rom_path_t *list, const char *path)
     }
 }
 
+static void rom_index_free(void);
+
 void
 rom_add_path(const char *path)
 {
+    if (rom_index_mutex == NULL)
+        rom_index_mutex = thread_create_mutex();
+
     add_path(&rom_paths, path);
+
+    thread_wait_mutex(rom_index_mutex);
+    rom_index_free();
+    thread_release_mutex(rom_index_mutex);
 }
 
 void
@@ -280,16 +325,245 @@ asset_getfile(const char *fn, char *s, int size)
     }
 }
 
+/* Relative path as stored in the index, folded on hosts with case-insensitive file systems. */
+static void
+rom_index_key(char *dest, const char *src, size_t size)
+{
+    size_t i;
+
+    for (i = 0; (src[i] != '\0') && (i < (size - 1)); i++) {
+#if defined(_WIN32) || defined(__APPLE__)
+        dest[i] = (src[i] == '\\') ? '/' : (char) tolower((unsigned char) src[i]);
+#else
+        dest[i] = src[i];
+#endif
+    }
+
+    dest[i] = '\0';
+}
+
+static uint32_t
+rom_index_hash(const char *key)
+{
+    uint32_t h = 0x811c9dc5;
+
+    while (*key)
+        h = (h ^ (uint8_t) *key++) * 0x01000193;
+
+    return h;
+}
+
+static char **
+rom_index_slot(const char *key)
+{
+    uint32_t i = rom_index_hash(key) & (rom_index_size - 1);
+
+    while ((rom_index[i] != NULL) && strcmp(rom_index[i], key))
+        i = (i + 1) & (rom_index_size - 1);
+
+    return &rom_index[i];
+}
+
+static void
+rom_index_insert(const char *rel)
+{
+    char   key[1024];
+    char **old;
+    char **slot;
+    uint32_t old_size;
+
+    if ((rom_index_count + 1) * 2 > rom_index_size) {
+        old      = rom_index;
+        old_size = rom_index_size;
+
+        rom_index_size = old_size ? (old_size << 1) : 4096;
+        rom_index      = (char **) calloc(rom_index_size, sizeof(char *));
+        for (uint32_t i = 0; i < old_size; i++) {
+            if (old[i] != NULL)
+                *rom_index_slot(old[i]) = old[i];
+        }
+        free(old);
+    }
+
+    rom_index_key(key, rel, sizeof(key));
+    slot = rom_index_slot(key);
+    if (*slot == NULL) {
+        *slot = strdup(key);
+        rom_index_count++;
+    }
+}
+
+static time_t
+rom_index_mtime(const char *path)
+{
+    struct stat st;
+
+    if (stat(path, &st) != 0)
+        return (time_t) -1;
+
+    return st.st_mtime;
+}
+
+/* Missing directories are recorded too, so that their creation is noticed. */
+static int
+rom_index_add_dir(const char *path)
+{
+    if (rom_index_dirs_num == rom_index_dirs_max) {
+        rom_index_dirs_max = rom_index_dirs_max ? (rom_index_dirs_max << 1) : 64;
+        rom_index_dirs     = (rom_index_dir_t *) realloc(rom_index_dirs, rom_index_dirs_max * sizeof(rom_index_dir_t));
+    }
+
+    rom_index_dirs[rom_index_dirs_num].path  = strdup(path);
+    rom_index_dirs[rom_index_dirs_num].mtime = rom_index_mtime(path);
+
+    return rom_index_dirs[rom_index_dirs_num++].mtime != (time_t) -1;
+}
+
+static int
+rom_index_scan(const char *dir, const char *rel, int depth)
+{
+    struct dirent *entry;
+    DIR           *dirp;
+    char           path[1024];
+    char           sub[1024];
+    int            ret = 1;
+
+#ifdef MAXDIRLEN
+    /* The Win32 opendir() only has room for MAXDIRLEN characters. */
+    if (strlen(dir) > (MAXDIRLEN - 4))
+        return 0;
+#endif
+
+    if (!rom_index_add_dir(dir) || ((dirp = opendir(dir)) == NULL))
+        return 0;
+
+    while (ret && ((entry = readdir(dirp)) != NULL)) {
+        if ((entry->d_name[0] == '.') && ((entry->d_name[1] == '\0') ||
+            ((entry->d_name[1] == '.') && (entry->d_name[2] == '\0'))))
+            continue;
+
+        path_append_filename(path, dir, entry->d_name);
+        snprintf(sub, sizeof(sub), "%s%s", rel, entry->d_name);
+
+        if (plat_dir_check(path)) {
+            /* Symbolic link loops end here too. */
+            if (depth >= ROM_INDEX_DEPTH)
+                continue;
+            path_slash(path);
+            strncat(sub, "/", sizeof(sub) - strlen(sub) - 1);
+            ret = rom_index_scan(path, sub, depth + 1);
+        } else
+            rom_index_insert(sub);
+    }
+
+    closedir(dirp);
+
+    return ret;
+}
+
+static void
+rom_index_free(void)
+{
+    for (uint32_t i = 0; i < rom_index_size; i++)
+        free(rom_index[i]);
+    free(rom_index);
+    rom_index       = NULL;
+    rom_index_size  = 0;
+    rom_index_count = 0;
+
+    for (int i = 0; i < rom_index_dirs_num; i++)
+        free(rom_index_dirs[i].path);
+    rom_index_dirs_num = 0;
+
+    rom_index_state = ROM_INDEX_NONE;
+}
+
+static void
+rom_index_build(void)
+{
+    rom_index_free();
+
+    rom_index_state = ROM_INDEX_VALID;
+    for (rom_path_t *rom_path = &rom_paths; rom_path != NULL; rom_path = rom_path->next) {
+        if (rom_path->path[0] == '\0') {
+            rom_index_state = ROM_INDEX_UNUSABLE;
+            break;
+        }
+
+        /* A missing ROM path is fine, it just has nothing in it. */
+        if (!plat_dir_check(rom_path->path))
+            (void) rom_index_add_dir(rom_path->path);
+        else if (!rom_index_scan(rom_path->path, "", 0)) {
+            rom_index_state = ROM_INDEX_UNUSABLE;
+            break;
+        }
+    }
+
+    rom_index_checked = plat_get_ticks();
+
+    rom_log("ROM index: %i files in %i directories%s\n", rom_index_count, rom_index_dirs_num,
+            (rom_index_state == ROM_INDEX_UNUSABLE) ? ", unusable" : "");
+}
+
+static void
+rom_index_validate(void)
+{
+    uint32_t now = plat_get_ticks();
+
+    if ((now - rom_index_checked) < ROM_INDEX_RECHECK)
+        return;
+
+    rom_index_checked = now;
+
+    for (int i = 0; i < rom_index_dirs_num; i++) {
+        if (rom_index_mtime(rom_index_dirs[i].path) != rom_index_dirs[i].mtime) {
+            rom_index_build();
+            return;
+        }
+    }
+}
+
+/* Returns 1 or 0 if the index can tell whether the ROM exists, -1 otherwise. */
+static int
+rom_index_lookup(const char *rel)
+{
+    char key[1024];
+    int  ret = -1;
+
+    if (rom_index_mutex == NULL)
+        return ret;
+
+    thread_wait_mutex(rom_index_mutex);
+
+    if (rom_index_state == ROM_INDEX_NONE)
+        rom_index_build();
+    else
+        rom_index_validate();
+
+    if (rom_index_state == ROM_INDEX_VALID) {
+        rom_index_key(key, rel, sizeof(key));
+        ret = (rom_index_size != 0) && (*rom_index_slot(key) != NULL);
+    }
+
+    thread_release_mutex(rom_index_mutex);
+
+    return ret;
+}
+
 int
 rom_present(const char *fn)
 {
     char temp[1024];
+    int  ret;
 
     if (fn == NULL)
         return 0;
 
     if (!strncmp(fn, "roms/", 5)) {
         /* Relative path */
+        if ((ret = rom_index_lookup(fn + 5)) != -1)
+            return ret;
+
         for (rom_path_t *rom_path = &rom_paths; rom_path != NULL; rom_path = rom_path->next) {
             path_append_filename(temp, rom_path->path, fn + 5);
 
@@ -477,10 +477,13 @@ pic_read(uint16_t addr, void *priv)
                 dev->data_bus = 0x80 | (dev->interrupt & 7);
                 pic_acknowledge(dev);
                 dev->int_pending = 0;
-                update_pending();
             } else
                 dev->data_bus = 0x00;
             dev->ocw3 &= ~0x04;
+            /* Always re-evaluate on unfreeze: requests raised during the poll
+               were not evaluated, and picint_common() only re-evaluates on
+               the edge that changes them. */
+            update_pending();
         } else if (addr & 0x0001)
             dev->data_bus = dev->imr;
         else if (dev->ocw3 & 0x02) {
@@ -510,6 +513,8 @@ pic_write(uint16_t addr, uint8_t val, void *priv)
     dev->data_bus = val;
 
     if (addr & 0x0001) {
+        int in_init = (dev->state != STATE_NONE);
+
         switch (dev->state) {
             case STATE_ICW2:
                 dev->icw2 = val;
@@ -537,6 +542,10 @@ pic_write(uint16_t addr, uint8_t val, void *priv)
             default:
                 break;
         }
+
+        /* Initialization is over, re-evaluate what ICW1 left pending. */
+        if (in_init && (dev->state == STATE_NONE))
+            update_pending();
     } else {
         if (val & 0x10) {
             /* Treat any write with any of the bits 7 to 5 set as invalid if PCI. */
@@ -689,6 +698,7 @@ picint_common(uint16_t num, int level, int set, uint8_t *irq_state)
     uint8_t slaves = 0;
     uint16_t w;
     uint16_t lines = level ? 0x0000 : num;
+    uint16_t old_irr;
     pic_t   *dev;
 
     /*
@@ -756,6 +766,8 @@ picint_common(uint16_t num, int level, int set, uint8_t *irq_state)
        acpi_rtc_status = !!set;
 
    if (num) {
+       old_irr = pic.irr | (pic2.irr << 8);
+
        if (set) {
             if (smi_irq_mask & num) {
                 smi_raise();
@@ -797,7 +809,12 @@ picint_common(uint16_t num, int level, int set, uint8_t *irq_state)
             }
         }
 
-        update_pending();
+        /* Re-evaluate only if a request actually changed: with the PIT at
+           high rates, most edges clear an already clear IRQ 0 or raise an
+           already latched one. With fast off IRQs enabled, keep evaluating
+           on every edge as that is what restarts the fast off timer. */
+        if (((pic.irr | (pic2.irr << 8)) != old_irr) || cpu_fast_off_flags)
+            update_pending();
     }
 }
 
@@ -95,7 +95,7 @@ HarddiskDialog::HarddiskDialog(bool existing, QWidget *parent)
                             tr("Differencing VHD") % util::DlgFilter({ "vhd" }, true) });
 
     if (existing) {
-        ui->fileField->setFilter(tr("Hard disk images") % util::DlgFilter({ "hd?", "im?", "vhd" }) % tr("All files") % util::DlgFilter({ "*" }, true));
+        ui->fileField->setFilter(tr("Hard disk images") % util::DlgFilter({ "hd?", "im?", "vhd", "chd" }) % tr("All files") % util::DlgFilter({ "*" }, true));
 
         setWindowTitle(tr("Add Existing Hard Disk"));
         ui->lineEditCylinders->setEnabled(false);
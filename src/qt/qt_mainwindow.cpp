@@ -54,6 +54,7 @@ extern "C" {
 #include <86box/apm.h>
 #include <86box/nvr.h>
 #include <86box/acpi.h>
+#include <86box/cpu_prof.h>
 #include <86box/renderdefs.h>
 
 #ifdef USE_VNC
@@ -64,6 +65,7 @@ extern int qt_nvr_save(void);
 
 #ifdef MTR_ENABLED
 #    include <minitrace/minitrace.h>
+#    include <86box/trace.h>
 #endif
 
 extern bool cpu_thread_running;
@@ -760,12 +762,10 @@ MainWindow::MainWindow(QWidget *parent)
         ui->actionEnd_trace->setShortcut(QKeySequence(Qt::Key_Control + Qt::Key_T));
         ui->actionEnd_trace->setDisabled(true);
         static auto init_trace = [&] {
-            mtr_init("trace.json");
-            mtr_start();
+            trace_start("trace.json");
         };
         static auto shutdown_trace = [&] {
-            mtr_stop();
-            mtr_shutdown();
+            trace_stop("trace_counters.json");
         };
         static bool trace = false;
         connect(ui->actionBegin_trace, &QAction::triggered, this, [this] {
@@ -795,6 +795,13 @@ MainWindow::MainWindow(QWidget *parent)
     connect(new QShortcut(QKeySequence(Qt::SHIFT + Qt::Key_F10), this), &QShortcut::activated, this, []() {});
 #endif
 
+    /* Start, or write out and stop, the guest execution profiler. */
+#if QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)
+    connect(new QShortcut(QKeySequence(Qt::CTRL | Qt::ALT | Qt::SHIFT | Qt::Key_P), this), &QShortcut::activated, this, []() { cpu_prof_request_toggle(); });
+#else
+    connect(new QShortcut(QKeySequence(Qt::CTRL + Qt::ALT + Qt::SHIFT + Qt::Key_P), this), &QShortcut::activated, this, []() { cpu_prof_request_toggle(); });
+#endif
+
     connect(this, &MainWindow::initRendererMonitor, this, &MainWindow::initRendererMonitorSlot);
     connect(this, &MainWindow::initRendererMonitorForNonQtThread, this, &MainWindow::initRendererMonitorSlot, Qt::BlockingQueuedConnection);
     connect(this, &MainWindow::destroyRendererMonitor, this, &MainWindow::destroyRendererMonitorSlot);
@@ -73,6 +73,24 @@ protected:
 
     virtual int output() const = 0;
 
+    /*
+     * Block loop shared by inputBlock() overrides. Called on a final class,
+     * input() and output() are bound statically and can be inlined.
+     */
+    template<class T>
+    static inline int inputBlockImpl(T& r, const int* samples, unsigned int n, short* buf, int scaleFactor)
+    {
+        int s = 0;
+
+        for (unsigned int i = 0; i < n; i++)
+        {
+            if (r.input(samples[i]))
+                buf[s++] = r.getOutput(scaleFactor);
+        }
+
+        return s;
+    }
+
     Resampler() {}
 
 public:
@@ -86,6 +104,20 @@ public:
      */
     virtual bool input(int sample) = 0;
 
+    /**
+     * Input a block of samples, storing each sample that becomes ready.
+     *
+     * @param samples input samples
+     * @param n number of input samples
+     * @param buf audio output buffer
+     * @param scaleFactor output scale, see getOutput()
+     * @return number of samples produced
+     */
+    virtual int inputBlock(const int* samples, unsigned int n, short* buf, int scaleFactor)
+    {
+        return inputBlockImpl(*this, samples, n, buf, scaleFactor);
+    }
+
     /**
      * Output a sample from resampler.
      *
@@ -77,6 +77,12 @@ public:
         return s1->input(sample) && s2->input(s1->output());
     }
 
+    // Lets both sinc passes inline into the block loop.
+    int inputBlock(const int* samples, unsigned int n, short* buf, int scaleFactor) override
+    {
+        return inputBlockImpl(*this, samples, n, buf, scaleFactor);
+    }
+
     int output() const override
     {
         return s2->output();
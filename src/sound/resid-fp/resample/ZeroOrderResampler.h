@@ -74,6 +74,12 @@ public:
         return ready;
     }
 
+    // The interpolation step is a few adds, so a call per sample would dominate.
+    int inputBlock(const int* samples, unsigned int n, short* buf, int scaleFactor) override
+    {
+        return inputBlockImpl(*this, samples, n, buf, scaleFactor);
+    }
+
     int output() const override { return outputValue; }
 
     void reset() override
@@ -99,6 +99,9 @@ private:
     /// Time until #voiceSync must be run.
     unsigned int nextVoiceSync;
 
+    /// Number of cycles rendered before handing them to the resampler
+    static constexpr unsigned int CLOCK_BLOCK = 256;
+
     /// Currently active chip model.
     ChipModel model;
 
@@ -357,22 +360,32 @@ int SID::clock(unsigned int cycles, short* buf)
 
         if (likely(delta_t > 0))
         {
-            for (unsigned int i = 0; i < delta_t; i++)
-            {
-                // clock waveform generators
-                voice[0].wave()->clock();
-                voice[1].wave()->clock();
-                voice[2].wave()->clock();
+            // Render the chip output in blocks, then resample each block in
+            // one go; this keeps the per-cycle loop free of the resampler's
+            // virtual call and lets both loops stay tight.
+            int block[CLOCK_BLOCK];
 
-                // clock envelope generators
-                voice[0].envelope()->clock();
-                voice[1].envelope()->clock();
-                voice[2].envelope()->clock();
+            for (unsigned int done = 0; done < delta_t; )
+            {
+                const unsigned int n = std::min(delta_t - done, static_cast<unsigned int>(CLOCK_BLOCK));
 
-                if (unlikely(resampler->input(output())))
+                for (unsigned int i = 0; i < n; i++)
                 {
-                    buf[s++] = resampler->getOutput(scaleFactor);
+                    // clock waveform generators
+                    voice[0].wave()->clock();
+                    voice[1].wave()->clock();
+                    voice[2].wave()->clock();
+
+                    // clock envelope generators
+                    voice[0].envelope()->clock();
+                    voice[1].envelope()->clock();
+                    voice[2].envelope()->clock();
+
+                    block[i] = output();
                 }
+
+                s += resampler->inputBlock(block, n, buf + s, scaleFactor);
+                done += n;
             }
 
             cycles -= delta_t;
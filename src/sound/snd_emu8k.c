@@ -16,6 +16,7 @@
 #include <86box/rom.h>
 #include <86box/sound.h>
 #include <86box/snd_emu8k.h>
+#include <86box/thread.h>
 #include <86box/timer.h>
 #include <86box/plat_unused.h>
 
@@ -115,6 +116,8 @@ enum {
     ENV_RAMP_UP   = 8
 };
 
+static void emu8k_fx_wait(emu8k_t *emu8k);
+
 static int random_helper = 0;
 int        dmareadbit    = 0;
 int        dmawritebit   = 0;
@@ -797,6 +800,12 @@ emu8k_outw(uint16_t addr, uint16_t val, void *priv)
      * Basically, being here means that the audio is generated in the emulation thread, instead of the audio thread.*/
     emu8k_update(emu8k);
 
+    /* Reverb and chorus parameters live in INIT1-4 and HWCF4/5, don't change them under the worker. */
+    if (emu8k->fx_thread && (((addr & 0xF00) == 0xA00) &&
+        ((emu8k->cur_reg == 2) || (emu8k->cur_reg == 3) ||
+         ((emu8k->cur_reg == 1) && ((emu8k->cur_voice == 9) || (emu8k->cur_voice == 10))))))
+        emu8k_fx_wait(emu8k);
+
 #ifdef EMU8K_DEBUG_REGISTERS
     if (addr == 0xE22) {
         // emu8k_log("EMU8K WRITE POINTER: %d\n", val);
@@ -1750,6 +1759,81 @@ emu8k_vol_slide(emu8k_slide_t *slide, int32_t target)
     return slide->last;
 }
 
+/* A voice is idle when it is silent and nothing is going to make it audible
+   before the next register write: the envelope engine is off and the volume
+   slide has settled at zero. Idle voices only need their address advanced. */
+static __inline int
+emu8k_voice_is_active(const emu8k_voice_t *emu_voice)
+{
+    return emu_voice->env_engine_on || emu_voice->cvcf_curr_volume ||
+           emu_voice->volumeslide.last || emu_voice->vtft_vol_target;
+}
+
+static void
+emu8k_voice_run_idle(emu8k_voice_t *emu_voice, int count)
+{
+    if (!emu_voice->cpf_curr_pitch && !emu_voice->ptrx_pit_target &&
+        (emu_voice->addr.addr < emu_voice->loop_end.addr)) {
+        /* Stopped, nothing moves. */
+        emu_voice->cvcf_curr_filt_ctoff = emu_voice->vtft_filter_target;
+        return;
+    }
+
+    for (int pos = 0; pos < count; pos++) {
+        emu_voice->addr.addr += ((uint64_t) emu_voice->cpf_curr_pitch) << 18;
+        if (emu_voice->addr.addr >= emu_voice->loop_end.addr) {
+            emu_voice->addr.int_address -= (emu_voice->loop_end.int_address - emu_voice->loop_start.int_address);
+            emu_voice->addr.int_address &= EMU8K_MEM_ADDRESS_MASK;
+        }
+        emu_voice->cpf_curr_pitch = emu_voice->ptrx_pit_target;
+    }
+    emu_voice->cvcf_curr_filt_ctoff = emu_voice->vtft_filter_target;
+}
+
+static void
+emu8k_fx_thread(void *param)
+{
+    emu8k_t *emu8k = (emu8k_t *) param;
+
+    while (1) {
+        thread_wait_event(emu8k->fx_start_event, -1);
+        thread_reset_event(emu8k->fx_start_event);
+
+        if (emu8k->fx_quit)
+            break;
+
+        memset(emu8k->fx_out, 0, sizeof(emu8k->fx_out));
+        emu8k_work_reverb(emu8k->fx_reverb_in, emu8k->fx_out, &emu8k->reverb_engine, WTBUFLEN);
+        emu8k_work_chorus(emu8k->fx_chorus_in, emu8k->fx_out, &emu8k->chorus_engine, WTBUFLEN);
+
+        thread_set_event(emu8k->fx_done_event);
+    }
+}
+
+/* Wait for the worker to finish the buffer it is working on. */
+static void
+emu8k_fx_wait(emu8k_t *emu8k)
+{
+    thread_wait_event(emu8k->fx_done_event, -1);
+}
+
+/* Mix the effects of the previous buffer into the current one,
+   then hand the current buffer's effect sends over to the worker. */
+static void
+emu8k_fx_submit(emu8k_t *emu8k)
+{
+    emu8k_fx_wait(emu8k);
+
+    for (int c = 0; c < WTBUFLEN * 2; c++)
+        emu8k->buffer[c] += emu8k->fx_out[c];
+
+    memcpy(emu8k->fx_reverb_in, emu8k->reverb_in_buffer, sizeof(emu8k->fx_reverb_in));
+    memcpy(emu8k->fx_chorus_in, emu8k->chorus_in_buffer, sizeof(emu8k->fx_chorus_in));
+
+    thread_reset_event(emu8k->fx_done_event);
+    thread_set_event(emu8k->fx_start_event);
+}
+
 #if 0
 int32_t old_pitch[32] = { 0 };
 int32_t old_cut[32]   = { 0 };
@@ -1764,6 +1848,12 @@ emu8k_update(emu8k_t *emu8k)
     int32_t       *buf;
     emu8k_voice_t *emu_voice;
     int            pos;
+    uint32_t       active = 0;
+
+    for (uint8_t c = 0; c < 32; c++) {
+        if (emu8k_voice_is_active(&emu8k->voice[c]))
+            active |= (1 << c);
+    }
 
     /* Clean the buffers since we will accumulate into them. */
     buf = &emu8k->buffer[emu8k->pos * 2];
@@ -1775,8 +1865,14 @@ emu8k_update(emu8k_t *emu8k)
     for (uint8_t c = 0; c < 32; c++) {
         emu_voice = &emu8k->voice[c];
         buf       = &emu8k->buffer[emu8k->pos * 2];
+        pos       = emu8k->pos;
+
+        if (!(active & (1 << c))) {
+            emu8k_voice_run_idle(emu_voice, wavetable_pos_global - emu8k->pos);
+            pos = wavetable_pos_global;
+        }
 
-        for (pos = emu8k->pos; pos < wavetable_pos_global; pos++) {
+        for (; pos < wavetable_pos_global; pos++) {
             int32_t dat;
 
             if (emu_voice->cvcf_curr_volume) {
@@ -2117,14 +2213,19 @@ emu8k_update(emu8k_t *emu8k)
     }
 
     buf = &emu8k->buffer[emu8k->pos * 2];
-    emu8k_work_reverb(&emu8k->reverb_in_buffer[emu8k->pos], buf, &emu8k->reverb_engine, wavetable_pos_global - emu8k->pos);
-    emu8k_work_chorus(&emu8k->chorus_in_buffer[emu8k->pos], buf, &emu8k->chorus_engine, wavetable_pos_global - emu8k->pos);
+    if (!emu8k->fx_thread) {
+        emu8k_work_reverb(&emu8k->reverb_in_buffer[emu8k->pos], buf, &emu8k->reverb_engine, wavetable_pos_global - emu8k->pos);
+        emu8k_work_chorus(&emu8k->chorus_in_buffer[emu8k->pos], buf, &emu8k->chorus_engine, wavetable_pos_global - emu8k->pos);
+    }
     emu8k_work_eq(buf, wavetable_pos_global - emu8k->pos);
 
     /* Update EMU clock. */
     emu8k->wc += (wavetable_pos_global - emu8k->pos);
 
     emu8k->pos = wavetable_pos_global;
+
+    if (emu8k->fx_thread && (emu8k->pos == WTBUFLEN))
+        emu8k_fx_submit(emu8k);
 }
 
 void
@@ -2366,9 +2467,30 @@ emu8k_init(emu8k_t *emu8k, uint16_t emu_addr, int onboard_ram)
     emu8k->hwcf3 = 0x00;
 }
 
+void
+emu8k_fx_thread_start(emu8k_t *emu8k)
+{
+    emu8k->fx_quit        = 0;
+    emu8k->fx_start_event = thread_create_event();
+    emu8k->fx_done_event  = thread_create_event();
+    /* The worker starts out idle. */
+    thread_set_event(emu8k->fx_done_event);
+    emu8k->fx_thread = thread_create(emu8k_fx_thread, emu8k);
+}
+
 void
 emu8k_close(emu8k_t *emu8k)
 {
+    if (emu8k->fx_thread) {
+        emu8k->fx_quit = 1;
+        thread_set_event(emu8k->fx_start_event);
+        thread_wait(emu8k->fx_thread);
+        emu8k->fx_thread = NULL;
+
+        thread_destroy_event(emu8k->fx_start_event);
+        thread_destroy_event(emu8k->fx_done_event);
+    }
+
     if (emu8k->rom)
         free(emu8k->rom);
     if (emu8k->ram)
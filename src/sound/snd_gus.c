@@ -60,6 +60,9 @@ enum {
     GUS_ICS2101_MAX     = 6
 };
 
+/* Maximum number of samples rendered at once in block rendering mode. */
+#define GUS_WAVE_BLOCK 256
+
 typedef struct ics2101_chan_t {
     uint8_t ctrl[2];
     double level[2];
@@ -118,6 +121,11 @@ typedef struct gus_t {
     pc_timer_t samp_timer;
     uint64_t   samp_latch;
 
+    int      block_render;
+    uint32_t wave_ahead;
+    int      wave_pos;
+    int32_t  wave_buf[2][GUS_WAVE_BLOCK];
+
     uint8_t *ram;
     uint32_t gus_end_ram;
 
@@ -284,8 +292,8 @@ gus_midi_update_int_status(gus_t *gus)
     gus_update_int_status(gus);
 }
 
-void
-gus_write(uint16_t addr, uint8_t val, void *priv)
+static void
+gus_write_reg(uint16_t addr, uint8_t val, void *priv)
 {
     gus_t   *gus = (gus_t *) priv;
     int      c;
@@ -801,8 +809,8 @@ gus_write(uint16_t addr, uint8_t val, void *priv)
     }
 }
 
-uint8_t
-gus_read(uint16_t addr, void *priv)
+static uint8_t
+gus_read_reg(uint16_t addr, void *priv)
 {
     gus_t   *gus = (gus_t *) priv;
     uint8_t  val = 0xff;
@@ -1105,32 +1113,188 @@ gus_poll_timer_2(void *priv)
     gus_update_int_status(gus);
 }
 
+static __inline void
+gus_output_sample(gus_t *gus)
+{
+    if (gus->out_l < -32768)
+        gus->buffer[0][gus->pos] = -32768;
+    else if (gus->out_l > 32767)
+        gus->buffer[0][gus->pos] = 32767;
+    else
+        gus->buffer[0][gus->pos] = gus->out_l;
+    if (gus->out_r < -32768)
+        gus->buffer[1][gus->pos] = -32768;
+    else if (gus->out_r > 32767)
+        gus->buffer[1][gus->pos] = 32767;
+    else
+        gus->buffer[1][gus->pos] = gus->out_r;
+}
+
 static void
 gus_update(gus_t *gus)
 {
-    for (; gus->pos < sound_pos_global; gus->pos++) {
-        if (gus->out_l < -32768)
-            gus->buffer[0][gus->pos] = -32768;
-        else if (gus->out_l > 32767)
-            gus->buffer[0][gus->pos] = 32767;
+    for (; gus->pos < sound_pos_global; gus->pos++)
+        gus_output_sample(gus);
+}
+
+/* Fetch the current (interpolated) sample of voice d, scaled by its volume. */
+static __inline int16_t
+gus_voice_sample(gus_t *gus, int d)
+{
+    uint32_t addr;
+    int16_t  v;
+    int32_t  vl;
+
+    if (gus->ctrl[d] & 4) {
+        addr = gus->cur[d] >> 9;
+        addr = (addr & 0xC0000) | ((addr << 1) & 0x3FFFE);
+        if (!(gus->freq[d] >> 10)) {
+            /* Interpolate */
+            if (((addr + 1) & 0xfffff) < gus->gus_end_ram)
+                vl = (int16_t) (int8_t) ((gus->ram[(addr + 1) & 0xfffff] ^ 0x80) - 0x80) *
+                     (511 - (gus->cur[d] & 511));
+            else
+                vl = 0;
+
+            if (((addr + 3) & 0xfffff) < gus->gus_end_ram)
+                vl += (int16_t) (int8_t) ((gus->ram[(addr + 3) & 0xfffff] ^ 0x80) - 0x80) *
+                      (gus->cur[d] & 511);
+
+            v = vl >> 9;
+        } else if (((addr + 1) & 0xfffff) < gus->gus_end_ram)
+            v = (int16_t) (int8_t) ((gus->ram[(addr + 1) & 0xfffff] ^ 0x80) - 0x80);
         else
-            gus->buffer[0][gus->pos] = gus->out_l;
-        if (gus->out_r < -32768)
-            gus->buffer[1][gus->pos] = -32768;
-        else if (gus->out_r > 32767)
-            gus->buffer[1][gus->pos] = 32767;
+            v = 0x0000;
+    } else {
+        if (!(gus->freq[d] >> 10)) {
+            /* Interpolate */
+            if (((gus->cur[d] >> 9) & 0xfffff) < gus->gus_end_ram)
+                vl = ((int8_t) ((gus->ram[(gus->cur[d] >> 9) & 0xfffff] ^ 0x80) - 0x80)) *
+                               (511 - (gus->cur[d] & 511));
+            else
+                vl = 0;
+
+            if ((((gus->cur[d] >> 9) + 1) & 0xfffff) < gus->gus_end_ram)
+                vl += ((int8_t) ((gus->ram[((gus->cur[d] >> 9) + 1) & 0xfffff] ^ 0x80) - 0x80)) *
+                      (gus->cur[d] & 511);
+
+            v = vl >> 9;
+        } else if (((gus->cur[d] >> 9) & 0xfffff) < gus->gus_end_ram)
+            v = (int16_t) (int8_t) ((gus->ram[(gus->cur[d] >> 9) & 0xfffff] ^ 0x80) - 0x80);
         else
-            gus->buffer[1][gus->pos] = gus->out_r;
+            v = 0x0000;
+    }
+
+    if ((gus->rcur[d] >> 14) > 4095)
+        v = (int16_t) (float) (v) *24.0 * vol16bit[4095];
+    else
+        v = (int16_t) (float) (v) *24.0 * vol16bit[(gus->rcur[d] >> 10) & 4095];
+
+    return v;
+}
+
+/* Advance the wave position of voice d by one sample, returns 1 if a wave IRQ was raised. */
+static __inline int
+gus_voice_step_wave(gus_t *gus, int d)
+{
+    int update_irqs = 0;
+
+    if (gus->ctrl[d] & 0x40) {
+        gus->cur[d] -= (gus->freq[d] >> 1);
+        if (gus->cur[d] <= gus->start[d]) {
+            int diff = gus->start[d] - gus->cur[d];
+
+            if (gus->ctrl[d] & 8) {
+                if (gus->ctrl[d] & 0x10)
+                    gus->ctrl[d] ^= 0x40;
+                gus->cur[d] = (gus->ctrl[d] & 0x40) ? (gus->end[d] - diff) : (gus->start[d] + diff);
+            } else if (!(gus->rctrl[d] & 4)) {
+                gus->ctrl[d] |= 1;
+                gus->cur[d] = (gus->ctrl[d] & 0x40) ? gus->end[d] : gus->start[d];
+            }
+
+            if ((gus->ctrl[d] & 0x20) && !gus->waveirqs[d]) {
+                gus->waveirqs[d] = 1;
+                update_irqs      = 1;
+            }
+        }
+    } else {
+        gus->cur[d] += (gus->freq[d] >> 1);
+
+        if (gus->cur[d] >= gus->end[d]) {
+            int diff = gus->cur[d] - gus->end[d];
+
+            if (gus->ctrl[d] & 8) {
+                if (gus->ctrl[d] & 0x10)
+                    gus->ctrl[d] ^= 0x40;
+                gus->cur[d] = (gus->ctrl[d] & 0x40) ? (gus->end[d] - diff) : (gus->start[d] + diff);
+            } else if (!(gus->rctrl[d] & 4)) {
+                gus->ctrl[d] |= 1;
+                gus->cur[d] = (gus->ctrl[d] & 0x40) ? gus->end[d] : gus->start[d];
+            }
+
+            if ((gus->ctrl[d] & 0x20) && !gus->waveirqs[d]) {
+                gus->waveirqs[d] = 1;
+                update_irqs      = 1;
+            }
+        }
+    }
+
+    return update_irqs;
+}
+
+/* Advance the volume ramp of voice d by one sample, returns 1 if a ramp IRQ was raised. */
+static __inline int
+gus_voice_step_ramp(gus_t *gus, int d)
+{
+    int update_irqs = 0;
+
+    if (gus->rctrl[d] & 0x40) {
+        gus->rcur[d] -= gus->rfreq[d];
+        if (gus->rcur[d] <= gus->rstart[d]) {
+            int diff = gus->rstart[d] - gus->rcur[d];
+            if (!(gus->rctrl[d] & 8)) {
+                gus->rctrl[d] |= 1;
+                gus->rcur[d] = (gus->rctrl[d] & 0x40) ? gus->rstart[d] : gus->rend[d];
+            } else {
+                if (gus->rctrl[d] & 0x10)
+                    gus->rctrl[d] ^= 0x40;
+                gus->rcur[d] = (gus->rctrl[d] & 0x40) ? (gus->rend[d] - diff) : (gus->rstart[d] + diff);
+            }
+
+            if ((gus->rctrl[d] & 0x20) && !gus->rampirqs[d]) {
+                gus->rampirqs[d] = 1;
+                update_irqs      = 1;
+            }
+        }
+    } else {
+        gus->rcur[d] += gus->rfreq[d];
+        if (gus->rcur[d] >= gus->rend[d]) {
+            int diff = gus->rcur[d] - gus->rend[d];
+            if (!(gus->rctrl[d] & 8)) {
+                gus->rctrl[d] |= 1;
+                gus->rcur[d] = (gus->rctrl[d] & 0x40) ? gus->rstart[d] : gus->rend[d];
+            } else {
+                if (gus->rctrl[d] & 0x10)
+                    gus->rctrl[d] ^= 0x40;
+                gus->rcur[d] = (gus->rctrl[d] & 0x40) ? (gus->rend[d] - diff) : (gus->rstart[d] + diff);
+            }
+
+            if ((gus->rctrl[d] & 0x20) && !gus->rampirqs[d]) {
+                gus->rampirqs[d] = 1;
+                update_irqs      = 1;
+            }
+        }
     }
+
+    return update_irqs;
 }
 
 void
 gus_poll_wave(void *priv)
 {
     gus_t   *gus = (gus_t *) priv;
-    uint32_t addr;
     int16_t  v;
-    int32_t  vl;
     int      update_irqs = 0;
 
     gus_update(gus);
@@ -1143,140 +1307,244 @@ gus_poll_wave(void *priv)
         return;
     for (uint8_t d = 0; d < 32; d++) {
         if (!(gus->ctrl[d] & 3)) {
-            if (gus->ctrl[d] & 4) {
-                addr = gus->cur[d] >> 9;
-                addr = (addr & 0xC0000) | ((addr << 1) & 0x3FFFE);
-                if (!(gus->freq[d] >> 10)) {
-                    /* Interpolate */
-                    if (((addr + 1) & 0xfffff) < gus->gus_end_ram)
-                        vl = (int16_t) (int8_t) ((gus->ram[(addr + 1) & 0xfffff] ^ 0x80) - 0x80) *
-                             (511 - (gus->cur[d] & 511));
-                    else
-                        vl = 0;
+            v = gus_voice_sample(gus, d);
 
-                    if (((addr + 3) & 0xfffff) < gus->gus_end_ram)
-                        vl += (int16_t) (int8_t) ((gus->ram[(addr + 3) & 0xfffff] ^ 0x80) - 0x80) *
-                              (gus->cur[d] & 511);
+            gus->out_l += (v * gus->pan_l[d]) / 7;
+            gus->out_r += (v * gus->pan_r[d]) / 7;
 
-                    v = vl >> 9;
-                } else if (((addr + 1) & 0xfffff) < gus->gus_end_ram)
-                    v = (int16_t) (int8_t) ((gus->ram[(addr + 1) & 0xfffff] ^ 0x80) - 0x80);
-                else
-                    v = 0x0000;
-            } else {
-                if (!(gus->freq[d] >> 10)) {
-                    /* Interpolate */
-                    if (((gus->cur[d] >> 9) & 0xfffff) < gus->gus_end_ram)
-                        vl = ((int8_t) ((gus->ram[(gus->cur[d] >> 9) & 0xfffff] ^ 0x80) - 0x80)) *
-                                       (511 - (gus->cur[d] & 511));
-                    else
-                        vl = 0;
+            update_irqs |= gus_voice_step_wave(gus, d);
+        }
+        if (!(gus->rctrl[d] & 3))
+            update_irqs |= gus_voice_step_ramp(gus, d);
+    }
 
-                    if ((((gus->cur[d] >> 9) + 1) & 0xfffff) < gus->gus_end_ram)
-                        vl += ((int8_t) ((gus->ram[((gus->cur[d] >> 9) + 1) & 0xfffff] ^ 0x80) - 0x80)) *
-                              (gus->cur[d] & 511);
+    if (update_irqs)
+        gus_update_int_status(gus);
+}
 
-                    v = vl >> 9;
-                } else if (((gus->cur[d] >> 9) & 0xfffff) < gus->gus_end_ram)
-                    v = (int16_t) (int8_t) ((gus->ram[(gus->cur[d] >> 9) & 0xfffff] ^ 0x80) - 0x80);
-                else
-                    v = 0x0000;
-            }
+/*
+   Block rendering mode.
+
+   Instead of firing samp_timer once per GF1 sample, the voices are rendered
+   in blocks whenever the emulated state is observed: on every access to the
+   card's ports, when the sound buffer is pulled, and when the next wave or
+   volume ramp IRQ is due. The timer is only armed for that IRQ boundary (or
+   GUS_WAVE_BLOCK samples at most), so guest-visible IRQ timing is unchanged.
+
+   samp_timer's timestamp always points wave_ahead sample periods past the
+   next sample that has not been rendered yet, so any TSC rebase done by the
+   timer code also applies to the render position.
+*/
+static uint32_t
+gus_wave_deadline(gus_t *gus)
+{
+    uint32_t deadline = GUS_WAVE_BLOCK;
+    uint32_t step;
+    int64_t  dist;
+    int64_t  k;
 
-            if ((gus->rcur[d] >> 14) > 4095)
-                v = (int16_t) (float) (v) *24.0 * vol16bit[4095];
-            else
-                v = (int16_t) (float) (v) *24.0 * vol16bit[(gus->rcur[d] >> 10) & 4095];
+    if ((gus->reset & 3) != 3)
+        return deadline;
 
-            gus->out_l += (v * gus->pan_l[d]) / 7;
-            gus->out_r += (v * gus->pan_r[d]) / 7;
+    for (uint8_t d = 0; d < 32; d++) {
+        k = GUS_WAVE_BLOCK;
 
+        if (!(gus->ctrl[d] & 3) && (gus->ctrl[d] & 0x20) && !gus->waveirqs[d]) {
+            step = gus->freq[d] >> 1;
             if (gus->ctrl[d] & 0x40) {
-                gus->cur[d] -= (gus->freq[d] >> 1);
-                if (gus->cur[d] <= gus->start[d]) {
-                    int diff = gus->start[d] - gus->cur[d];
-
-                    if (gus->ctrl[d] & 8) {
-                        if (gus->ctrl[d] & 0x10)
-                            gus->ctrl[d] ^= 0x40;
-                        gus->cur[d] = (gus->ctrl[d] & 0x40) ? (gus->end[d] - diff) : (gus->start[d] + diff);
-                    } else if (!(gus->rctrl[d] & 4)) {
-                        gus->ctrl[d] |= 1;
-                        gus->cur[d] = (gus->ctrl[d] & 0x40) ? gus->end[d] : gus->start[d];
-                    }
-
-                    if ((gus->ctrl[d] & 0x20) && !gus->waveirqs[d]) {
-                        gus->waveirqs[d] = 1;
-                        update_irqs      = 1;
-                    }
+                /* The position is unsigned, so mind the wrap below zero. */
+                if (step == 0)
+                    k = (gus->cur[d] <= gus->start[d]) ? 1 : GUS_WAVE_BLOCK;
+                else if (gus->cur[d] < step)
+                    k = GUS_WAVE_BLOCK;
+                else if ((gus->cur[d] - step) <= gus->start[d])
+                    k = 1;
+                else {
+                    dist = (int64_t) gus->cur[d] - gus->start[d];
+                    k    = (dist + step - 1) / step;
+                    if ((k * step) > gus->cur[d])
+                        k = GUS_WAVE_BLOCK;
                 }
             } else {
-                gus->cur[d] += (gus->freq[d] >> 1);
-
-                if (gus->cur[d] >= gus->end[d]) {
-                    int diff = gus->cur[d] - gus->end[d];
-
-                    if (gus->ctrl[d] & 8) {
-                        if (gus->ctrl[d] & 0x10)
-                            gus->ctrl[d] ^= 0x40;
-                        gus->cur[d] = (gus->ctrl[d] & 0x40) ? (gus->end[d] - diff) : (gus->start[d] + diff);
-                    } else if (!(gus->rctrl[d] & 4)) {
-                        gus->ctrl[d] |= 1;
-                        gus->cur[d] = (gus->ctrl[d] & 0x40) ? gus->end[d] : gus->start[d];
-                    }
-
-                    if ((gus->ctrl[d] & 0x20) && !gus->waveirqs[d]) {
-                        gus->waveirqs[d] = 1;
-                        update_irqs      = 1;
-                    }
+                if ((gus->cur[d] + step) >= gus->end[d])
+                    k = 1;
+                else if (step != 0) {
+                    dist = (int64_t) gus->end[d] - gus->cur[d];
+                    k    = (dist + step - 1) / step;
                 }
             }
         }
-        if (!(gus->rctrl[d] & 3)) {
-            if (gus->rctrl[d] & 0x40) {
-                gus->rcur[d] -= gus->rfreq[d];
-                if (gus->rcur[d] <= gus->rstart[d]) {
-                    int diff = gus->rstart[d] - gus->rcur[d];
-                    if (!(gus->rctrl[d] & 8)) {
-                        gus->rctrl[d] |= 1;
-                        gus->rcur[d] = (gus->rctrl[d] & 0x40) ? gus->rstart[d] : gus->rend[d];
-                    } else {
-                        if (gus->rctrl[d] & 0x10)
-                            gus->rctrl[d] ^= 0x40;
-                        gus->rcur[d] = (gus->rctrl[d] & 0x40) ? (gus->rend[d] - diff) : (gus->rstart[d] + diff);
-                    }
+        if (k < deadline)
+            deadline = k;
 
-                    if ((gus->rctrl[d] & 0x20) && !gus->rampirqs[d]) {
-                        gus->rampirqs[d] = 1;
-                        update_irqs      = 1;
-                    }
+        k = GUS_WAVE_BLOCK;
+
+        if (!(gus->rctrl[d] & 3) && (gus->rctrl[d] & 0x20) && !gus->rampirqs[d]) {
+            if (gus->rctrl[d] & 0x40) {
+                if ((gus->rcur[d] - gus->rfreq[d]) <= gus->rstart[d])
+                    k = 1;
+                else if (gus->rfreq[d] > 0) {
+                    dist = (int64_t) gus->rcur[d] - gus->rstart[d];
+                    k    = (dist + gus->rfreq[d] - 1) / gus->rfreq[d];
                 }
             } else {
-                gus->rcur[d] += gus->rfreq[d];
-                if (gus->rcur[d] >= gus->rend[d]) {
-                    int diff = gus->rcur[d] - gus->rend[d];
-                    if (!(gus->rctrl[d] & 8)) {
-                        gus->rctrl[d] |= 1;
-                        gus->rcur[d] = (gus->rctrl[d] & 0x40) ? gus->rstart[d] : gus->rend[d];
-                    } else {
-                        if (gus->rctrl[d] & 0x10)
-                            gus->rctrl[d] ^= 0x40;
-                        gus->rcur[d] = (gus->rctrl[d] & 0x40) ? (gus->rend[d] - diff) : (gus->rstart[d] + diff);
-                    }
-
-                    if ((gus->rctrl[d] & 0x20) && !gus->rampirqs[d]) {
-                        gus->rampirqs[d] = 1;
-                        update_irqs      = 1;
-                    }
+                if ((gus->rcur[d] + gus->rfreq[d]) >= gus->rend[d])
+                    k = 1;
+                else if (gus->rfreq[d] > 0) {
+                    dist = (int64_t) gus->rend[d] - gus->rcur[d];
+                    k    = (dist + gus->rfreq[d] - 1) / gus->rfreq[d];
                 }
             }
         }
+        if (k < deadline)
+            deadline = k;
+    }
+
+    return (deadline < 1) ? 1 : deadline;
+}
+
+/* Render len samples into wave_buf, voice by voice. */
+static void
+gus_wave_render(gus_t *gus, int len)
+{
+    int32_t *buf_l       = &gus->wave_buf[0][gus->wave_pos];
+    int32_t *buf_r       = &gus->wave_buf[1][gus->wave_pos];
+    int      update_irqs = 0;
+    int16_t  v;
+
+    memset(buf_l, 0x00, len * sizeof(int32_t));
+    memset(buf_r, 0x00, len * sizeof(int32_t));
+    gus->wave_pos += len;
+
+    if ((gus->reset & 3) != 3)
+        return;
+
+    for (uint8_t d = 0; d < 32; d++) {
+        const int pan_l = gus->pan_l[d];
+        const int pan_r = gus->pan_r[d];
+
+        for (int c = 0; c < len; c++) {
+            if (!(gus->ctrl[d] & 3)) {
+                v = gus_voice_sample(gus, d);
+
+                buf_l[c] += (v * pan_l) / 7;
+                buf_r[c] += (v * pan_r) / 7;
+
+                update_irqs |= gus_voice_step_wave(gus, d);
+            } else if (gus->rctrl[d] & 3)
+                break; /* Voice and ramp both stopped, nothing left to do. */
+            if (!(gus->rctrl[d] & 3))
+                update_irqs |= gus_voice_step_ramp(gus, d);
+        }
     }
 
+    /* IRQs can only be raised on the last sample of a block, see gus_wave_deadline(). */
     if (update_irqs)
         gus_update_int_status(gus);
 }
 
+/* Spread the rendered samples over the output positions elapsed since the last flush. */
+static void
+gus_wave_flush(gus_t *gus)
+{
+    int len = sound_pos_global - gus->pos;
+    int idx;
+
+    for (int c = 0; c < len; c++, gus->pos++) {
+        idx = (((c + 1) * gus->wave_pos) / len) - 1;
+        if (idx >= 0) {
+            gus->out_l = gus->wave_buf[0][idx];
+            gus->out_r = gus->wave_buf[1][idx];
+        }
+        gus_output_sample(gus);
+    }
+    if (gus->wave_pos > 0) {
+        gus->out_l = gus->wave_buf[0][gus->wave_pos - 1];
+        gus->out_r = gus->wave_buf[1][gus->wave_pos - 1];
+    }
+    gus->wave_pos = 0;
+}
+
+static void
+gus_wave_catch_up(gus_t *gus)
+{
+    uint128_t next;
+    int128_t  diff;
+    uint64_t  pending;
+    int       len;
+
+    /* Timestamp of the next sample that has not been rendered yet. */
+    next = (((uint128_t) gus->samp_timer.ts_integer << 32) | gus->samp_timer.ts_frac) -
+           ((uint128_t) gus->wave_ahead * gus->samp_latch);
+    diff = (((int128_t) tsc + 1) << 32) - (int128_t) next;
+
+    timer_disable(&gus->samp_timer);
+
+    if (diff > 0) {
+        pending = (uint64_t) ((diff - 1) / gus->samp_latch) + 1;
+
+        while (pending > 0) {
+            len = (pending > GUS_WAVE_BLOCK) ? GUS_WAVE_BLOCK : (int) pending;
+            gus_wave_render(gus, len);
+            gus_wave_flush(gus);
+            pending -= len;
+            next += (uint128_t) len * gus->samp_latch;
+        }
+    }
+
+    gus->samp_timer.ts_integer = (uint64_t) (next >> 32);
+    gus->samp_timer.ts_frac    = (uint32_t) next;
+    gus->wave_ahead            = 0;
+}
+
+/* Arm samp_timer for the last sample of the next block. */
+static void
+gus_wave_schedule(gus_t *gus)
+{
+    uint32_t len = gus_wave_deadline(gus);
+
+    gus->wave_ahead = len - 1;
+    timer_advance_u64(&gus->samp_timer, (uint64_t) gus->wave_ahead * gus->samp_latch);
+}
+
+static void
+gus_poll_wave_block(void *priv)
+{
+    gus_t *gus = (gus_t *) priv;
+
+    gus_wave_catch_up(gus);
+    gus_wave_schedule(gus);
+}
+
+void
+gus_write(uint16_t addr, uint8_t val, void *priv)
+{
+    gus_t *gus = (gus_t *) priv;
+
+    if (gus->block_render) {
+        gus_wave_catch_up(gus);
+        gus_write_reg(addr, val, priv);
+        gus_wave_schedule(gus);
+    } else
+        gus_write_reg(addr, val, priv);
+}
+
+uint8_t
+gus_read(uint16_t addr, void *priv)
+{
+    gus_t  *gus = (gus_t *) priv;
+    uint8_t ret;
+
+    if (gus->block_render) {
+        gus_wave_catch_up(gus);
+        ret = gus_read_reg(addr, priv);
+        gus_wave_schedule(gus);
+    } else
+        ret = gus_read_reg(addr, priv);
+
+    return ret;
+}
+
 void
 gus_ics2101_filter(void *priv, int channel, double *out_l, double *out_r)
 {
@@ -1337,6 +1605,8 @@ gus_get_buffer(int32_t *buffer, int len, void *priv)
     if ((gus->type == GUS_MAX) && (gus->max_ctrl))
         ad1848_update(&gus->ad1848);
 
+    if (gus->block_render)
+        gus_wave_catch_up(gus);
     gus_update(gus);
     for (int c = 0; c < len * 2; c += 2) {
         double temp_l = 0.0;
@@ -1364,6 +1634,9 @@ gus_get_buffer(int32_t *buffer, int len, void *priv)
         gus->ad1848.pos = 0;
 
     gus->pos = 0;
+
+    if (gus->block_render)
+        gus_wave_schedule(gus);
 }
 
 void
@@ -1427,6 +1700,9 @@ gus_reset(void *priv)
     if (gus == NULL)
         return;
 
+    if (gus->block_render)
+        gus_wave_catch_up(gus);
+
     memset(gus->ram, 0x00, (gus->gus_end_ram));
 
     for (c = 0; c < 32; c++) {
@@ -1520,6 +1796,9 @@ gus_reset(void *priv)
     }
 
     gus_update_int_status(gus);
+
+    if (gus->block_render)
+        gus_wave_schedule(gus);
 }
 
 void *
@@ -1601,7 +1880,8 @@ gus_init(UNUSED(const device_t *info))
                       ad1848_read, NULL, NULL, ad1848_write, NULL, NULL, &gus->ad1848);
     }
 
-    timer_add(&gus->samp_timer, gus_poll_wave, gus, 1);
+    gus->block_render = device_get_config_int("block_render");
+    timer_add(&gus->samp_timer, gus->block_render ? gus_poll_wave_block : gus_poll_wave, gus, 1);
     timer_add(&gus->timer_1, gus_poll_timer_1, gus, 1);
     timer_add(&gus->timer_2, gus_poll_timer_2, gus, 1);
 
@@ -1627,11 +1907,17 @@ gus_speed_changed(void *priv)
 {
     gus_t *gus = (gus_t *) priv;
 
+    if (gus->block_render)
+        gus_wave_catch_up(gus);
+
     if (gus->voices < 14)
         gus->samp_latch = (uint64_t) (TIMER_USEC * (1000000.0 / 44100.0));
     else
         gus->samp_latch = (uint64_t) (TIMER_USEC * (1000000.0 / gusfreqs[gus->voices - 14]));
 
+    if (gus->block_render)
+        gus_wave_schedule(gus);
+
     if ((gus->type == GUS_MAX) && (gus->max_ctrl))
         ad1848_speed_changed(&gus->ad1848);
 }
@@ -1695,6 +1981,17 @@ static const device_config_t gus_config[] = {
         .selection      = { { 0 } },
         .bios           = { { 0 } }
     },
+    {
+        .name           = "block_render",
+        .description    = "Block-based wave synthesis",
+        .type           = CONFIG_BINARY,
+        .default_string = NULL,
+        .default_int    = 0,
+        .file_filter    = NULL,
+        .spinner        = { 0 },
+        .selection      = { { 0 } },
+        .bios           = { { 0 } }
+    },
     { .name = "", .description = "", .type = CONFIG_END }
 // clang-format off
 };
@@ -1747,6 +2044,17 @@ static const device_config_t gus_v37_config[] = {
         .selection      = { { 0 } },
         .bios           = { { 0 } }
     },
+    {
+        .name           = "block_render",
+        .description    = "Block-based wave synthesis",
+        .type           = CONFIG_BINARY,
+        .default_string = NULL,
+        .default_int    = 0,
+        .file_filter    = NULL,
+        .spinner        = { 0 },
+        .selection      = { { 0 } },
+        .bios           = { { 0 } }
+    },
     { .name = "", .description = "", .type = CONFIG_END }
 // clang-format off
 };
@@ -1798,6 +2106,17 @@ static const device_config_t gus_max_config[] = {
         .selection      = { { 0 } },
         .bios           = { { 0 } }
     },
+    {
+        .name           = "block_render",
+        .description    = "Block-based wave synthesis",
+        .type           = CONFIG_BINARY,
+        .default_string = NULL,
+        .default_int    = 0,
+        .file_filter    = NULL,
+        .spinner        = { 0 },
+        .selection      = { { 0 } },
+        .bios           = { { 0 } }
+    },
     { .name = "", .description = "", .type = CONFIG_END }
 // clang-format off
 };
@@ -1849,6 +2168,17 @@ static const device_config_t gus_ace_config[] = {
         .selection      = { { 0 } },
         .bios           = { { 0 } }
     },
+    {
+        .name           = "block_render",
+        .description    = "Block-based wave synthesis",
+        .type           = CONFIG_BINARY,
+        .default_string = NULL,
+        .default_int    = 0,
+        .file_filter    = NULL,
+        .spinner        = { 0 },
+        .selection      = { { 0 } },
+        .bios           = { { 0 } }
+    },
     { .name = "", .description = "", .type = CONFIG_END }
 // clang-format off
 };
@@ -19,6 +19,7 @@
  *          Copyright 2016-2020 Miran Grca.
  */
 #include <stdarg.h>
+#include <stdatomic.h>
 #include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
@@ -31,10 +32,70 @@
 #include <86box/device.h>
 #include <86box/io.h>
 #include <86box/sound.h>
+#include <86box/thread.h>
 #include <86box/snd_opl.h>
+#include <86box/plat_unused.h>
+
+/* Size of the per-chip register queue, must be a power of two. */
+#define FM_OFFLOAD_QUEUE 4096
+#define FM_OFFLOAD_WAKE  (FM_OFFLOAD_QUEUE / 4)
+#define FM_OFFLOAD_MAX   8
+/* One buffer being read by the card, one being rendered, and one for the
+   next submission, which can start as soon as the card writes a register. */
+#define FM_OFFLOAD_BUFS  3
+
+enum {
+    FM_OFFLOAD_WRITE = 0,
+    FM_OFFLOAD_READ  = 1,
+    FM_OFFLOAD_TIMER = 2,
+    FM_OFFLOAD_END   = 3
+};
+
+typedef struct fm_offload_ev_t {
+    int      pos;
+    uint16_t port;
+    uint8_t  val;
+    uint8_t  type;
+} fm_offload_ev_t;
+
+struct fm_offload_t {
+    void *priv;
+    void (*write)(void *priv, uint16_t port, uint8_t val);
+    void (*read)(void *priv, uint16_t port);
+    void (*timer)(void *priv, int tnum);
+    void (*generate)(void *priv, int32_t *data, uint32_t num_samples);
+    int  *pos_global;
+
+    /* Single producer (emulation thread), single consumer (synthesis thread). */
+    fm_offload_ev_t queue[FM_OFFLOAD_QUEUE];
+    atomic_uint     head;
+    atomic_uint     tail;
+
+    /* Emulation thread side. */
+    uint32_t submitted;
+    int      submit_buf;
+    int      last_pos;
+
+    /* Synthesis thread side. */
+    uint32_t rendering;
+    int      render_buf;
+    int      pos;
+
+    atomic_uint done;
+    event_t    *done_event;
+
+    int32_t buffer[FM_OFFLOAD_BUFS][MUSICBUFLEN * 2];
+};
 
 static uint32_t fm_dev_inst[FM_DRV_MAX][FM_MAX];
 
+static fm_offload_t *fm_offload_chips[FM_OFFLOAD_MAX];
+static int           fm_offload_count;
+static thread_t     *fm_offload_thread;
+static event_t      *fm_offload_event;
+static mutex_t      *fm_offload_mutex;
+static atomic_int    fm_offload_quit;
+
 uint8_t
 fm_driver_get_ex(int chip_id, fm_drv_t *drv, int is_48k)
 {
@@ -197,3 +258,228 @@ fm_driver_get(int chip_id, fm_drv_t *drv)
 {
     return fm_driver_get_ex(chip_id, drv, 0);
 }
+
+/* Render everything queued for one chip, applying each register access at
+   the sample position it was made at by the guest. */
+static void
+fm_offload_service(fm_offload_t *fo)
+{
+    uint32_t head = atomic_load_explicit(&fo->head, memory_order_acquire);
+    uint32_t tail = atomic_load_explicit(&fo->tail, memory_order_relaxed);
+    int32_t *buf  = fo->buffer[fo->render_buf];
+
+    while (tail != head) {
+        const fm_offload_ev_t *ev  = &fo->queue[tail & (FM_OFFLOAD_QUEUE - 1)];
+        int                    pos = ev->pos;
+
+        if (pos > MUSICBUFLEN)
+            pos = MUSICBUFLEN;
+
+        if (pos > fo->pos) {
+            fo->generate(fo->priv, &buf[fo->pos * 2], pos - fo->pos);
+            fo->pos = pos;
+        }
+
+        switch (ev->type) {
+            case FM_OFFLOAD_WRITE:
+                fo->write(fo->priv, ev->port, ev->val);
+                break;
+
+            case FM_OFFLOAD_READ:
+                if (fo->read != NULL)
+                    fo->read(fo->priv, ev->port);
+                break;
+
+            case FM_OFFLOAD_TIMER:
+                if (fo->timer != NULL)
+                    fo->timer(fo->priv, ev->port);
+                break;
+
+            case FM_OFFLOAD_END:
+                fo->pos = 0;
+                fo->rendering++;
+                fo->render_buf = (fo->render_buf + 1) % FM_OFFLOAD_BUFS;
+                buf            = fo->buffer[fo->render_buf];
+                atomic_store_explicit(&fo->done, fo->rendering, memory_order_release);
+                break;
+
+            default:
+                break;
+        }
+
+        tail++;
+    }
+
+    atomic_store_explicit(&fo->tail, tail, memory_order_release);
+    thread_set_event(fo->done_event);
+}
+
+static void
+fm_offload_thread_func(UNUSED(void *priv))
+{
+    while (1) {
+        thread_wait_event(fm_offload_event, -1);
+        thread_reset_event(fm_offload_event);
+
+        if (atomic_load(&fm_offload_quit))
+            break;
+
+        thread_wait_mutex(fm_offload_mutex);
+        for (int i = 0; i < fm_offload_count; i++)
+            fm_offload_service(fm_offload_chips[i]);
+        thread_release_mutex(fm_offload_mutex);
+    }
+}
+
+static void
+fm_offload_push(fm_offload_t *fo, uint8_t type, uint16_t port, uint8_t val, int pos)
+{
+    uint32_t         head = atomic_load_explicit(&fo->head, memory_order_relaxed);
+    fm_offload_ev_t *ev;
+
+    /* Queue full, let the synthesis thread catch up. */
+    while ((head - atomic_load_explicit(&fo->tail, memory_order_acquire)) >= FM_OFFLOAD_QUEUE) {
+        thread_set_event(fm_offload_event);
+        thread_wait_event(fo->done_event, 1);
+        thread_reset_event(fo->done_event);
+    }
+
+    ev       = &fo->queue[head & (FM_OFFLOAD_QUEUE - 1)];
+    ev->pos  = pos;
+    ev->port = port;
+    ev->val  = val;
+    ev->type = type;
+    head++;
+    atomic_store_explicit(&fo->head, head, memory_order_release);
+
+    if ((type == FM_OFFLOAD_END) || !(head & (FM_OFFLOAD_WAKE - 1)))
+        thread_set_event(fm_offload_event);
+}
+
+static void
+fm_offload_access(fm_offload_t *fo, uint8_t type, uint16_t port, uint8_t val)
+{
+    int pos = *fo->pos_global;
+
+    /* The card skipped a buffer without pulling our output, close it here
+       so the timestamps in the queue stay monotonic. */
+    if (pos < fo->last_pos) {
+        fm_offload_push(fo, FM_OFFLOAD_END, 0, 0, fo->last_pos);
+        fo->submitted++;
+        fo->submit_buf = (fo->submit_buf + 1) % FM_OFFLOAD_BUFS;
+    }
+    fo->last_pos = pos;
+
+    fm_offload_push(fo, type, port, val, pos);
+}
+
+/* Queue a register write, timestamped with the current buffer position. */
+void
+fm_offload_write(fm_offload_t *fo, uint16_t port, uint8_t val)
+{
+    fm_offload_access(fo, FM_OFFLOAD_WRITE, port, val);
+}
+
+/* Replay a read on the synthesis side, for chips where reads have side
+   effects (such as the OPL4 memory address auto-increment). */
+void
+fm_offload_read(fm_offload_t *fo, uint16_t port)
+{
+    fm_offload_access(fo, FM_OFFLOAD_READ, port, 0);
+}
+
+/* Replay a timer expiry on the synthesis side, for chips where it keys
+   channels on (CSM mode). */
+void
+fm_offload_timer(fm_offload_t *fo, int tnum)
+{
+    fm_offload_access(fo, FM_OFFLOAD_TIMER, tnum, 0);
+}
+
+/* Close the current buffer and return the previous one, which the synthesis
+   thread has normally finished long ago; this adds one buffer of latency.
+   The returned buffer is not reused until two more have been submitted, so
+   it stays intact while the card mixes it. */
+int32_t *
+fm_offload_update(fm_offload_t *fo)
+{
+    uint32_t cur  = fo->submitted;
+    int      prev = (fo->submit_buf + FM_OFFLOAD_BUFS - 1) % FM_OFFLOAD_BUFS;
+
+    fm_offload_push(fo, FM_OFFLOAD_END, 0, 0, *fo->pos_global);
+    fo->submitted++;
+    fo->submit_buf = (fo->submit_buf + 1) % FM_OFFLOAD_BUFS;
+    fo->last_pos   = 0;
+
+    while ((int32_t) (atomic_load_explicit(&fo->done, memory_order_acquire) - cur) < 0) {
+        thread_wait_event(fo->done_event, -1);
+        thread_reset_event(fo->done_event);
+    }
+
+    return fo->buffer[prev];
+}
+
+fm_offload_t *
+fm_offload_attach(void *priv, void (*write)(void *priv, uint16_t port, uint8_t val),
+                  void (*read)(void *priv, uint16_t port), void (*timer)(void *priv, int tnum),
+                  void (*generate)(void *priv, int32_t *data, uint32_t num_samples),
+                  int *pos_global)
+{
+    fm_offload_t *fo;
+
+    if (fm_offload_count >= FM_OFFLOAD_MAX)
+        return NULL;
+
+    fo             = (fm_offload_t *) calloc(1, sizeof(fm_offload_t));
+    fo->priv       = priv;
+    fo->write      = write;
+    fo->read       = read;
+    fo->timer      = timer;
+    fo->generate   = generate;
+    fo->pos_global = pos_global;
+    fo->done_event = thread_create_event();
+
+    if (fm_offload_thread == NULL) {
+        fm_offload_mutex = thread_create_mutex();
+        fm_offload_event = thread_create_event();
+        atomic_store(&fm_offload_quit, 0);
+        fm_offload_thread = thread_create(fm_offload_thread_func, NULL);
+    }
+
+    thread_wait_mutex(fm_offload_mutex);
+    fm_offload_chips[fm_offload_count++] = fo;
+    thread_release_mutex(fm_offload_mutex);
+
+    return fo;
+}
+
+void
+fm_offload_detach(fm_offload_t *fo)
+{
+    if (fo == NULL)
+        return;
+
+    thread_wait_mutex(fm_offload_mutex);
+    for (int i = 0; i < fm_offload_count; i++) {
+        if (fm_offload_chips[i] == fo) {
+            fm_offload_chips[i] = fm_offload_chips[--fm_offload_count];
+            break;
+        }
+    }
+    thread_release_mutex(fm_offload_mutex);
+
+    if (fm_offload_count == 0) {
+        atomic_store(&fm_offload_quit, 1);
+        thread_set_event(fm_offload_event);
+        thread_wait(fm_offload_thread);
+        fm_offload_thread = NULL;
+
+        thread_destroy_event(fm_offload_event);
+        fm_offload_event = NULL;
+        thread_close_mutex(fm_offload_mutex);
+        fm_offload_mutex = NULL;
+    }
+
+    thread_destroy_event(fo->done_event);
+    free(fo);
+}
@@ -1335,6 +1335,49 @@ nuked_opl2_drv_set_do_cycles(void *priv, int8_t do_cycles)
         dev->flags &= ~FLAG_CYCLES;
 }
 
+static void
+nuked_opl2_offload_write(void *priv, uint16_t port, uint8_t val)
+{
+    nuked_opl2_drv_t *dev = (nuked_opl2_drv_t *) priv;
+
+    OPL2_WriteRegBuffered(&dev->opl, port, val);
+}
+
+static void
+nuked_opl2_offload_generate(void *priv, int32_t *data, uint32_t num_samples)
+{
+    nuked_opl2_drv_t *dev = (nuked_opl2_drv_t *) priv;
+
+    if (dev->is_48k)
+        OPL2_GenerateResampledStream(&dev->opl, data, num_samples);
+    else
+        OPL2_GenerateStream(&dev->opl, data, num_samples);
+
+    for (uint32_t i = 0; i < (num_samples * 2); i++)
+        data[i] /= 2;
+}
+
+/* Called from the sound card's buffer callback; on the first call in offload
+   mode, the chip is handed over to the synthesis thread after rendering this
+   buffer synchronously, from then on only the queue touches dev->opl. */
+static int32_t *
+nuked_opl2_drv_get_buffer(void *priv)
+{
+    nuked_opl2_drv_t *dev = (nuked_opl2_drv_t *) priv;
+    int32_t          *ret;
+
+    if (dev->offload != NULL)
+        return fm_offload_update(dev->offload);
+
+    ret = dev->update(dev);
+
+    if (fm_offload)
+        dev->offload = fm_offload_attach(dev, nuked_opl2_offload_write, NULL, NULL, nuked_opl2_offload_generate,
+                                         dev->is_48k ? &sound_pos_global : &music_pos_global);
+
+    return ret;
+}
+
 static int32_t *
 nuked_opl2_drv_update(void *priv)
 {
@@ -1383,7 +1426,8 @@ nuked_opl2_drv_read(uint16_t port, void *priv)
     if (dev->flags & FLAG_CYCLES)
         cycles -= ((int) (isa_timing * 8));
 
-    dev->update(dev);
+    if (dev->offload == NULL)
+        dev->update(dev);
 
     uint8_t ret = 0xff;
 
@@ -1403,10 +1447,14 @@ nuked_opl2_drv_write(uint16_t port, uint8_t val, void *priv)
 {
     nuked_opl2_drv_t *dev = (nuked_opl2_drv_t *) priv;
 
-    dev->update(dev);
+    if (dev->offload == NULL)
+        dev->update(dev);
 
     if ((port & 0x0001) == 0x0001) {
-        OPL2_WriteRegBuffered(&dev->opl, dev->port, val);
+        if (dev->offload != NULL)
+            fm_offload_write(dev->offload, dev->port, val);
+        else
+            OPL2_WriteRegBuffered(&dev->opl, dev->port, val);
 
         switch (dev->port) {
             case 0x002: // Timer 1
@@ -1462,6 +1510,8 @@ nuked_opl2_drv_close(void *priv)
 {
     nuked_opl2_drv_t *dev = (nuked_opl2_drv_t *) priv;
 
+    fm_offload_detach(dev->offload);
+
     free(dev);
 }
 
@@ -1507,7 +1557,7 @@ const device_t ym3812_nuked_opl2_device = {
 const fm_drv_t nuked_opl2_drv = {
     .read          = &nuked_opl2_drv_read,
     .write         = &nuked_opl2_drv_write,
-    .update        = &nuked_opl2_drv_update,
+    .update        = &nuked_opl2_drv_get_buffer,
     .reset_buffer  = &nuked_opl2_drv_reset_buffer,
     .set_do_cycles = &nuked_opl2_drv_set_do_cycles,
     .priv          = NULL,
@@ -1517,7 +1567,7 @@ const fm_drv_t nuked_opl2_drv = {
 const fm_drv_t nuked_opl2_drv_48k = {
     .read          = &nuked_opl2_drv_read,
     .write         = &nuked_opl2_drv_write,
-    .update        = &nuked_opl2_drv_update_48k,
+    .update        = &nuked_opl2_drv_get_buffer,
     .reset_buffer  = &nuked_opl2_drv_reset_buffer,
     .set_do_cycles = &nuked_opl2_drv_set_do_cycles,
     .priv          = NULL,
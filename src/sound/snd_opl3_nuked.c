@@ -1540,6 +1540,49 @@ nuked_opl3_drv_set_do_cycles(void *priv, int8_t do_cycles)
         dev->flags &= ~FLAG_CYCLES;
 }
 
+static void
+nuked_opl3_offload_write(void *priv, uint16_t port, uint8_t val)
+{
+    nuked_opl3_drv_t *dev = (nuked_opl3_drv_t *) priv;
+
+    OPL3_WriteRegBuffered(&dev->opl, port, val);
+}
+
+static void
+nuked_opl3_offload_generate(void *priv, int32_t *data, uint32_t num_samples)
+{
+    nuked_opl3_drv_t *dev = (nuked_opl3_drv_t *) priv;
+
+    if (dev->is_48k)
+        OPL3_GenerateResampledStream(&dev->opl, data, num_samples);
+    else
+        OPL3_GenerateStream(&dev->opl, data, num_samples);
+
+    for (uint32_t i = 0; i < (num_samples * 2); i++)
+        data[i] /= 2;
+}
+
+/* Called from the sound card's buffer callback; on the first call in offload
+   mode, the chip is handed over to the synthesis thread after rendering this
+   buffer synchronously, from then on only the queue touches dev->opl. */
+static int32_t *
+nuked_opl3_drv_get_buffer(void *priv)
+{
+    nuked_opl3_drv_t *dev = (nuked_opl3_drv_t *) priv;
+    int32_t          *ret;
+
+    if (dev->offload != NULL)
+        return fm_offload_update(dev->offload);
+
+    ret = dev->update(dev);
+
+    if (fm_offload)
+        dev->offload = fm_offload_attach(dev, nuked_opl3_offload_write, NULL, NULL, nuked_opl3_offload_generate,
+                                         dev->is_48k ? &sound_pos_global : &music_pos_global);
+
+    return ret;
+}
+
 static int32_t *
 nuked_opl3_drv_update(void *priv)
 {
@@ -1588,7 +1631,8 @@ nuked_opl3_drv_read(uint16_t port, void *priv)
     if (dev->flags & FLAG_CYCLES)
         cycles -= ((int) (isa_timing * 8));
 
-    dev->update(dev);
+    if (dev->offload == NULL)
+        dev->update(dev);
 
     uint8_t ret = 0xff;
 
@@ -1608,10 +1652,14 @@ nuked_opl3_drv_write(uint16_t port, uint8_t val, void *priv)
 {
     nuked_opl3_drv_t *dev = (nuked_opl3_drv_t *) priv;
 
-    dev->update(dev);
+    if (dev->offload == NULL)
+        dev->update(dev);
 
     if ((port & 0x0001) == 0x0001) {
-        OPL3_WriteRegBuffered(&dev->opl, dev->port, val);
+        if (dev->offload != NULL)
+            fm_offload_write(dev->offload, dev->port, val);
+        else
+            OPL3_WriteRegBuffered(&dev->opl, dev->port, val);
 
         switch (dev->port) {
             case 0x002: // Timer 1
@@ -1637,14 +1685,20 @@ nuked_opl3_drv_write(uint16_t port, uint8_t val, void *priv)
                 break;
 
             case 0x105:
-                dev->opl.newm = val & 0x01;
+                dev->newm = val & 0x01;
+                if (dev->offload == NULL)
+                    dev->opl.newm = dev->newm;
                 break;
 
             default:
                 break;
         }
     } else {
-        dev->port = nuked_opl3_write_addr(&dev->opl, port, val) & 0x01ff;
+        /* Same decoding as nuked_opl3_write_addr(), but on our copy of NEW
+           so the chip itself can be owned by the synthesis thread. */
+        dev->port = val;
+        if ((port & 0x0002) && ((val == 0x05) || dev->newm))
+            dev->port |= 0x0100;
 
         if (!(dev->flags & FLAG_OPL3))
             dev->port &= 0x00ff;
@@ -1664,6 +1718,8 @@ nuked_opl3_drv_close(void *priv)
 {
     nuked_opl3_drv_t *dev = (nuked_opl3_drv_t *) priv;
 
+    fm_offload_detach(dev->offload);
+
     free(dev);
 }
 
@@ -1739,7 +1795,7 @@ const device_t ymf289b_nuked_opl3_device = {
 const fm_drv_t nuked_opl3_drv = {
     .read          = &nuked_opl3_drv_read,
     .write         = &nuked_opl3_drv_write,
-    .update        = &nuked_opl3_drv_update,
+    .update        = &nuked_opl3_drv_get_buffer,
     .reset_buffer  = &nuked_opl3_drv_reset_buffer,
     .set_do_cycles = &nuked_opl3_drv_set_do_cycles,
     .priv          = NULL,
@@ -1749,7 +1805,7 @@ const fm_drv_t nuked_opl3_drv = {
 const fm_drv_t nuked_opl3_drv_48k = {
     .read          = &nuked_opl3_drv_read,
     .write         = &nuked_opl3_drv_write,
-    .update        = &nuked_opl3_drv_update_48k,
+    .update        = &nuked_opl3_drv_get_buffer,
     .reset_buffer  = &nuked_opl3_drv_reset_buffer,
     .set_do_cycles = &nuked_opl3_drv_set_do_cycles,
     .priv          = NULL,
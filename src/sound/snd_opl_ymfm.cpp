@@ -17,6 +17,7 @@
 #include <cstdio>
 #include <cstdlib>
 #include <cstring>
+#include <vector>
 #include "ymfm/ymfm_ssg.h"
 #include "ymfm/ymfm_misc.h"
 #include "ymfm/ymfm_opl.h"
@@ -54,10 +55,48 @@ enum {
     FLAG_CYCLES = (1 << 0)
 };
 
+/* Interface for the copy of the chip that renders on the FM synthesis thread
+   in offload mode. Timers, IRQs and status stay with the primary chip on the
+   emulation thread, which still receives every register write but is no
+   longer clocked, so chips with clocked status are never offloaded. Timer A
+   expiries are replayed here, as they key channels on in CSM mode. */
+class YMFMSynthInterface : public ymfm::ymfm_interface {
+public:
+    YMFMSynthInterface(uint32_t special_flags, const uint8_t *rom)
+        : m_special_flags(special_flags)
+        , m_rom(rom)
+    {
+    }
+
+    virtual uint32_t get_special_flags(void) override
+    {
+        return m_special_flags;
+    }
+
+    virtual uint8_t ymfm_external_read(ymfm::access_class type, uint32_t address) override
+    {
+        if (type == ymfm::access_class::ACCESS_PCM && address < 0x200000) {
+            return m_rom[address];
+        }
+        return 0xFF;
+    }
+
+    void timer_expired(uint32_t tnum)
+    {
+        m_engine->engine_timer_expired(tnum);
+    }
+
+private:
+    uint32_t       m_special_flags;
+    const uint8_t *m_rom;
+};
+
 class YMFMChipBase {
 public:
     YMFMChipBase(UNUSED(uint32_t clock), fm_type type, uint32_t samplerate, int is_48k)
         : m_buf_pos(0)
+        , m_offload(nullptr)
+        , m_offload_tried(0)
         , m_flags(0)
         , m_type(type)
         , m_samplerate(samplerate)
@@ -76,6 +115,16 @@ public:
     int32_t *buffer() const { return (int32_t *) m_buffer; }
     void     reset_buffer() { m_buf_pos = 0; }
     int      is_48k() const { return m_48k; }
+    fm_offload_t *offload() const { return m_offload; }
+
+    /* The chip is only considered once, on its first buffer callback. */
+    void try_offload()
+    {
+        if (!m_offload_tried) {
+            m_offload_tried = 1;
+            start_offload();
+        }
+    }
 
     virtual uint32_t sample_rate() const = 0;
 
@@ -85,11 +134,14 @@ public:
     virtual int32_t *update()                                                = 0;
     virtual uint8_t  read(uint16_t addr)                                     = 0;
     virtual void     set_clock(uint32_t clock)                               = 0;
+    virtual void     start_offload()                                         = 0;
 
 protected:
     int32_t  m_buffer[MUSICBUFLEN * 2];
     int      m_buf_pos;
     int      *m_buf_pos_global;
+    fm_offload_t *m_offload;
+    int8_t   m_offload_tried;
     int8_t   m_flags;
     fm_type  m_type;
     uint32_t m_samplerate;
@@ -102,6 +154,8 @@ public:
     YMFMChip(uint32_t clock, fm_type type, uint32_t samplerate, int m_48k)
         : YMFMChipBase(clock, type, samplerate, m_48k)
         , m_chip(*this)
+        , m_synth(nullptr)
+        , m_synth_intf(nullptr)
         , m_clock(clock)
         , m_samplerate(samplerate)
         , m_samplecnt(0)
@@ -129,6 +183,13 @@ public:
         timer_add(&m_timers[1], YMFMChip::timer2, this, 0);
     }
 
+    virtual ~YMFMChip()
+    {
+        fm_offload_detach(m_offload);
+        delete m_synth;
+        delete m_synth_intf;
+    }
+
     virtual uint32_t sample_rate() const override
     {
         return m_chip.sample_rate(m_clock);
@@ -146,7 +207,7 @@ public:
         else {
             double period = m_clock_us * duration_in_clocks;
             if (period < m_subtract[tnum])
-                m_engine->engine_timer_expired(tnum);
+                timer_expired(tnum);
             else
                 timer_on_auto(timer, period);
         }
@@ -164,8 +225,10 @@ public:
 
     virtual void generate(int32_t *data, uint32_t num_samples) override
     {
+        ChipType &chip = (m_synth != nullptr) ? *m_synth : m_chip;
+
         for (uint32_t i = 0; i < num_samples; i++) {
-            m_chip.generate(&m_output);
+            chip.generate(&m_output);
             if ((m_type == FM_YMF278B) && (sizeof(m_output.data) > (4 * sizeof(int32_t)))) {
                 if (ChipType::OUTPUTS == 1) {
                     *data++ = m_output.data[4];
@@ -186,11 +249,13 @@ public:
 
     virtual void generate_resampled(int32_t *data, uint32_t num_samples) override
     {
+        ChipType &chip = (m_synth != nullptr) ? *m_synth : m_chip;
+
         for (uint32_t i = 0; i < num_samples; i++) {
             while (m_samplecnt >= m_rateratio) {
                 m_oldsamples[0] = m_samples[0];
                 m_oldsamples[1] = m_samples[1];
-                m_chip.generate(&m_output);
+                chip.generate(&m_output);
                 if ((m_type == FM_YMF278B) && (sizeof(m_output.data) > (4 * sizeof(int32_t)))) {
                     if (ChipType::OUTPUTS == 1) {
                         m_samples[0] = m_output.data[4];
@@ -241,11 +306,92 @@ public:
     virtual void write(uint16_t addr, uint8_t data) override
     {
         m_chip.write(addr, data);
+
+        if (m_offload != nullptr)
+            fm_offload_write(m_offload, addr, data);
     }
 
     virtual uint8_t read(uint16_t addr) override
     {
-        return m_chip.read(addr);
+        uint8_t ret = m_chip.read(addr);
+
+        /* Keep the synthesis copy in step with any side effects of data
+           port reads. */
+        if ((m_offload != nullptr) && (addr & 1))
+            fm_offload_read(m_offload, addr);
+
+        return ret;
+    }
+
+    /* Clone the chip state into a second chip that only renders audio, then
+       hand that one over to the FM synthesis thread. */
+    virtual void start_offload() override
+    {
+        /* The primary chip is no longer clocked once offloaded, which is fine
+           for timers and FM but not for chips whose ADPCM or PCM engines
+           report status (OPL4 load busy, ADPCM EOS/BRDY) that the guest
+           polls. Keep those synchronous. */
+        switch (m_type) {
+            case FM_Y8950:
+            case FM_YMF278B:
+            case FM_YM2608:
+            case FM_YM2610:
+            case FM_YM2610B:
+                return;
+
+            default:
+                break;
+        }
+
+        std::vector<uint8_t> state;
+        ymfm::ymfm_saved_state save(state, true);
+
+        m_chip.save_restore(save);
+
+        m_synth_intf = new YMFMSynthInterface(get_special_flags(), m_yrw801);
+        m_synth      = new ChipType(*m_synth_intf);
+
+        ymfm::ymfm_saved_state restore(state, false);
+        m_synth->save_restore(restore);
+
+        m_offload = fm_offload_attach(this, offload_write, offload_read, offload_timer, offload_generate, m_buf_pos_global);
+        if (m_offload == nullptr) {
+            delete m_synth;
+            delete m_synth_intf;
+            m_synth      = nullptr;
+            m_synth_intf = nullptr;
+        }
+    }
+
+    static void offload_write(void *priv, uint16_t port, uint8_t val)
+    {
+        YMFMChip<ChipType> *drv = (YMFMChip<ChipType> *) priv;
+        drv->m_synth->write(port, val);
+    }
+
+    static void offload_read(void *priv, uint16_t port)
+    {
+        YMFMChip<ChipType> *drv = (YMFMChip<ChipType> *) priv;
+        (void) drv->m_synth->read(port);
+    }
+
+    static void offload_timer(void *priv, int tnum)
+    {
+        YMFMChip<ChipType> *drv = (YMFMChip<ChipType> *) priv;
+        drv->m_synth_intf->timer_expired(tnum);
+    }
+
+    static void offload_generate(void *priv, int32_t *data, uint32_t num_samples)
+    {
+        YMFMChip<ChipType> *drv = (YMFMChip<ChipType> *) priv;
+
+        if (drv->m_48k)
+            drv->generate_resampled(data, num_samples);
+        else
+            drv->generate(data, num_samples);
+
+        for (uint32_t i = 0; i < (num_samples * 2); i++)
+            data[i] /= 2;
     }
 
     virtual uint32_t get_special_flags(void) override
@@ -253,16 +399,25 @@ public:
         return ((m_type == FM_YMF262) || (m_type == FM_YMF289B) || (m_type == FM_YMF278B)) ? 0x8000 : 0x0000;
     }
 
+    void timer_expired(uint32_t tnum)
+    {
+        m_engine->engine_timer_expired(tnum);
+
+        /* Timer A triggers CSM key on, which the synthesis copy has to see. */
+        if ((tnum == 0) && (m_offload != nullptr))
+            fm_offload_timer(m_offload, 0);
+    }
+
     static void timer1(void *priv)
     {
         YMFMChip<ChipType> *drv = (YMFMChip<ChipType> *) priv;
-        drv->m_engine->engine_timer_expired(0);
+        drv->timer_expired(0);
     }
 
     static void timer2(void *priv)
     {
         YMFMChip<ChipType> *drv = (YMFMChip<ChipType> *) priv;
-        drv->m_engine->engine_timer_expired(1);
+        drv->timer_expired(1);
     }
 
     virtual uint8_t ymfm_external_read(ymfm::access_class type, uint32_t address) override
@@ -275,6 +430,8 @@ public:
 
 private:
     ChipType                       m_chip;
+    ChipType                      *m_synth;
+    YMFMSynthInterface            *m_synth_intf;
     uint32_t                       m_clock;
     double                         m_clock_us;
     double                         m_subtract[2];
@@ -483,7 +640,8 @@ ymfm_drv_read(uint16_t port, void *priv)
         cycles -= ((int) (isa_timing * 8));
 
     uint8_t ret = drv->read(port);
-    drv->update();
+    if (drv->offload() == nullptr)
+        drv->update();
 
     ymfm_log("YMFM read port %04x, status = %02x\n", port, ret);
     return ret;
@@ -498,15 +656,27 @@ ymfm_drv_write(uint16_t port, uint8_t val, void *priv)
     if ((port == 0x380) || (port == 0x381))
         port |= 4;
     drv->write(port, val);
-    drv->update();
+    if (drv->offload() == nullptr)
+        drv->update();
 }
 
 static int32_t *
 ymfm_drv_update(void *priv)
 {
     YMFMChipBase *drv = (YMFMChipBase *) priv;
+    int32_t      *ret;
 
-    return drv->update();
+    if (drv->offload() != nullptr)
+        return fm_offload_update(drv->offload());
+
+    ret = drv->update();
+
+    /* Only chips driven by a sound card's buffer callback are offloaded,
+       those rendered through ymfm_drv_generate() stay synchronous. */
+    if (fm_offload)
+        drv->try_offload();
+
+    return ret;
 }
 
 static void
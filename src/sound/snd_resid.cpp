@@ -19,10 +19,12 @@ typedef struct psid_t {
 
 psid_t *psid;
 
+/* fast selects linear interpolation instead of the two-pass sinc resampler,
+   which is most of the cost of the sinc path at a ~895 kHz chip clock. */
 void *
-sid_init(uint8_t type, double range)
+sid_init(uint8_t type, double range, int fast)
 {
-    reSIDfp::SamplingMethod method         = reSIDfp::RESAMPLE;
+    reSIDfp::SamplingMethod method         = fast ? reSIDfp::DECIMATE : reSIDfp::RESAMPLE;
     float                   cycles_per_sec = 14318180.0 / 16.0;
 
     psid      = new psid_t;
@@ -3810,6 +3810,8 @@ sb_awe32_init(UNUSED(const device_t *info))
     sb_dsp_set_mpu(&sb->dsp, sb->mpu);
 
     emu8k_init(&sb->emu8k, emu_addr, onboard_ram);
+    if (device_get_config_int("fx_thread"))
+        emu8k_fx_thread_start(&sb->emu8k);
 
     if (device_get_config_int("receive_input"))
         midi_in_handler(1, sb_dsp_input_msg, sb_dsp_input_sysex, &sb->dsp);
@@ -3831,6 +3833,8 @@ sb_goldfinch_init(const device_t *info)
     wavetable_add_handler(sb_get_wavetable_buffer_goldfinch, goldfinch);
 
     emu8k_init(&goldfinch->emu8k, 0, onboard_ram);
+    if (device_get_config_int("fx_thread"))
+        emu8k_fx_thread_start(&goldfinch->emu8k);
 
     const char *pnp_rom_file = NULL;
     switch (info->local) {
@@ -3899,6 +3903,8 @@ sb_awe32_pnp_init(const device_t *info)
     sb_dsp_set_mpu(&sb->dsp, sb->mpu);
 
     emu8k_init(&sb->emu8k, 0, onboard_ram);
+    if (device_get_config_int("fx_thread"))
+        emu8k_fx_thread_start(&sb->emu8k);
 
     if (device_get_config_int("receive_input"))
         midi_in_handler(1, sb_dsp_input_msg, sb_dsp_input_sysex, &sb->dsp);
@@ -5364,6 +5370,17 @@ static const device_config_t sb_goldfinch_config[] = {
         },
         .bios           = { { 0 } }
     },
+    {
+        .name           = "fx_thread",
+        .description    = "Render reverb and chorus on a separate thread",
+        .type           = CONFIG_BINARY,
+        .default_string = NULL,
+        .default_int    = 0,
+        .file_filter    = NULL,
+        .spinner        = { 0 },
+        .selection      = { { 0 } },
+        .bios           = { { 0 } }
+    },
     { .name = "", .description = "", .type = CONFIG_END }
 };
 
@@ -5386,6 +5403,17 @@ static const device_config_t sb_32_pnp_config[] = {
         },
         .bios           = { { 0 } }
     },
+    {
+        .name           = "fx_thread",
+        .description    = "Render reverb and chorus on a separate thread",
+        .type           = CONFIG_BINARY,
+        .default_string = NULL,
+        .default_int    = 0,
+        .file_filter    = NULL,
+        .spinner        = { 0 },
+        .selection      = { { 0 } },
+        .bios           = { { 0 } }
+    },
     {
         .name           = "control_pc_speaker",
         .description    = "Control PC speaker",
@@ -5540,6 +5568,17 @@ static const device_config_t sb_awe32_config[] = {
         },
         .bios           = { { 0 } }
     },
+    {
+        .name           = "fx_thread",
+        .description    = "Render reverb and chorus on a separate thread",
+        .type           = CONFIG_BINARY,
+        .default_string = NULL,
+        .default_int    = 0,
+        .file_filter    = NULL,
+        .spinner        = { 0 },
+        .selection      = { { 0 } },
+        .bios           = { { 0 } }
+    },
     {
         .name           = "gameport",
         .description    = "Enable Game port",
@@ -5617,6 +5656,17 @@ static const device_config_t sb_awe32_pnp_config[] = {
         },
         .bios           = { { 0 } }
     },
+    {
+        .name           = "fx_thread",
+        .description    = "Render reverb and chorus on a separate thread",
+        .type           = CONFIG_BINARY,
+        .default_string = NULL,
+        .default_int    = 0,
+        .file_filter    = NULL,
+        .spinner        = { 0 },
+        .selection      = { { 0 } },
+        .bios           = { { 0 } }
+    },
     {
         .name           = "control_pc_speaker",
         .description    = "Control PC speaker",
@@ -5677,6 +5727,17 @@ static const device_config_t sb_awe64_value_config[] = {
         },
         .bios           = { { 0 } }
     },
+    {
+        .name           = "fx_thread",
+        .description    = "Render reverb and chorus on a separate thread",
+        .type           = CONFIG_BINARY,
+        .default_string = NULL,
+        .default_int    = 0,
+        .file_filter    = NULL,
+        .spinner        = { 0 },
+        .selection      = { { 0 } },
+        .bios           = { { 0 } }
+    },
     {
         .name           = "control_pc_speaker",
         .description    = "Control PC speaker",
@@ -5736,6 +5797,17 @@ static const device_config_t sb_awe64_config[] = {
         },
         .bios           = { { 0 } }
     },
+    {
+        .name           = "fx_thread",
+        .description    = "Render reverb and chorus on a separate thread",
+        .type           = CONFIG_BINARY,
+        .default_string = NULL,
+        .default_int    = 0,
+        .file_filter    = NULL,
+        .spinner        = { 0 },
+        .selection      = { { 0 } },
+        .bios           = { { 0 } }
+    },
     {
         .name           = "control_pc_speaker",
         .description    = "Control PC speaker",
@@ -5793,6 +5865,17 @@ static const device_config_t sb_awe64_gold_config[] = {
         },
         .bios           = { { 0 } }
     },
+    {
+        .name           = "fx_thread",
+        .description    = "Render reverb and chorus on a separate thread",
+        .type           = CONFIG_BINARY,
+        .default_string = NULL,
+        .default_int    = 0,
+        .file_filter    = NULL,
+        .spinner        = { 0 },
+        .selection      = { { 0 } },
+        .bios           = { { 0 } }
+    },
     {
         .name           = "control_pc_speaker",
         .description    = "Control PC speaker",
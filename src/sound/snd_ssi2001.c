@@ -72,7 +72,8 @@ ssi2001_init(UNUSED(const device_t *info))
 {
     ssi2001_t *ssi2001 = calloc(1, sizeof(ssi2001_t));
 
-    ssi2001->psid = sid_init(device_get_config_int("sid_config"),device_get_config_int("sid_adjustment"));
+    ssi2001->psid = sid_init(device_get_config_int("sid_config"),device_get_config_int("sid_adjustment"),
+                             device_get_config_int("sid_resampling"));
     sid_reset(ssi2001->psid);
     uint16_t addr             = device_get_config_hex16("base");
     ssi2001->gameport_enabled = device_get_config_int("gameport");
@@ -112,7 +113,7 @@ entertainer_init(UNUSED(const device_t *info))
     ssi2001_t     *ssi2001     = calloc(1, sizeof(ssi2001_t));
     entertainer_t *entertainer = calloc(1, sizeof(entertainer_t));
 
-    ssi2001->psid = sid_init(0, 0.5);
+    ssi2001->psid = sid_init(0, 0.5, device_get_config_int("sid_resampling"));
     sid_reset(ssi2001->psid);
     ssi2001->gameport_enabled = device_get_config_int("gameport");
     io_sethandler(0x200, 0x0001, entertainer_read, NULL, NULL, entertainer_write, NULL, NULL, entertainer);
@@ -189,6 +190,21 @@ static const device_config_t ssi2001_config[] = {
         .selection      = {{"0.5"}},
         .bios           = { { 0 } }
     },
+    {
+        .name           = "sid_resampling",
+        .description    = "SID Resampling",
+        .type           = CONFIG_SELECTION,
+        .default_string = NULL,
+        .default_int    = 0,
+        .file_filter    = NULL,
+        .spinner        = { 0 },
+        .selection      = {
+            { .description = "Sinc (best quality)", .value = 0 },
+            { .description = "Linear (fastest)",    .value = 1 },
+            { .description = ""                              }
+        },
+        .bios           = { { 0 } }
+    },
     { .name = "", .description = "", .type = CONFIG_END }
 // clang-format off
 };
@@ -206,6 +222,21 @@ static const device_config_t entertainer_config[] = {
         .selection      = { { 0 } },
         .bios           = { { 0 } }
     },
+    {
+        .name           = "sid_resampling",
+        .description    = "SID Resampling",
+        .type           = CONFIG_SELECTION,
+        .default_string = NULL,
+        .default_int    = 0,
+        .file_filter    = NULL,
+        .spinner        = { 0 },
+        .selection      = {
+            { .description = "Sinc (best quality)", .value = 0 },
+            { .description = "Linear (fastest)",    .value = 1 },
+            { .description = ""                              }
+        },
+        .bios           = { { 0 } }
+    },
     { .name = "", .description = "", .type = CONFIG_END }
 // clang-format off
 };
@@ -34,6 +34,7 @@
 #include <86box/thread.h>
 #include <86box/snd_ac97.h>
 #include <86box/timer.h>
+#include <86box/trace.h>
 #include <86box/snd_mpu401.h>
 #include <86box/sound.h>
 #include <86box/fdd_audio.h>
@@ -596,8 +597,11 @@ sound_poll(UNUSED(void *priv))
 
         memset(outbuffer, 0x00, SOUNDBUFLEN * 2 * sizeof(int32_t));
 
-        for (c = 0; c < sound_handlers_num; c++)
+        for (c = 0; c < sound_handlers_num; c++) {
+            TRACE_SPAN_ENTER("sound", sound_handlers[c].get_buffer, sound_handlers[c].priv);
             sound_handlers[c].get_buffer(outbuffer, SOUNDBUFLEN, sound_handlers[c].priv);
+            TRACE_LEAVE();
+        }
 
         for (c = 0; c < SOUNDBUFLEN * 2; c++) {
             if (sound_is_float)
@@ -647,8 +651,11 @@ music_poll(UNUSED(void *priv))
 
         memset(outbuffer_m, 0x00, MUSICBUFLEN * 2 * sizeof(int32_t));
 
-        for (c = 0; c < music_handlers_num; c++)
+        for (c = 0; c < music_handlers_num; c++) {
+            TRACE_SPAN_ENTER("sound", music_handlers[c].get_buffer, music_handlers[c].priv);
             music_handlers[c].get_buffer(outbuffer_m, MUSICBUFLEN, music_handlers[c].priv);
+            TRACE_LEAVE();
+        }
 
         for (c = 0; c < MUSICBUFLEN * 2; c++) {
             if (sound_is_float)
@@ -683,8 +690,11 @@ wavetable_poll(UNUSED(void *priv))
 
         memset(outbuffer_w, 0x00, WTBUFLEN * 2 * sizeof(int32_t));
 
-        for (c = 0; c < wavetable_handlers_num; c++)
+        for (c = 0; c < wavetable_handlers_num; c++) {
+            TRACE_SPAN_ENTER("sound", wavetable_handlers[c].get_buffer, wavetable_handlers[c].priv);
             wavetable_handlers[c].get_buffer(outbuffer_w, WTBUFLEN, wavetable_handlers[c].priv);
+            TRACE_LEAVE();
+        }
 
         for (c = 0; c < WTBUFLEN * 2; c++) {
             if (sound_is_float)
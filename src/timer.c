@@ -5,6 +5,7 @@
 #include <86box/86box.h>
 #include "cpu.h"
 #include <86box/timer.h>
+#include <86box/trace.h>
 #include <86box/nv/vid_nv_rivatimer.h>
 
 uint64_t TIMER_USEC;
@@ -134,9 +135,11 @@ timer_process(void)
                have a NULL callback when no operation
                is needed.
              */
+            TRACE_COUNT_ENTER("timer", timer->callback, timer->priv);
             timer->in_callback = 1;
             timer->callback(timer->priv);
             timer->in_callback = 0;
+            TRACE_LEAVE();
         }
     }
 
@@ -0,0 +1,231 @@
+/*
+ * 86Box    A hypervisor and IBM PC system emulator that specializes in
+ *          running old operating systems and software designed for IBM
+ *          PC systems and compatibles from 1981 through fairly recent
+ *          system designs based on the PCI bus.
+ *
+ *          This file is part of the 86Box distribution.
+ *
+ *          Host time instrumentation layer on top of minitrace.
+ *
+ *          Counters are keyed by (handler, instance) and live in a
+ *          fixed open-addressed table; lookups are lock-free, only
+ *          the insertion of a new counter takes the mutex. Counters
+ *          are named after the device owning the instance pointer
+ *          when there is one, so time spent in timer callbacks, I/O
+ *          and MMIO handlers and so on can be attributed per device.
+ */
+#include <stdarg.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <wchar.h>
+#define HAVE_STDARG_H
+#include <86box/86box.h>
+#include <86box/device.h>
+#include <86box/plat.h>
+#include <86box/thread.h>
+#include <86box/trace.h>
+
+#define TRACE_COUNTERS 4096 /* must be a power of two */
+
+struct trace_counter_t {
+    atomic_uintptr_t key;
+    const void      *priv;
+    const char      *cat;
+    char             name[80];
+    int              span;
+
+    atomic_uint_fast64_t calls;
+    atomic_uint_fast64_t total_ns;
+    atomic_uint_fast64_t max_ns;
+};
+
+static trace_counter_t trace_counters[TRACE_COUNTERS];
+static mutex_t        *trace_mutex;
+
+static uint32_t
+trace_hash(const void *key, const void *priv)
+{
+    uint64_t h = ((uint64_t) (uintptr_t) key) ^ ((uint64_t) (uintptr_t) priv * 0x9e3779b97f4a7c15ULL);
+
+    h ^= h >> 29;
+    h *= 0xbf58476d1ce4e5b9ULL;
+    h ^= h >> 32;
+
+    return (uint32_t) h & (TRACE_COUNTERS - 1);
+}
+
+static void
+trace_counter_name(trace_counter_t *ctr, const void *key, const void *priv, const char *name)
+{
+    const device_t *dev;
+
+    if (name != NULL) {
+        snprintf(ctr->name, sizeof(ctr->name), "%s", name);
+        return;
+    }
+
+    dev = device_get_by_priv(priv);
+    if (dev != NULL)
+        snprintf(ctr->name, sizeof(ctr->name), "%s [%p]", dev->name, key);
+    else
+        snprintf(ctr->name, sizeof(ctr->name), "%s %p/%p", ctr->cat, key, priv);
+}
+
+trace_counter_t *
+trace_counter_get(const char *cat, const void *key, void *priv, const char *name, int span)
+{
+    uint32_t         i = trace_hash(key, priv);
+    trace_counter_t *ctr;
+    uintptr_t        k;
+
+    for (uint32_t n = 0; n < TRACE_COUNTERS; n++, i = (i + 1) & (TRACE_COUNTERS - 1)) {
+        ctr = &trace_counters[i];
+        k   = atomic_load_explicit(&ctr->key, memory_order_acquire);
+
+        if (k == 0) {
+            /* Not found, insert it under the lock; somebody may have beaten us to this slot. */
+            thread_wait_mutex(trace_mutex);
+            if (atomic_load_explicit(&ctr->key, memory_order_relaxed) == 0) {
+                ctr->priv = priv;
+                ctr->cat  = cat;
+                ctr->span = span;
+                trace_counter_name(ctr, key, priv, name);
+                atomic_store_explicit(&ctr->key, (uintptr_t) key, memory_order_release);
+                thread_release_mutex(trace_mutex);
+                return ctr;
+            }
+            thread_release_mutex(trace_mutex);
+            k = atomic_load_explicit(&ctr->key, memory_order_acquire);
+        }
+
+        if ((k == (uintptr_t) key) && (ctr->priv == priv))
+            return ctr;
+    }
+
+    /* Table full, stop counting new handlers. */
+    return NULL;
+}
+
+uint64_t
+trace_enter(trace_counter_t *ctr)
+{
+    if (ctr->span)
+        internal_mtr_raw_event(ctr->cat, ctr->name, 'B', 0);
+
+    return (uint64_t) (mtr_time_s() * 1000000000.0);
+}
+
+void
+trace_leave(trace_counter_t *ctr, uint64_t start)
+{
+    uint64_t ns = (uint64_t) (mtr_time_s() * 1000000000.0) - start;
+    uint64_t max;
+
+    if (ctr->span)
+        internal_mtr_raw_event(ctr->cat, ctr->name, 'E', 0);
+
+    atomic_fetch_add_explicit(&ctr->calls, 1, memory_order_relaxed);
+    atomic_fetch_add_explicit(&ctr->total_ns, ns, memory_order_relaxed);
+
+    max = atomic_load_explicit(&ctr->max_ns, memory_order_relaxed);
+    while ((ns > max) && !atomic_compare_exchange_weak_explicit(&ctr->max_ns, &max, ns,
+                                                               memory_order_relaxed, memory_order_relaxed))
+        ;
+}
+
+static int
+trace_counter_cmp(const void *a, const void *b)
+{
+    uint64_t ta = atomic_load(&(*(trace_counter_t * const *) a)->total_ns);
+    uint64_t tb = atomic_load(&(*(trace_counter_t * const *) b)->total_ns);
+
+    return (ta < tb) - (ta > tb);
+}
+
+static void
+trace_json_string(FILE *fp, const char *s)
+{
+    fputc('"', fp);
+    for (; *s; s++) {
+        if ((*s == '"') || (*s == '\\'))
+            fputc('\\', fp);
+        if ((unsigned char) *s >= 0x20)
+            fputc(*s, fp);
+    }
+    fputc('"', fp);
+}
+
+void
+trace_counters_save(const char *fn)
+{
+    trace_counter_t **list;
+    int               n = 0;
+    FILE             *fp;
+
+    if ((fn == NULL) || ((fp = plat_fopen(fn, "wb")) == NULL))
+        return;
+
+    list = (trace_counter_t **) malloc(TRACE_COUNTERS * sizeof(trace_counter_t *));
+    for (int i = 0; i < TRACE_COUNTERS; i++) {
+        if (atomic_load(&trace_counters[i].key) && atomic_load(&trace_counters[i].calls))
+            list[n++] = &trace_counters[i];
+    }
+    qsort(list, n, sizeof(trace_counter_t *), trace_counter_cmp);
+
+    fprintf(fp, "{\"counters\":[\n");
+    for (int i = 0; i < n; i++) {
+        uint64_t calls = atomic_load(&list[i]->calls);
+        uint64_t total = atomic_load(&list[i]->total_ns);
+
+        fprintf(fp, "  {\"cat\":");
+        trace_json_string(fp, list[i]->cat);
+        fprintf(fp, ",\"name\":");
+        trace_json_string(fp, list[i]->name);
+        fprintf(fp, ",\"calls\":%" PRIu64 ",\"total_us\":%.3f,\"avg_us\":%.3f,\"max_us\":%.3f}%s\n",
+                calls, total / 1000.0, (total / 1000.0) / calls,
+                atomic_load(&list[i]->max_ns) / 1000.0, (i < (n - 1)) ? "," : "");
+    }
+    fprintf(fp, "]}\n");
+
+    fclose(fp);
+    free(list);
+}
+
+void
+trace_start(const char *trace_fn)
+{
+    if (tracing_on)
+        return;
+
+    if (trace_mutex == NULL)
+        trace_mutex = thread_create_mutex();
+
+    for (int i = 0; i < TRACE_COUNTERS; i++) {
+        atomic_store(&trace_counters[i].calls, 0);
+        atomic_store(&trace_counters[i].total_ns, 0);
+        atomic_store(&trace_counters[i].max_ns, 0);
+    }
+
+    mtr_init(trace_fn);
+    mtr_start();
+
+    tracing_on = 1;
+}
+
+void
+trace_stop(const char *counters_fn)
+{
+    if (!tracing_on)
+        return;
+
+    tracing_on = 0;
+
+    mtr_stop();
+    mtr_shutdown();
+
+    trace_counters_save(counters_fn);
+}
@@ -0,0 +1,156 @@
+/*
+ * 86Box    A hypervisor and IBM PC system emulator that specializes in
+ *          running old operating systems and software designed for IBM
+ *          PC systems and compatibles from 1981 through fairly recent
+ *          system designs based on the PCI bus.
+ *
+ *          This file is part of the 86Box distribution.
+ *
+ *          Shared 2D blitter core.
+ *
+ *          One row kernel is instantiated per pixel size for each ROP
+ *          that ignores the pattern, with the ROP known at compile time
+ *          so that video_rop3() reduces to its expression and the loops
+ *          can be vectorized. Those are the ROPs the S3 fast paths use;
+ *          the rest share a loop that evaluates the ROP per pixel.
+ */
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <wchar.h>
+#include <86box/86box.h>
+#include <86box/vid_blit.h>
+
+typedef void (*video_blit_row_t)(uint8_t *dst, const uint8_t *src, uint32_t pat, int n, int backwards);
+
+/* Only the 16 ROPs that ignore the pattern, which are the two-operand mixes
+   S3 maps its foreground mix to, get their own kernels. The other 240 take
+   the generic loop below. */
+#define ROP_LIST(X) \
+    X(00) X(11) X(22) X(33) X(44) X(55) X(66) X(77) X(88) X(99) X(aa) X(bb) X(cc) X(dd) X(ee) X(ff)
+
+#define ROW_KERNEL(type, bits, r)                                                              \
+    static void                                                                                \
+    video_blit_row##bits##_##r(uint8_t *dst8, const uint8_t *src8, uint32_t pat, int n, int backwards) \
+    {                                                                                          \
+        type       *dst = (type *) dst8;                                                       \
+        const type *src = (const type *) src8;                                                 \
+        const type  p   = (type) pat;                                                          \
+                                                                                               \
+        if (backwards) {                                                                       \
+            for (int x = n - 1; x >= 0; x--)                                                   \
+                dst[x] = video_rop3(0x##r, VIDEO_ROP_USES_DST(0x##r) ? dst[x] : 0, p,          \
+                                    VIDEO_ROP_USES_SRC(0x##r) ? src[x] : 0);                   \
+        } else {                                                                               \
+            for (int x = 0; x < n; x++)                                                        \
+                dst[x] = video_rop3(0x##r, VIDEO_ROP_USES_DST(0x##r) ? dst[x] : 0, p,          \
+                                    VIDEO_ROP_USES_SRC(0x##r) ? src[x] : 0);                   \
+        }                                                                                      \
+    }
+
+#define ROW_KERNEL8(r)  ROW_KERNEL(uint8_t, 8, r)
+#define ROW_KERNEL16(r) ROW_KERNEL(uint16_t, 16, r)
+#define ROW_KERNEL32(r) ROW_KERNEL(uint32_t, 32, r)
+
+ROP_LIST(ROW_KERNEL8)
+ROP_LIST(ROW_KERNEL16)
+ROP_LIST(ROW_KERNEL32)
+
+#define ROW_ENTRY8(r)  video_blit_row8_##r,
+#define ROW_ENTRY16(r) video_blit_row16_##r,
+#define ROW_ENTRY32(r) video_blit_row32_##r,
+
+/* Indexed by the high nibble of a pattern-independent ROP. */
+static const video_blit_row_t video_blit_rows[3][16] = {
+    { ROP_LIST(ROW_ENTRY8) },
+    { ROP_LIST(ROW_ENTRY16) },
+    { ROP_LIST(ROW_ENTRY32) }
+};
+
+#define ROW_GENERIC(type)                                                              \
+    {                                                                                  \
+        type       *d = (type *) dst;                                                  \
+        const type *s = (const type *) src;                                            \
+                                                                                       \
+        if (backwards) {                                                               \
+            for (int x = n - 1; x >= 0; x--)                                           \
+                d[x] = video_rop3(rop, d[x], (type) pat, (s != NULL) ? s[x] : 0);      \
+        } else {                                                                       \
+            for (int x = 0; x < n; x++)                                                \
+                d[x] = video_rop3(rop, d[x], (type) pat, (s != NULL) ? s[x] : 0);      \
+        }                                                                              \
+    }
+
+static void
+video_blit_row_generic(uint8_t rop, int shift, uint8_t *dst, const uint8_t *src, uint32_t pat, int n, int backwards)
+{
+    switch (shift) {
+        case 0:
+            ROW_GENERIC(uint8_t)
+            break;
+        case 1:
+            ROW_GENERIC(uint16_t)
+            break;
+        default:
+            ROW_GENERIC(uint32_t)
+            break;
+    }
+}
+
+void
+video_blit_rop_row(uint8_t rop, int bpp, uint8_t *dst, const uint8_t *src, uint32_t pat, int n, int backwards)
+{
+    int    shift = (bpp == 8) ? 0 : ((bpp == 16) ? 1 : 2);
+    size_t len   = (size_t) n << shift;
+
+    if (n <= 0)
+        return;
+
+    /* A straight copy only needs the pixel walk when the runs overlap
+       against the walk direction, otherwise memmove() gives the same result. */
+    if ((rop == 0xcc) && (((dst + len) <= src) || ((src + len) <= dst) || (backwards ? (dst >= src) : (dst <= src))))
+        memmove(dst, src, len);
+    else if (((rop >> 4) ^ rop) & 0x0f)
+        video_blit_row_generic(rop, shift, dst, src, pat, n, backwards);
+    else
+        video_blit_rows[shift][rop >> 4](dst, src, pat, n, backwards);
+}
+
+void
+video_blit_logic_row(int bpp, uint8_t *dst, uint32_t and_mask, uint32_t xor_val, int n)
+{
+    switch (bpp) {
+        case 8:
+            if (!(and_mask & 0xff))
+                memset(dst, xor_val & 0xff, n);
+            else {
+                for (int x = 0; x < n; x++)
+                    dst[x] = (dst[x] & and_mask) ^ xor_val;
+            }
+            break;
+        case 16: {
+            uint16_t *p = (uint16_t *) dst;
+
+            if (!(and_mask & 0xffff)) {
+                for (int x = 0; x < n; x++)
+                    p[x] = xor_val;
+            } else {
+                for (int x = 0; x < n; x++)
+                    p[x] = (p[x] & and_mask) ^ xor_val;
+            }
+            break;
+        }
+        default: {
+            uint32_t *p = (uint32_t *) dst;
+
+            if (!and_mask) {
+                for (int x = 0; x < n; x++)
+                    p[x] = xor_val;
+            } else {
+                for (int x = 0; x < n; x++)
+                    p[x] = (p[x] & and_mask) ^ xor_val;
+            }
+            break;
+        }
+    }
+}
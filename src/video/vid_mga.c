@@ -58,6 +58,8 @@
 #define FIFO_TYPE        0xff000000
 #define FIFO_ADDR        0x00ffffff
 
+#define ILOAD_BATCH      256 /*ILOAD data words handed to the blitter at once*/
+
 #define DMA_POLL_TIME_US 100 /*100us*/
 #define DMA_MAX_WORDS    (20 * 14) /*280 quad words per 100us poll*/
 
@@ -670,6 +672,7 @@ static void mystique_start_blit(mystique_t *mystique);
 static void mystique_update_irqs(mystique_t *mystique);
 
 static void wake_fifo_thread(mystique_t *mystique);
+static void wake_fifo_thread_now(mystique_t *mystique);
 static void wait_fifo_idle(mystique_t *mystique);
 static void mystique_queue(mystique_t *mystique, uint32_t addr, uint32_t val, uint32_t type);
 
@@ -690,6 +693,8 @@ static void     mystique_iload_write_l(uint32_t addr, uint32_t val, void *priv);
 
 static uint32_t blit_idump_read(mystique_t *mystique);
 static void     blit_iload_write(mystique_t *mystique, uint32_t data, int size);
+static int      blit_iload_rows_possible(mystique_t *mystique);
+static int      blit_iload_rows(mystique_t *mystique, const uint32_t *data, int count);
 
 void
 mystique_out(uint16_t addr, uint8_t val, void *priv)
@@ -1566,12 +1571,18 @@ mystique_ctrl_read_b(uint32_t addr, void *priv)
     } else
         switch (addr & 0x3fff) {
             case REG_FIFOSTATUS:
+                /* Polling for free space (or BEMPTY) should see the FIFO drain
+                   as soon as possible, not one wake delay later. */
+                if (!FIFO_EMPTY)
+                    wake_fifo_thread_now(mystique);
                 fifocount = FIFO_SIZE - FIFO_ENTRIES;
                 if (fifocount > (mystique->type <= MGA_1064SG ? 32 : 64))
                     fifocount = (mystique->type <= MGA_1064SG ? 32 : 64);
                 ret = fifocount;
                 break;
             case REG_FIFOSTATUS + 1:
+                if (!FIFO_EMPTY)
+                    wake_fifo_thread_now(mystique);
                 if (FIFO_EMPTY)
                     ret |= 2;
                 else if (FIFO_ENTRIES >= (mystique->type <= MGA_1064SG ? 32 : 64))
@@ -1597,6 +1608,8 @@ mystique_ctrl_read_b(uint32_t addr, void *priv)
                 ret = (mystique->status >> 8) & 0xff;
                 break;
             case REG_STATUS + 2:
+                if (!FIFO_EMPTY)
+                    wake_fifo_thread_now(mystique);
                 ret = (mystique->status >> 16) & 0xff;
                 if (mystique->busy || ((mystique->blitter_submit_refcount + mystique->blitter_submit_dma_refcount) != mystique->blitter_complete_refcount) || !FIFO_EMPTY
                 || mystique->dma.state != MGA_DMA_STATE_IDLE || mystique->softrap_pending || mystique->endprdmasts_pending)
@@ -2820,6 +2833,20 @@ mystique_accel_iload_write_l(UNUSED(uint32_t addr), uint32_t val, void *priv)
     }
 }
 
+/* Runs of ILOAD data words are handed over from the FIFO in one go, so the
+   common opaque colour blit can be drawn a row at a time. */
+static void
+mystique_accel_iload_write_block(mystique_t *mystique, const uint32_t *data, int count)
+{
+    int c = 0;
+
+    if ((mystique->dwgreg.dmamod == DMA_MODE_BLIT) && mystique->busy && blit_iload_rows_possible(mystique))
+        c = blit_iload_rows(mystique, data, count);
+
+    for (; c < count; c++)
+        mystique_accel_iload_write_l(0, data[c], mystique);
+}
+
 static uint8_t
 mystique_readb_linear(uint32_t addr, void *priv)
 {
@@ -3138,6 +3165,8 @@ static void
 fifo_thread(void *priv)
 {
     mystique_t *mystique = (mystique_t *) priv;
+    uint32_t    iload_data[ILOAD_BATCH];
+    int         iload_count;
 
     while (mystique->thread_run) {
         thread_set_event(mystique->fifo_not_full_event);
@@ -3158,7 +3187,19 @@ fifo_thread(void *priv)
                         mystique_accel_ctrl_write_l(fifo->addr_type & FIFO_ADDR, fifo->val, mystique);
                         break;
                     case FIFO_WRITE_ILOAD_LONG:
-                        mystique_accel_iload_write_l(fifo->addr_type & FIFO_ADDR, fifo->val, mystique);
+                        iload_data[0] = fifo->val;
+                        iload_count   = 1;
+                        while ((iload_count < ILOAD_BATCH) && ((FIFO_ENTRIES - iload_count) > 0)) {
+                            fifo_entry_t *next = &mystique->fifo[(mystique->fifo_read_idx + iload_count) & FIFO_MASK];
+
+                            if ((next->addr_type & FIFO_TYPE) != FIFO_WRITE_ILOAD_LONG)
+                                break;
+                            iload_data[iload_count++] = next->val;
+                            next->addr_type           = FIFO_INVALID;
+                        }
+                        mystique_accel_iload_write_block(mystique, iload_data, iload_count);
+                        mystique->fifo_read_idx += iload_count - 1;
+                        words_transferred += iload_count - 1;
                         break;
 
                     default:
@@ -4403,6 +4444,111 @@ blit_iload_iload_highv(mystique_t *mystique, uint32_t data, UNUSED(int size))
     }
 }
 
+/* Whether the running ILOAD is a plain opaque colour copy, which
+   blit_iload_rows() can draw without going through the generic pixel loop. */
+static int
+blit_iload_rows_possible(mystique_t *mystique)
+{
+    const uint32_t dwgctrl = mystique->dwgreg.dwgctrl_running;
+
+    if (((dwgctrl & DWGCTRL_OPCODE_MASK) != DWGCTRL_OPCODE_ILOAD) ||
+        ((dwgctrl & DWGCTRL_BLTMOD_MASK) != DWGCTRL_BLTMOD_BFCOL) ||
+        ((dwgctrl & DWGCTRL_BOP_MASK) != BOP(0xc)) || (dwgctrl & DWGCTRL_TRANSC) ||
+        (dwgctrl & DWGCTRL_TRANS_MASK) || mystique->dwgreg.iload_rem_count)
+        return 0;
+
+    switch (dwgctrl & DWGCTRL_ATYPE_MASK) {
+        case DWGCTRL_ATYPE_RPL:
+            if (mystique->maccess_running & MACCESS_TLUTLOAD)
+                return 0;
+            break;
+        case DWGCTRL_ATYPE_RSTR:
+        case DWGCTRL_ATYPE_BLK:
+            break;
+        default:
+            return 0;
+    }
+
+    switch (mystique->maccess_running & MACCESS_PWIDTH_MASK) {
+        case MACCESS_PWIDTH_8:
+        case MACCESS_PWIDTH_16:
+        case MACCESS_PWIDTH_32:
+            return 1;
+
+        default:
+            return 0;
+    }
+}
+
+/* Same result as feeding the words to blit_iload_iload() one at a time, with
+   the Y clip test hoisted out to once per word. Returns the number of words
+   consumed, which is less than count if the blit finishes. */
+static int
+blit_iload_rows(mystique_t *mystique, const uint32_t *data, int count)
+{
+    svga_t  *svga = &mystique->svga;
+    int      bits;
+    int      c;
+
+    switch (mystique->maccess_running & MACCESS_PWIDTH_MASK) {
+        case MACCESS_PWIDTH_8:
+            bits = 8;
+            break;
+        case MACCESS_PWIDTH_16:
+            bits = 16;
+            break;
+        default:
+            bits = 32;
+            break;
+    }
+
+    for (c = 0; (c < count) && mystique->busy; c++) {
+        uint32_t  val  = data[c];
+        const int in_y = (mystique->dwgreg.ydst_lin >= mystique->dwgreg.ytop) && (mystique->dwgreg.ydst_lin <= mystique->dwgreg.ybot);
+
+        mystique->dwgreg.words++;
+
+        for (int size = 32; size > 0; size -= bits) {
+            if (in_y && (mystique->dwgreg.xdst >= mystique->dwgreg.cxleft) && (mystique->dwgreg.xdst <= mystique->dwgreg.cxright)) {
+                uint32_t addr = mystique->dwgreg.ydst_lin + mystique->dwgreg.xdst;
+
+                switch (bits) {
+                    case 8:
+                        svga->vram[addr & mystique->vram_mask]                 = val;
+                        svga->changedvram[(addr & mystique->vram_mask) >> 12] = changeframecount;
+                        break;
+                    case 16:
+                        ((uint16_t *) svga->vram)[addr & mystique->vram_mask_w] = val;
+                        svga->changedvram[(addr & mystique->vram_mask_w) >> 11] = changeframecount;
+                        break;
+                    default:
+                        ((uint32_t *) svga->vram)[addr & mystique->vram_mask_l] = val;
+                        svga->changedvram[(addr & mystique->vram_mask_l) >> 10] = changeframecount;
+                        break;
+                }
+            }
+            if (bits < 32)
+                val >>= bits;
+
+            if (mystique->dwgreg.xdst == mystique->dwgreg.fxright) {
+                /* Rows start on a word boundary, the rest of this one is padding. */
+                mystique->dwgreg.xdst = mystique->dwgreg.fxleft;
+                mystique->dwgreg.ydst_lin += (mystique->dwgreg.pitch & PITCH_MASK);
+                mystique->dwgreg.selline = (mystique->dwgreg.selline + 1) & 7;
+                mystique->dwgreg.length_cur--;
+                if (!mystique->dwgreg.length_cur) {
+                    mystique->busy = 0;
+                    mystique->blitter_complete_refcount++;
+                }
+                break;
+            } else
+                mystique->dwgreg.xdst = (mystique->dwgreg.xdst + 1) & 0xffff;
+        }
+    }
+
+    return c;
+}
+
 static void
 blit_iload_write(mystique_t *mystique, uint32_t data, int size)
 {
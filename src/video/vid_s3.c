@@ -41,6 +41,7 @@
 #include <86box/vid_ddc.h>
 #include <86box/vid_xga.h>
 #include <86box/vid_svga.h>
+#include <86box/vid_blit.h>
 #include <86box/vid_svga_render.h>
 #include "cpu.h"
 
@@ -7139,784 +7140,10 @@ polygon_setup(s3_t *s3)
         dest_dat = (dest_dat & wrt_mask) | (old_dest_dat & ~wrt_mask); \
     }
 
-#define ROPMIX_READ(D, P, S)                       \
-    {                                              \
-        switch (rop) {                             \
-            case 0x00:                             \
-                out = 0;                           \
-                break;                             \
-            case 0x01:                             \
-                out = ~(D | (P | S));              \
-                break;                             \
-            case 0x02:                             \
-                out = D & ~(P | S);                \
-                break;                             \
-            case 0x03:                             \
-                out = ~(P | S);                    \
-                break;                             \
-            case 0x04:                             \
-                out = S & ~(D | P);                \
-                break;                             \
-            case 0x05:                             \
-                out = ~(D | P);                    \
-                break;                             \
-            case 0x06:                             \
-                out = ~(P | ~(D ^ S));             \
-                break;                             \
-            case 0x07:                             \
-                out = ~(P | (D & S));              \
-                break;                             \
-            case 0x08:                             \
-                out = S & (D & ~P);                \
-                break;                             \
-            case 0x09:                             \
-                out = ~(P | (D ^ S));              \
-                break;                             \
-            case 0x0a:                             \
-                out = D & ~P;                      \
-                break;                             \
-            case 0x0b:                             \
-                out = ~(P | (S & ~D));             \
-                break;                             \
-            case 0x0c:                             \
-                out = S & ~P;                      \
-                break;                             \
-            case 0x0d:                             \
-                out = ~(P | (D & ~S));             \
-                break;                             \
-            case 0x0e:                             \
-                out = ~(P | ~(D | S));             \
-                break;                             \
-            case 0x0f:                             \
-                out = ~P;                          \
-                break;                             \
-            case 0x10:                             \
-                out = P & ~(D | S);                \
-                break;                             \
-            case 0x11:                             \
-                out = ~(D | S);                    \
-                break;                             \
-            case 0x12:                             \
-                out = ~(S | ~(D ^ P));             \
-                break;                             \
-            case 0x13:                             \
-                out = ~(S | (D & P));              \
-                break;                             \
-            case 0x14:                             \
-                out = ~(D | ~(P ^ S));             \
-                break;                             \
-            case 0x15:                             \
-                out = ~(D | (P & S));              \
-                break;                             \
-            case 0x16:                             \
-                out = P ^ (S ^ (D & ~(P & S)));    \
-                break;                             \
-            case 0x17:                             \
-                out = ~(S ^ ((S ^ P) & (D ^ S)));  \
-                break;                             \
-            case 0x18:                             \
-                out = (S ^ P) & (P ^ D);           \
-                break;                             \
-            case 0x19:                             \
-                out = ~(S ^ (D & ~(P & S)));       \
-                break;                             \
-            case 0x1a:                             \
-                out = P ^ (D | (S & P));           \
-                break;                             \
-            case 0x1b:                             \
-                out = ~(S ^ (D & (P ^ S)));        \
-                break;                             \
-            case 0x1c:                             \
-                out = P ^ (S | (D & P));           \
-                break;                             \
-            case 0x1d:                             \
-                out = ~(D ^ (S & (P ^ D)));        \
-                break;                             \
-            case 0x1e:                             \
-                out = P ^ (D | S);                 \
-                break;                             \
-            case 0x1f:                             \
-                out = ~(P & (D | S));              \
-                break;                             \
-            case 0x20:                             \
-                out = D & (P & ~S);                \
-                break;                             \
-            case 0x21:                             \
-                out = ~(S | (D ^ P));              \
-                break;                             \
-            case 0x22:                             \
-                out = D & ~S;                      \
-                break;                             \
-            case 0x23:                             \
-                out = ~(S | (P & ~D));             \
-                break;                             \
-            case 0x24:                             \
-                out = (S ^ P) & (D ^ S);           \
-                break;                             \
-            case 0x25:                             \
-                out = ~(P ^ (D & ~(S & P)));       \
-                break;                             \
-            case 0x26:                             \
-                out = S ^ (D | (P & S));           \
-                break;                             \
-            case 0x27:                             \
-                out = S ^ (D | ~(P ^ S));          \
-                break;                             \
-            case 0x28:                             \
-                out = D & (P ^ S);                 \
-                break;                             \
-            case 0x29:                             \
-                out = ~(P ^ (S ^ (D | (P & S))));  \
-                break;                             \
-            case 0x2a:                             \
-                out = D & ~(P & S);                \
-                break;                             \
-            case 0x2b:                             \
-                out = ~(S ^ ((S ^ P) & (P ^ D)));  \
-                break;                             \
-            case 0x2c:                             \
-                out = S ^ (P & (D | S));           \
-                break;                             \
-            case 0x2d:                             \
-                out = P ^ (S | ~D);                \
-                break;                             \
-            case 0x2e:                             \
-                out = P ^ (S | (D ^ P));           \
-                break;                             \
-            case 0x2f:                             \
-                out = ~(P & (S | ~D));             \
-                break;                             \
-            case 0x30:                             \
-                out = P & ~S;                      \
-                break;                             \
-            case 0x31:                             \
-                out = ~(S | (D & ~P));             \
-                break;                             \
-            case 0x32:                             \
-                out = S ^ (D | (P | S));           \
-                break;                             \
-            case 0x33:                             \
-                out = ~S;                          \
-                break;                             \
-            case 0x34:                             \
-                out = S ^ (P | (D & S));           \
-                break;                             \
-            case 0x35:                             \
-                out = S ^ (P | ~(D ^ S));          \
-                break;                             \
-            case 0x36:                             \
-                out = S ^ (D | P);                 \
-                break;                             \
-            case 0x37:                             \
-                out = ~(S & (D | P));              \
-                break;                             \
-            case 0x38:                             \
-                out = P ^ (S & (D | P));           \
-                break;                             \
-            case 0x39:                             \
-                out = S ^ (P | ~D);                \
-                break;                             \
-            case 0x3a:                             \
-                out = S ^ (P | (D ^ S));           \
-                break;                             \
-            case 0x3b:                             \
-                out = ~(S & (P | ~D));             \
-                break;                             \
-            case 0x3c:                             \
-                out = P ^ S;                       \
-                break;                             \
-            case 0x3d:                             \
-                out = S ^ (P | ~(D | S));          \
-                break;                             \
-            case 0x3e:                             \
-                out = S ^ (P | (D & ~S));          \
-                break;                             \
-            case 0x3f:                             \
-                out = ~(P & S);                    \
-                break;                             \
-            case 0x40:                             \
-                out = P & (S & ~D);                \
-                break;                             \
-            case 0x41:                             \
-                out = ~(D | (P ^ S));              \
-                break;                             \
-            case 0x42:                             \
-                out = (S ^ D) & (P ^ D);           \
-                break;                             \
-            case 0x43:                             \
-                out = ~(S ^ (P & ~(D & S)));       \
-                break;                             \
-            case 0x44:                             \
-                out = S & ~D;                      \
-                break;                             \
-            case 0x45:                             \
-                out = ~(D | (P & ~S));             \
-                break;                             \
-            case 0x46:                             \
-                out = D ^ (S | (P & D));           \
-                break;                             \
-            case 0x47:                             \
-                out = ~(P ^ (S & (D ^ P)));        \
-                break;                             \
-            case 0x48:                             \
-                out = S & (D ^ P);                 \
-                break;                             \
-            case 0x49:                             \
-                out = ~(P ^ (D ^ (S | (P & D))));  \
-                break;                             \
-            case 0x4a:                             \
-                out = D ^ (P & (S | D));           \
-                break;                             \
-            case 0x4b:                             \
-                out = P ^ (D | ~S);                \
-                break;                             \
-            case 0x4c:                             \
-                out = S & ~(D & P);                \
-                break;                             \
-            case 0x4d:                             \
-                out = ~(S ^ ((S ^ P) | (D ^ S)));  \
-                break;                             \
-            case 0x4e:                             \
-                out = P ^ (D | (S ^ P));           \
-                break;                             \
-            case 0x4f:                             \
-                out = ~(P & (D | ~S));             \
-                break;                             \
-            case 0x50:                             \
-                out = P & ~D;                      \
-                break;                             \
-            case 0x51:                             \
-                out = ~(D | (S & ~P));             \
-                break;                             \
-            case 0x52:                             \
-                out = D ^ (P | (S & D));           \
-                break;                             \
-            case 0x53:                             \
-                out = ~(S ^ (P & (D ^ S)));        \
-                break;                             \
-            case 0x54:                             \
-                out = ~(D | ~(P | S));             \
-                break;                             \
-            case 0x55:                             \
-                out = ~D;                          \
-                break;                             \
-            case 0x56:                             \
-                out = D ^ (P | S);                 \
-                break;                             \
-            case 0x57:                             \
-                out = ~(D & (P | S));              \
-                break;                             \
-            case 0x58:                             \
-                out = P ^ (D & (S | P));           \
-                break;                             \
-            case 0x59:                             \
-                out = D ^ (P | ~S);                \
-                break;                             \
-            case 0x5a:                             \
-                out = D ^ P;                       \
-                break;                             \
-            case 0x5b:                             \
-                out = D ^ (P | ~(S | D));          \
-                break;                             \
-            case 0x5c:                             \
-                out = D ^ (P | (S ^ D));           \
-                break;                             \
-            case 0x5d:                             \
-                out = ~(D & (P | ~S));             \
-                break;                             \
-            case 0x5e:                             \
-                out = D ^ (P | (S & ~D));          \
-                break;                             \
-            case 0x5f:                             \
-                out = ~(D & P);                    \
-                break;                             \
-            case 0x60:                             \
-                out = P & (D ^ S);                 \
-                break;                             \
-            case 0x61:                             \
-                out = ~(D ^ (S ^ (P | (D & S))));  \
-                break;                             \
-            case 0x62:                             \
-                out = D ^ (S & (P | D));           \
-                break;                             \
-            case 0x63:                             \
-                out = S ^ (D | ~P);                \
-                break;                             \
-            case 0x64:                             \
-                out = S ^ (D & (P | S));           \
-                break;                             \
-            case 0x65:                             \
-                out = D ^ (S | ~P);                \
-                break;                             \
-            case 0x66:                             \
-                out = D ^ S;                       \
-                break;                             \
-            case 0x67:                             \
-                out = S ^ (D | ~(P | S));          \
-                break;                             \
-            case 0x68:                             \
-                out = ~(D ^ (S ^ (P | ~(D | S)))); \
-                break;                             \
-            case 0x69:                             \
-                out = ~(P ^ (D ^ S));              \
-                break;                             \
-            case 0x6a:                             \
-                out = D ^ (P & S);                 \
-                break;                             \
-            case 0x6b:                             \
-                out = ~(P ^ (S ^ (D & (P | S))));  \
-                break;                             \
-            case 0x6c:                             \
-                out = S ^ (D & P);                 \
-                break;                             \
-            case 0x6d:                             \
-                out = ~(P ^ (D ^ (S & (P | D))));  \
-                break;                             \
-            case 0x6e:                             \
-                out = S ^ (D & (P | ~S));          \
-                break;                             \
-            case 0x6f:                             \
-                out = ~(P & ~(D ^ S));             \
-                break;                             \
-            case 0x70:                             \
-                out = P & ~(D & S);                \
-                break;                             \
-            case 0x71:                             \
-                out = ~(S ^ ((S ^ D) & (P ^ D)));  \
-                break;                             \
-            case 0x72:                             \
-                out = S ^ (D | (P ^ S));           \
-                break;                             \
-            case 0x73:                             \
-                out = ~(S & (D | ~P));             \
-                break;                             \
-            case 0x74:                             \
-                out = D ^ (S | (P ^ D));           \
-                break;                             \
-            case 0x75:                             \
-                out = ~(D & (S | ~P));             \
-                break;                             \
-            case 0x76:                             \
-                out = S ^ (D | (P & ~S));          \
-                break;                             \
-            case 0x77:                             \
-                out = ~(D & S);                    \
-                break;                             \
-            case 0x78:                             \
-                out = P ^ (D & S);                 \
-                break;                             \
-            case 0x79:                             \
-                out = ~(D ^ (S ^ (P & (D | S))));  \
-                break;                             \
-            case 0x7a:                             \
-                out = D ^ (P & (S | ~D));          \
-                break;                             \
-            case 0x7b:                             \
-                out = ~(S & ~(D ^ P));             \
-                break;                             \
-            case 0x7c:                             \
-                out = S ^ (P & (D | ~S));          \
-                break;                             \
-            case 0x7d:                             \
-                out = ~(D & ~(P ^ S));             \
-                break;                             \
-            case 0x7e:                             \
-                out = (S ^ P) | (D ^ S);           \
-                break;                             \
-            case 0x7f:                             \
-                out = ~(D & (P & S));              \
-                break;                             \
-            case 0x80:                             \
-                out = D & (P & S);                 \
-                break;                             \
-            case 0x81:                             \
-                out = ~((S ^ P) | (D ^ S));        \
-                break;                             \
-            case 0x82:                             \
-                out = D & ~(P ^ S);                \
-                break;                             \
-            case 0x83:                             \
-                out = ~(S ^ (P & (D | ~S)));       \
-                break;                             \
-            case 0x84:                             \
-                out = S & ~(D ^ P);                \
-                break;                             \
-            case 0x85:                             \
-                out = ~(P ^ (D & (S | ~P)));       \
-                break;                             \
-            case 0x86:                             \
-                out = D ^ (S ^ (P & (D | S)));     \
-                break;                             \
-            case 0x87:                             \
-                out = ~(P ^ (D & S));              \
-                break;                             \
-            case 0x88:                             \
-                out = D & S;                       \
-                break;                             \
-            case 0x89:                             \
-                out = ~(S ^ (D | (P & ~S)));       \
-                break;                             \
-            case 0x8a:                             \
-                out = D & (S | ~P);                \
-                break;                             \
-            case 0x8b:                             \
-                out = ~(D ^ (S | (P ^ D)));        \
-                break;                             \
-            case 0x8c:                             \
-                out = S & (D | ~P);                \
-                break;                             \
-            case 0x8d:                             \
-                out = ~(S ^ (D | (P ^ S)));        \
-                break;                             \
-            case 0x8e:                             \
-                out = S ^ ((S ^ D) & (P ^ D));     \
-                break;                             \
-            case 0x8f:                             \
-                out = ~(P & ~(D & S));             \
-                break;                             \
-            case 0x90:                             \
-                out = P & ~(D ^ S);                \
-                break;                             \
-            case 0x91:                             \
-                out = ~(S ^ (D & (P | ~S)));       \
-                break;                             \
-            case 0x92:                             \
-                out = D ^ (P ^ (S & (D | P)));     \
-                break;                             \
-            case 0x93:                             \
-                out = ~(S ^ (P & D));              \
-                break;                             \
-            case 0x94:                             \
-                out = P ^ (S ^ (D & (P | S)));     \
-                break;                             \
-            case 0x95:                             \
-                out = ~(D ^ (P & S));              \
-                break;                             \
-            case 0x96:                             \
-                out = D ^ (P ^ S);                 \
-                break;                             \
-            case 0x97:                             \
-                out = P ^ (S ^ (D | ~(P | S)));    \
-                break;                             \
-            case 0x98:                             \
-                out = ~(S ^ (D | ~(P | S)));       \
-                break;                             \
-            case 0x99:                             \
-                out = ~(D ^ S);                    \
-                break;                             \
-            case 0x9a:                             \
-                out = D ^ (P & ~S);                \
-                break;                             \
-            case 0x9b:                             \
-                out = ~(S ^ (D & (P | S)));        \
-                break;                             \
-            case 0x9c:                             \
-                out = S ^ (P & ~D);                \
-                break;                             \
-            case 0x9d:                             \
-                out = ~(D ^ (S & (P | D)));        \
-                break;                             \
-            case 0x9e:                             \
-                out = D ^ (S ^ (P | (D & S)));     \
-                break;                             \
-            case 0x9f:                             \
-                out = ~(P & (D ^ S));              \
-                break;                             \
-            case 0xa0:                             \
-                out = D & P;                       \
-                break;                             \
-            case 0xa1:                             \
-                out = ~(P ^ (D | (S & ~P)));       \
-                break;                             \
-            case 0xa2:                             \
-                out = D & (P | ~S);                \
-                break;                             \
-            case 0xa3:                             \
-                out = ~(D ^ (P | (S ^ D)));        \
-                break;                             \
-            case 0xa4:                             \
-                out = ~(P ^ (D | ~(S | P)));       \
-                break;                             \
-            case 0xa5:                             \
-                out = ~(P ^ D);                    \
-                break;                             \
-            case 0xa6:                             \
-                out = D ^ (S & ~P);                \
-                break;                             \
-            case 0xa7:                             \
-                out = ~(P ^ (D & (S | P)));        \
-                break;                             \
-            case 0xa8:                             \
-                out = D & (P | S);                 \
-                break;                             \
-            case 0xa9:                             \
-                out = ~(D ^ (P | S));              \
-                break;                             \
-            case 0xaa:                             \
-                out = D;                           \
-                break;                             \
-            case 0xab:                             \
-                out = D | ~(P | S);                \
-                break;                             \
-            case 0xac:                             \
-                out = S ^ (P & (D ^ S));           \
-                break;                             \
-            case 0xad:                             \
-                out = ~(D ^ (P | (S & D)));        \
-                break;                             \
-            case 0xae:                             \
-                out = D | (S & ~P);                \
-                break;                             \
-            case 0xaf:                             \
-                out = D | ~P;                      \
-                break;                             \
-            case 0xb0:                             \
-                out = P & (D | ~S);                \
-                break;                             \
-            case 0xb1:                             \
-                out = ~(P ^ (D | (S ^ P)));        \
-                break;                             \
-            case 0xb2:                             \
-                out = S ^ ((S ^ P) | (D ^ S));     \
-                break;                             \
-            case 0xb3:                             \
-                out = ~(S & ~(D & P));             \
-                break;                             \
-            case 0xb4:                             \
-                out = P ^ (S & ~D);                \
-                break;                             \
-            case 0xb5:                             \
-                out = ~(D ^ (P & (S | D)));        \
-                break;                             \
-            case 0xb6:                             \
-                out = D ^ (P ^ (S | (D & P)));     \
-                break;                             \
-            case 0xb7:                             \
-                out = ~(S & (D ^ P));              \
-                break;                             \
-            case 0xb8:                             \
-                out = P ^ (S & (D ^ P));           \
-                break;                             \
-            case 0xb9:                             \
-                out = ~(D ^ (S | (P & D)));        \
-                break;                             \
-            case 0xba:                             \
-                out = D | (P & ~S);                \
-                break;                             \
-            case 0xbb:                             \
-                out = D | ~S;                      \
-                break;                             \
-            case 0xbc:                             \
-                out = S ^ (P & ~(D & S));          \
-                break;                             \
-            case 0xbd:                             \
-                out = ~((S ^ D) & (P ^ D));        \
-                break;                             \
-            case 0xbe:                             \
-                out = D | (P ^ S);                 \
-                break;                             \
-            case 0xbf:                             \
-                out = D | ~(P & S);                \
-                break;                             \
-            case 0xc0:                             \
-                out = P & S;                       \
-                break;                             \
-            case 0xc1:                             \
-                out = ~(S ^ (P | (D & ~S)));       \
-                break;                             \
-            case 0xc2:                             \
-                out = ~(S ^ (P | ~(D | S)));       \
-                break;                             \
-            case 0xc3:                             \
-                out = ~(P ^ S);                    \
-                break;                             \
-            case 0xc4:                             \
-                out = S & (P | ~D);                \
-                break;                             \
-            case 0xc5:                             \
-                out = ~(S ^ (P | (D ^ S)));        \
-                break;                             \
-            case 0xc6:                             \
-                out = S ^ (D & ~P);                \
-                break;                             \
-            case 0xc7:                             \
-                out = ~(P ^ (S & (D | P)));        \
-                break;                             \
-            case 0xc8:                             \
-                out = S & (D | P);                 \
-                break;                             \
-            case 0xc9:                             \
-                out = ~(S ^ (P | D));              \
-                break;                             \
-            case 0xca:                             \
-                out = D ^ (P & (S ^ D));           \
-                break;                             \
-            case 0xcb:                             \
-                out = ~(S ^ (P | (D & S)));        \
-                break;                             \
-            case 0xcc:                             \
-                out = S;                           \
-                break;                             \
-            case 0xcd:                             \
-                out = S | ~(D | P);                \
-                break;                             \
-            case 0xce:                             \
-                out = S | (D & ~P);                \
-                break;                             \
-            case 0xcf:                             \
-                out = S | ~P;                      \
-                break;                             \
-            case 0xd0:                             \
-                out = P & (S | ~D);                \
-                break;                             \
-            case 0xd1:                             \
-                out = ~(P ^ (S | (D ^ P)));        \
-                break;                             \
-            case 0xd2:                             \
-                out = P ^ (D & ~S);                \
-                break;                             \
-            case 0xd3:                             \
-                out = ~(S ^ (P & (D | S)));        \
-                break;                             \
-            case 0xd4:                             \
-                out = S ^ ((S ^ P) & (P ^ D));     \
-                break;                             \
-            case 0xd5:                             \
-                out = ~(D & ~(P & S));             \
-                break;                             \
-            case 0xd6:                             \
-                out = P ^ (S ^ (D | (P & S)));     \
-                break;                             \
-            case 0xd7:                             \
-                out = ~(D & (P ^ S));              \
-                break;                             \
-            case 0xd8:                             \
-                out = P ^ (D & (S ^ P));           \
-                break;                             \
-            case 0xd9:                             \
-                out = ~(S ^ (D | (P & S)));        \
-                break;                             \
-            case 0xda:                             \
-                out = D ^ (P & ~(S & D));          \
-                break;                             \
-            case 0xdb:                             \
-                out = ~((S ^ P) & (D ^ S));        \
-                break;                             \
-            case 0xdc:                             \
-                out = S | (P & ~D);                \
-                break;                             \
-            case 0xdd:                             \
-                out = S | ~D;                      \
-                break;                             \
-            case 0xde:                             \
-                out = S | (D ^ P);                 \
-                break;                             \
-            case 0xdf:                             \
-                out = S | ~(D & P);                \
-                break;                             \
-            case 0xe0:                             \
-                out = P & (D | S);                 \
-                break;                             \
-            case 0xe1:                             \
-                out = ~(P ^ (D | S));              \
-                break;                             \
-            case 0xe2:                             \
-                out = D ^ (S & (P ^ D));           \
-                break;                             \
-            case 0xe3:                             \
-                out = ~(P ^ (S | (D & P)));        \
-                break;                             \
-            case 0xe4:                             \
-                out = S ^ (D & (P ^ S));           \
-                break;                             \
-            case 0xe5:                             \
-                out = ~(P ^ (D | (S & P)));        \
-                break;                             \
-            case 0xe6:                             \
-                out = S ^ (D & ~(P & S));          \
-                break;                             \
-            case 0xe7:                             \
-                out = ~((S ^ P) & (P ^ D));        \
-                break;                             \
-            case 0xe8:                             \
-                out = S ^ ((S ^ P) & (D ^ S));     \
-                break;                             \
-            case 0xe9:                             \
-                out = ~(D ^ (S ^ (P & ~(D & S)))); \
-                break;                             \
-            case 0xea:                             \
-                out = D | (P & S);                 \
-                break;                             \
-            case 0xeb:                             \
-                out = D | ~(P ^ S);                \
-                break;                             \
-            case 0xec:                             \
-                out = S | (D & P);                 \
-                break;                             \
-            case 0xed:                             \
-                out = S | ~(D ^ P);                \
-                break;                             \
-            case 0xee:                             \
-                out = D | S;                       \
-                break;                             \
-            case 0xef:                             \
-                out = S | (D | ~P);                \
-                break;                             \
-            case 0xf0:                             \
-                out = P;                           \
-                break;                             \
-            case 0xf1:                             \
-                out = P | ~(D | S);                \
-                break;                             \
-            case 0xf2:                             \
-                out = P | (D & ~S);                \
-                break;                             \
-            case 0xf3:                             \
-                out = P | ~S;                      \
-                break;                             \
-            case 0xf4:                             \
-                out = P | (S & ~D);                \
-                break;                             \
-            case 0xf5:                             \
-                out = P | ~D;                      \
-                break;                             \
-            case 0xf6:                             \
-                out = P | (D ^ S);                 \
-                break;                             \
-            case 0xf7:                             \
-                out = P | ~(D & S);                \
-                break;                             \
-            case 0xf8:                             \
-                out = P | (D & S);                 \
-                break;                             \
-            case 0xf9:                             \
-                out = P | ~(D ^ S);                \
-                break;                             \
-            case 0xfa:                             \
-                out = D | P;                       \
-                break;                             \
-            case 0xfb:                             \
-                out = D | (P | ~S);                \
-                break;                             \
-            case 0xfc:                             \
-                out = P | S;                       \
-                break;                             \
-            case 0xfd:                             \
-                out = P | (S | ~D);                \
-                break;                             \
-            case 0xfe:                             \
-                out = D | (P | S);                 \
-                break;                             \
-            case 0xff:                             \
-                out = ~0;                          \
-                break;                             \
-        }                                          \
-    }
-
 #define ROPMIX                                                                   \
     {                                                                            \
         old_dest_dat = dest_dat;                                                 \
-        ROPMIX_READ(dest_dat, pat_dat, src_dat);                                 \
+        out          = video_rop3(rop, dest_dat, pat_dat, src_dat);              \
     }
 
 #define WRITE(addr, dat)                                                                                                   \
@@ -8326,6 +7553,434 @@ s3_short_stroke_start(s3_t *s3, uint8_t ssv)
     s3->accel_start(-1, 0, -1, 0, s3);
 }
 
+/*Specialized kernels for the common GDI operations. They take over from the
+  generic per-pixel loops in s3_accel_start() only when the result is identical:
+  linear (packed) VRAM addressing, 8/16/32bpp, no color compare, no inverted
+  clipping and none of the 911/924 15/16bpp workarounds. Anything else returns 0
+  and falls through to the generic code.*/
+static int
+s3_accel_fast_eligible(s3_t *s3)
+{
+    const svga_t *svga = &s3->svga;
+
+    if (!svga->packed_chain4 && !svga->force_old_addr)
+        return 0;
+    if ((s3->bpp == 2) || (svga->bpp == 24) || ((s3->bpp == 0) && s3->color_16bit))
+        return 0;
+    if ((s3->accel.multifunc[0xe] & 0x120) || !(s3->accel.cmd & 0x10))
+        return 0;
+    if (s3->accel.rd_mask_16bit_check || s3->accel.minus)
+        return 0;
+
+    return 1;
+}
+
+static __inline int
+s3_accel_fast_shift(s3_t *s3)
+{
+    return (s3->bpp == 0) ? 0 : ((s3->bpp == 1) ? 1 : 2);
+}
+
+/*Reduce a foreground/background mix to dest = (dest & and_mask) ^ xor_val,
+  returns 0 for the mixes that depend on source and destination in other ways.*/
+static int
+s3_accel_fast_mix(int mix, uint32_t src, uint32_t wrt_mask, uint32_t *and_mask, uint32_t *xor_val)
+{
+    switch (mix) {
+        case 0x0: /*NOT D*/
+            *and_mask = 0xffffffff;
+            *xor_val  = wrt_mask;
+            break;
+        case 0x1: /*0*/
+            *and_mask = ~wrt_mask;
+            *xor_val  = 0;
+            break;
+        case 0x2: /*1*/
+            *and_mask = ~wrt_mask;
+            *xor_val  = wrt_mask;
+            break;
+        case 0x3: /*D*/
+            *and_mask = 0xffffffff;
+            *xor_val  = 0;
+            break;
+        case 0x4: /*NOT S*/
+            *and_mask = ~wrt_mask;
+            *xor_val  = ~src & wrt_mask;
+            break;
+        case 0x5: /*S XOR D*/
+            *and_mask = 0xffffffff;
+            *xor_val  = src & wrt_mask;
+            break;
+        case 0x6: /*NOT (S XOR D)*/
+            *and_mask = 0xffffffff;
+            *xor_val  = ~src & wrt_mask;
+            break;
+        case 0x7: /*S*/
+            *and_mask = ~wrt_mask;
+            *xor_val  = src & wrt_mask;
+            break;
+
+        default:
+            return 0;
+    }
+
+    return 1;
+}
+
+static __inline int
+s3_accel_fast_src(int sel, uint32_t frgd_color, uint32_t bkgd_color, uint32_t *src)
+{
+    switch (sel) {
+        case 0:
+            *src = bkgd_color;
+            break;
+        case 1:
+            *src = frgd_color;
+            break;
+        case 3:
+            *src = 0;
+            break;
+
+        default: /*CPU data*/
+            return 0;
+    }
+
+    return 1;
+}
+
+static void
+s3_accel_fast_changed(svga_t *svga, uint32_t addr, uint32_t len)
+{
+    for (uint32_t page = addr >> 12; page <= ((addr + len - 1) >> 12); page++)
+        svga->changedvram[page] = svga->monitor->mon_changeframecount;
+}
+
+static void
+s3_accel_fast_row(s3_t *s3, int shift, uint32_t addr, int w, uint32_t and_mask, uint32_t xor_val)
+{
+    svga_t *svga = &s3->svga;
+
+    video_blit_logic_row(8 << shift, &svga->vram[addr << shift], and_mask, xor_val, w);
+    s3_accel_fast_changed(svga, addr << shift, w << shift);
+}
+
+/*Clip the span [start, start + len) walked in the given direction against
+  [lo, hi]. Returns 0 if the span wraps around the 12-bit coordinate space.*/
+static int
+s3_accel_fast_span(int start, int len, int inc, int lo, int hi, int *first, int *last)
+{
+    int s = inc ? start : (start - len + 1);
+    int e = inc ? (start + len - 1) : start;
+
+    if ((s < 0) || (e > 0xfff))
+        return 0;
+
+    *first = MAX(s, lo);
+    *last  = MIN(e, hi);
+    return 1;
+}
+
+/*Solid rectangle fill (command 2) without CPU data.*/
+static int
+s3_accel_fast_fill(s3_t *s3, uint32_t dstbase)
+{
+    int      shift = s3_accel_fast_shift(s3);
+    int      w     = (s3->accel.maj_axis_pcnt & 0xfff) + 1;
+    int      h     = (s3->accel.multifunc[0] & 0xfff) + 1;
+    int      x0;
+    int      x1;
+    int      y0;
+    int      y1;
+    uint32_t src;
+    uint32_t and_mask;
+    uint32_t xor_val;
+
+    if (!s3_accel_fast_eligible(s3))
+        return 0;
+    if (!s3_accel_fast_src((s3->accel.frgd_mix >> 5) & 3, s3->accel.frgd_color, s3->accel.bkgd_color, &src))
+        return 0;
+    if (!s3_accel_fast_mix(s3->accel.frgd_mix & 0xf, src, s3->accel.wrt_mask, &and_mask, &xor_val))
+        return 0;
+    if (!s3_accel_fast_span(s3->accel.cx, w, s3->accel.cmd & 0x20, s3->accel.multifunc[2] & 0xfff, s3->accel.multifunc[4] & 0xfff, &x0, &x1) ||
+        !s3_accel_fast_span(s3->accel.cy, h, s3->accel.cmd & 0x80, s3->accel.multifunc[1] & 0xfff, s3->accel.multifunc[3] & 0xfff, &y0, &y1))
+        return 0;
+
+    if ((x0 <= x1) && (y0 <= y1)) {
+        if ((dstbase + (y1 * s3->width) + x1) > (s3->vram_mask >> shift))
+            return 0;
+
+        if ((and_mask != 0xffffffff) || xor_val) {
+            for (int y = y0; y <= y1; y++)
+                s3_accel_fast_row(s3, shift, dstbase + (y * s3->width) + x0, x1 - x0 + 1, and_mask, xor_val);
+        }
+    }
+
+    /*Leave the engine in the same state as the generic loop does.*/
+    s3->accel.sx = s3->accel.maj_axis_pcnt & 0xfff;
+    if (s3->accel.cmd & 0x80)
+        s3->accel.cy += h;
+    else
+        s3->accel.cy -= h;
+    s3->accel.cy &= 0xfff;
+    s3->accel.sy    = -1;
+    s3->accel.dest  = dstbase + s3->accel.cy * s3->width;
+    s3->accel.cur_x = s3->accel.cx;
+    s3->accel.cur_y = s3->accel.cy;
+    return 1;
+}
+
+/*Rectangle fill (command 2) with the mix taken from monochrome CPU data and
+  both sources being color registers, as used for text and mono bitmaps.*/
+static int
+s3_accel_fast_mono(s3_t *s3, int count, uint32_t mix_dat, uint32_t mix_mask, uint32_t dstbase)
+{
+    svga_t   *svga   = &s3->svga;
+    int       shift  = s3_accel_fast_shift(s3);
+    uint32_t  amask  = s3->vram_mask >> shift;
+    int       clip_t = s3->accel.multifunc[1] & 0xfff;
+    int       clip_l = s3->accel.multifunc[2] & 0xfff;
+    int       clip_b = s3->accel.multifunc[3] & 0xfff;
+    int       clip_r = s3->accel.multifunc[4] & 0xfff;
+    uint32_t  src[2];
+    uint32_t  and_mask[2];
+    uint32_t  xor_val[2];
+    uint32_t  addr;
+
+    if (!s3_accel_fast_eligible(s3) || s3->accel.b2e8_pix || !s3_cpu_src(s3) || s3_cpu_dest(s3))
+        return 0;
+    if (!s3_accel_fast_src((s3->accel.bkgd_mix >> 5) & 3, s3->accel.frgd_color, s3->accel.bkgd_color, &src[0]) ||
+        !s3_accel_fast_src((s3->accel.frgd_mix >> 5) & 3, s3->accel.frgd_color, s3->accel.bkgd_color, &src[1]))
+        return 0;
+    if (!s3_accel_fast_mix(s3->accel.bkgd_mix & 0xf, src[0], s3->accel.wrt_mask, &and_mask[0], &xor_val[0]) ||
+        !s3_accel_fast_mix(s3->accel.frgd_mix & 0xf, src[1], s3->accel.wrt_mask, &and_mask[1], &xor_val[1]))
+        return 0;
+
+    while (count-- && (s3->accel.sy >= 0)) {
+        int m = !!(mix_dat & mix_mask);
+
+        if ((s3->accel.cx >= clip_l) && (s3->accel.cx <= clip_r) && (s3->accel.cy >= clip_t) && (s3->accel.cy <= clip_b) &&
+            ((and_mask[m] != 0xffffffff) || xor_val[m])) {
+            addr = (s3->accel.dest + s3->accel.cx) & amask;
+            switch (shift) {
+                case 0:
+                    svga->vram[addr] = (svga->vram[addr] & and_mask[m]) ^ xor_val[m];
+                    break;
+                case 1:
+                    ((uint16_t *) svga->vram)[addr] = (((uint16_t *) svga->vram)[addr] & and_mask[m]) ^ xor_val[m];
+                    break;
+                default:
+                    ((uint32_t *) svga->vram)[addr] = (((uint32_t *) svga->vram)[addr] & and_mask[m]) ^ xor_val[m];
+                    break;
+            }
+            svga->changedvram[(addr << shift) >> 12] = svga->monitor->mon_changeframecount;
+        }
+
+        mix_dat <<= 1;
+        mix_dat |= 1;
+
+        if (s3->accel.cmd & 0x20)
+            s3->accel.cx++;
+        else
+            s3->accel.cx--;
+
+        s3->accel.cx &= 0xfff;
+        s3->accel.sx--;
+        if (s3->accel.sx < 0) {
+            s3->accel.sx = s3->accel.maj_axis_pcnt & 0xfff;
+
+            if (s3->accel.cmd & 0x20)
+                s3->accel.cx -= (s3->accel.sx + 1);
+            else
+                s3->accel.cx += (s3->accel.sx + 1);
+
+            if (s3->accel.cmd & 0x80)
+                s3->accel.cy++;
+            else
+                s3->accel.cy--;
+
+            s3->accel.cy &= 0xfff;
+            s3->accel.dest = dstbase + s3->accel.cy * s3->width;
+            s3->accel.sy--;
+            /*The rest of the CPU word is discarded at the end of a line.*/
+            break;
+        }
+    }
+
+    return 1;
+}
+
+/*The 16 source/destination mixes as ternary ROPs, for the shared row kernels.*/
+static const uint8_t s3_mix_rop[16] = {
+    0x55, 0x00, 0xff, 0xaa, 0x33, 0x66, 0x99, 0xcc,
+    0x77, 0xbb, 0xdd, 0xee, 0x88, 0x44, 0x22, 0x11
+};
+
+/*Screen to screen BitBLT (command 6) with a plain foreground mix.*/
+static int
+s3_accel_fast_blit(s3_t *s3, uint32_t srcbase, uint32_t dstbase)
+{
+    svga_t   *svga  = &s3->svga;
+    int       shift = s3_accel_fast_shift(s3);
+    int       w     = (s3->accel.maj_axis_pcnt & 0xfff) + 1;
+    int       h     = (s3->accel.multifunc[0] & 0xfff) + 1;
+    int       xinc  = s3->accel.cmd & 0x20;
+    int       yinc  = s3->accel.cmd & 0x80;
+    uint32_t  pix_mask;
+    int       x0;
+    int       x1;
+    int       y0;
+    int       y1;
+    int       sx0;
+    int       sx1;
+    int       sy0;
+    int       sy1;
+    int       n;
+
+    if (!s3_accel_fast_eligible(s3) || ((s3->accel.multifunc[0xa] & 0xc0) == 0xc0))
+        return 0;
+    if (((s3->accel.frgd_mix >> 5) & 3) != 3)
+        return 0;
+
+    pix_mask = (shift == 0) ? 0xff : ((shift == 1) ? 0xffff : 0xffffffff);
+    if ((s3->accel.wrt_mask & pix_mask) != pix_mask)
+        return 0;
+
+    if (!s3_accel_fast_span(s3->accel.dx, w, xinc, s3->accel.multifunc[2] & 0xfff, s3->accel.multifunc[4] & 0xfff, &x0, &x1) ||
+        !s3_accel_fast_span(s3->accel.dy, h, yinc, s3->accel.multifunc[1] & 0xfff, s3->accel.multifunc[3] & 0xfff, &y0, &y1) ||
+        !s3_accel_fast_span(s3->accel.cx, w, xinc, 0, 0xfff, &sx0, &sx1) ||
+        !s3_accel_fast_span(s3->accel.cy, h, yinc, 0, 0xfff, &sy0, &sy1))
+        return 0;
+    /*The generic loop wraps the destination X after the last pixel of each
+      row before stepping it back, so a row ending on the 12-bit boundary
+      leaves X off by 4096 for the rows after it and for DESTX read back.*/
+    if (xinc ? ((s3->accel.dx + w) > 0xfff) : ((s3->accel.dx - w) < 0))
+        return 0;
+
+    n = x1 - x0 + 1;
+    if ((x0 <= x1) && (y0 <= y1)) {
+        uint32_t sx = x0 + (s3->accel.cx - s3->accel.dx);
+        uint32_t sy = y0 + (s3->accel.cy - s3->accel.dy);
+
+        if (((dstbase + (y1 * s3->width) + x1) > (s3->vram_mask >> shift)) ||
+            ((srcbase + ((sy + y1 - y0) * s3->width) + sx + n - 1) > (s3->vram_mask >> shift)))
+            return 0;
+
+        for (int i = 0; i <= (y1 - y0); i++) {
+            int      y = yinc ? (y0 + i) : (y1 - i);
+            uint32_t d = dstbase + (y * s3->width) + x0;
+            uint32_t s = srcbase + ((sy + y - y0) * s3->width) + sx;
+
+            video_blit_rop_row(s3_mix_rop[s3->accel.frgd_mix & 0xf], 8 << shift, &svga->vram[d << shift], &svga->vram[s << shift], 0, n, !xinc);
+            s3_accel_fast_changed(svga, d << shift, n << shift);
+        }
+    }
+
+    /*Leave the engine in the same state as the generic loop does: X is back
+      where it started on both sides, Y has moved by the height.*/
+    s3->accel.sx = s3->accel.maj_axis_pcnt & 0xfff;
+    if (yinc) {
+        s3->accel.cy += h;
+        s3->accel.dy += h;
+    } else {
+        s3->accel.cy -= h;
+        s3->accel.dy -= h;
+    }
+    s3->accel.sy          = -1;
+    s3->accel.src         = srcbase + s3->accel.cy * s3->width;
+    s3->accel.dest        = dstbase + s3->accel.dy * s3->width;
+    s3->accel.destx_distp = s3->accel.dx;
+    s3->accel.desty_axstp = s3->accel.dy;
+    return 1;
+}
+
+#ifndef RELEASE_BUILD
+static uint32_t
+s3_mix_check_get(const uint8_t *buf, int shift, int x)
+{
+    switch (shift) {
+        case 0:
+            return buf[x];
+        case 1:
+            return ((const uint16_t *) buf)[x];
+        default:
+            return ((const uint32_t *) buf)[x];
+    }
+}
+
+static void
+s3_mix_check_set(uint8_t *buf, int shift, int x, uint32_t val)
+{
+    switch (shift) {
+        case 0:
+            buf[x] = val;
+            break;
+        case 1:
+            ((uint16_t *) buf)[x] = val;
+            break;
+        default:
+            ((uint32_t *) buf)[x] = val;
+            break;
+    }
+}
+
+/*Check the shared row kernels against MIX_READ for every foreground mix,
+  pixel size and walk direction, including overlapping runs.*/
+static void
+s3_mix_rop_check(s3_t *s3)
+{
+    static const int offsets[3][2] = { { 0, 4 }, { 4, 0 }, { 0, 40 } };
+    uint16_t         frgd_mix      = s3->accel.frgd_mix;
+    uint32_t         mix_dat       = 1;
+    uint32_t         mix_mask      = 1;
+    uint32_t         seed          = 0x12345678;
+    uint32_t         src_dat;
+    uint32_t         dest_dat;
+    uint32_t         pix_mask;
+    uint32_t         buf32[80];
+    uint32_t         ref32[80];
+    uint8_t         *buf           = (uint8_t *) buf32;
+    uint8_t         *ref           = (uint8_t *) ref32;
+
+    for (int mix = 0; mix < 16; mix++) {
+        s3->accel.frgd_mix = mix;
+        for (int shift = 0; shift < 3; shift++) {
+            pix_mask = (shift == 2) ? 0xffffffff : ((1 << (8 << shift)) - 1);
+            for (int o = 0; o < 3; o++) {
+                for (int backwards = 0; backwards < 2; backwards++) {
+                    int dx = offsets[o][0];
+                    int sx = offsets[o][1];
+
+                    for (int i = 0; i < 80; i++) {
+                        seed     = seed * 1103515245 + 12345;
+                        buf32[i] = (seed >> 16) | (seed << 16);
+                    }
+                    memcpy(ref32, buf32, sizeof(ref32));
+
+                    video_blit_rop_row(s3_mix_rop[mix], 8 << shift, buf + (dx << shift), buf + (sx << shift), 0, 40, backwards);
+
+                    for (int n = 0; n < 40; n++) {
+                        int x = backwards ? (39 - n) : n;
+
+                        src_dat  = s3_mix_check_get(ref, shift, sx + x);
+                        dest_dat = s3_mix_check_get(ref, shift, dx + x);
+                        MIX_READ
+                        s3_mix_check_set(ref, shift, dx + x, dest_dat & pix_mask);
+                    }
+
+                    for (int x = 0; x < 80; x++) {
+                        if (s3_mix_check_get(buf, shift, x) != s3_mix_check_get(ref, shift, x))
+                            fatal("S3: row kernel for mix %x (ROP %02x, %i bpp, %s) differs at pixel %i\n",
+                                  mix, s3_mix_rop[mix], 8 << shift, backwards ? "backwards" : "forwards", x);
+                    }
+                }
+            }
+        }
+    }
+
+    s3->accel.frgd_mix = frgd_mix;
+}
+#endif
+
 void
 s3_accel_start(int count, int cpu_input, uint32_t mix_dat, uint32_t cpu_dat, void *priv)
 {
@@ -9264,6 +8919,9 @@ s3_accel_start(int count, int cpu_input, uint32_t mix_dat, uint32_t cpu_dat, voi
 
             s3_log("CMDFULL=%04x, FRGDSEL=%x, BKGDSEL=%x, FRGDMIX=%02x, BKGDMIX=%02x, MASKCHECK=%x, RDMASK=%04x, MINUS=%d, WRTMASK=%04X, MIX=%04x, CX=%d, CY=%d, DX=%d, DY=%d, SX=%d, SY=%d, PIXCNTL=%02x, 16BITCOLOR=%x, RDCHECK=%x, CLIPL=%d, CLIPR=%d, OVERFLOW=%d, pitch=%d.\n", s3->accel.cmd, frgd_mix, bkgd_mix, s3->accel.frgd_mix & 0x0f, s3->accel.bkgd_mix & 0x0f, s3->accel.rd_mask_16bit_check, rd_mask, s3->accel.minus, wrt_mask, mix_dat & 0xffff, s3->accel.cx, s3->accel.cy, s3->accel.dx, s3->accel.dy, s3->accel.sx, s3->accel.sy, s3->accel.multifunc[0x0a] & 0xc4, s3->accel.color_16bit_check, s3->accel.rd_mask_16bit_check, clip_l, clip_r, (s3->accel.destx_overflow & 0xc00) == 0xc00, s3->width);
 
+            if (cpu_input ? s3_accel_fast_mono(s3, count, mix_dat, mix_mask, dstbase) : s3_accel_fast_fill(s3, dstbase))
+                return;
+
             if ((s3->bpp == 2) || (svga->bpp == 24)) {
                 int multiplier = 1;
                 if (s3->bpp == 2) {
@@ -9899,6 +9557,9 @@ s3_accel_start(int count, int cpu_input, uint32_t mix_dat, uint32_t cpu_dat, voi
                 break;
             }
 
+            if (!cpu_input && s3_accel_fast_blit(s3, srcbase, dstbase))
+                return;
+
             if (!cpu_input && (frgd_mix == 3) && !vram_mask && !(s3->accel.multifunc[0xe] & 0x100) && ((s3->accel.cmd & 0xa0) == 0xa0) && ((s3->accel.frgd_mix & 0xf) == 7) && ((s3->accel.bkgd_mix & 0xf) == 7)) {
                 s3_log("Special BitBLT.\n");
                 while (1) {
@@ -12255,6 +11916,10 @@ s3_init(const device_t *info)
     s3->accel.multifunc[0xd] = 0xd000;
     s3->accel.multifunc[0xe] = 0xe000;
 
+#ifndef RELEASE_BUILD
+    s3_mix_rop_check(s3);
+#endif
+
     s3->wake_fifo_thread    = thread_create_event();
     s3->fifo_not_full_event = thread_create_event();
     s3->fifo_thread_run     = 1;
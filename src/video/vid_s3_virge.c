@@ -39,6 +39,7 @@
 #include <86box/vid_ddc.h>
 #include <86box/vid_xga.h>
 #include <86box/vid_svga.h>
+#include <86box/vid_blit.h>
 #include <86box/vid_svga_render.h>
 
 #ifdef MIN
@@ -75,9 +76,16 @@ static int dither[4][4] = {
 #define RB_SIZE 256
 #define RB_MASK (RB_SIZE - 1)
 
-#define RB_ENTRIES (virge->s3d_write_idx - virge->s3d_read_idx)
-#define RB_FULL (RB_ENTRIES == RB_SIZE)
-#define RB_EMPTY (!RB_ENTRIES)
+#define RB_ENTRIES(n) (virge->s3d_write_idx - virge->s3d_read_idx[n])
+#define RB_FULL(n) (RB_ENTRIES(n) == RB_SIZE)
+#define RB_EMPTY(n) (!RB_ENTRIES(n))
+
+#define S3D_MAX_THREADS 4
+
+#define TEX_CACHE_MAX   32
+#define TEX_DIRTY_SHIFT 10
+/* Decoded mip levels are stored smallest first, level c starts after the 4^0..4^(c-1) texels of the smaller ones. */
+#define TEX_LEVEL_OFFSET(c) (((1 << ((c) * 2)) - 1) / 3)
 
 #define FIFO_SIZE 65536
 #define FIFO_MASK (FIFO_SIZE - 1)
@@ -187,8 +195,27 @@ typedef struct s3d_t {
     uint8_t fog_r;
     uint8_t fog_g;
     uint8_t fog_b;
+
+    int tex_entry; /* Texture cache entry used by the render threads, -1 if untextured. */
 } s3d_t;
 
+/* Textures decoded to ARGB8888, keyed by base address, format and mip depth.
+   Entries are looked up on the FIFO thread when a triangle is queued and stay
+   in use until every render thread has bumped refcount_r past it. */
+typedef struct s3d_tex_cache_t {
+    int       valid;
+    uint32_t  base;
+    int       format;
+    int       max_d;
+    uint32_t  addr_start;
+    uint32_t  addr_end;
+    uint32_t *data;
+    int       data_size;
+
+    int        refcount;
+    ATOMIC_INT refcount_r[S3D_MAX_THREADS];
+} s3d_tex_cache_t;
+
 typedef struct virge_t {
     mem_mapping_t linear_mapping;
     mem_mapping_t mmio_mapping;
@@ -219,13 +246,26 @@ typedef struct virge_t {
     int dithering_enabled;
     int memory_size;
 
-    int pixel_count;
+    int pixel_count[S3D_MAX_THREADS];
     int tri_count;
 
-    thread_t *render_thread;
-    event_t  *wake_render_thread;
+    int render_threads;
+    int odd_even_mask;
+
+    thread_t *render_thread[S3D_MAX_THREADS];
+    event_t  *wake_render_thread[S3D_MAX_THREADS];
     event_t  *wake_main_thread;
     event_t  *not_full_event;
+    mutex_t  *s3d_idle_mutex;
+
+    s3d_tex_cache_t *tex_cache;
+    uint8_t         *tex_present;
+    uint8_t         *tex_present_new; /* Scratch map, see s3_virge_tex_update_present(). */
+    mutex_t         *tex_mutex;
+    ATOMIC_INT       tex_cached;
+    int              tex_last_removed;
+    uint32_t         tex_render_start; /* VRAM written by the triangles queued since the render threads were last idle. */
+    uint32_t         tex_render_end;
 
     uint32_t hwc_fg_col;
     uint32_t hwc_bg_col;
@@ -291,9 +331,9 @@ typedef struct virge_t {
     s3d_t s3d_tri;
 
     s3d_t      s3d_buffer[RB_SIZE];
-    ATOMIC_INT s3d_read_idx;
+    ATOMIC_INT s3d_read_idx[S3D_MAX_THREADS];
     ATOMIC_INT s3d_write_idx;
-    ATOMIC_INT s3d_busy;
+    ATOMIC_INT s3d_busy[S3D_MAX_THREADS];
 
     struct {
         uint32_t pri_ctrl;
@@ -400,6 +440,8 @@ static video_timings_t timing_virge_dx_pci               = { .type = VIDEO_PCI,
 static video_timings_t timing_virge_agp                  = { .type = VIDEO_AGP, .write_b = 2, .write_w = 2, .write_l = 3, .read_b = 28, .read_w = 28, .read_l = 45 };
 
 static void queue_triangle(virge_t *virge);
+static void s3_virge_tex_dirty(virge_t *virge, uint32_t addr, uint32_t len);
+static void s3_virge_tex_flush_all(virge_t *virge);
 
 static void s3_virge_recalctimings(svga_t *svga);
 static void s3_virge_updatemapping(virge_t *virge);
@@ -1177,6 +1219,152 @@ s3_virge_vblank_start(svga_t *svga)
     s3_virge_update_irqs(virge);
 }
 
+static int
+s3_virge_s3d_busy(virge_t *virge)
+{
+    for (int c = 0; c < virge->render_threads; c++) {
+        if (virge->s3d_busy[c] || !RB_EMPTY(c))
+            return 1;
+    }
+
+    return 0;
+}
+
+/* The render threads write VRAM on their own, so a read through the linear
+   aperture has to wait for every queued triangle to land first. */
+static void
+s3_virge_wait_for_render_finished(virge_t *virge)
+{
+    while (s3_virge_s3d_busy(virge)) {
+        for (int c = 0; c < virge->render_threads; c++) {
+            if (!virge->s3d_busy[c] && !RB_EMPTY(c))
+                thread_set_event(virge->wake_render_thread[c]);
+        }
+        thread_wait_event(virge->wake_main_thread, 1);
+        thread_reset_event(virge->wake_main_thread);
+    }
+}
+
+static uint8_t
+s3_virge_read_linear(uint32_t addr, void *priv)
+{
+    const svga_t *svga  = (svga_t *) priv;
+    virge_t      *virge = (virge_t *) svga->priv;
+
+    if (s3_virge_s3d_busy(virge))
+        s3_virge_wait_for_render_finished(virge);
+
+    return svga_read_linear(addr, priv);
+}
+
+static uint16_t
+s3_virge_readw_linear(uint32_t addr, void *priv)
+{
+    const svga_t *svga  = (svga_t *) priv;
+    virge_t      *virge = (virge_t *) svga->priv;
+
+    if (s3_virge_s3d_busy(virge))
+        s3_virge_wait_for_render_finished(virge);
+
+    return svga_readw_linear(addr, priv);
+}
+
+static uint32_t
+s3_virge_readl_linear(uint32_t addr, void *priv)
+{
+    const svga_t *svga  = (svga_t *) priv;
+    virge_t      *virge = (virge_t *) svga->priv;
+
+    if (s3_virge_s3d_busy(virge))
+        s3_virge_wait_for_render_finished(virge);
+
+    return svga_readl_linear(addr, priv);
+}
+
+/* Writes through either aperture have to drop the decoded copies of any texture they hit. */
+static void
+s3_virge_tex_write_linear(virge_t *virge, uint32_t addr, uint32_t len)
+{
+    const svga_t *svga = &virge->svga;
+
+    /* Pairs with the fence in s3_virge_tex_lookup(): either the decode sees
+       this write, or this sees the entry counted and its pages marked. */
+    atomic_thread_fence(memory_order_seq_cst);
+    if (!virge->tex_cached)
+        return;
+
+    if (svga->fast)
+        s3_virge_tex_dirty(virge, addr & svga->decode_mask, len);
+    else
+        s3_virge_tex_flush_all(virge);
+}
+
+static void
+s3_virge_write_linear(uint32_t addr, uint8_t val, void *priv)
+{
+    svga_t *svga = (svga_t *) priv;
+
+    svga_write_linear(addr, val, priv);
+    s3_virge_tex_write_linear((virge_t *) svga->priv, addr, 1);
+}
+
+static void
+s3_virge_writew_linear(uint32_t addr, uint16_t val, void *priv)
+{
+    svga_t *svga = (svga_t *) priv;
+
+    svga_writew_linear(addr, val, priv);
+    s3_virge_tex_write_linear((virge_t *) svga->priv, addr, 2);
+}
+
+static void
+s3_virge_writel_linear(uint32_t addr, uint32_t val, void *priv)
+{
+    svga_t *svga = (svga_t *) priv;
+
+    svga_writel_linear(addr, val, priv);
+    s3_virge_tex_write_linear((virge_t *) svga->priv, addr, 4);
+}
+
+/* Banked addresses go through the VGA planar logic, so just flush everything. */
+static void
+s3_virge_tex_write_banked(virge_t *virge)
+{
+    atomic_thread_fence(memory_order_seq_cst);
+    if (virge->tex_cached)
+        s3_virge_tex_flush_all(virge);
+}
+
+static void
+s3_virge_write(uint32_t addr, uint8_t val, void *priv)
+{
+    svga_t  *svga  = (svga_t *) priv;
+    virge_t *virge = (virge_t *) svga->priv;
+
+    svga_write(addr, val, priv);
+    s3_virge_tex_write_banked(virge);
+}
+
+static void
+s3_virge_writew(uint32_t addr, uint16_t val, void *priv)
+{
+    svga_t  *svga  = (svga_t *) priv;
+    virge_t *virge = (virge_t *) svga->priv;
+
+    svga_writew(addr, val, priv);
+    s3_virge_tex_write_banked(virge);
+}
+
+static void
+s3_virge_writel(uint32_t addr, uint32_t val, void *priv)
+{
+    svga_t  *svga  = (svga_t *) priv;
+    virge_t *virge = (virge_t *) svga->priv;
+
+    svga_writel(addr, val, priv);
+    s3_virge_tex_write_banked(virge);
+}
+
 static void
 s3_virge_wait_fifo_idle(virge_t *virge)
 {
@@ -1204,7 +1392,7 @@ s3_virge_mmio_read(uint32_t addr, void *priv)
             return ret;
         case 0x8505:
             ret = 0xc0;
-            if (virge->s3d_busy || virge->virge_busy || !FIFO_EMPTY)
+            if (s3_virge_s3d_busy(virge) || virge->virge_busy || !FIFO_EMPTY)
                 ret |= 0x10;
             else
                 ret |= 0x30;
@@ -1252,7 +1440,7 @@ s3_virge_mmio_read_w(uint32_t addr, void *priv)
     switch (addr & 0xfffe) {
         case 0x8504:
             ret = 0xc000;
-            if (virge->s3d_busy || virge->virge_busy || !FIFO_EMPTY)
+            if (s3_virge_s3d_busy(virge) || virge->virge_busy || !FIFO_EMPTY)
                 ret |= 0x1000;
             else
                 ret |= 0x3000;
@@ -1355,7 +1543,7 @@ s3_virge_mmio_read_l(uint32_t addr, void *priv)
 
         case 0x8504:
             ret = 0x0000c000;
-            if (virge->s3d_busy || virge->virge_busy || !FIFO_EMPTY)
+            if (s3_virge_s3d_busy(virge) || virge->virge_busy || !FIFO_EMPTY)
                 ret |= 0x00001000;
             else
                 ret |= 0x00003000;
@@ -2254,784 +2442,10 @@ s3_virge_mmio_write_l(uint32_t addr, uint32_t val, void *priv)
             }                                       \
     } while (0)
 
-#define ROPMIX(R, D, P, S, out)                    \
-    {                                              \
-        switch (R) {                               \
-            case 0x00:                             \
-                out = 0;                           \
-                break;                             \
-            case 0x01:                             \
-                out = ~(D | (P | S));              \
-                break;                             \
-            case 0x02:                             \
-                out = D & ~(P | S);                \
-                break;                             \
-            case 0x03:                             \
-                out = ~(P | S);                    \
-                break;                             \
-            case 0x04:                             \
-                out = S & ~(D | P);                \
-                break;                             \
-            case 0x05:                             \
-                out = ~(D | P);                    \
-                break;                             \
-            case 0x06:                             \
-                out = ~(P | ~(D ^ S));             \
-                break;                             \
-            case 0x07:                             \
-                out = ~(P | (D & S));              \
-                break;                             \
-            case 0x08:                             \
-                out = S & (D & ~P);                \
-                break;                             \
-            case 0x09:                             \
-                out = ~(P | (D ^ S));              \
-                break;                             \
-            case 0x0a:                             \
-                out = D & ~P;                      \
-                break;                             \
-            case 0x0b:                             \
-                out = ~(P | (S & ~D));             \
-                break;                             \
-            case 0x0c:                             \
-                out = S & ~P;                      \
-                break;                             \
-            case 0x0d:                             \
-                out = ~(P | (D & ~S));             \
-                break;                             \
-            case 0x0e:                             \
-                out = ~(P | ~(D | S));             \
-                break;                             \
-            case 0x0f:                             \
-                out = ~P;                          \
-                break;                             \
-            case 0x10:                             \
-                out = P & ~(D | S);                \
-                break;                             \
-            case 0x11:                             \
-                out = ~(D | S);                    \
-                break;                             \
-            case 0x12:                             \
-                out = ~(S | ~(D ^ P));             \
-                break;                             \
-            case 0x13:                             \
-                out = ~(S | (D & P));              \
-                break;                             \
-            case 0x14:                             \
-                out = ~(D | ~(P ^ S));             \
-                break;                             \
-            case 0x15:                             \
-                out = ~(D | (P & S));              \
-                break;                             \
-            case 0x16:                             \
-                out = P ^ (S ^ (D & ~(P & S)));    \
-                break;                             \
-            case 0x17:                             \
-                out = ~(S ^ ((S ^ P) & (D ^ S)));  \
-                break;                             \
-            case 0x18:                             \
-                out = (S ^ P) & (P ^ D);           \
-                break;                             \
-            case 0x19:                             \
-                out = ~(S ^ (D & ~(P & S)));       \
-                break;                             \
-            case 0x1a:                             \
-                out = P ^ (D | (S & P));           \
-                break;                             \
-            case 0x1b:                             \
-                out = ~(S ^ (D & (P ^ S)));        \
-                break;                             \
-            case 0x1c:                             \
-                out = P ^ (S | (D & P));           \
-                break;                             \
-            case 0x1d:                             \
-                out = ~(D ^ (S & (P ^ D)));        \
-                break;                             \
-            case 0x1e:                             \
-                out = P ^ (D | S);                 \
-                break;                             \
-            case 0x1f:                             \
-                out = ~(P & (D | S));              \
-                break;                             \
-            case 0x20:                             \
-                out = D & (P & ~S);                \
-                break;                             \
-            case 0x21:                             \
-                out = ~(S | (D ^ P));              \
-                break;                             \
-            case 0x22:                             \
-                out = D & ~S;                      \
-                break;                             \
-            case 0x23:                             \
-                out = ~(S | (P & ~D));             \
-                break;                             \
-            case 0x24:                             \
-                out = (S ^ P) & (D ^ S);           \
-                break;                             \
-            case 0x25:                             \
-                out = ~(P ^ (D & ~(S & P)));       \
-                break;                             \
-            case 0x26:                             \
-                out = S ^ (D | (P & S));           \
-                break;                             \
-            case 0x27:                             \
-                out = S ^ (D | ~(P ^ S));          \
-                break;                             \
-            case 0x28:                             \
-                out = D & (P ^ S);                 \
-                break;                             \
-            case 0x29:                             \
-                out = ~(P ^ (S ^ (D | (P & S))));  \
-                break;                             \
-            case 0x2a:                             \
-                out = D & ~(P & S);                \
-                break;                             \
-            case 0x2b:                             \
-                out = ~(S ^ ((S ^ P) & (P ^ D)));  \
-                break;                             \
-            case 0x2c:                             \
-                out = S ^ (P & (D | S));           \
-                break;                             \
-            case 0x2d:                             \
-                out = P ^ (S | ~D);                \
-                break;                             \
-            case 0x2e:                             \
-                out = P ^ (S | (D ^ P));           \
-                break;                             \
-            case 0x2f:                             \
-                out = ~(P & (S | ~D));             \
-                break;                             \
-            case 0x30:                             \
-                out = P & ~S;                      \
-                break;                             \
-            case 0x31:                             \
-                out = ~(S | (D & ~P));             \
-                break;                             \
-            case 0x32:                             \
-                out = S ^ (D | (P | S));           \
-                break;                             \
-            case 0x33:                             \
-                out = ~S;                          \
-                break;                             \
-            case 0x34:                             \
-                out = S ^ (P | (D & S));           \
-                break;                             \
-            case 0x35:                             \
-                out = S ^ (P | ~(D ^ S));          \
-                break;                             \
-            case 0x36:                             \
-                out = S ^ (D | P);                 \
-                break;                             \
-            case 0x37:                             \
-                out = ~(S & (D | P));              \
-                break;                             \
-            case 0x38:                             \
-                out = P ^ (S & (D | P));           \
-                break;                             \
-            case 0x39:                             \
-                out = S ^ (P | ~D);                \
-                break;                             \
-            case 0x3a:                             \
-                out = S ^ (P | (D ^ S));           \
-                break;                             \
-            case 0x3b:                             \
-                out = ~(S & (P | ~D));             \
-                break;                             \
-            case 0x3c:                             \
-                out = P ^ S;                       \
-                break;                             \
-            case 0x3d:                             \
-                out = S ^ (P | ~(D | S));          \
-                break;                             \
-            case 0x3e:                             \
-                out = S ^ (P | (D & ~S));          \
-                break;                             \
-            case 0x3f:                             \
-                out = ~(P & S);                    \
-                break;                             \
-            case 0x40:                             \
-                out = P & (S & ~D);                \
-                break;                             \
-            case 0x41:                             \
-                out = ~(D | (P ^ S));              \
-                break;                             \
-            case 0x42:                             \
-                out = (S ^ D) & (P ^ D);           \
-                break;                             \
-            case 0x43:                             \
-                out = ~(S ^ (P & ~(D & S)));       \
-                break;                             \
-            case 0x44:                             \
-                out = S & ~D;                      \
-                break;                             \
-            case 0x45:                             \
-                out = ~(D | (P & ~S));             \
-                break;                             \
-            case 0x46:                             \
-                out = D ^ (S | (P & D));           \
-                break;                             \
-            case 0x47:                             \
-                out = ~(P ^ (S & (D ^ P)));        \
-                break;                             \
-            case 0x48:                             \
-                out = S & (D ^ P);                 \
-                break;                             \
-            case 0x49:                             \
-                out = ~(P ^ (D ^ (S | (P & D))));  \
-                break;                             \
-            case 0x4a:                             \
-                out = D ^ (P & (S | D));           \
-                break;                             \
-            case 0x4b:                             \
-                out = P ^ (D | ~S);                \
-                break;                             \
-            case 0x4c:                             \
-                out = S & ~(D & P);                \
-                break;                             \
-            case 0x4d:                             \
-                out = ~(S ^ ((S ^ P) | (D ^ S)));  \
-                break;                             \
-            case 0x4e:                             \
-                out = P ^ (D | (S ^ P));           \
-                break;                             \
-            case 0x4f:                             \
-                out = ~(P & (D | ~S));             \
-                break;                             \
-            case 0x50:                             \
-                out = P & ~D;                      \
-                break;                             \
-            case 0x51:                             \
-                out = ~(D | (S & ~P));             \
-                break;                             \
-            case 0x52:                             \
-                out = D ^ (P | (S & D));           \
-                break;                             \
-            case 0x53:                             \
-                out = ~(S ^ (P & (D ^ S)));        \
-                break;                             \
-            case 0x54:                             \
-                out = ~(D | ~(P | S));             \
-                break;                             \
-            case 0x55:                             \
-                out = ~D;                          \
-                break;                             \
-            case 0x56:                             \
-                out = D ^ (P | S);                 \
-                break;                             \
-            case 0x57:                             \
-                out = ~(D & (P | S));              \
-                break;                             \
-            case 0x58:                             \
-                out = P ^ (D & (S | P));           \
-                break;                             \
-            case 0x59:                             \
-                out = D ^ (P | ~S);                \
-                break;                             \
-            case 0x5a:                             \
-                out = D ^ P;                       \
-                break;                             \
-            case 0x5b:                             \
-                out = D ^ (P | ~(S | D));          \
-                break;                             \
-            case 0x5c:                             \
-                out = D ^ (P | (S ^ D));           \
-                break;                             \
-            case 0x5d:                             \
-                out = ~(D & (P | ~S));             \
-                break;                             \
-            case 0x5e:                             \
-                out = D ^ (P | (S & ~D));          \
-                break;                             \
-            case 0x5f:                             \
-                out = ~(D & P);                    \
-                break;                             \
-            case 0x60:                             \
-                out = P & (D ^ S);                 \
-                break;                             \
-            case 0x61:                             \
-                out = ~(D ^ (S ^ (P | (D & S))));  \
-                break;                             \
-            case 0x62:                             \
-                out = D ^ (S & (P | D));           \
-                break;                             \
-            case 0x63:                             \
-                out = S ^ (D | ~P);                \
-                break;                             \
-            case 0x64:                             \
-                out = S ^ (D & (P | S));           \
-                break;                             \
-            case 0x65:                             \
-                out = D ^ (S | ~P);                \
-                break;                             \
-            case 0x66:                             \
-                out = D ^ S;                       \
-                break;                             \
-            case 0x67:                             \
-                out = S ^ (D | ~(P | S));          \
-                break;                             \
-            case 0x68:                             \
-                out = ~(D ^ (S ^ (P | ~(D | S)))); \
-                break;                             \
-            case 0x69:                             \
-                out = ~(P ^ (D ^ S));              \
-                break;                             \
-            case 0x6a:                             \
-                out = D ^ (P & S);                 \
-                break;                             \
-            case 0x6b:                             \
-                out = ~(P ^ (S ^ (D & (P | S))));  \
-                break;                             \
-            case 0x6c:                             \
-                out = S ^ (D & P);                 \
-                break;                             \
-            case 0x6d:                             \
-                out = ~(P ^ (D ^ (S & (P | D))));  \
-                break;                             \
-            case 0x6e:                             \
-                out = S ^ (D & (P | ~S));          \
-                break;                             \
-            case 0x6f:                             \
-                out = ~(P & ~(D ^ S));             \
-                break;                             \
-            case 0x70:                             \
-                out = P & ~(D & S);                \
-                break;                             \
-            case 0x71:                             \
-                out = ~(S ^ ((S ^ D) & (P ^ D)));  \
-                break;                             \
-            case 0x72:                             \
-                out = S ^ (D | (P ^ S));           \
-                break;                             \
-            case 0x73:                             \
-                out = ~(S & (D | ~P));             \
-                break;                             \
-            case 0x74:                             \
-                out = D ^ (S | (P ^ D));           \
-                break;                             \
-            case 0x75:                             \
-                out = ~(D & (S | ~P));             \
-                break;                             \
-            case 0x76:                             \
-                out = S ^ (D | (P & ~S));          \
-                break;                             \
-            case 0x77:                             \
-                out = ~(D & S);                    \
-                break;                             \
-            case 0x78:                             \
-                out = P ^ (D & S);                 \
-                break;                             \
-            case 0x79:                             \
-                out = ~(D ^ (S ^ (P & (D | S))));  \
-                break;                             \
-            case 0x7a:                             \
-                out = D ^ (P & (S | ~D));          \
-                break;                             \
-            case 0x7b:                             \
-                out = ~(S & ~(D ^ P));             \
-                break;                             \
-            case 0x7c:                             \
-                out = S ^ (P & (D | ~S));          \
-                break;                             \
-            case 0x7d:                             \
-                out = ~(D & ~(P ^ S));             \
-                break;                             \
-            case 0x7e:                             \
-                out = (S ^ P) | (D ^ S);           \
-                break;                             \
-            case 0x7f:                             \
-                out = ~(D & (P & S));              \
-                break;                             \
-            case 0x80:                             \
-                out = D & (P & S);                 \
-                break;                             \
-            case 0x81:                             \
-                out = ~((S ^ P) | (D ^ S));        \
-                break;                             \
-            case 0x82:                             \
-                out = D & ~(P ^ S);                \
-                break;                             \
-            case 0x83:                             \
-                out = ~(S ^ (P & (D | ~S)));       \
-                break;                             \
-            case 0x84:                             \
-                out = S & ~(D ^ P);                \
-                break;                             \
-            case 0x85:                             \
-                out = ~(P ^ (D & (S | ~P)));       \
-                break;                             \
-            case 0x86:                             \
-                out = D ^ (S ^ (P & (D | S)));     \
-                break;                             \
-            case 0x87:                             \
-                out = ~(P ^ (D & S));              \
-                break;                             \
-            case 0x88:                             \
-                out = D & S;                       \
-                break;                             \
-            case 0x89:                             \
-                out = ~(S ^ (D | (P & ~S)));       \
-                break;                             \
-            case 0x8a:                             \
-                out = D & (S | ~P);                \
-                break;                             \
-            case 0x8b:                             \
-                out = ~(D ^ (S | (P ^ D)));        \
-                break;                             \
-            case 0x8c:                             \
-                out = S & (D | ~P);                \
-                break;                             \
-            case 0x8d:                             \
-                out = ~(S ^ (D | (P ^ S)));        \
-                break;                             \
-            case 0x8e:                             \
-                out = S ^ ((S ^ D) & (P ^ D));     \
-                break;                             \
-            case 0x8f:                             \
-                out = ~(P & ~(D & S));             \
-                break;                             \
-            case 0x90:                             \
-                out = P & ~(D ^ S);                \
-                break;                             \
-            case 0x91:                             \
-                out = ~(S ^ (D & (P | ~S)));       \
-                break;                             \
-            case 0x92:                             \
-                out = D ^ (P ^ (S & (D | P)));     \
-                break;                             \
-            case 0x93:                             \
-                out = ~(S ^ (P & D));              \
-                break;                             \
-            case 0x94:                             \
-                out = P ^ (S ^ (D & (P | S)));     \
-                break;                             \
-            case 0x95:                             \
-                out = ~(D ^ (P & S));              \
-                break;                             \
-            case 0x96:                             \
-                out = D ^ (P ^ S);                 \
-                break;                             \
-            case 0x97:                             \
-                out = P ^ (S ^ (D | ~(P | S)));    \
-                break;                             \
-            case 0x98:                             \
-                out = ~(S ^ (D | ~(P | S)));       \
-                break;                             \
-            case 0x99:                             \
-                out = ~(D ^ S);                    \
-                break;                             \
-            case 0x9a:                             \
-                out = D ^ (P & ~S);                \
-                break;                             \
-            case 0x9b:                             \
-                out = ~(S ^ (D & (P | S)));        \
-                break;                             \
-            case 0x9c:                             \
-                out = S ^ (P & ~D);                \
-                break;                             \
-            case 0x9d:                             \
-                out = ~(D ^ (S & (P | D)));        \
-                break;                             \
-            case 0x9e:                             \
-                out = D ^ (S ^ (P | (D & S)));     \
-                break;                             \
-            case 0x9f:                             \
-                out = ~(P & (D ^ S));              \
-                break;                             \
-            case 0xa0:                             \
-                out = D & P;                       \
-                break;                             \
-            case 0xa1:                             \
-                out = ~(P ^ (D | (S & ~P)));       \
-                break;                             \
-            case 0xa2:                             \
-                out = D & (P | ~S);                \
-                break;                             \
-            case 0xa3:                             \
-                out = ~(D ^ (P | (S ^ D)));        \
-                break;                             \
-            case 0xa4:                             \
-                out = ~(P ^ (D | ~(S | P)));       \
-                break;                             \
-            case 0xa5:                             \
-                out = ~(P ^ D);                    \
-                break;                             \
-            case 0xa6:                             \
-                out = D ^ (S & ~P);                \
-                break;                             \
-            case 0xa7:                             \
-                out = ~(P ^ (D & (S | P)));        \
-                break;                             \
-            case 0xa8:                             \
-                out = D & (P | S);                 \
-                break;                             \
-            case 0xa9:                             \
-                out = ~(D ^ (P | S));              \
-                break;                             \
-            case 0xaa:                             \
-                out = D;                           \
-                break;                             \
-            case 0xab:                             \
-                out = D | ~(P | S);                \
-                break;                             \
-            case 0xac:                             \
-                out = S ^ (P & (D ^ S));           \
-                break;                             \
-            case 0xad:                             \
-                out = ~(D ^ (P | (S & D)));        \
-                break;                             \
-            case 0xae:                             \
-                out = D | (S & ~P);                \
-                break;                             \
-            case 0xaf:                             \
-                out = D | ~P;                      \
-                break;                             \
-            case 0xb0:                             \
-                out = P & (D | ~S);                \
-                break;                             \
-            case 0xb1:                             \
-                out = ~(P ^ (D | (S ^ P)));        \
-                break;                             \
-            case 0xb2:                             \
-                out = S ^ ((S ^ P) | (D ^ S));     \
-                break;                             \
-            case 0xb3:                             \
-                out = ~(S & ~(D & P));             \
-                break;                             \
-            case 0xb4:                             \
-                out = P ^ (S & ~D);                \
-                break;                             \
-            case 0xb5:                             \
-                out = ~(D ^ (P & (S | D)));        \
-                break;                             \
-            case 0xb6:                             \
-                out = D ^ (P ^ (S | (D & P)));     \
-                break;                             \
-            case 0xb7:                             \
-                out = ~(S & (D ^ P));              \
-                break;                             \
-            case 0xb8:                             \
-                out = P ^ (S & (D ^ P));           \
-                break;                             \
-            case 0xb9:                             \
-                out = ~(D ^ (S | (P & D)));        \
-                break;                             \
-            case 0xba:                             \
-                out = D | (P & ~S);                \
-                break;                             \
-            case 0xbb:                             \
-                out = D | ~S;                      \
-                break;                             \
-            case 0xbc:                             \
-                out = S ^ (P & ~(D & S));          \
-                break;                             \
-            case 0xbd:                             \
-                out = ~((S ^ D) & (P ^ D));        \
-                break;                             \
-            case 0xbe:                             \
-                out = D | (P ^ S);                 \
-                break;                             \
-            case 0xbf:                             \
-                out = D | ~(P & S);                \
-                break;                             \
-            case 0xc0:                             \
-                out = P & S;                       \
-                break;                             \
-            case 0xc1:                             \
-                out = ~(S ^ (P | (D & ~S)));       \
-                break;                             \
-            case 0xc2:                             \
-                out = ~(S ^ (P | ~(D | S)));       \
-                break;                             \
-            case 0xc3:                             \
-                out = ~(P ^ S);                    \
-                break;                             \
-            case 0xc4:                             \
-                out = S & (P | ~D);                \
-                break;                             \
-            case 0xc5:                             \
-                out = ~(S ^ (P | (D ^ S)));        \
-                break;                             \
-            case 0xc6:                             \
-                out = S ^ (D & ~P);                \
-                break;                             \
-            case 0xc7:                             \
-                out = ~(P ^ (S & (D | P)));        \
-                break;                             \
-            case 0xc8:                             \
-                out = S & (D | P);                 \
-                break;                             \
-            case 0xc9:                             \
-                out = ~(S ^ (P | D));              \
-                break;                             \
-            case 0xca:                             \
-                out = D ^ (P & (S ^ D));           \
-                break;                             \
-            case 0xcb:                             \
-                out = ~(S ^ (P | (D & S)));        \
-                break;                             \
-            case 0xcc:                             \
-                out = S;                           \
-                break;                             \
-            case 0xcd:                             \
-                out = S | ~(D | P);                \
-                break;                             \
-            case 0xce:                             \
-                out = S | (D & ~P);                \
-                break;                             \
-            case 0xcf:                             \
-                out = S | ~P;                      \
-                break;                             \
-            case 0xd0:                             \
-                out = P & (S | ~D);                \
-                break;                             \
-            case 0xd1:                             \
-                out = ~(P ^ (S | (D ^ P)));        \
-                break;                             \
-            case 0xd2:                             \
-                out = P ^ (D & ~S);                \
-                break;                             \
-            case 0xd3:                             \
-                out = ~(S ^ (P & (D | S)));        \
-                break;                             \
-            case 0xd4:                             \
-                out = S ^ ((S ^ P) & (P ^ D));     \
-                break;                             \
-            case 0xd5:                             \
-                out = ~(D & ~(P & S));             \
-                break;                             \
-            case 0xd6:                             \
-                out = P ^ (S ^ (D | (P & S)));     \
-                break;                             \
-            case 0xd7:                             \
-                out = ~(D & (P ^ S));              \
-                break;                             \
-            case 0xd8:                             \
-                out = P ^ (D & (S ^ P));           \
-                break;                             \
-            case 0xd9:                             \
-                out = ~(S ^ (D | (P & S)));        \
-                break;                             \
-            case 0xda:                             \
-                out = D ^ (P & ~(S & D));          \
-                break;                             \
-            case 0xdb:                             \
-                out = ~((S ^ P) & (D ^ S));        \
-                break;                             \
-            case 0xdc:                             \
-                out = S | (P & ~D);                \
-                break;                             \
-            case 0xdd:                             \
-                out = S | ~D;                      \
-                break;                             \
-            case 0xde:                             \
-                out = S | (D ^ P);                 \
-                break;                             \
-            case 0xdf:                             \
-                out = S | ~(D & P);                \
-                break;                             \
-            case 0xe0:                             \
-                out = P & (D | S);                 \
-                break;                             \
-            case 0xe1:                             \
-                out = ~(P ^ (D | S));              \
-                break;                             \
-            case 0xe2:                             \
-                out = D ^ (S & (P ^ D));           \
-                break;                             \
-            case 0xe3:                             \
-                out = ~(P ^ (S | (D & P)));        \
-                break;                             \
-            case 0xe4:                             \
-                out = S ^ (D & (P ^ S));           \
-                break;                             \
-            case 0xe5:                             \
-                out = ~(P ^ (D | (S & P)));        \
-                break;                             \
-            case 0xe6:                             \
-                out = S ^ (D & ~(P & S));          \
-                break;                             \
-            case 0xe7:                             \
-                out = ~((S ^ P) & (P ^ D));        \
-                break;                             \
-            case 0xe8:                             \
-                out = S ^ ((S ^ P) & (D ^ S));     \
-                break;                             \
-            case 0xe9:                             \
-                out = ~(D ^ (S ^ (P & ~(D & S)))); \
-                break;                             \
-            case 0xea:                             \
-                out = D | (P & S);                 \
-                break;                             \
-            case 0xeb:                             \
-                out = D | ~(P ^ S);                \
-                break;                             \
-            case 0xec:                             \
-                out = S | (D & P);                 \
-                break;                             \
-            case 0xed:                             \
-                out = S | ~(D ^ P);                \
-                break;                             \
-            case 0xee:                             \
-                out = D | S;                       \
-                break;                             \
-            case 0xef:                             \
-                out = S | (D | ~P);                \
-                break;                             \
-            case 0xf0:                             \
-                out = P;                           \
-                break;                             \
-            case 0xf1:                             \
-                out = P | ~(D | S);                \
-                break;                             \
-            case 0xf2:                             \
-                out = P | (D & ~S);                \
-                break;                             \
-            case 0xf3:                             \
-                out = P | ~S;                      \
-                break;                             \
-            case 0xf4:                             \
-                out = P | (S & ~D);                \
-                break;                             \
-            case 0xf5:                             \
-                out = P | ~D;                      \
-                break;                             \
-            case 0xf6:                             \
-                out = P | (D ^ S);                 \
-                break;                             \
-            case 0xf7:                             \
-                out = P | ~(D & S);                \
-                break;                             \
-            case 0xf8:                             \
-                out = P | (D & S);                 \
-                break;                             \
-            case 0xf9:                             \
-                out = P | ~(D ^ S);                \
-                break;                             \
-            case 0xfa:                             \
-                out = D | P;                       \
-                break;                             \
-            case 0xfb:                             \
-                out = D | (P | ~S);                \
-                break;                             \
-            case 0xfc:                             \
-                out = P | S;                       \
-                break;                             \
-            case 0xfd:                             \
-                out = P | (S | ~D);                \
-                break;                             \
-            case 0xfe:                             \
-                out = D | (P | S);                 \
-                break;                             \
-            case 0xff:                             \
-                out = ~0;                          \
-                break;                             \
-        }                                          \
-    }
-
-#define MIX()                                                      \
-    do {                                                           \
-        ROPMIX(virge->s3d.rop & 0xFF, dest, pattern, source, out); \
-        out &= 0xFFFFFF;                                           \
+#define MIX()                                                           \
+    do {                                                                \
+        out = video_rop3(virge->s3d.rop & 0xFF, dest, pattern, source); \
+        out &= 0xFFFFFF;                                                \
     } while (0)
 
 #define WRITE(addr, val)                                                         \
@@ -3054,6 +2468,8 @@ s3_virge_mmio_write_l(uint32_t addr, uint32_t val, void *priv)
                     changeframecount;                                            \
                 break;                                                           \
         }                                                                        \
+        if (virge->tex_cached)                                                   \
+            s3_virge_tex_dirty(virge, addr, bpp + 1);                            \
     } while (0)
 
 static void
@@ -3422,9 +2838,9 @@ skip_line:
         g = (val & 0xff00) >> 8;   \
         r = (val & 0xff0000) >> 16
 
-#define RGB15(r, g, b, dest)                        \
+#define RGB15(x, y, r, g, b, dest)                  \
         if (virge->dithering_enabled) {             \
-                int add = dither[_y & 3][_x & 3];   \
+                int add = dither[(y) & 3][(x) & 3]; \
                 int _r = (r > 248) ? 248 : r + add; \
                 int _g = (g > 248) ? 248 : g + add; \
                 int _b = (b > 248) ? 248 : b + add; \
@@ -3445,6 +2861,14 @@ typedef struct rgba_t {
     int a;
 } rgba_t;
 
+typedef struct s3d_texture_state_t {
+    int level;
+    int texture_shift;
+
+    int32_t u;
+    int32_t v;
+} s3d_texture_state_t;
+
 typedef struct s3d_state_t {
     int32_t r;
     int32_t g;
@@ -3472,7 +2896,7 @@ typedef struct s3d_state_t {
     uint32_t cmd_set;
     int      max_d;
 
-    uint16_t *texture[10];
+    uint32_t *texture[10];
 
     uint32_t tex_bdr_clr;
 
@@ -3482,111 +2906,66 @@ typedef struct s3d_state_t {
     int y;
 
     rgba_t dest_rgba;
-} s3d_state_t;
-
-typedef struct s3d_texture_state_t {
-    int level;
-    int texture_shift;
 
-    int32_t u;
-    int32_t v;
-} s3d_texture_state_t;
-
-static void (*tex_read)(s3d_state_t *state, s3d_texture_state_t *texture_state, rgba_t *out);
-static void (*tex_sample)(s3d_state_t *state);
-static void (*dest_pixel)(s3d_state_t *state);
+    uint32_t (*tex_read)(struct s3d_state_t *state, s3d_texture_state_t *texture_state);
+    void (*tex_sample)(struct s3d_state_t *state);
+} s3d_state_t;
 
 #define MAX(a, b) ((a) > (b) ? (a) : (b))
 #define MIN(a, b) ((a) < (b) ? (a) : (b))
 
-static int _x;
-static int _y;
-
-static void
-tex_ARGB1555(s3d_state_t *state, s3d_texture_state_t *texture_state, rgba_t *out)
-{
-    int offset = ((texture_state->u & 0x7fc0000) >> texture_state->texture_shift) +
-                 (((texture_state->v & 0x7fc0000) >> texture_state->texture_shift) << texture_state->level);
-    uint16_t val = state->texture[texture_state->level][offset];
-
-    out->r = ((val & 0x7c00) >> 7) | ((val & 0x7000) >> 12);
-    out->g = ((val & 0x03e0) >> 2) | ((val & 0x0380) >> 7);
-    out->b = ((val & 0x001f) << 3) | ((val & 0x001c) >> 2);
-    out->a = (val & 0x8000) ? 0xff : 0;
-}
-
-static void
-tex_ARGB1555_nowrap(s3d_state_t *state, s3d_texture_state_t *texture_state, rgba_t *out)
-{
-    int offset = ((texture_state->u & 0x7fc0000) >> texture_state->texture_shift) +
-                 (((texture_state->v & 0x7fc0000) >> texture_state->texture_shift) << texture_state->level);
-    uint16_t val = state->texture[texture_state->level][offset];
-
-    if (((texture_state->u | texture_state->v) & 0xf8000000) == 0xf8000000)
-        val = state->tex_bdr_clr;
-
-    out->r = ((val & 0x7c00) >> 7) | ((val & 0x7000) >> 12);
-    out->g = ((val & 0x03e0) >> 2) | ((val & 0x0380) >> 7);
-    out->b = ((val & 0x001f) << 3) | ((val & 0x001c) >> 2);
-    out->a = (val & 0x8000) ? 0xff : 0;
-}
-
-static void
-tex_ARGB4444(s3d_state_t *state, s3d_texture_state_t *texture_state, rgba_t *out)
+static uint32_t
+tex_read(s3d_state_t *state, s3d_texture_state_t *texture_state)
 {
     int offset = ((texture_state->u & 0x7fc0000) >> texture_state->texture_shift) +
                  (((texture_state->v & 0x7fc0000) >> texture_state->texture_shift) << texture_state->level);
-    uint16_t val = state->texture[texture_state->level][offset];
 
-    out->r = ((val & 0x0f00) >> 4) | ((val & 0x0f00) >> 8);
-    out->g = (val & 0x00f0) | ((val & 0x00f0) >> 4);
-    out->b = ((val & 0x000f) << 4) | (val & 0x000f);
-    out->a = ((val & 0xf000) >> 8) | ((val & 0xf000) >> 12);
+    return state->texture[texture_state->level][offset];
 }
 
-static void
-tex_ARGB4444_nowrap(s3d_state_t *state, s3d_texture_state_t *texture_state, rgba_t *out)
+static uint32_t
+tex_read_nowrap(s3d_state_t *state, s3d_texture_state_t *texture_state)
 {
-    int offset = ((texture_state->u & 0x7fc0000) >> texture_state->texture_shift) +
-                 (((texture_state->v & 0x7fc0000) >> texture_state->texture_shift) << texture_state->level);
-    uint16_t val = state->texture[texture_state->level][offset];
-
     if (((texture_state->u | texture_state->v) & 0xf8000000) == 0xf8000000)
-        val = state->tex_bdr_clr;
+        return state->tex_bdr_clr;
 
-    out->r = ((val & 0x0f00) >> 4) | ((val & 0x0f00) >> 8);
-    out->g = (val & 0x00f0) | ((val & 0x00f0) >> 4);
-    out->b = ((val & 0x000f) << 4) | (val & 0x000f);
-    out->a = ((val & 0xf000) >> 8) | ((val & 0xf000) >> 12);
+    return tex_read(state, texture_state);
 }
 
-static void
-tex_ARGB8888(s3d_state_t *state, s3d_texture_state_t *texture_state, rgba_t *out)
+static inline void
+tex_unpack(uint32_t val, rgba_t *out)
 {
-    int offset = ((texture_state->u & 0x7fc0000) >> texture_state->texture_shift) +
-                  (((texture_state->v & 0x7fc0000) >> texture_state->texture_shift) << texture_state->level);
-    uint32_t val = ((uint32_t *)state->texture[texture_state->level])[offset];
-
     out->r = (val >> 16) & 0xff;
     out->g = (val >> 8) & 0xff;
     out->b = val & 0xff;
     out->a = (val >> 24) & 0xff;
 }
 
+/* Bilinear blend of four ARGB8888 texels. Red/blue and alpha/green are each
+   spread into the two 32-bit halves of a 64-bit word, so two channels are
+   weighted per multiply; the weights sum to 65536, so the halves can't carry
+   into each other and the result matches filtering each channel alone. */
 static void
-tex_ARGB8888_nowrap(s3d_state_t *state, s3d_texture_state_t *texture_state, rgba_t *out)
+tex_filter(s3d_state_t *state, const uint32_t *samples, int du, int dv)
 {
-    int offset = ((texture_state->u & 0x7fc0000) >> texture_state->texture_shift) +
-                 (((texture_state->v & 0x7fc0000) >> texture_state->texture_shift) << texture_state->level);
-    uint32_t val = ((uint32_t *)state->texture[texture_state->level])[offset];
+    uint32_t d[4];
+    uint64_t rb = 0;
+    uint64_t ag = 0;
 
-    if (((texture_state->u | texture_state->v) & 0xf8000000) == 0xf8000000)
-        val = state->tex_bdr_clr;
+    d[0] = (256 - du) * (256 - dv);
+    d[1] = du * (256 - dv);
+    d[2] = (256 - du) * dv;
+    d[3] = du * dv;
 
-    out->r = (val >> 16) & 0xff;
-    out->g = (val >> 8) & 0xff;
-    out->b = val & 0xff;
-    out->a = (val >> 24) & 0xff;
+    for (int c = 0; c < 4; c++) {
+        rb += (((uint64_t) (samples[c] & 0x00ff0000) << 16) | (samples[c] & 0xff)) * d[c];
+        ag += (((uint64_t) (samples[c] & 0xff000000) << 8) | ((samples[c] >> 8) & 0xff)) * d[c];
+    }
+
+    state->dest_rgba.r = rb >> 48;
+    state->dest_rgba.g = (uint32_t) ag >> 16;
+    state->dest_rgba.b = (uint32_t) rb >> 16;
+    state->dest_rgba.a = ag >> 48;
 }
 
 static void
@@ -3599,7 +2978,7 @@ tex_sample_normal(s3d_state_t *state)
     texture_state.u             = state->u + state->tbu;
     texture_state.v             = state->v + state->tbv;
 
-    tex_read(state, &texture_state, &state->dest_rgba);
+    tex_unpack(state->tex_read(state, &texture_state), &state->dest_rgba);
 }
 
 static void
@@ -3607,10 +2986,9 @@ tex_sample_normal_filter(s3d_state_t *state)
 {
     s3d_texture_state_t texture_state;
     int                 tex_offset;
-    rgba_t              tex_samples[4];
+    uint32_t            tex_samples[4];
     int                 du;
     int                 dv;
-    int                 d[4];
 
     texture_state.level         = state->max_d;
     texture_state.texture_shift = 18 + (9 - texture_state.level);
@@ -3618,35 +2996,23 @@ tex_sample_normal_filter(s3d_state_t *state)
 
     texture_state.u = state->u + state->tbu;
     texture_state.v = state->v + state->tbv;
-    tex_read(state, &texture_state, &tex_samples[0]);
+    tex_samples[0] = state->tex_read(state, &texture_state);
     du = (texture_state.u >> (texture_state.texture_shift - 8)) & 0xff;
     dv = (texture_state.v >> (texture_state.texture_shift - 8)) & 0xff;
 
     texture_state.u = state->u + state->tbu + tex_offset;
     texture_state.v = state->v + state->tbv;
-    tex_read(state, &texture_state, &tex_samples[1]);
+    tex_samples[1] = state->tex_read(state, &texture_state);
 
     texture_state.u = state->u + state->tbu;
     texture_state.v = state->v + state->tbv + tex_offset;
-    tex_read(state, &texture_state, &tex_samples[2]);
+    tex_samples[2] = state->tex_read(state, &texture_state);
 
     texture_state.u = state->u + state->tbu + tex_offset;
     texture_state.v = state->v + state->tbv + tex_offset;
-    tex_read(state, &texture_state, &tex_samples[3]);
+    tex_samples[3] = state->tex_read(state, &texture_state);
 
-    d[0] = (256 - du) * (256 - dv);
-    d[1] = du * (256 - dv);
-    d[2] = (256 - du) * dv;
-    d[3] = du * dv;
-
-    state->dest_rgba.r = (tex_samples[0].r * d[0] + tex_samples[1].r * d[1] +
-                          tex_samples[2].r * d[2] + tex_samples[3].r * d[3]) >> 16;
-    state->dest_rgba.g = (tex_samples[0].g * d[0] + tex_samples[1].g * d[1] +
-                          tex_samples[2].g * d[2] + tex_samples[3].g * d[3]) >> 16;
-    state->dest_rgba.b = (tex_samples[0].b * d[0] + tex_samples[1].b * d[1] +
-                          tex_samples[2].b * d[2] + tex_samples[3].b * d[3]) >> 16;
-    state->dest_rgba.a = (tex_samples[0].a * d[0] + tex_samples[1].a * d[1] +
-                          tex_samples[2].a * d[2] + tex_samples[3].a * d[3]) >> 16;
+    tex_filter(state, tex_samples, du, dv);
 }
 
 static void
@@ -3661,7 +3027,7 @@ tex_sample_mipmap(s3d_state_t *state)
     texture_state.u             = state->u + state->tbu;
     texture_state.v             = state->v + state->tbv;
 
-    tex_read(state, &texture_state, &state->dest_rgba);
+    tex_unpack(state->tex_read(state, &texture_state), &state->dest_rgba);
 }
 
 static void
@@ -3669,10 +3035,9 @@ tex_sample_mipmap_filter(s3d_state_t *state)
 {
     s3d_texture_state_t texture_state;
     int                 tex_offset;
-    rgba_t              tex_samples[4];
+    uint32_t            tex_samples[4];
     int                 du;
     int                 dv;
-    int                 d[4];
 
     texture_state.level = (state->d < 0) ? state->max_d : state->max_d - ((state->d >> 27) & 0xf);
     if (texture_state.level < 0)
@@ -3682,35 +3047,23 @@ tex_sample_mipmap_filter(s3d_state_t *state)
 
     texture_state.u = state->u + state->tbu;
     texture_state.v = state->v + state->tbv;
-    tex_read(state, &texture_state, &tex_samples[0]);
+    tex_samples[0] = state->tex_read(state, &texture_state);
     du = (texture_state.u >> (texture_state.texture_shift - 8)) & 0xff;
     dv = (texture_state.v >> (texture_state.texture_shift - 8)) & 0xff;
 
     texture_state.u = state->u + state->tbu + tex_offset;
     texture_state.v = state->v + state->tbv;
-    tex_read(state, &texture_state, &tex_samples[1]);
+    tex_samples[1] = state->tex_read(state, &texture_state);
 
     texture_state.u = state->u + state->tbu;
     texture_state.v = state->v + state->tbv + tex_offset;
-    tex_read(state, &texture_state, &tex_samples[2]);
+    tex_samples[2] = state->tex_read(state, &texture_state);
 
     texture_state.u = state->u + state->tbu + tex_offset;
     texture_state.v = state->v + state->tbv + tex_offset;
-    tex_read(state, &texture_state, &tex_samples[3]);
-
-    d[0] = (256 - du) * (256 - dv);
-    d[1] = du * (256 - dv);
-    d[2] = (256 - du) * dv;
-    d[3] = du * dv;
+    tex_samples[3] = state->tex_read(state, &texture_state);
 
-    state->dest_rgba.r = (tex_samples[0].r * d[0] + tex_samples[1].r * d[1] +
-                          tex_samples[2].r * d[2] + tex_samples[3].r * d[3]) >> 16;
-    state->dest_rgba.g = (tex_samples[0].g * d[0] + tex_samples[1].g * d[1] +
-                          tex_samples[2].g * d[2] + tex_samples[3].g * d[3]) >> 16;
-    state->dest_rgba.b = (tex_samples[0].b * d[0] + tex_samples[1].b * d[1] +
-                          tex_samples[2].b * d[2] + tex_samples[3].b * d[3]) >> 16;
-    state->dest_rgba.a = (tex_samples[0].a * d[0] + tex_samples[1].a * d[1] +
-                          tex_samples[2].a * d[2] + tex_samples[3].a * d[3]) >> 16;
+    tex_filter(state, tex_samples, du, dv);
 }
 
 static void
@@ -3727,7 +3080,7 @@ tex_sample_persp_normal(s3d_state_t *state)
     texture_state.u             = (int32_t) (((int64_t) state->u * (int64_t) w) >> (12 + state->max_d)) + state->tbu;
     texture_state.v             = (int32_t) (((int64_t) state->v * (int64_t) w) >> (12 + state->max_d)) + state->tbv;
 
-    tex_read(state, &texture_state, &state->dest_rgba);
+    tex_unpack(state->tex_read(state, &texture_state), &state->dest_rgba);
 }
 
 static void
@@ -3738,10 +3091,9 @@ tex_sample_persp_normal_filter(s3d_state_t *state)
     int32_t             u;
     int32_t             v;
     int                 tex_offset;
-    rgba_t              tex_samples[4];
+    uint32_t            tex_samples[4];
     int                 du;
     int                 dv;
-    int                 d[4];
 
     if (state->w)
         w = (int32_t) (((1ULL << 27) << 19) / (int64_t) state->w);
@@ -3755,35 +3107,23 @@ tex_sample_persp_normal_filter(s3d_state_t *state)
 
     texture_state.u = u;
     texture_state.v = v;
-    tex_read(state, &texture_state, &tex_samples[0]);
+    tex_samples[0] = state->tex_read(state, &texture_state);
     du = (u >> (texture_state.texture_shift - 8)) & 0xff;
     dv = (v >> (texture_state.texture_shift - 8)) & 0xff;
 
     texture_state.u = u + tex_offset;
     texture_state.v = v;
-    tex_read(state, &texture_state, &tex_samples[1]);
+    tex_samples[1] = state->tex_read(state, &texture_state);
 
     texture_state.u = u;
     texture_state.v = v + tex_offset;
-    tex_read(state, &texture_state, &tex_samples[2]);
+    tex_samples[2] = state->tex_read(state, &texture_state);
 
     texture_state.u = u + tex_offset;
     texture_state.v = v + tex_offset;
-    tex_read(state, &texture_state, &tex_samples[3]);
+    tex_samples[3] = state->tex_read(state, &texture_state);
 
-    d[0] = (256 - du) * (256 - dv);
-    d[1] = du * (256 - dv);
-    d[2] = (256 - du) * dv;
-    d[3] = du * dv;
-
-    state->dest_rgba.r = (tex_samples[0].r * d[0] + tex_samples[1].r * d[1] +
-                          tex_samples[2].r * d[2] + tex_samples[3].r * d[3]) >> 16;
-    state->dest_rgba.g = (tex_samples[0].g * d[0] + tex_samples[1].g * d[1] +
-                          tex_samples[2].g * d[2] + tex_samples[3].g * d[3]) >> 16;
-    state->dest_rgba.b = (tex_samples[0].b * d[0] + tex_samples[1].b * d[1] +
-                          tex_samples[2].b * d[2] + tex_samples[3].b * d[3]) >> 16;
-    state->dest_rgba.a = (tex_samples[0].a * d[0] + tex_samples[1].a * d[1] +
-                          tex_samples[2].a * d[2] + tex_samples[3].a * d[3]) >> 16;
+    tex_filter(state, tex_samples, du, dv);
 }
 
 static void
@@ -3800,7 +3140,7 @@ tex_sample_persp_normal_375(s3d_state_t *state)
     texture_state.u             = (int32_t) (((int64_t) state->u * (int64_t) w) >> (8 + state->max_d)) + state->tbu;
     texture_state.v             = (int32_t) (((int64_t) state->v * (int64_t) w) >> (8 + state->max_d)) + state->tbv;
 
-    tex_read(state, &texture_state, &state->dest_rgba);
+    tex_unpack(state->tex_read(state, &texture_state), &state->dest_rgba);
 }
 
 static void
@@ -3811,10 +3151,9 @@ tex_sample_persp_normal_filter_375(s3d_state_t *state)
     int32_t             u;
     int32_t             v;
     int                 tex_offset;
-    rgba_t              tex_samples[4];
+    uint32_t            tex_samples[4];
     int                 du;
     int                 dv;
-    int                 d[4];
 
     if (state->w)
         w = (int32_t) (((1ULL << 27) << 19) / (int64_t) state->w);
@@ -3828,35 +3167,23 @@ tex_sample_persp_normal_filter_375(s3d_state_t *state)
 
     texture_state.u = u;
     texture_state.v = v;
-    tex_read(state, &texture_state, &tex_samples[0]);
+    tex_samples[0] = state->tex_read(state, &texture_state);
     du = (u >> (texture_state.texture_shift - 8)) & 0xff;
     dv = (v >> (texture_state.texture_shift - 8)) & 0xff;
 
     texture_state.u = u + tex_offset;
     texture_state.v = v;
-    tex_read(state, &texture_state, &tex_samples[1]);
+    tex_samples[1] = state->tex_read(state, &texture_state);
 
     texture_state.u = u;
     texture_state.v = v + tex_offset;
-    tex_read(state, &texture_state, &tex_samples[2]);
+    tex_samples[2] = state->tex_read(state, &texture_state);
 
     texture_state.u = u + tex_offset;
     texture_state.v = v + tex_offset;
-    tex_read(state, &texture_state, &tex_samples[3]);
+    tex_samples[3] = state->tex_read(state, &texture_state);
 
-    d[0] = (256 - du) * (256 - dv);
-    d[1] = du * (256 - dv);
-    d[2] = (256 - du) * dv;
-    d[3] = du * dv;
-
-    state->dest_rgba.r = (tex_samples[0].r * d[0] + tex_samples[1].r * d[1] +
-                          tex_samples[2].r * d[2] + tex_samples[3].r * d[3]) >> 16;
-    state->dest_rgba.g = (tex_samples[0].g * d[0] + tex_samples[1].g * d[1] +
-                          tex_samples[2].g * d[2] + tex_samples[3].g * d[3]) >> 16;
-    state->dest_rgba.b = (tex_samples[0].b * d[0] + tex_samples[1].b * d[1] +
-                          tex_samples[2].b * d[2] + tex_samples[3].b * d[3]) >> 16;
-    state->dest_rgba.a = (tex_samples[0].a * d[0] + tex_samples[1].a * d[1] +
-                          tex_samples[2].a * d[2] + tex_samples[3].a * d[3]) >> 16;
+    tex_filter(state, tex_samples, du, dv);
 }
 
 static void
@@ -3875,7 +3202,7 @@ tex_sample_persp_mipmap(s3d_state_t *state)
     texture_state.u             = (int32_t) (((int64_t) state->u * (int64_t) w) >> (12 + state->max_d)) + state->tbu;
     texture_state.v             = (int32_t) (((int64_t) state->v * (int64_t) w) >> (12 + state->max_d)) + state->tbv;
 
-    tex_read(state, &texture_state, &state->dest_rgba);
+    tex_unpack(state->tex_read(state, &texture_state), &state->dest_rgba);
 }
 
 static void
@@ -3886,10 +3213,9 @@ tex_sample_persp_mipmap_filter(s3d_state_t *state)
     int32_t             u;
     int32_t             v;
     int                 tex_offset;
-    rgba_t              tex_samples[4];
+    uint32_t            tex_samples[4];
     int                 du;
     int                 dv;
-    int                 d[4];
 
     if (state->w)
         w = (int32_t) (((1ULL << 27) << 19) / (int64_t) state->w);
@@ -3905,35 +3231,23 @@ tex_sample_persp_mipmap_filter(s3d_state_t *state)
 
     texture_state.u = u;
     texture_state.v = v;
-    tex_read(state, &texture_state, &tex_samples[0]);
+    tex_samples[0] = state->tex_read(state, &texture_state);
     du = (u >> (texture_state.texture_shift - 8)) & 0xff;
     dv = (v >> (texture_state.texture_shift - 8)) & 0xff;
 
     texture_state.u = u + tex_offset;
     texture_state.v = v;
-    tex_read(state, &texture_state, &tex_samples[1]);
+    tex_samples[1] = state->tex_read(state, &texture_state);
 
     texture_state.u = u;
     texture_state.v = v + tex_offset;
-    tex_read(state, &texture_state, &tex_samples[2]);
+    tex_samples[2] = state->tex_read(state, &texture_state);
 
     texture_state.u = u + tex_offset;
     texture_state.v = v + tex_offset;
-    tex_read(state, &texture_state, &tex_samples[3]);
-
-    d[0] = (256 - du) * (256 - dv);
-    d[1] = du * (256 - dv);
-    d[2] = (256 - du) * dv;
-    d[3] = du * dv;
+    tex_samples[3] = state->tex_read(state, &texture_state);
 
-    state->dest_rgba.r = (tex_samples[0].r * d[0] + tex_samples[1].r * d[1] +
-                          tex_samples[2].r * d[2] + tex_samples[3].r * d[3]) >> 16;
-    state->dest_rgba.g = (tex_samples[0].g * d[0] + tex_samples[1].g * d[1] +
-                          tex_samples[2].g * d[2] + tex_samples[3].g * d[3]) >> 16;
-    state->dest_rgba.b = (tex_samples[0].b * d[0] + tex_samples[1].b * d[1] +
-                          tex_samples[2].b * d[2] + tex_samples[3].b * d[3]) >> 16;
-    state->dest_rgba.a = (tex_samples[0].a * d[0] + tex_samples[1].a * d[1] +
-                          tex_samples[2].a * d[2] + tex_samples[3].a * d[3]) >> 16;
+    tex_filter(state, tex_samples, du, dv);
 }
 
 static void
@@ -3952,7 +3266,7 @@ tex_sample_persp_mipmap_375(s3d_state_t *state)
     texture_state.u             = (int32_t) (((int64_t) state->u * (int64_t) w) >> (8 + state->max_d)) + state->tbu;
     texture_state.v             = (int32_t) (((int64_t) state->v * (int64_t) w) >> (8 + state->max_d)) + state->tbv;
 
-    tex_read(state, &texture_state, &state->dest_rgba);
+    tex_unpack(state->tex_read(state, &texture_state), &state->dest_rgba);
 }
 
 static void
@@ -3963,10 +3277,9 @@ tex_sample_persp_mipmap_filter_375(s3d_state_t *state)
     int32_t             u;
     int32_t             v;
     int                 tex_offset;
-    rgba_t              tex_samples[4];
+    uint32_t            tex_samples[4];
     int                 du;
     int                 dv;
-    int                 d[4];
 
     if (state->w)
         w = (int32_t) (((1ULL << 27) << 19) / (int64_t) state->w);
@@ -3982,35 +3295,23 @@ tex_sample_persp_mipmap_filter_375(s3d_state_t *state)
 
     texture_state.u = u;
     texture_state.v = v;
-    tex_read(state, &texture_state, &tex_samples[0]);
+    tex_samples[0] = state->tex_read(state, &texture_state);
     du = (u >> (texture_state.texture_shift - 8)) & 0xff;
     dv = (v >> (texture_state.texture_shift - 8)) & 0xff;
 
     texture_state.u = u + tex_offset;
     texture_state.v = v;
-    tex_read(state, &texture_state, &tex_samples[1]);
+    tex_samples[1] = state->tex_read(state, &texture_state);
 
     texture_state.u = u;
     texture_state.v = v + tex_offset;
-    tex_read(state, &texture_state, &tex_samples[2]);
+    tex_samples[2] = state->tex_read(state, &texture_state);
 
     texture_state.u = u + tex_offset;
     texture_state.v = v + tex_offset;
-    tex_read(state, &texture_state, &tex_samples[3]);
+    tex_samples[3] = state->tex_read(state, &texture_state);
 
-    d[0] = (256 - du) * (256 - dv);
-    d[1] = du * (256 - dv);
-    d[2] = (256 - du) * dv;
-    d[3] = du * dv;
-
-    state->dest_rgba.r = (tex_samples[0].r * d[0] + tex_samples[1].r * d[1] +
-                          tex_samples[2].r * d[2] + tex_samples[3].r * d[3]) >> 16;
-    state->dest_rgba.g = (tex_samples[0].g * d[0] + tex_samples[1].g * d[1] +
-                          tex_samples[2].g * d[2] + tex_samples[3].g * d[3]) >> 16;
-    state->dest_rgba.b = (tex_samples[0].b * d[0] + tex_samples[1].b * d[1] +
-                          tex_samples[2].b * d[2] + tex_samples[3].b * d[3]) >> 16;
-    state->dest_rgba.a = (tex_samples[0].a * d[0] + tex_samples[1].a * d[1] +
-                          tex_samples[2].a * d[2] + tex_samples[3].a * d[3]) >> 16;
+    tex_filter(state, tex_samples, du, dv);
 }
 
 #define CLAMP(x)                      \
@@ -4064,7 +3365,7 @@ dest_pixel_gouraud_shaded_triangle(s3d_state_t *state)
 static void
 dest_pixel_unlit_texture_triangle(s3d_state_t *state)
 {
-    tex_sample(state);
+    state->tex_sample(state);
 
     if (state->cmd_set & CMD_SET_ABC_SRC)
         state->dest_rgba.a = state->a >> 7;
@@ -4073,7 +3374,7 @@ dest_pixel_unlit_texture_triangle(s3d_state_t *state)
 static void
 dest_pixel_lit_texture_decal(s3d_state_t *state)
 {
-    tex_sample(state);
+    state->tex_sample(state);
 
     if (state->cmd_set & CMD_SET_ABC_SRC)
         state->dest_rgba.a = state->a >> 7;
@@ -4082,7 +3383,7 @@ dest_pixel_lit_texture_decal(s3d_state_t *state)
 static void
 dest_pixel_lit_texture_reflection(s3d_state_t *state)
 {
-    tex_sample(state);
+    state->tex_sample(state);
 
     state->dest_rgba.r += (state->r >> 7);
     state->dest_rgba.g += (state->g >> 7);
@@ -4101,7 +3402,7 @@ dest_pixel_lit_texture_modulate(s3d_state_t *state)
     int b = state->b >> 7;
     int a = state->a >> 7;
 
-    tex_sample(state);
+    state->tex_sample(state);
 
     CLAMP_RGBA(r, g, b, a);
 
@@ -4113,12 +3414,147 @@ dest_pixel_lit_texture_modulate(s3d_state_t *state)
         state->dest_rgba.a = a;
 }
 
+/* Per-pixel inner loop of tri(). It is instantiated once per lighting mode
+   below so that dest_pixel is inlined into each copy; the texture format and
+   filter are reached through the sampler pointers in the state. */
+static inline int
+tri_span(virge_t *virge, s3d_t *s3d_tri, s3d_state_t *state, int x, int xe, uint32_t z,
+         uint32_t dest_addr, uint32_t z_addr, void (*dest_pixel)(s3d_state_t *state))
+{
+    uint8_t *vram      = virge->svga.vram;
+    int      x_dir     = s3d_tri->tlr ? 1 : -1;
+    int      use_z     = !(s3d_tri->cmd_set & CMD_SET_ZB_MODE);
+    int      bpp       = (s3d_tri->cmd_set >> 2) & 7;
+    int      x_offset  = x_dir * (bpp + 1);
+    int      xz_offset = x_dir << 1;
+    int      pixels    = 0;
+
+    for (; x != xe; x = (x + x_dir) & 0xfff) {
+        int      update = 1;
+        uint16_t src_z  = 0;
+
+        if (use_z) {
+            src_z = Z_READ(z_addr);
+            Z_CLIP(src_z, z >> 16);
+        }
+
+        if (update) {
+            uint32_t dest_col;
+
+            dest_pixel(state);
+
+            if (s3d_tri->cmd_set & CMD_SET_FE) {
+                int a              = state->a >> 7;
+                state->dest_rgba.r = ((state->dest_rgba.r * a) + (s3d_tri->fog_r * (255 - a))) / 255;
+                state->dest_rgba.g = ((state->dest_rgba.g * a) + (s3d_tri->fog_g * (255 - a))) / 255;
+                state->dest_rgba.b = ((state->dest_rgba.b * a) + (s3d_tri->fog_b * (255 - a))) / 255;
+            }
+
+            if (s3d_tri->cmd_set & CMD_SET_ABC_ENABLE) {
+                uint32_t src_col;
+                int      src_r = 0;
+                uint32_t src_g = 0;
+                uint32_t src_b = 0;
+
+                switch (bpp) {
+                    case 0: /*8 bpp*/
+                        /*Not implemented yet*/
+                        break;
+                    case 1: /*16 bpp*/
+                        src_col = *(uint16_t *) &vram[dest_addr & virge->vram_mask];
+                        RGB15_TO_24(src_col, src_r, src_g, src_b);
+                        break;
+                    case 2: /*24 bpp*/
+                        src_col = (*(uint32_t *) &vram[dest_addr & virge->vram_mask]) & 0xffffff;
+                        RGB24_TO_24(src_col, src_r, src_g, src_b);
+                        break;
+                }
+
+                state->dest_rgba.r = ((state->dest_rgba.r * state->dest_rgba.a) + (src_r * (255 - state->dest_rgba.a))) / 255;
+                state->dest_rgba.g = ((state->dest_rgba.g * state->dest_rgba.a) + (src_g * (255 - state->dest_rgba.a))) / 255;
+                state->dest_rgba.b = ((state->dest_rgba.b * state->dest_rgba.a) + (src_b * (255 - state->dest_rgba.a))) / 255;
+            }
+
+            switch (bpp) {
+                case 0: /*8 bpp*/
+                    /*Not implemented yet*/
+                    break;
+                case 1: /*16 bpp*/
+                    RGB15(x, state->y, state->dest_rgba.r, state->dest_rgba.g, state->dest_rgba.b, dest_col);
+                    *(uint16_t *) &vram[dest_addr] = dest_col;
+                    break;
+                case 2: /*24 bpp*/
+                    dest_col                          = RGB24(state->dest_rgba.r, state->dest_rgba.g, state->dest_rgba.b);
+                    *(uint8_t *) &vram[dest_addr]     = dest_col & 0xff;
+                    *(uint8_t *) &vram[dest_addr + 1] = (dest_col >> 8) & 0xff;
+                    *(uint8_t *) &vram[dest_addr + 2] = (dest_col >> 16) & 0xff;
+                    break;
+            }
+
+            if (use_z && (s3d_tri->cmd_set & CMD_SET_ZUP))
+                Z_WRITE(z_addr, src_z);
+        }
+
+        z += s3d_tri->TdZdX;
+        state->u += s3d_tri->TdUdX;
+        state->v += s3d_tri->TdVdX;
+        state->r += s3d_tri->TdRdX;
+        state->g += s3d_tri->TdGdX;
+        state->b += s3d_tri->TdBdX;
+        state->a += s3d_tri->TdAdX;
+        state->d += s3d_tri->TdDdX;
+        state->w += s3d_tri->TdWdX;
+        dest_addr += x_offset;
+        z_addr += xz_offset;
+        pixels++;
+    }
+
+    return pixels;
+}
+
+typedef int (*tri_span_t)(virge_t *virge, s3d_t *s3d_tri, s3d_state_t *state, int x, int xe,
+                          uint32_t z, uint32_t dest_addr, uint32_t z_addr);
+
+static int
+tri_span_gouraud_shaded(virge_t *virge, s3d_t *s3d_tri, s3d_state_t *state, int x, int xe,
+                        uint32_t z, uint32_t dest_addr, uint32_t z_addr)
+{
+    return tri_span(virge, s3d_tri, state, x, xe, z, dest_addr, z_addr, dest_pixel_gouraud_shaded_triangle);
+}
+
+static int
+tri_span_unlit_texture(virge_t *virge, s3d_t *s3d_tri, s3d_state_t *state, int x, int xe,
+                       uint32_t z, uint32_t dest_addr, uint32_t z_addr)
+{
+    return tri_span(virge, s3d_tri, state, x, xe, z, dest_addr, z_addr, dest_pixel_unlit_texture_triangle);
+}
+
+static int
+tri_span_lit_texture_decal(virge_t *virge, s3d_t *s3d_tri, s3d_state_t *state, int x, int xe,
+                           uint32_t z, uint32_t dest_addr, uint32_t z_addr)
+{
+    return tri_span(virge, s3d_tri, state, x, xe, z, dest_addr, z_addr, dest_pixel_lit_texture_decal);
+}
+
+static int
+tri_span_lit_texture_reflection(virge_t *virge, s3d_t *s3d_tri, s3d_state_t *state, int x, int xe,
+                                uint32_t z, uint32_t dest_addr, uint32_t z_addr)
+{
+    return tri_span(virge, s3d_tri, state, x, xe, z, dest_addr, z_addr, dest_pixel_lit_texture_reflection);
+}
+
+static int
+tri_span_lit_texture_modulate(virge_t *virge, s3d_t *s3d_tri, s3d_state_t *state, int x, int xe,
+                              uint32_t z, uint32_t dest_addr, uint32_t z_addr)
+{
+    return tri_span(virge, s3d_tri, state, x, xe, z, dest_addr, z_addr, dest_pixel_lit_texture_modulate);
+}
+
 static void
-tri(virge_t *virge, s3d_t *s3d_tri, s3d_state_t *state, int yc, int32_t dx1, int32_t dx2)
+tri(virge_t *virge, s3d_t *s3d_tri, s3d_state_t *state, int yc, int32_t dx1, int32_t dx2,
+    tri_span_t span, int thread)
 {
-    uint8_t *vram    = virge->svga.vram;
     int      x_dir   = s3d_tri->tlr ? 1 : -1;
-    int      use_z   = !(s3d_tri->cmd_set & CMD_SET_ZB_MODE);
     int      y_count = yc;
     int      bpp     = (s3d_tri->cmd_set >> 2) & 7;
     uint32_t dest_offset;
@@ -4166,12 +3602,13 @@ tri(virge_t *virge, s3d_t *s3d_tri, s3d_state_t *state, int yc, int32_t dx1, int
             xe--;
         }
 
-        if (x != xe && ((x_dir > 0 && x < xe) || (x_dir < 0 && x > xe))) {
+        /* Lines are interleaved between the render threads; the threads that
+           don't own this line only step the edges and gradients past it. */
+        if ((state->y & virge->odd_even_mask) == thread &&
+            x != xe && ((x_dir > 0 && x < xe) || (x_dir < 0 && x > xe))) {
             uint32_t dest_addr;
             uint32_t z_addr;
-            int      dx        = (x_dir > 0) ? ((31 - ((state->x1 - 1) >> 15)) & 0x1f) : (((state->x1 - 1) >> 15) & 0x1f);
-            int      x_offset  = x_dir * (bpp + 1);
-            int      xz_offset = x_dir << 1;
+            int      dx = (x_dir > 0) ? ((31 - ((state->x1 - 1) >> 15)) & 0x1f) : (((state->x1 - 1) >> 15) & 0x1f);
 
             if (x_dir > 0)
                 dx += 1;
@@ -4242,88 +3679,7 @@ tri(virge_t *virge, s3d_t *s3d_tri, s3d_state_t *state, int yc, int32_t dx1, int
             x &= 0xfff;
             xe &= 0xfff;
 
-            for (; x != xe; x = (x + x_dir) & 0xfff) {
-                int      update = 1;
-                uint16_t src_z  = 0;
-
-                _x = x;
-                _y = state->y;
-
-                if (use_z) {
-                    src_z = Z_READ(z_addr);
-                    Z_CLIP(src_z, z >> 16);
-                }
-
-                if (update) {
-                    uint32_t dest_col;
-
-                    dest_pixel(state);
-
-                    if (s3d_tri->cmd_set & CMD_SET_FE) {
-                        int a              = state->a >> 7;
-                        state->dest_rgba.r = ((state->dest_rgba.r * a) + (s3d_tri->fog_r * (255 - a))) / 255;
-                        state->dest_rgba.g = ((state->dest_rgba.g * a) + (s3d_tri->fog_g * (255 - a))) / 255;
-                        state->dest_rgba.b = ((state->dest_rgba.b * a) + (s3d_tri->fog_b * (255 - a))) / 255;
-                    }
-
-                    if (s3d_tri->cmd_set & CMD_SET_ABC_ENABLE) {
-                        uint32_t src_col;
-                        int      src_r = 0;
-                        uint32_t src_g = 0;
-                        uint32_t src_b = 0;
-
-                        switch (bpp) {
-                            case 0: /*8 bpp*/
-                                /*Not implemented yet*/
-                                break;
-                            case 1: /*16 bpp*/
-                                src_col = *(uint16_t *) &vram[dest_addr & virge->vram_mask];
-                                RGB15_TO_24(src_col, src_r, src_g, src_b);
-                                break;
-                            case 2: /*24 bpp*/
-                                src_col = (*(uint32_t *) &vram[dest_addr & virge->vram_mask]) & 0xffffff;
-                                RGB24_TO_24(src_col, src_r, src_g, src_b);
-                                break;
-                        }
-
-                        state->dest_rgba.r = ((state->dest_rgba.r * state->dest_rgba.a) + (src_r * (255 - state->dest_rgba.a))) / 255;
-                        state->dest_rgba.g = ((state->dest_rgba.g * state->dest_rgba.a) + (src_g * (255 - state->dest_rgba.a))) / 255;
-                        state->dest_rgba.b = ((state->dest_rgba.b * state->dest_rgba.a) + (src_b * (255 - state->dest_rgba.a))) / 255;
-                    }
-
-                    switch (bpp) {
-                        case 0: /*8 bpp*/
-                            /*Not implemented yet*/
-                            break;
-                        case 1: /*16 bpp*/
-                            RGB15(state->dest_rgba.r, state->dest_rgba.g, state->dest_rgba.b, dest_col);
-                            *(uint16_t *) &vram[dest_addr] = dest_col;
-                            break;
-                        case 2: /*24 bpp*/
-                            dest_col                          = RGB24(state->dest_rgba.r, state->dest_rgba.g, state->dest_rgba.b);
-                            *(uint8_t *) &vram[dest_addr]     = dest_col & 0xff;
-                            *(uint8_t *) &vram[dest_addr + 1] = (dest_col >> 8) & 0xff;
-                            *(uint8_t *) &vram[dest_addr + 2] = (dest_col >> 16) & 0xff;
-                            break;
-                    }
-
-                    if (use_z && (s3d_tri->cmd_set & CMD_SET_ZUP))
-                        Z_WRITE(z_addr, src_z);
-                }
-
-                z += s3d_tri->TdZdX;
-                state->u += s3d_tri->TdUdX;
-                state->v += s3d_tri->TdVdX;
-                state->r += s3d_tri->TdRdX;
-                state->g += s3d_tri->TdGdX;
-                state->b += s3d_tri->TdBdX;
-                state->a += s3d_tri->TdAdX;
-                state->d += s3d_tri->TdDdX;
-                state->w += s3d_tri->TdWdX;
-                dest_addr += x_offset;
-                z_addr += xz_offset;
-                virge->pixel_count++;
-            }
+            virge->pixel_count[thread] += span(virge, s3d_tri, state, x, xe, z, dest_addr, z_addr);
         }
 
 tri_skip_line:
@@ -4346,13 +3702,34 @@ tri_skip_line:
 
 static int tex_size[8] = { 4 * 2, 2 * 2, 2 * 2, 1 * 2, 2 / 1, 2 / 1, 1 * 2, 1 * 2 };
 
+/* Converts a texel (or the border colour) to ARGB8888; the formats without a
+   decoder of their own are read as ARGB1555. */
+static inline uint32_t
+tex_decode(int format, uint32_t val)
+{
+    switch (format) {
+        case 0:
+            return val;
+        case 1:
+            return (((val & 0xf000) << 12) | ((val & 0xf000) << 16) |
+                    ((val & 0x0f00) << 8) | ((val & 0x0f00) << 12) |
+                    ((val & 0x00f0) << 4) | ((val & 0x00f0) << 8) |
+                    ((val & 0x000f) << 4) | (val & 0x000f));
+        default:
+            return ((val & 0x8000) ? 0xff000000 : 0) |
+                   ((((val & 0x7c00) >> 7) | ((val & 0x7000) >> 12)) << 16) |
+                   ((((val & 0x03e0) >> 2) | ((val & 0x0380) >> 7)) << 8) |
+                   (((val & 0x001f) << 3) | ((val & 0x001c) >> 2));
+    }
+}
+
 static void
-s3_virge_triangle(virge_t *virge, s3d_t *s3d_tri)
+s3_virge_triangle(virge_t *virge, s3d_t *s3d_tri, int thread)
 {
     s3d_state_t state;
+    tri_span_t  span;
 
-    uint32_t tex_base;
-    int      c;
+    int c;
 
     uint64_t start_time = plat_timer_read();
     uint64_t end_time;
@@ -4360,9 +3737,7 @@ s3_virge_triangle(virge_t *virge, s3d_t *s3d_tri)
     state.tbu = s3d_tri->tbu << 11;
     state.tbv = s3d_tri->tbv << 11;
 
-    state.max_d = (s3d_tri->cmd_set >> 8) & 15;
-
-    state.tex_bdr_clr = s3d_tri->tex_bdr_clr;
+    state.max_d = MIN((s3d_tri->cmd_set >> 8) & 15, 9);
 
     state.cmd_set = s3d_tri->cmd_set;
 
@@ -4376,28 +3751,29 @@ s3_virge_triangle(virge_t *virge, s3d_t *s3d_tri)
     state.base_d = s3d_tri->tds;
     state.base_w = s3d_tri->tws;
 
-    tex_base = s3d_tri->tex_base;
-    for (c = 9; c >= 0; c--) {
-        state.texture[c] = (uint16_t *) &virge->svga.vram[tex_base];
-        if (c <= state.max_d)
-            tex_base += ((1 << (c * 2)) * tex_size[(s3d_tri->cmd_set >> 5) & 7]) / 2;
+    if (s3d_tri->tex_entry >= 0) {
+        const s3d_tex_cache_t *entry = &virge->tex_cache[s3d_tri->tex_entry];
+
+        for (c = 0; c <= state.max_d; c++)
+            state.texture[c] = &entry->data[TEX_LEVEL_OFFSET(c)];
+        state.tex_bdr_clr = tex_decode(entry->format, s3d_tri->tex_bdr_clr);
     }
 
     switch ((s3d_tri->cmd_set >> 27) & 0xf) {
         case 0:
-            dest_pixel = dest_pixel_gouraud_shaded_triangle;
+            span = tri_span_gouraud_shaded;
             break;
         case 1:
         case 5:
             switch ((s3d_tri->cmd_set >> 15) & 0x3) {
                 case 0:
-                    dest_pixel = dest_pixel_lit_texture_reflection;
+                    span = tri_span_lit_texture_reflection;
                     break;
                 case 1:
-                    dest_pixel = dest_pixel_lit_texture_modulate;
+                    span = tri_span_lit_texture_modulate;
                     break;
                 case 2:
-                    dest_pixel = dest_pixel_lit_texture_decal;
+                    span = tri_span_lit_texture_decal;
                     break;
                 default:
                     return;
@@ -4405,7 +3781,7 @@ s3_virge_triangle(virge_t *virge, s3d_t *s3d_tri)
             break;
         case 2:
         case 6:
-            dest_pixel = dest_pixel_unlit_texture_triangle;
+            span = tri_span_unlit_texture;
             break;
         default:
             return;
@@ -4414,117 +3790,432 @@ s3_virge_triangle(virge_t *virge, s3d_t *s3d_tri)
     switch (((s3d_tri->cmd_set >> 12) & 7) | ((s3d_tri->cmd_set & (1 << 29)) ? 8 : 0)) {
         case 0:
         case 1:
-            tex_sample = tex_sample_mipmap;
+            state.tex_sample = tex_sample_mipmap;
             break;
         case 2:
         case 3:
-            tex_sample = virge->bilinear_enabled ? tex_sample_mipmap_filter : tex_sample_mipmap;
+            state.tex_sample = virge->bilinear_enabled ? tex_sample_mipmap_filter : tex_sample_mipmap;
             break;
         case 4:
         case 5:
-            tex_sample = tex_sample_normal;
+            state.tex_sample = tex_sample_normal;
             break;
         case 6:
         case 7:
-            tex_sample = virge->bilinear_enabled ? tex_sample_normal_filter : tex_sample_normal;
+            state.tex_sample = virge->bilinear_enabled ? tex_sample_normal_filter : tex_sample_normal;
             break;
         case (0 | 8):
         case (1 | 8):
             if ((virge->chip == S3_VIRGEDX) || (virge->chip >= S3_VIRGEGX2))
-                tex_sample = tex_sample_persp_mipmap_375;
+                state.tex_sample = tex_sample_persp_mipmap_375;
             else
-                tex_sample = tex_sample_persp_mipmap;
+                state.tex_sample = tex_sample_persp_mipmap;
             break;
         case (2 | 8):
         case (3 | 8):
             if ((virge->chip == S3_VIRGEDX) || (virge->chip >= S3_VIRGEGX2))
-                tex_sample = virge->bilinear_enabled ? tex_sample_persp_mipmap_filter_375 :
-                                                       tex_sample_persp_mipmap_375;
+                state.tex_sample = virge->bilinear_enabled ? tex_sample_persp_mipmap_filter_375 :
+                                                             tex_sample_persp_mipmap_375;
             else
-                tex_sample = virge->bilinear_enabled ? tex_sample_persp_mipmap_filter :
-                                                       tex_sample_persp_mipmap;
+                state.tex_sample = virge->bilinear_enabled ? tex_sample_persp_mipmap_filter :
+                                                             tex_sample_persp_mipmap;
             break;
         case (4 | 8):
         case (5 | 8):
             if ((virge->chip == S3_VIRGEDX) || (virge->chip >= S3_VIRGEGX2))
-                tex_sample = tex_sample_persp_normal_375;
+                state.tex_sample = tex_sample_persp_normal_375;
             else
-                tex_sample = tex_sample_persp_normal;
+                state.tex_sample = tex_sample_persp_normal;
             break;
         case (6 | 8):
         case (7 | 8):
             if ((virge->chip == S3_VIRGEDX) || (virge->chip >= S3_VIRGEGX2))
-                tex_sample = virge->bilinear_enabled ? tex_sample_persp_normal_filter_375 :
-                                                       tex_sample_persp_normal_375;
+                state.tex_sample = virge->bilinear_enabled ? tex_sample_persp_normal_filter_375 :
+                                                             tex_sample_persp_normal_375;
             else
-                tex_sample = virge->bilinear_enabled ? tex_sample_persp_normal_filter :
-                                                       tex_sample_persp_normal;
+                state.tex_sample = virge->bilinear_enabled ? tex_sample_persp_normal_filter :
+                                                             tex_sample_persp_normal;
             break;
     }
 
-    switch ((s3d_tri->cmd_set >> 5) & 7) {
-        case 0:
-            tex_read = (s3d_tri->cmd_set & CMD_SET_TWE) ? tex_ARGB8888 : tex_ARGB8888_nowrap;
-            break;
-        case 1:
-            tex_read = (s3d_tri->cmd_set & CMD_SET_TWE) ? tex_ARGB4444 : tex_ARGB4444_nowrap;
-            break;
-        case 2:
-            tex_read = (s3d_tri->cmd_set & CMD_SET_TWE) ? tex_ARGB1555 : tex_ARGB1555_nowrap;
-            break;
-        default:
-            tex_read = (s3d_tri->cmd_set & CMD_SET_TWE) ? tex_ARGB1555 : tex_ARGB1555_nowrap;
-            break;
-    }
+    state.tex_read = (s3d_tri->cmd_set & CMD_SET_TWE) ? tex_read : tex_read_nowrap;
 
     state.y  = s3d_tri->tys;
     state.x1 = s3d_tri->txs;
     state.x2 = s3d_tri->txend01;
-    tri(virge, s3d_tri, &state, s3d_tri->ty01, s3d_tri->TdXdY02, s3d_tri->TdXdY01);
+    tri(virge, s3d_tri, &state, s3d_tri->ty01, s3d_tri->TdXdY02, s3d_tri->TdXdY01, span, thread);
     state.x2 = s3d_tri->txend12;
-    tri(virge, s3d_tri, &state, s3d_tri->ty12, s3d_tri->TdXdY02, s3d_tri->TdXdY12);
+    tri(virge, s3d_tri, &state, s3d_tri->ty12, s3d_tri->TdXdY02, s3d_tri->TdXdY12, span, thread);
 
-    virge->tri_count++;
+    if (thread == 0) {
+        virge->tri_count++;
 
-    end_time = plat_timer_read();
+        end_time = plat_timer_read();
 
-    virge_time += end_time - start_time;
+        virge_time += end_time - start_time;
+    }
 }
 
 static void
-render_thread(void *param)
+render_thread(virge_t *virge, int thread)
 {
-    virge_t *virge = (virge_t *) param;
-
     while (virge->render_thread_run) {
-        thread_wait_event(virge->wake_render_thread, -1);
-        thread_reset_event(virge->wake_render_thread);
-        virge->s3d_busy = 1;
-        while (!RB_EMPTY) {
-            s3_virge_triangle(virge, &virge->s3d_buffer[virge->s3d_read_idx & RB_MASK]);
-            virge->s3d_read_idx++;
-
-            if (RB_ENTRIES == RB_MASK)
+        thread_wait_event(virge->wake_render_thread[thread], -1);
+        thread_reset_event(virge->wake_render_thread[thread]);
+        virge->s3d_busy[thread] = 1;
+        while (!RB_EMPTY(thread)) {
+            s3d_t *s3d_tri = &virge->s3d_buffer[virge->s3d_read_idx[thread] & RB_MASK];
+
+            s3_virge_triangle(virge, s3d_tri, thread);
+            if (s3d_tri->tex_entry >= 0)
+                virge->tex_cache[s3d_tri->tex_entry].refcount_r[thread]++;
+            virge->s3d_read_idx[thread]++;
+
+            if (RB_ENTRIES(thread) == RB_MASK)
                 thread_set_event(virge->not_full_event);
         }
-        virge->s3d_busy = 0;
-        virge->subsys_stat |= INT_S3D_DONE;
-        virge->irq_pending++;
+
+        /*Only the last thread to go idle raises the completion interrupt*/
+        thread_wait_mutex(virge->s3d_idle_mutex);
+        virge->s3d_busy[thread] = 0;
+        if (!s3_virge_s3d_busy(virge)) {
+            virge->subsys_stat |= INT_S3D_DONE;
+            virge->irq_pending++;
+        }
+        thread_release_mutex(virge->s3d_idle_mutex);
+
+        /*A triangle queued while we were going idle may not have woken us*/
+        if (!RB_EMPTY(thread))
+            thread_set_event(virge->wake_render_thread[thread]);
+        thread_set_event(virge->wake_main_thread);
+    }
+}
+
+static void
+render_thread_1(void *param)
+{
+    render_thread((virge_t *) param, 0);
+}
+
+static void
+render_thread_2(void *param)
+{
+    render_thread((virge_t *) param, 1);
+}
+
+static void
+render_thread_3(void *param)
+{
+    render_thread((virge_t *) param, 2);
+}
+
+static void
+render_thread_4(void *param)
+{
+    render_thread((virge_t *) param, 3);
+}
+
+static int
+s3_virge_rb_full(virge_t *virge)
+{
+    for (int c = 0; c < virge->render_threads; c++) {
+        if (RB_FULL(c))
+            return 1;
+    }
+
+    return 0;
+}
+
+static void
+s3_virge_tex_mark_present(uint8_t *present, uint32_t start, uint32_t end)
+{
+    for (uint32_t addr = start & ~((1 << TEX_DIRTY_SHIFT) - 1); addr < end; addr += (1 << TEX_DIRTY_SHIFT))
+        present[addr >> TEX_DIRTY_SHIFT] = 1;
+}
+
+/* s3_virge_tex_dirty() reads the map without tex_mutex, so build the new one
+   aside and copy it over: pages of live entries never read as clear. */
+static void
+s3_virge_tex_update_present(virge_t *virge)
+{
+    memset(virge->tex_present_new, 0, (virge->vram_mask + 1) >> TEX_DIRTY_SHIFT);
+
+    for (int c = 0; c < TEX_CACHE_MAX; c++) {
+        const s3d_tex_cache_t *entry = &virge->tex_cache[c];
+
+        if (entry->valid)
+            s3_virge_tex_mark_present(virge->tex_present_new, entry->addr_start, entry->addr_end);
+    }
+
+    memcpy(virge->tex_present, virge->tex_present_new, (virge->vram_mask + 1) >> TEX_DIRTY_SHIFT);
+}
+
+/* Drops every entry decoded from VRAM in [start, end). Entries still in use
+   by queued triangles keep their data until the render threads are done. */
+static void
+s3_virge_tex_invalidate(virge_t *virge, uint32_t start, uint32_t end)
+{
+    int evicted = 0;
+
+    for (int c = 0; c < TEX_CACHE_MAX; c++) {
+        s3d_tex_cache_t *entry = &virge->tex_cache[c];
+
+        if (entry->valid && (start < entry->addr_end) && (end > entry->addr_start)) {
+            entry->valid = 0;
+            virge->tex_cached--;
+            evicted = 1;
+        }
+    }
+
+    if (evicted)
+        s3_virge_tex_update_present(virge);
+}
+
+/* Called after VRAM at addr has been written, with the write no longer than a dword. */
+static void
+s3_virge_tex_dirty(virge_t *virge, uint32_t addr, uint32_t len)
+{
+    addr &= virge->vram_mask;
+
+    /* CPU writes are fenced in s3_virge_tex_write_linear(); blits run on the
+       FIFO thread, which also does the lookups. */
+    if (!virge->tex_present[addr >> TEX_DIRTY_SHIFT] &&
+        !virge->tex_present[((addr + len - 1) & virge->vram_mask) >> TEX_DIRTY_SHIFT])
+        return;
+
+    thread_wait_mutex(virge->tex_mutex);
+    s3_virge_tex_invalidate(virge, addr, addr + len);
+    thread_release_mutex(virge->tex_mutex);
+}
+
+static void
+s3_virge_tex_flush_all(virge_t *virge)
+{
+    thread_wait_mutex(virge->tex_mutex);
+    s3_virge_tex_invalidate(virge, 0, virge->vram_mask + 1);
+    thread_release_mutex(virge->tex_mutex);
+}
+
+static int
+s3_virge_tex_entry_idle(virge_t *virge, const s3d_tex_cache_t *entry)
+{
+    for (int c = 0; c < virge->render_threads; c++) {
+        if (entry->refcount != entry->refcount_r[c])
+            return 0;
+    }
+
+    return 1;
+}
+
+static void
+s3_virge_tex_range(virge_t *virge, s3d_tex_cache_t *entry)
+{
+    uint32_t tex_base   = entry->base;
+    uint32_t texel_size = entry->format ? 2 : 4;
+
+    entry->addr_start = tex_base;
+    entry->addr_end   = tex_base;
+
+    for (int c = entry->max_d; c >= 0; c--) {
+        entry->addr_end = MAX(entry->addr_end, tex_base + ((1 << (c * 2)) * texel_size));
+        tex_base += ((1 << (c * 2)) * tex_size[entry->format]) / 2;
+    }
+
+    /* A texture running off the end of VRAM wraps; just treat it as covering all of it. */
+    if (entry->addr_end > (virge->vram_mask + 1)) {
+        entry->addr_start = 0;
+        entry->addr_end   = virge->vram_mask + 1;
+    }
+}
+
+static void
+s3_virge_tex_decode(virge_t *virge, s3d_tex_cache_t *entry)
+{
+    const uint8_t *vram       = virge->svga.vram;
+    uint32_t       tex_base   = entry->base;
+    uint32_t       texel_size = entry->format ? 2 : 4;
+    uint32_t       addr;
+
+    for (int c = entry->max_d; c >= 0; c--) {
+        uint32_t *out    = &entry->data[TEX_LEVEL_OFFSET(c)];
+        int       texels = 1 << (c * 2);
+
+        for (int i = 0; i < texels; i++) {
+            addr = tex_base + (i * texel_size);
+
+            if (entry->format == 0)
+                out[i] = *(uint32_t *) &vram[addr & virge->vram_mask];
+            else
+                out[i] = tex_decode(entry->format, vram[addr & virge->vram_mask] |
+                                                   (vram[(addr + 1) & virge->vram_mask] << 8));
+        }
+
+        tex_base += (texels * tex_size[entry->format]) / 2;
+    }
+}
+
+static int
+s3_virge_tex_lookup(virge_t *virge, const s3d_t *s3d_tri)
+{
+    s3d_tex_cache_t *entry;
+    uint32_t         base   = s3d_tri->tex_base & virge->vram_mask;
+    int              format = (s3d_tri->cmd_set >> 5) & 7;
+    int              max_d  = MIN((s3d_tri->cmd_set >> 8) & 15, 9);
+    int              size   = TEX_LEVEL_OFFSET(max_d + 1);
+    int              c;
+
+    for (c = 0; c < TEX_CACHE_MAX; c++) {
+        entry = &virge->tex_cache[c];
+
+        if (entry->valid && (entry->base == base) && (entry->format == format) && (entry->max_d == max_d)) {
+            entry->refcount++;
+            return c;
+        }
+    }
+
+    /* Prefer a free entry, otherwise evict round robin, skipping the ones
+       queued triangles still sample from. */
+    for (c = 0; c < TEX_CACHE_MAX; c++) {
+        if (!virge->tex_cache[c].valid && s3_virge_tex_entry_idle(virge, &virge->tex_cache[c]))
+            break;
+    }
+    if (c == TEX_CACHE_MAX) {
+        c = virge->tex_last_removed;
+        for (int n = 0; n < TEX_CACHE_MAX; n++) {
+            c = (c + 1) & (TEX_CACHE_MAX - 1);
+            if (s3_virge_tex_entry_idle(virge, &virge->tex_cache[c]))
+                break;
+        }
+        if (!s3_virge_tex_entry_idle(virge, &virge->tex_cache[c]))
+            s3_virge_wait_for_render_finished(virge);
+        virge->tex_last_removed = c;
+    }
+
+    entry = &virge->tex_cache[c];
+    if (entry->valid) {
+        entry->valid = 0;
+        virge->tex_cached--;
+    }
+
+    if (entry->data_size < size) {
+        entry->data      = realloc(entry->data, size * sizeof(uint32_t));
+        entry->data_size = size;
+    }
+    entry->base   = base;
+    entry->format = format;
+    entry->max_d  = max_d;
+
+    /* The texture may be one the render threads are still drawing. */
+    s3_virge_tex_range(virge, entry);
+    if ((entry->addr_start < virge->tex_render_end) && (entry->addr_end > virge->tex_render_start)) {
+        s3_virge_wait_for_render_finished(virge);
+        virge->tex_render_start = virge->tex_render_end = 0;
+    }
+
+    /* Count the entry and mark its pages before reading them, so a guest
+       write racing with the decode takes tex_mutex in s3_virge_tex_dirty()
+       and drops the entry once it is valid. */
+    virge->tex_cached++;
+    s3_virge_tex_mark_present(virge->tex_present, entry->addr_start, entry->addr_end);
+    atomic_thread_fence(memory_order_seq_cst);
+    s3_virge_tex_decode(virge, entry);
+
+    entry->valid = 1;
+    entry->refcount++;
+    s3_virge_tex_update_present(virge);
+
+    return c;
+}
+
+/* Conservative range of VRAM touched by the scanlines of a triangle. */
+static void
+s3_virge_tri_range(virge_t *virge, const s3d_t *s3d_tri, uint32_t base, uint32_t str,
+                   uint32_t *start, uint32_t *end)
+{
+    int     lines = s3d_tri->ty01 + s3d_tri->ty12;
+    int64_t y     = (int32_t) s3d_tri->tys;
+    int64_t first;
+    int64_t last;
+
+    if (lines <= 0) {
+        *start = *end = 0;
+        return;
+    }
+
+    first = base + ((y - lines + 1) * str);
+    last  = base + (y * str) + (0x1000 * 4);
+
+    if ((first < 0) || (last > (virge->vram_mask + 1))) {
+        *start = 0;
+        *end   = virge->vram_mask + 1;
+    } else {
+        *start = first;
+        *end   = last;
+    }
+}
+
+static void
+s3_virge_tex_queue(virge_t *virge, s3d_t *s3d_tri)
+{
+    uint32_t range[2][2];
+    int      ranges = 1;
+
+    s3_virge_tri_range(virge, s3d_tri, s3d_tri->dest_base, s3d_tri->dest_str, &range[0][0], &range[0][1]);
+    if (!(s3d_tri->cmd_set & CMD_SET_ZB_MODE)) {
+        s3_virge_tri_range(virge, s3d_tri, s3d_tri->z_base, s3d_tri->z_str, &range[1][0], &range[1][1]);
+        ranges = 2;
+    }
+
+    thread_wait_mutex(virge->tex_mutex);
+
+    if (!s3_virge_s3d_busy(virge))
+        virge->tex_render_start = virge->tex_render_end = 0;
+
+    switch ((s3d_tri->cmd_set >> 27) & 0xf) {
+        case 1:
+        case 2:
+        case 5:
+        case 6:
+            s3d_tri->tex_entry = s3_virge_tex_lookup(virge, s3d_tri);
+            break;
+        default:
+            s3d_tri->tex_entry = -1;
+            break;
+    }
+
+    /* Anything this triangle draws over must be decoded afresh by the next one sampling it. */
+    for (int c = 0; c < ranges; c++) {
+        if (range[c][0] == range[c][1])
+            continue;
+        if (virge->tex_cached)
+            s3_virge_tex_invalidate(virge, range[c][0], range[c][1]);
+        if (virge->tex_render_start == virge->tex_render_end) {
+            virge->tex_render_start = range[c][0];
+            virge->tex_render_end   = range[c][1];
+        } else {
+            virge->tex_render_start = MIN(virge->tex_render_start, range[c][0]);
+            virge->tex_render_end   = MAX(virge->tex_render_end, range[c][1]);
+        }
     }
+
+    thread_release_mutex(virge->tex_mutex);
 }
 
 static void
 queue_triangle(virge_t *virge)
 {
-    if (RB_FULL) {
+    while (s3_virge_rb_full(virge)) {
         thread_reset_event(virge->not_full_event);
-        if (RB_FULL)
+        if (s3_virge_rb_full(virge))
             thread_wait_event(virge->not_full_event, -1); /*Wait for room in ringbuffer*/
     }
+    s3_virge_tex_queue(virge, &virge->s3d_tri);
     virge->s3d_buffer[virge->s3d_write_idx & RB_MASK] = virge->s3d_tri;
     virge->s3d_write_idx++;
-    if (!virge->s3d_busy)
-        thread_set_event(virge->wake_render_thread); /*Wake up render thread if moving from idle*/
+    for (int c = 0; c < virge->render_threads; c++) {
+        if (!virge->s3d_busy[c])
+            thread_set_event(virge->wake_render_thread[c]); /*Wake up render thread if moving from idle*/
+    }
 }
 
 static void
@@ -5314,11 +5005,21 @@ s3_virge_reset(void *priv)
         dev->virge_busy       = 0;
         dev->fifo_write_idx   = 0;
         dev->fifo_read_idx    = 0;
-        dev->s3d_busy         = 0;
+        for (int c = 0; c < S3D_MAX_THREADS; c++) {
+            dev->s3d_busy[c]     = 0;
+            dev->s3d_read_idx[c] = 0;
+        }
         dev->s3d_write_idx    = 0;
-        dev->s3d_read_idx     = 0;
         reset_state->pci_slot = dev->pci_slot;
 
+        /* The texture cache lives outside the device state, so empty it and
+           forget about the triangles that were dropped from the ring. */
+        s3_virge_tex_flush_all(dev);
+        for (int c = 0; c < TEX_CACHE_MAX; c++) {
+            for (int d = 0; d < S3D_MAX_THREADS; d++)
+                dev->tex_cache[c].refcount_r[d] = dev->tex_cache[c].refcount;
+        }
+
         *dev = *reset_state;
     }
 }
@@ -5338,6 +5039,15 @@ s3_virge_init(const device_t *info)
 
     virge->bilinear_enabled  = device_get_config_int("bilinear");
     virge->dithering_enabled = device_get_config_int("dithering");
+    virge->render_threads    = device_get_config_int("render_threads");
+    /* Lines are split by odd_even_mask, so only 1, 2 or 4 threads work. */
+    if (virge->render_threads >= S3D_MAX_THREADS)
+        virge->render_threads = S3D_MAX_THREADS;
+    else if (virge->render_threads >= 2)
+        virge->render_threads = 2;
+    else
+        virge->render_threads = 1;
+    virge->odd_even_mask     = virge->render_threads - 1;
     if (virge->type >= S3_VIRGE_GX2)
         virge->memory_size = 4;
     else if (virge->type == S3_VIRGE_325 && local & 0x100)
@@ -5398,6 +5108,12 @@ s3_virge_init(const device_t *info)
     virge->svga.hwcursor.cur_ysize = 64;
     virge->svga.conv_16to32        = tvp3026_conv_16to32;
 
+    virge->svga.write  = s3_virge_write;
+    virge->svga.writew = s3_virge_writew;
+    virge->svga.writel = s3_virge_writel;
+    mem_mapping_set_handler(&virge->svga.mapping, virge->svga.read, virge->svga.readw, virge->svga.readl,
+                            virge->svga.write, virge->svga.writew, virge->svga.writel);
+
     if (bios_fn != NULL) {
         if (virge->type == S3_VIRGE_GX2)
             rom_init(&virge->bios_rom, bios_fn, 0xc0000, 0x10000, 0xffff, 0, MEM_MAPPING_EXTERNAL);
@@ -5408,12 +5124,12 @@ s3_virge_init(const device_t *info)
     }
 
     mem_mapping_add(&virge->linear_mapping, 0, 0,
-                    svga_read_linear,
-                    svga_readw_linear,
-                    svga_readl_linear,
-                    svga_write_linear,
-                    svga_writew_linear,
-                    svga_writel_linear,
+                    s3_virge_read_linear,
+                    s3_virge_readw_linear,
+                    s3_virge_readl_linear,
+                    s3_virge_write_linear,
+                    s3_virge_writew_linear,
+                    s3_virge_writel_linear,
                     NULL,
                     MEM_MAPPING_EXTERNAL,
                     &virge->svga);
@@ -5575,11 +5291,23 @@ s3_virge_init(const device_t *info)
 
     virge->svga.force_old_addr = 1;
 
-    virge->render_thread_run  = 1;
-    virge->wake_render_thread = thread_create_event();
-    virge->wake_main_thread   = thread_create_event();
-    virge->not_full_event     = thread_create_event();
-    virge->render_thread      = thread_create(render_thread, virge);
+    virge->render_thread_run = 1;
+    virge->wake_main_thread  = thread_create_event();
+    virge->not_full_event    = thread_create_event();
+    virge->s3d_idle_mutex    = thread_create_mutex();
+    virge->tex_mutex         = thread_create_mutex();
+    virge->tex_cache         = calloc(TEX_CACHE_MAX, sizeof(s3d_tex_cache_t));
+    virge->tex_present       = calloc((virge->vram_mask + 1) >> TEX_DIRTY_SHIFT, 1);
+    virge->tex_present_new   = calloc((virge->vram_mask + 1) >> TEX_DIRTY_SHIFT, 1);
+    for (int c = 0; c < virge->render_threads; c++)
+        virge->wake_render_thread[c] = thread_create_event();
+    virge->render_thread[0] = thread_create(render_thread_1, virge);
+    if (virge->render_threads >= 2)
+        virge->render_thread[1] = thread_create(render_thread_2, virge);
+    if (virge->render_threads == 4) {
+        virge->render_thread[2] = thread_create(render_thread_3, virge);
+        virge->render_thread[3] = thread_create(render_thread_4, virge);
+    }
 
     virge->fifo_thread_run     = 1;
     virge->wake_fifo_thread    = thread_create_event();
@@ -5601,11 +5329,14 @@ s3_virge_close(void *priv)
     virge_t *virge = (virge_t *) priv;
 
     virge->render_thread_run = 0;
-    thread_set_event(virge->wake_render_thread);
-    thread_wait(virge->render_thread);
+    for (int c = 0; c < virge->render_threads; c++) {
+        thread_set_event(virge->wake_render_thread[c]);
+        thread_wait(virge->render_thread[c]);
+        thread_destroy_event(virge->wake_render_thread[c]);
+    }
+    thread_close_mutex(virge->s3d_idle_mutex);
     thread_destroy_event(virge->not_full_event);
     thread_destroy_event(virge->wake_main_thread);
-    thread_destroy_event(virge->wake_render_thread);
 
     virge->fifo_thread_run = 0;
     thread_set_event(virge->wake_fifo_thread);
@@ -5613,6 +5344,13 @@ s3_virge_close(void *priv)
     thread_destroy_event(virge->fifo_not_full_event);
     thread_destroy_event(virge->wake_fifo_thread);
 
+    for (int c = 0; c < TEX_CACHE_MAX; c++)
+        free(virge->tex_cache[c].data);
+    free(virge->tex_cache);
+    free(virge->tex_present);
+    free(virge->tex_present_new);
+    thread_close_mutex(virge->tex_mutex);
+
     svga_close(&virge->svga);
 
     ddc_close(virge->ddc);
@@ -5705,6 +5443,22 @@ static const device_config_t s3_virge_config[] = {
         .selection      = { { 0 } },
         .bios           = { { 0 } }
     },
+    {
+        .name           = "render_threads",
+        .description    = "Render threads",
+        .type           = CONFIG_SELECTION,
+        .default_string = NULL,
+        .default_int    = 2,
+        .file_filter    = NULL,
+        .spinner        = { 0 },
+        .selection      = {
+            { .description = "1", .value = 1 },
+            { .description = "2", .value = 2 },
+            { .description = "4", .value = 4 },
+            { .description = ""              }
+        },
+        .bios           = { { 0 } }
+    },
     { .name = "", .description = "", .type = CONFIG_END }
     // clang-format on
 };
@@ -5798,6 +5552,22 @@ static const device_config_t s3_virge_pci_config[] = {
         .selection      = { { 0 } },
         .bios           = { { 0 } }
     },
+    {
+        .name           = "render_threads",
+        .description    = "Render threads",
+        .type           = CONFIG_SELECTION,
+        .default_string = NULL,
+        .default_int    = 2,
+        .file_filter    = NULL,
+        .spinner        = { 0 },
+        .selection      = {
+            { .description = "1", .value = 1 },
+            { .description = "2", .value = 2 },
+            { .description = "4", .value = 4 },
+            { .description = ""              }
+        },
+        .bios           = { { 0 } }
+    },
     { .name = "", .description = "", .type = CONFIG_END }
     // clang-format on
 };
@@ -5835,6 +5605,22 @@ static const device_config_t s3_virge_onboard_config[] = {
         .selection      = { { 0 } },
         .bios           = { { 0 } }
     },
+    {
+        .name           = "render_threads",
+        .description    = "Render threads",
+        .type           = CONFIG_SELECTION,
+        .default_string = NULL,
+        .default_int    = 2,
+        .file_filter    = NULL,
+        .spinner        = { 0 },
+        .selection      = {
+            { .description = "1", .value = 1 },
+            { .description = "2", .value = 2 },
+            { .description = "4", .value = 4 },
+            { .description = ""              }
+        },
+        .bios           = { { 0 } }
+    },
     { .name = "", .description = "", .type = CONFIG_END }
     // clang-format on
 };
@@ -5919,6 +5705,22 @@ static const device_config_t s3_virge_vx_pci_config[] = {
         .selection      = { { 0 } },
         .bios           = { { 0 } }
     },
+    {
+        .name           = "render_threads",
+        .description    = "Render threads",
+        .type           = CONFIG_SELECTION,
+        .default_string = NULL,
+        .default_int    = 2,
+        .file_filter    = NULL,
+        .spinner        = { 0 },
+        .selection      = {
+            { .description = "1", .value = 1 },
+            { .description = "2", .value = 2 },
+            { .description = "4", .value = 4 },
+            { .description = ""              }
+        },
+        .bios           = { { 0 } }
+    },
     { .name = "", .description = "", .type = CONFIG_END }
     // clang-format on
 };
@@ -6002,6 +5804,22 @@ static const device_config_t s3_virge_dx_pci_config[] = {
         .selection      = { { 0 } },
         .bios           = { { 0 } }
     },
+    {
+        .name           = "render_threads",
+        .description    = "Render threads",
+        .type           = CONFIG_SELECTION,
+        .default_string = NULL,
+        .default_int    = 2,
+        .file_filter    = NULL,
+        .spinner        = { 0 },
+        .selection      = {
+            { .description = "1", .value = 1 },
+            { .description = "2", .value = 2 },
+            { .description = "4", .value = 4 },
+            { .description = ""              }
+        },
+        .bios           = { { 0 } }
+    },
     { .name = "", .description = "", .type = CONFIG_END }
     // clang-format on
 };
@@ -6054,6 +5872,22 @@ static const device_config_t s3_virge_gx2_pci_config[] = {
         .selection      = { { 0 } },
         .bios           = { { 0 } }
     },
+    {
+        .name           = "render_threads",
+        .description    = "Render threads",
+        .type           = CONFIG_SELECTION,
+        .default_string = NULL,
+        .default_int    = 2,
+        .file_filter    = NULL,
+        .spinner        = { 0 },
+        .selection      = {
+            { .description = "1", .value = 1 },
+            { .description = "2", .value = 2 },
+            { .description = "4", .value = 4 },
+            { .description = ""              }
+        },
+        .bios           = { { 0 } }
+    },
     { .name = "", .description = "", .type = CONFIG_END }
     // clang-format on
 };
@@ -6138,6 +5972,22 @@ static const device_config_t s3_virge_gx2_agp_config[] = {
         .selection      = { { 0 } },
         .bios           = { { 0 } }
     },
+    {
+        .name           = "render_threads",
+        .description    = "Render threads",
+        .type           = CONFIG_SELECTION,
+        .default_string = NULL,
+        .default_int    = 2,
+        .file_filter    = NULL,
+        .spinner        = { 0 },
+        .selection      = {
+            { .description = "1", .value = 1 },
+            { .description = "2", .value = 2 },
+            { .description = "4", .value = 4 },
+            { .description = ""              }
+        },
+        .bios           = { { 0 } }
+    },
     { .name = "", .description = "", .type = CONFIG_END }
     // clang-format on
 };
@@ -6192,6 +6042,22 @@ static const device_config_t s3_trio3d2x_config[] = {
         .selection      = { { 0 } },
         .bios           = { { 0 } }
     },
+    {
+        .name           = "render_threads",
+        .description    = "Render threads",
+        .type           = CONFIG_SELECTION,
+        .default_string = NULL,
+        .default_int    = 2,
+        .file_filter    = NULL,
+        .spinner        = { 0 },
+        .selection      = {
+            { .description = "1", .value = 1 },
+            { .description = "2", .value = 2 },
+            { .description = "4", .value = 4 },
+            { .description = ""              }
+        },
+        .bios           = { { 0 } }
+    },
     { .name = "", .description = "", .type = CONFIG_END }
     // clang-format on
 };
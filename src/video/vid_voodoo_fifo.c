@@ -30,6 +30,7 @@
 #include <86box/device.h>
 #include <86box/plat.h>
 #include <86box/thread.h>
+#include <86box/trace.h>
 #include <86box/video.h>
 #include <86box/vid_svga.h>
 #include <86box/vid_voodoo_common.h>
@@ -388,6 +389,7 @@ voodoo_fifo_thread(void *param)
         thread_wait_event(voodoo->wake_fifo_thread, -1);
         thread_reset_event(voodoo->wake_fifo_thread);
         voodoo->voodoo_busy = 1;
+        TRACE_NAMED_ENTER("voodoo", "fifo");
         while (!FIFO_EMPTY) {
             uint64_t      start_time = plat_timer_read();
             uint64_t      end_time;
@@ -1062,6 +1064,7 @@ voodoo_fifo_thread(void *param)
             voodoo->time += end_time - start_time;
         }
 
+        TRACE_LEAVE();
         voodoo->voodoo_busy = 0;
     }
 }
@@ -33,6 +33,7 @@
 #include <86box/device.h>
 #include <86box/plat.h>
 #include <86box/thread.h>
+#include <86box/trace.h>
 #include <86box/video.h>
 #include <86box/vid_svga.h>
 #include <86box/vid_voodoo_common.h>
@@ -1608,6 +1609,7 @@ render_thread(void *param, int odd_even)
     process_work:
 #endif
         RENDER_VOODOO_BUSY(voodoo, odd_even) = 1;
+        TRACE_NAMED_ENTER("voodoo", odd_even ? "render odd" : "render even");
 
         while (!PARAM_EMPTY(odd_even)) {
             uint64_t         start_time = plat_timer_read();
@@ -1625,6 +1627,7 @@ render_thread(void *param, int odd_even)
             voodoo->render_time[odd_even] += end_time - start_time;
         }
 
+        TRACE_LEAVE();
         RENDER_VOODOO_BUSY(voodoo, odd_even) = 0;
 #if (defined __aarch64__ || defined _M_ARM64)
         /* Spin briefly before sleeping to absorb burst triangle submissions